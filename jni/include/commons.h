@@ -97,10 +97,97 @@ namespace knn_jni {
          */
         void freeBinaryVectorData(jlong);
 
+        /**
+         * Builds a KNNQueryResult array out of the first resultSize ids and distances. The local reference of every
+         * KNNQueryResult is released once it is stored in the array, so large result sets do not exhaust the local
+         * reference table.
+         *
+         * @param ids doc ids of the results
+         * @param distances distances of the results
+         * @param resultSize number of results
+         * @return array of KNNQueryResult
+         */
+        jobjectArray buildKNNQueryResults(knn_jni::JNIUtilInterface *, JNIEnv *, const int64_t *, const float *, int);
+
+        /**
+         * Copies the first resultSize ids and distances into caller provided Java arrays, without allocating any Java
+         * object. When the arrays are shorter than resultSize, only as many results as the arrays can hold are copied,
+         * and the returned count exceeds the array length so the caller can detect the overflow.
+         *
+         * @param ids doc ids of the results
+         * @param distances distances of the results
+         * @param resultSize number of results
+         * @param resultIdsJ output int array for the doc ids
+         * @param resultDistancesJ output float array for the distances
+         * @return number of results found, which may be larger than the number copied
+         */
+        jint copyQueryResults(knn_jni::JNIUtilInterface *, JNIEnv *, const int64_t *, const float *, int, jintArray, jfloatArray);
+
         /**
          * Extracts query time efSearch from method parameters
          **/
-        int getIntegerMethodParameter(JNIEnv *, knn_jni::JNIUtilInterface *, std::unordered_map<std::string, jobject>, std::string, int);
+        int getIntegerMethodParameter(JNIEnv *, knn_jni::JNIUtilInterface *, const std::unordered_map<std::string, jobject> &, const std::string &, int);
+
+        /**
+         * Query time parameters resolved out of the Java method parameters map. Walking the Java map takes several JNI
+         * upcalls per entry, so callers running many queries with the same parameters can compile them once with
+         * compileSearchParams and pass the returned handle instead of the map.
+         */
+        struct SearchParams {
+            bool hasEfSearch = false;
+            int efSearch = 0;
+            bool hasNprobes = false;
+            int nprobes = 0;
+            // Number of threads a single query may use to scan inverted lists or flat vectors. Queries run on the
+            // calling thread alone unless this is set above 1.
+            bool hasParallelism = false;
+            int parallelism = 0;
+
+            int getEfSearch(int defaultValue) const {
+                return hasEfSearch ? efSearch : defaultValue;
+            }
+
+            int getNprobes(int defaultValue) const {
+                return hasNprobes ? nprobes : defaultValue;
+            }
+
+            int getParallelism(int defaultValue) const {
+                return hasParallelism ? parallelism : defaultValue;
+            }
+        };
+
+        /**
+         * Resolves the query time parameters from a Java method parameters map. A null map yields empty parameters.
+         *
+         * @param methodParamsJ Java Map<String, Object> of method parameters, may be null
+         * @return resolved parameters
+         */
+        SearchParams parseSearchParams(knn_jni::JNIUtilInterface *, JNIEnv *, jobject);
+
+        /**
+         * Resolves the query time parameters from a Java method parameters map and stores them in native memory so
+         * they can be reused across queries. The returned handle must be released with freeSearchParams.
+         *
+         * @param methodParamsJ Java Map<String, Object> of method parameters, may be null
+         * @return memory address of the SearchParams
+         */
+        jlong compileSearchParams(knn_jni::JNIUtilInterface *, JNIEnv *, jobject);
+
+        /**
+         * Returns the SearchParams stored at the handle returned by compileSearchParams. A 0 handle yields empty
+         * parameters, so the index defaults apply.
+         *
+         * @param searchParamsPointer handle returned by compileSearchParams, or 0
+         * @return the stored parameters
+         */
+        const SearchParams &getSearchParams(jlong);
+
+        /**
+         * Free up the memory allocated by compileSearchParams.
+         *
+         * @param searchParamsPointer handle to be freed.
+         */
+        void freeSearchParams(jlong);
     }
 }
 
@@ -0,0 +1,53 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * The OpenSearch Contributors require contributions made to
+ * this file be licensed under the Apache-2.0 license or a
+ * compatible open source license.
+ *
+ * Modifications Copyright OpenSearch Contributors. See
+ * GitHub history for details.
+ */
+
+#ifndef KNNPLUGIN_JNI_INCLUDE_CRC32_UTIL_H_
+#define KNNPLUGIN_JNI_INCLUDE_CRC32_UTIL_H_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace knn_jni {
+namespace util {
+
+/**
+ * CRC32 of java.util.zip.CRC32, the checksum Lucene writes in the footer of every file. The bytes are folded with
+ * carry-less multiplications on CPUs having PCLMULQDQ, and with lookup tables otherwise.
+ *
+ * Note that the crc32 instruction of SSE4.2 computes CRC32C, a different polynomial, so it cannot be used here.
+ */
+class Crc32 {
+ public:
+  Crc32() : crc() {
+  }
+
+  // Resumes the CRC32 of bytes already checksummed
+  explicit Crc32(uint32_t _crc) : crc(_crc) {
+  }
+
+  void update(const uint8_t *bytes, size_t length);
+
+  // Same as java.util.zip.CRC32#getValue
+  uint32_t getValue() const {
+    return crc;
+  }
+
+ private:
+  uint32_t crc;
+};  // class Crc32
+
+// Updates a CRC32 with the given bytes, like zlib's crc32
+uint32_t crc32(uint32_t crc, const uint8_t *bytes, size_t length);
+
+}
+}  // namespace knn_jni
+
+#endif //KNNPLUGIN_JNI_INCLUDE_CRC32_UTIL_H_
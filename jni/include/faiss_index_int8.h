@@ -0,0 +1,80 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * The OpenSearch Contributors require contributions made to
+ * this file be licensed under the Apache-2.0 license or a
+ * compatible open source license.
+ *
+ * Modifications Copyright OpenSearch Contributors. See
+ * GitHub history for details.
+ */
+
+#ifndef KNNPLUGIN_JNI_FAISS_INDEX_INT8_H
+#define KNNPLUGIN_JNI_FAISS_INDEX_INT8_H
+
+#include "faiss/Index.h"
+#include "faiss/IndexFlatCodes.h"
+#include "faiss/IndexScalarQuantizer.h"
+#include "faiss/impl/DistanceComputer.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace knn_jni {
+    namespace faiss_wrapper {
+
+        /**
+         * Byte vectors are stored with the QT_8bit_direct_signed scalar quantizer, which keeps component x as the code
+         * x + 128. A code is thus the int8 value with its sign bit flipped, so byte vectors can be encoded and compared
+         * without going through float.
+         */
+
+        // Whether index is an IndexScalarQuantizer storing QT_8bit_direct_signed codes
+        bool isInt8DirectStorage(const faiss::Index *index);
+
+        // Whether index is an int8 direct storage or an IndexHNSW over one, so addInt8Vectors can be used
+        bool supportsInt8Add(const faiss::Index *index);
+
+        // Encode n int8 vectors of dimension d as QT_8bit_direct_signed codes
+        void encodeInt8Vectors(const int8_t *x, size_t n, size_t d, uint8_t *codes);
+
+        // Squared L2 distance between an int8 vector and a QT_8bit_direct_signed code, computed in integers
+        int32_t int8L2Sqr(const int8_t *x, const uint8_t *code, size_t d);
+
+        // Inner product of an int8 vector and a QT_8bit_direct_signed code, computed in integers
+        int32_t int8InnerProduct(const int8_t *x, const uint8_t *code, size_t d);
+
+        /**
+         * Distance computer over QT_8bit_direct_signed codes using the integer kernels. Float queries are rounded to
+         * int8, which is exact for the byte vector queries sent by the plugin. Like the faiss computers, inner product
+         * is returned as is, so larger is closer, unless negated is set.
+         */
+        struct Int8DirectDistanceComputer : faiss::FlatCodesDistanceComputer {
+            size_t d;
+            faiss::MetricType metric;
+            bool negated;
+            std::vector<int8_t> query;
+            std::vector<int8_t> symmetricQuery;
+
+            explicit Int8DirectDistanceComputer(const faiss::IndexScalarQuantizer &storage, bool negated = false);
+
+            void set_query(const float *x) override;
+
+            // Use the vector stored as code as the query
+            void set_query_code(const uint8_t *code);
+
+            float distance_to_code(const uint8_t *code) override;
+
+            float symmetric_dis(faiss::idx_t i, faiss::idx_t j) override;
+        };
+
+        /**
+         * Add n int8 vectors to an index storing QT_8bit_direct_signed codes, either an IndexScalarQuantizer or an
+         * IndexHNSW over one. The codes are appended to the storage directly and the HNSW graph is linked with
+         * Int8DirectDistanceComputer, so the vectors are never converted to float.
+         */
+        void addInt8Vectors(faiss::Index *index, size_t n, const int8_t *x);
+    }
+}
+
+#endif //KNNPLUGIN_JNI_FAISS_INDEX_INT8_H
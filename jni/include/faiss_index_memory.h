@@ -0,0 +1,46 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * The OpenSearch Contributors require contributions made to
+ * this file be licensed under the Apache-2.0 license or a
+ * compatible open source license.
+ *
+ * Modifications Copyright OpenSearch Contributors. See
+ * GitHub history for details.
+ */
+
+#ifndef KNNPLUGIN_JNI_FAISS_INDEX_MEMORY_H
+#define KNNPLUGIN_JNI_FAISS_INDEX_MEMORY_H
+
+#include "faiss/Index.h"
+#include "faiss/IndexBinary.h"
+#include "faiss/impl/HNSW.h"
+#include <cstddef>
+
+namespace knn_jni {
+    namespace faiss_wrapper {
+
+        /**
+         * Memory model of the structures of an index that grow with the vectors added to it: IDMap labels, flat codes,
+         * HNSW levels, offsets and neighbors, IVF lists and direct map, and the centroids of an IVF quantizer that is
+         * not trained yet. The estimate and the reservation walk the index the same way and every one of these
+         * structures is reserved. IVF lists are the exception, as the list of a vector is only known once it is added:
+         * each list is reserved an even share, and the estimate allows for lists that outgrow it to double.
+         */
+
+        // Expected number of HNSW neighbor slots taken by numVectors vertices, with a margin for the random levels
+        size_t expectedHNSWNeighborSlots(const faiss::HNSW &hnsw, size_t numVectors);
+
+        // Bytes the index will grow by once numVectors more vectors are added to it
+        size_t estimateIndexMemory(const faiss::Index *index, size_t numVectors);
+
+        size_t estimateIndexMemory(const faiss::IndexBinary *index, size_t numVectors);
+
+        // Reserve every structure estimateIndexMemory counts, so adding numVectors vectors does not reallocate them
+        void reserveIndexMemory(faiss::Index *index, size_t numVectors);
+
+        void reserveIndexMemory(faiss::IndexBinary *index, size_t numVectors);
+    }
+}
+
+#endif //KNNPLUGIN_JNI_FAISS_INDEX_MEMORY_H
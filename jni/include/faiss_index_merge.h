@@ -0,0 +1,41 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * The OpenSearch Contributors require contributions made to
+ * this file be licensed under the Apache-2.0 license or a
+ * compatible open source license.
+ *
+ * Modifications Copyright OpenSearch Contributors. See
+ * GitHub history for details.
+ */
+
+#ifndef KNNPLUGIN_JNI_FAISS_INDEX_MERGE_H
+#define KNNPLUGIN_JNI_FAISS_INDEX_MERGE_H
+
+#include "faiss/IndexIDMap.h"
+#include <cstddef>
+#include <cstdint>
+
+namespace knn_jni {
+    namespace faiss_wrapper {
+
+        // Whether the graph of the index can be carried over to a merged segment: an HNSW index over flat codes,
+        // whose vertices can be dropped by moving the codes of the others
+        bool supportsGraphReuse(const faiss::Index *index);
+
+        bool supportsGraphReuse(const faiss::IndexBinary *index);
+
+        /**
+         * Turn the HNSW index of a source segment into the start of the merged segment's index. The label of every
+         * vector is replaced by docMap[label], the doc id of the vector in the merged segment. Vectors of deleted
+         * docs, mapped to a negative doc id, are dropped along with their vertices. The neighbors they leave behind
+         * fill the freed slots with the neighbors of the dropped vertices, closest first, and vertices that are no
+         * longer reachable from the entry point are linked into the graph again.
+         */
+        void remapGraphIndex(faiss::IndexIDMap *idMap, const int32_t *docMap, size_t docMapSize);
+
+        void remapGraphIndex(faiss::IndexBinaryIDMap *idMap, const int32_t *docMap, size_t docMapSize);
+    }
+}
+
+#endif //KNNPLUGIN_JNI_FAISS_INDEX_MERGE_H
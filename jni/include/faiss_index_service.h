@@ -69,6 +69,17 @@ public:
      */
     virtual void writeIndex(faiss::IOWriter* writer, jlong idMapAddress);
 
+    /**
+     * Estimate the native memory an index takes once numVectors vectors are added to it
+     *
+     * @param metric space type for distance calculation
+     * @param indexDescription index description to be used by faiss index factory
+     * @param dim dimension of vectors
+     * @param numVectors number of vectors
+     * @return estimated size of the index in bytes
+     */
+    virtual size_t estimateIndexMemory(faiss::MetricType metric, std::string indexDescription, int dim, size_t numVectors);
+
     virtual ~IndexService() = default;
 
 protected:
@@ -132,8 +143,16 @@ public:
      */
     void writeIndex(faiss::IOWriter* writer, jlong idMapAddress) final;
 
-protected:
-    void allocIndex(faiss::Index * index, size_t dim, size_t numVectors) final;
+    /**
+     * Estimate the native memory an index takes once numVectors vectors are added to it
+     *
+     * @param metric space type for distance calculation
+     * @param indexDescription index description to be used by faiss binary index factory
+     * @param dim dimension of vectors
+     * @param numVectors number of vectors
+     * @return estimated size of the index in bytes
+     */
+    size_t estimateIndexMemory(faiss::MetricType metric, std::string indexDescription, int dim, size_t numVectors) final;
 };  // class BinaryIndexService
 
 /**
@@ -190,9 +209,6 @@ public:
      * @param parameters parameters to be applied to faiss index
      */
     void writeIndex(faiss::IOWriter* writer, jlong idMapAddress) final;
-
- protected:
-    void allocIndex(faiss::Index * index, size_t dim, size_t numVectors) final;
 };  // class ByteIndexService
 
 }
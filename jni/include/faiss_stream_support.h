@@ -18,9 +18,18 @@
 #include "parameter_utils.h"
 
 #include <jni.h>
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
 #include <stdexcept>
 #include <iostream>
 #include <cstring>
+#include <thread>
+#include <vector>
 
 namespace knn_jni {
 namespace stream {
@@ -92,6 +101,180 @@ class FaissOpenSearchIOWriter final : public faiss::IOWriter {
 
 
 
+/**
+ * An IOWriter Faiss writes to from a background thread. The bytes are collected in a bounded ring of native blocks,
+ * which the thread calling into Java drains to the actual writer, so serializing the index overlaps with writing it
+ * to IndexOutput. Faiss waits once every block is filled and not drained yet, so at most `numBlocks` blocks are held.
+ */
+class FaissRingBufferIOWriter final : public faiss::IOWriter {
+ public:
+  FaissRingBufferIOWriter(size_t _blockSize, size_t _numBlocks)
+      : faiss::IOWriter(),
+        blockSize(_blockSize),
+        numBlocks(_numBlocks),
+        allocatedBlocks(),
+        closed(),
+        cancelled() {
+    if (blockSize == 0 || numBlocks == 0) {
+      throw std::runtime_error("FaissRingBufferIOWriter needs at least one non empty block");
+    }
+    name = "FaissRingBufferIOWriter";
+  }
+
+  // Called by Faiss on the background thread.
+  size_t operator()(const void *ptr, size_t size, size_t nitems) final {
+    auto source = reinterpret_cast<const uint8_t *>(ptr);
+    auto left = size * nitems;
+    while (left > 0) {
+      if (current == nullptr) {
+        current = acquireBlock();
+      }
+      const auto writeBytes = std::min(blockSize - current->size, left);
+      std::memcpy(current->bytes.data() + current->size, source, writeBytes);
+      current->size += writeBytes;
+      if (current->size == blockSize) {
+        publishCurrentBlock();
+      }
+      source += writeBytes;
+      left -= writeBytes;
+    }
+    return nitems;
+  }
+
+  int filedescriptor() final {
+    throw std::runtime_error("filedescriptor() is not supported in FaissRingBufferIOWriter.");
+  }
+
+  // Called by the background thread once Faiss wrote everything.
+  void close() {
+    if (current != nullptr && current->size > 0) {
+      publishCurrentBlock();
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    closed = true;
+    condition.notify_all();
+  }
+
+  // Stops both sides, the next write of Faiss throws and the drain returns.
+  void cancel() {
+    std::lock_guard<std::mutex> lock(mutex);
+    cancelled = true;
+    condition.notify_all();
+  }
+
+  // Called by the calling thread, writes blocks to `output` as they are filled until the writer is closed or
+  // cancelled.
+  void drainTo(faiss::IOWriter *output) {
+    while (true) {
+      std::unique_ptr<Block> block;
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        condition.wait(lock, [this] { return cancelled || closed || !filledBlocks.empty(); });
+        if (cancelled || filledBlocks.empty()) {
+          return;
+        }
+        block = std::move(filledBlocks.front());
+        filledBlocks.pop_front();
+      }
+
+      (*output)(block->bytes.data(), 1, block->size);
+      block->size = 0;
+
+      std::lock_guard<std::mutex> lock(mutex);
+      freeBlocks.push_back(std::move(block));
+      condition.notify_all();
+    }
+  }
+
+ private:
+  struct Block {
+    explicit Block(size_t capacity) : bytes(capacity), size() {
+    }
+
+    std::vector<uint8_t> bytes;
+    size_t size;
+  };
+
+  std::unique_ptr<Block> acquireBlock() {
+    std::unique_lock<std::mutex> lock(mutex);
+    condition.wait(lock, [this] { return cancelled || !freeBlocks.empty() || allocatedBlocks < numBlocks; });
+    if (cancelled) {
+      throw std::runtime_error("Writing the index was cancelled.");
+    }
+    if (!freeBlocks.empty()) {
+      auto block = std::move(freeBlocks.back());
+      freeBlocks.pop_back();
+      return block;
+    }
+    // Blocks are only allocated once needed, so a small index takes a single block.
+    allocatedBlocks++;
+    return std::unique_ptr<Block>(new Block(blockSize));
+  }
+
+  void publishCurrentBlock() {
+    std::lock_guard<std::mutex> lock(mutex);
+    filledBlocks.push_back(std::move(current));
+    condition.notify_all();
+  }
+
+  const size_t blockSize;
+  const size_t numBlocks;
+  // Only touched by the background thread.
+  std::unique_ptr<Block> current;
+  std::mutex mutex;
+  std::condition_variable condition;
+  std::deque<std::unique_ptr<Block>> filledBlocks;
+  std::vector<std::unique_ptr<Block>> freeBlocks;
+  size_t allocatedBlocks;
+  bool closed;
+  bool cancelled;
+};  // class FaissRingBufferIOWriter
+
+// 4 blocks of 1MB, large enough for the output mediator to copy whole blocks to Java without staging them.
+constexpr size_t RING_BUFFER_BLOCK_SIZE = 1024 * 1024;
+constexpr size_t RING_BUFFER_NUM_BLOCKS = 4;
+
+/**
+ * Runs `write` on a background thread with a FaissRingBufferIOWriter, while the calling thread drains it to `output`.
+ * `output` is only ever called from the calling thread, so it may call into Java. An error of either side stops the
+ * other one, and is rethrown once the background thread is done. A failed drain comes first, as it is what made
+ * `write` fail when both did.
+ */
+inline void writeInBackground(faiss::IOWriter *output,
+                              const std::function<void(faiss::IOWriter *)> &write,
+                              size_t blockSize = RING_BUFFER_BLOCK_SIZE,
+                              size_t numBlocks = RING_BUFFER_NUM_BLOCKS) {
+  FaissRingBufferIOWriter ringWriter {blockSize, numBlocks};
+  std::exception_ptr writeError;
+  std::thread writer([&ringWriter, &write, &writeError]() {
+    try {
+      write(&ringWriter);
+      ringWriter.close();
+    } catch (...) {
+      writeError = std::current_exception();
+      ringWriter.cancel();
+    }
+  });
+
+  std::exception_ptr drainError;
+  try {
+    ringWriter.drainTo(output);
+  } catch (...) {
+    drainError = std::current_exception();
+    ringWriter.cancel();
+  }
+  writer.join();
+
+  if (drainError) {
+    std::rethrow_exception(drainError);
+  }
+  if (writeError) {
+    std::rethrow_exception(writeError);
+  }
+}
+
+
+
 }
 }
 
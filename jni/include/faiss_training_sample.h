@@ -0,0 +1,73 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * The OpenSearch Contributors require contributions made to
+ * this file be licensed under the Apache-2.0 license or a
+ * compatible open source license.
+ *
+ * Modifications Copyright OpenSearch Contributors. See
+ * GitHub history for details.
+ */
+
+#ifndef KNNPLUGIN_JNI_FAISS_TRAINING_SAMPLE_H
+#define KNNPLUGIN_JNI_FAISS_TRAINING_SAMPLE_H
+
+#include "faiss/Index.h"
+#include "faiss/IndexBinary.h"
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace knn_jni {
+    namespace faiss_wrapper {
+
+        // Number of training vectors the index makes use of. k-means, for the coarse quantizer and for the product
+        // quantizer sub-spaces alike, only looks at max_points_per_centroid points per centroid and subsamples
+        // anything beyond that. Returns 0 for an index that needs no training.
+        size_t trainingSampleSize(const faiss::Index *index);
+
+        size_t trainingSampleSize(const faiss::IndexBinary *index);
+
+        /**
+         * Uniform sample of fixed capacity over a stream of vectors of codeSize bytes each, fed in batches of any
+         * size. Once the sample is full, the positions of the vectors that replace a sampled one are drawn directly
+         * (reservoir sampling, algorithm L), so the vectors that are skipped cost nothing but the batch boundaries.
+         */
+        class VectorReservoir {
+        public:
+            VectorReservoir(size_t codeSize, size_t capacity, uint64_t seed);
+
+            void add(const uint8_t *vectors, size_t n);
+
+            // Number of sampled vectors, at most the capacity
+            size_t size() const { return sampled; }
+
+            // Number of vectors fed to the reservoir so far
+            size_t seen() const { return total; }
+
+            size_t capacity() const { return maxSampled; }
+
+            size_t vectorSize() const { return codeSize; }
+
+            const uint8_t *data() const { return codes.data(); }
+
+        private:
+            double randomUniform();
+
+            void drawNextSampled();
+
+            size_t codeSize;
+            size_t maxSampled;
+            size_t sampled = 0;
+            size_t total = 0;
+            // Stream position of the next vector that replaces a sampled one, once the sample is full
+            size_t nextSampled = 0;
+            double weight = 0;
+            std::mt19937_64 generator;
+            std::vector<uint8_t> codes;
+        };
+    }
+}
+
+#endif //KNNPLUGIN_JNI_FAISS_TRAINING_SAMPLE_H
@@ -15,10 +15,157 @@
 #define OPENSEARCH_KNN_FAISS_UTIL_H
 
 #include "faiss/impl/IDGrouper.h"
+#include "faiss/impl/IDSelector.h"
+#include "faiss/impl/ResultHandler.h"
+#include "faiss/utils/Heap.h"
+#include <cstdint>
 #include <memory>
+#include <unordered_map>
+#include <vector>
 
 namespace faiss_util {
     std::unique_ptr<faiss::IDGrouperBitmap> buildIDGrouperBitmap(int *parentIdsArray,  int parentIdsLength, std::vector<uint64_t>* bitmap);
+
+    // Filters of up to this many sorted ids are searched in place, larger ones are converted to roaring containers
+    constexpr size_t SORTED_ARRAY_SELECTOR_MAX_IDS = 4096;
+
+    // Selector over sorted ids. It is only a view over the ids, so nothing is built per query. A lookup interpolates
+    // the position of the id from the first and last ids and gallops from there, which lands next to the id when the
+    // filter is spread evenly over the segment.
+    struct IDSelectorSortedArray : faiss::IDSelector {
+        size_t n;
+        const int64_t *ids;
+
+        IDSelectorSortedArray(size_t _n, const int64_t *_ids) : n(_n), ids(_ids) {}
+
+        bool is_member(faiss::idx_t id) const final;
+    };
+
+    // Selector over sorted, disjoint id ranges laid out as begin0, end0, begin1, end1, ... with exclusive ends. Like
+    // IDSelectorSortedArray it is a view over the ranges.
+    struct IDSelectorRanges : faiss::IDSelector {
+        size_t numRanges;
+        const int64_t *ranges;
+
+        IDSelectorRanges(size_t _numRanges, const int64_t *_ranges) : numRanges(_numRanges), ranges(_ranges) {}
+
+        bool is_member(faiss::idx_t id) const final;
+    };
+
+    // Roaring style selector. Ids are split into chunks of 2^16 ids by their high bits, and every chunk keeps the
+    // smallest of a sorted array of its low bits, a bitmap or a list of runs.
+    class IDSelectorRoaring : public faiss::IDSelector {
+    public:
+        // Builds the containers from non negative, sorted ids. Duplicates are allowed.
+        IDSelectorRoaring(size_t n, const int64_t *sortedIds);
+
+        bool is_member(faiss::idx_t id) const final;
+
+    private:
+        enum ContainerType : uint8_t {
+            EMPTY, ARRAY, BITMAP, RUNS,
+        };
+
+        struct Container {
+            ContainerType type;
+            // Offset of the container in lows for arrays and runs, or in words for bitmaps
+            uint32_t offset;
+            // Number of ids of an array or number of runs
+            uint32_t size;
+        };
+
+        int64_t firstChunk;
+        std::vector<Container> containers;
+        // Low bits of array containers, and first and last low bits of every run of run containers
+        std::vector<uint16_t> lows;
+        std::vector<uint64_t> words;
+    };
+
+    // Selector to use for a filter given as an array of ids
+    enum class IdsSelectorKind {
+        // Ids are not sorted, they need a hash based selector
+        UNSORTED,
+        SORTED_ARRAY,
+        ROARING,
+    };
+
+    // Picks the selector for a filter given as an array of ids from its cardinality. Small filters are cheapest to
+    // search in place, larger ones pay for building roaring containers, which then pick arrays, bitmaps or runs from
+    // the density of every chunk.
+    IdsSelectorKind chooseIdsSelector(const int64_t *ids, size_t n);
+
+    // Whether brute forcing the docs selected by a filter is cheaper than a filtered HNSW search. With a selectivity
+    // of s, HNSW has to visit about efSearch / s nodes before it collects efSearch candidates that pass the filter,
+    // which exceeds the filterCardinality distances of an exact search once filterCardinality^2 <= efSearch * ntotal.
+    bool isExactSearchPreferred(int64_t filterCardinality, int64_t ntotal, int k, int efSearch);
+
+    // Flat scans hand each thread at least this many vectors, below that the thread hand off costs more than it saves
+    constexpr int64_t MIN_VECTORS_PER_SCAN_TASK = 16384;
+
+    // Number of parts to split a query into given the parallelism it asked for and the units of work it has, like
+    // probed inverted lists or vectors to scan. Every part gets at least minWorkPerTask units, so small queries stay
+    // on the calling thread.
+    int chooseQueryParallelism(int requestedParallelism, int64_t work, int64_t minWorkPerTask);
+
+    // What a BoundedRangeResultHandler keeps of the hits under the radius
+    enum class RangeResultMode {
+        // The maxResults closest hits
+        BEST,
+        // Nothing, hits are only counted
+        COUNT,
+    };
+
+    // Range search result handler that keeps at most maxResults hits, where a faiss RangeSearchResult keeps every hit
+    // under the radius. Smaller distances are better, so similarity scores have to be negated first, like faiss does
+    // for its own HNSW search. In BEST mode the threshold is tightened to the worst kept hit once maxResults are kept.
+    //
+    // With a grouper only the closest hit of every group is kept, and maxResults and the count apply to groups. The
+    // closest hit of a group can come after hits of other groups, so in BEST mode up to 2 * maxResults groups are
+    // kept and pruned back to the best maxResults when that fills up.
+    class BoundedRangeResultHandler : public faiss::ResultHandler<faiss::CMax<float, int64_t>> {
+    public:
+        BoundedRangeResultHandler(float radius, size_t maxResults, RangeResultMode mode,
+                                  const faiss::IDGrouper *grouper = nullptr);
+
+        bool add_result(float distance, int64_t id) final;
+
+        // Number of hits, or groups, under the radius. Only COUNT mode sees them all, BEST mode misses the ones
+        // past its tightened threshold.
+        size_t count() const;
+
+        // Moves the kept hits into distances and ids, closest first, and returns how many there are
+        size_t finish(std::vector<float> *distances, std::vector<int64_t> *ids);
+
+    private:
+        bool addGroupedResult(float distance, int64_t id);
+
+        size_t maxResults;
+        RangeResultMode mode;
+        const faiss::IDGrouper *grouper;
+        size_t hits;
+        // Max heap on distance in BEST mode, hits in the order they were found with a grouper
+        std::vector<std::pair<float, int64_t>> kept;
+        // Slot in kept of every group with a kept hit
+        std::unordered_map<int64_t, size_t> groupSlots;
+    };
+
+    // 64 bit fingerprint of a byte buffer, to tell whether two serialized indexes are the same without keeping a copy
+    // of either. It reads 8 bytes per step, so it runs at about the memory bandwidth. Not meant to resist collisions
+    // crafted on purpose.
+    uint64_t fingerprint(const uint8_t *data, size_t length);
+
+    // fingerprint() of a buffer that is read in chunks. Every chunk but the last must be a multiple of 8 bytes long.
+    class Fingerprinter {
+    public:
+        explicit Fingerprinter(size_t length);
+
+        void update(const uint8_t *data, size_t length);
+
+        uint64_t finish() const;
+
+    private:
+        uint64_t hash;
+    };
 };
 
 
@@ -21,8 +21,34 @@ namespace knn_jni {
     namespace faiss_wrapper {
         jlong InitIndex(knn_jni::JNIUtilInterface *jniUtil, JNIEnv *env, jlong numDocs, jint dimJ, jobject parametersJ, IndexService *indexService);
 
+        // Estimate the native memory, in bytes, of the index InitIndex would create for the same parameters once numDocs
+        // vectors are added to it. Nothing is allocated for the vectors.
+        jlong EstimateIndexMemory(knn_jni::JNIUtilInterface *jniUtil, JNIEnv *env, jlong numDocs, jint dimJ, jobject parametersJ, IndexService *indexService);
+
         void InsertToIndex(knn_jni::JNIUtilInterface *jniUtil, JNIEnv *env, jintArray idsJ, jlong vectorsAddressJ, jint dimJ, jlong indexAddr, jint threadCount, IndexService *indexService);
 
+        // Start the background thread that adds the batches of one build to the index at indexAddr. The same thread
+        // serves every batch, and must be stopped with StopInsertWorker once the build is done.
+        //
+        // Return a handle to the insert worker
+        jlong StartInsertWorker(jlong indexAddr, jint dimJ, jint threadCount, std::unique_ptr<IndexService> indexService);
+
+        // Same as InsertToIndex, but the vectors are queued to be added by the insert worker and the call returns right
+        // away, so the caller can fill its next batch in the meantime. Batches are added in the order they are
+        // submitted. The vectors at vectorsAddressJ must be left untouched, and no other insert may be made into the
+        // index, until WaitForInsertToIndex returns for the batch.
+        //
+        // Return the number of the batch, to be passed to WaitForInsertToIndex
+        jlong SubmitInsertToIndex(knn_jni::JNIUtilInterface *jniUtil, JNIEnv *env, jlong insertWorkerJ, jintArray idsJ,
+                                  jlong vectorsAddressJ);
+
+        // Wait for the worker to be done with batch insertBatchJ and the ones submitted before it. Rethrow the error of
+        // a failed insert, once an insert failed the later batches are skipped.
+        void WaitForInsertToIndex(jlong insertWorkerJ, jlong insertBatchJ);
+
+        // Stop the insert worker and free it. The batch being added is finished first, the queued ones are dropped.
+        void StopInsertWorker(jlong insertWorkerJ);
+
         void WriteIndex(knn_jni::JNIUtilInterface *jniUtil, JNIEnv *env, jobject output, jlong indexAddr, IndexService *indexService);
 
         // Create an index with ids and vectors. Instead of creating a new index, this function creates the index
@@ -43,11 +69,22 @@ namespace knn_jni {
                                          jlong vectorsAddressJ, jint dimJ, jobject output, jbyteArray templateIndexJ,
                                          jobject parametersJ);
 
+        // Drop the deserialized template of modelId cached by the builds from templates. Called once the model is
+        // deleted or evicted from the model cache.
+        void EvictTemplateIndex(const std::string &modelId);
+
         // Load an index from indexPathJ into memory.
         //
         // Return a pointer to the loaded index
         jlong LoadIndex(knn_jni::JNIUtilInterface * jniUtil, JNIEnv * env, jstring indexPathJ);
 
+        // Load an index from indexPathJ by mapping the file into memory. The flat, scalar quantizer and binary codes
+        // and the HNSW neighbors are read in place from the mapping, which the index keeps alive, instead of being
+        // copied. The file must be on a local filesystem and must not be modified while the index is loaded.
+        //
+        // Return a pointer to the loaded index
+        jlong LoadIndexWithMmap(knn_jni::JNIUtilInterface * jniUtil, JNIEnv * env, jstring indexPathJ);
+
         // Loads an index with a reader implemented IOReader
         //
         // Returns a pointer of the loaded index
@@ -71,11 +108,30 @@ namespace knn_jni {
         // Return a pointer to the loaded index
         jlong LoadBinaryIndex(knn_jni::JNIUtilInterface * jniUtil, JNIEnv * env, jstring indexPathJ);
 
+        // Same as LoadIndexWithMmap, for a binary index
+        jlong LoadBinaryIndexWithMmap(knn_jni::JNIUtilInterface * jniUtil, JNIEnv * env, jstring indexPathJ);
+
         // Loads a binary index with a reader implemented IOReader
         //
         // Returns a pointer of the loaded index
         jlong LoadBinaryIndexWithStream(faiss::IOReader* ioReader);
 
+        // Load the HNSW index of the largest segment of a merge with a reader implemented IOReader, and carry its
+        // graph over to the merged segment instead of rebuilding it. docMapJ maps every doc id of the segment to its
+        // doc id in the merged segment, or to -1 for a deleted doc. The labels are remapped, the vertices of deleted
+        // docs are dropped and their neighbors repaired, and memory is reserved for the numDocs vectors of the merged
+        // segment. The vectors of the other segments are then added with InsertToIndex, and the index is written with
+        // WriteIndex.
+        //
+        // Returns a pointer of the loaded index, or 0 when its graph cannot be carried over and the merged index has
+        // to be built from scratch
+        jlong LoadIndexForMerge(knn_jni::JNIUtilInterface * jniUtil, JNIEnv * env, faiss::IOReader* ioReader,
+                                jintArray docMapJ, jlong numDocs, jobject parametersJ);
+
+        // Same as LoadIndexForMerge, for a binary index
+        jlong LoadBinaryIndexForMerge(knn_jni::JNIUtilInterface * jniUtil, JNIEnv * env, faiss::IOReader* ioReader,
+                                      jintArray docMapJ, jlong numDocs, jobject parametersJ);
+
         // Check if a loaded index requires shared state
         bool IsSharedIndexStateRequired(jlong indexPointerJ);
 
@@ -111,20 +167,141 @@ namespace knn_jni {
                                            jfloatArray queryVectorJ, jint kJ, jobject methodParamsJ, jlongArray filterIdsJ,
                                            jint filterIdsTypeJ, jintArray parentIdsJ);
 
+        /**
+         * Same as QueryIndex_WithFilter, but the results are written into caller provided arrays instead of being
+         * returned as KNNQueryResult objects.
+         *
+         * @param resultIdsJ - output array for the doc ids, should hold k entries
+         * @param resultDistancesJ - output array for the distances, should hold k entries
+         *
+         * @return number of results found. When it is larger than the arrays, only the first array length results
+         *         are written
+         */
+        jint QueryIndex_WithFilterIntoArrays(knn_jni::JNIUtilInterface * jniUtil, JNIEnv * env, jlong indexPointerJ,
+                                             jfloatArray queryVectorJ, jint kJ, jobject methodParamsJ, jlongArray filterIdsJ,
+                                             jint filterIdsTypeJ, jintArray parentIdsJ, jintArray resultIdsJ, jfloatArray resultDistancesJ);
+
+        /**
+         * Same as QueryIndex_WithFilter, but the query time parameters come from a handle returned by
+         * knn_jni::commons::compileSearchParams instead of a Java map, so the map is not walked on every query.
+         *
+         * @param searchParamsPointerJ - handle to the compiled search parameters, 0 to use the index defaults
+         *
+         * @return array of KNNQueryResults
+         */
+        jobjectArray QueryIndex_WithSearchParams(knn_jni::JNIUtilInterface * jniUtil, JNIEnv * env, jlong indexPointerJ,
+                                                 jfloatArray queryVectorJ, jint kJ, jlong searchParamsPointerJ, jlongArray filterIdsJ,
+                                                 jint filterIdsTypeJ, jintArray parentIdsJ);
+
+        /**
+         * Same as QueryIndex_WithSearchParams, but the results are written into caller provided arrays instead of being
+         * returned as KNNQueryResult objects.
+         *
+         * @return number of results found, see QueryIndex_WithFilterIntoArrays
+         */
+        jint QueryIndex_WithSearchParamsIntoArrays(knn_jni::JNIUtilInterface * jniUtil, JNIEnv * env, jlong indexPointerJ,
+                                                   jfloatArray queryVectorJ, jint kJ, jlong searchParamsPointerJ, jlongArray filterIdsJ,
+                                                   jint filterIdsTypeJ, jintArray parentIdsJ, jintArray resultIdsJ,
+                                                   jfloatArray resultDistancesJ);
+
+        /**
+         * Execute a batch of queries against the index located in memory at indexPointerJ. The filter and parent
+         * grouping are built once and shared by every query, and all queries go through a single faiss search call.
+         *
+         * @param queryVectorsJ - numQueries query vectors packed back to back, numQueries = length / dimension
+         * @param kJ - number of results per query
+         * @param methodParamsJ - the method parameters
+         * @param filterIdsJ - the filter ids, shared by all queries
+         * @param filterIdsTypeJ - the filter ids type
+         * @param parentIdsJ - the parent ids
+         * @param resultIdsJ - output array of at least numQueries * k ids. Results of query i are at [i * k, (i + 1) * k),
+         *                     slots without a result are set to -1
+         * @param resultDistancesJ - output array of at least numQueries * k distances, laid out like resultIdsJ
+         */
+        void QueryIndexBatch(knn_jni::JNIUtilInterface * jniUtil, JNIEnv * env, jlong indexPointerJ,
+                             jfloatArray queryVectorsJ, jint kJ, jobject methodParamsJ, jlongArray filterIdsJ,
+                             jint filterIdsTypeJ, jintArray parentIdsJ, jintArray resultIdsJ, jfloatArray resultDistancesJ);
+
         // Execute a query against the binary index located in memory at indexPointerJ along with Filters
         //
         // Return an array of KNNQueryResults
         jobjectArray QueryBinaryIndex_WithFilter(knn_jni::JNIUtilInterface * jniUtil, JNIEnv * env, jlong indexPointerJ,
                                                  jbyteArray queryVectorJ, jint kJ, jobject methodParamsJ, jlongArray filterIdsJ, jint filterIdsTypeJ, jintArray parentIdsJ);
 
+        // Same as QueryBinaryIndex_WithFilter, but the results are written into caller provided arrays instead of being
+        // returned as KNNQueryResult objects.
+        //
+        // Return the number of results found. When it is larger than the arrays, only the first array length results
+        // are written
+        jint QueryBinaryIndex_WithFilterIntoArrays(knn_jni::JNIUtilInterface * jniUtil, JNIEnv * env, jlong indexPointerJ,
+                                                   jbyteArray queryVectorJ, jint kJ, jobject methodParamsJ, jlongArray filterIdsJ,
+                                                   jint filterIdsTypeJ, jintArray parentIdsJ, jintArray resultIdsJ,
+                                                   jfloatArray resultDistancesJ);
+
+        // Same as QueryBinaryIndex_WithFilter, but the query time parameters come from a handle returned by
+        // knn_jni::commons::compileSearchParams instead of a Java map
+        //
+        // Return an array of KNNQueryResults
+        jobjectArray QueryBinaryIndex_WithSearchParams(knn_jni::JNIUtilInterface * jniUtil, JNIEnv * env, jlong indexPointerJ,
+                                                       jbyteArray queryVectorJ, jint kJ, jlong searchParamsPointerJ, jlongArray filterIdsJ,
+                                                       jint filterIdsTypeJ, jintArray parentIdsJ);
+
+        // Brute force a query against the docs of the index located in memory at indexPointerJ that are selected by
+        // the filter, or against every doc when filterIdsJ is null. The distances are computed on the vectors stored
+        // in the index, so the index must be HNSW or flat. Byte indexes are searched with a float query like any
+        // other float index.
+        //
+        // Return an array of KNNQueryResults
+        jobjectArray ExactSearch(knn_jni::JNIUtilInterface * jniUtil, JNIEnv * env, jlong indexPointerJ,
+                                 jfloatArray queryVectorJ, jint kJ, jlongArray filterIdsJ, jint filterIdsTypeJ);
+
+        // Same as ExactSearch, but against the binary HNSW index located in memory at indexPointerJ
+        //
+        // Return an array of KNNQueryResults
+        jobjectArray ExactSearchBinary(knn_jni::JNIUtilInterface * jniUtil, JNIEnv * env, jlong indexPointerJ,
+                                       jbyteArray queryVectorJ, jint kJ, jlongArray filterIdsJ, jint filterIdsTypeJ);
+
+        // Queue the same search as QueryIndex_WithFilter on the native search thread pool and return right away. The
+        // query and filter are copied, so the Java arrays can be reused once this returns. The index must not be freed
+        // until the task is, with GetSearchTaskResults or FreeSearchTask.
+        //
+        // Return a handle to the search task
+        jlong SubmitQueryIndex(knn_jni::JNIUtilInterface * jniUtil, JNIEnv * env, jlong indexPointerJ,
+                               jfloatArray queryVectorJ, jint kJ, jobject methodParamsJ, jlongArray filterIdsJ,
+                               jint filterIdsTypeJ, jintArray parentIdsJ);
+
+        // Search several loaded indexes, one per segment, for the k nearest neighbors of the query over all of them.
+        // Segment i is searched with the filter filterIdsJ[i] of type filterIdsTypesJ[i], and its doc ids are offset by
+        // docBasesJ[i]. The k-th best distance found so far bounds the search of every later segment, so searching the
+        // segments most likely to hold the best hits first saves the most work. filterIdsJ may be null, as may any of
+        // its elements. The indexes must share their dimension and metric. Nested fields are not supported.
+        //
+        // Return an array of KNNQueryResults holding doc base offset ids
+        jobjectArray QueryIndexes(knn_jni::JNIUtilInterface * jniUtil, JNIEnv * env, jlongArray indexPointersJ,
+                                  jintArray docBasesJ, jfloatArray queryVectorJ, jint kJ, jobject methodParamsJ,
+                                  jobjectArray filterIdsJ, jintArray filterIdsTypesJ);
+
+        // Return whether the search task at searchTaskPointerJ has finished, without waiting for it
+        jboolean IsSearchTaskDone(jlong searchTaskPointerJ);
+
+        // Wait for the search task at searchTaskPointerJ to finish and free it. Rethrow the error of a failed search.
+        //
+        // Return an array of KNNQueryResults
+        jobjectArray GetSearchTaskResults(knn_jni::JNIUtilInterface * jniUtil, JNIEnv * env, jlong searchTaskPointerJ);
+
+        // Wait for the search task at searchTaskPointerJ to finish and free it, dropping its results
+        void FreeSearchTask(jlong searchTaskPointerJ);
+
         // Free the index located in memory at indexPointerJ
         void Free(jlong indexPointer, jboolean isBinaryIndexJ);
 
         // Free shared index state in memory at shareIndexStatePointerJ
         void FreeSharedIndexState(jlong shareIndexStatePointerJ);
 
-        // Perform initilization operations for the library
-        void InitLibrary();
+        // Perform initilization operations for the library. Starts the native search thread pool with
+        // searchThreadPoolSizeJ threads, or one less than the number of cores when it is 0 or less, and pins its
+        // threads to cores when pinSearchThreadsJ is true
+        void InitLibrary(jint searchThreadPoolSizeJ, jboolean pinSearchThreadsJ);
 
         // Create an empty index defined by the values in the Java map, parametersJ. Train the index with
         // the vector of floats located at trainVectorsPointerJ.
@@ -147,6 +324,50 @@ namespace knn_jni {
         jbyteArray TrainByteIndex(knn_jni::JNIUtilInterface * jniUtil, JNIEnv * env, jobject parametersJ, jint dimension,
                                   jlong trainVectorsPointerJ);
 
+        // Create and train an index like TrainIndex, and serialize it straight into the IndexOutputWithBuffer output
+        // instead of returning it, so the trained model is never copied into a Java byte array
+        void TrainIndexWithStream(knn_jni::JNIUtilInterface * jniUtil, JNIEnv * env, jobject parametersJ,
+                                  jint dimensionJ, jlong trainVectorsPointerJ, jobject output);
+
+        // Create and train a binary index like TrainBinaryIndex, and serialize it into output
+        void TrainBinaryIndexWithStream(knn_jni::JNIUtilInterface * jniUtil, JNIEnv * env, jobject parametersJ,
+                                        jint dimensionJ, jlong trainVectorsPointerJ, jobject output);
+
+        // Create and train a byte index like TrainByteIndex, and serialize it into output
+        void TrainByteIndexWithStream(knn_jni::JNIUtilInterface * jniUtil, JNIEnv * env, jobject parametersJ,
+                                      jint dimensionJ, jlong trainVectorsPointerJ, jobject output);
+
+        // Element type of the vectors a training session is fed
+        enum class TrainingVectorType {
+            FLOAT,
+            BYTE,
+            BINARY
+        };
+
+        // Create the untrained index defined by the values in the Java map, parametersJ, for a training session that
+        // is fed vectors of the given type in batches. The session keeps a uniform sample of the vectors it is fed,
+        // sized to what training the index makes use of, so its memory is bounded whatever the number of vectors.
+        //
+        // Return a handle to the training session
+        jlong InitTrainingSession(knn_jni::JNIUtilInterface * jniUtil, JNIEnv * env, jobject parametersJ,
+                                  jint dimensionJ, TrainingVectorType vectorType);
+
+        // Sample the vectors located at vectorsPointerJ, stored like the training vectors of the Train functions, into
+        // the training session. The vectors are copied, so the caller may free or reuse them once this returns.
+        void AddTrainingVectors(jlong sessionPointerJ, jlong vectorsPointerJ);
+
+        // Train the index of the training session on its sample.
+        //
+        // Return the serialized representation
+        jbyteArray TrainFromSession(knn_jni::JNIUtilInterface * jniUtil, JNIEnv * env, jlong sessionPointerJ);
+
+        // Train the index of the training session on its sample, and serialize it into output
+        void TrainFromSessionWithStream(knn_jni::JNIUtilInterface * jniUtil, JNIEnv * env, jlong sessionPointerJ,
+                                        jobject output);
+
+        // Free the training session at sessionPointerJ along with its sample
+        void FreeTrainingSession(jlong sessionPointerJ);
+
         /*
          * Perform a range search with filter against the index located in memory at indexPointerJ.
          *
@@ -154,7 +375,8 @@ namespace knn_jni {
          * @param queryVectorJ - the query vector
          * @param radiusJ - the radius for the range search
          * @param methodParamsJ - the method parameters
-         * @param maxResultsWindowJ - the maximum number of results to return
+         * @param maxResultsWindowJ - the maximum number of results to return. Only the closest hits are kept, so
+         *                            memory stays bounded however many docs fall within the radius
          * @param filterIdsJ - the filter ids
          * @param filterIdsTypeJ - the filter ids type
          * @param parentIdsJ - the parent ids
@@ -164,6 +386,37 @@ namespace knn_jni {
         jobjectArray RangeSearchWithFilter(knn_jni::JNIUtilInterface *jniUtil, JNIEnv *env, jlong indexPointerJ, jfloatArray queryVectorJ,
                                            jfloat radiusJ, jobject methodParamsJ, jint maxResultWindowJ, jlongArray filterIdsJ, jint filterIdsTypeJ, jintArray parentIdsJ);
 
+        /*
+         * Same as RangeSearchWithFilter, but the results are written into caller provided arrays instead of being
+         * returned as KNNQueryResult objects. At most min(maxResultWindowJ, array length) results are written.
+         *
+         * @param resultIdsJ - output array for the doc ids
+         * @param resultDistancesJ - output array for the distances
+         *
+         * @return number of results found, at most maxResultWindowJ. When it is larger than the arrays, only the first
+         *         array length results are written
+         */
+        jint RangeSearchWithFilterIntoArrays(knn_jni::JNIUtilInterface *jniUtil, JNIEnv *env, jlong indexPointerJ, jfloatArray queryVectorJ,
+                                             jfloat radiusJ, jobject methodParamsJ, jint maxResultWindowJ, jlongArray filterIdsJ,
+                                             jint filterIdsTypeJ, jintArray parentIdsJ, jintArray resultIdsJ, jfloatArray resultDistancesJ);
+
+        /*
+         * Count the docs within the radius of the query in the index located in memory at indexPointerJ, without
+         * collecting them. For HNSW indexes only the docs visited by the graph search are counted, like for
+         * RangeSearchWithFilter.
+         *
+         * @param indexPointerJ - pointer to the index
+         * @param queryVectorJ - the query vector
+         * @param radiusJ - the radius for the range search
+         * @param methodParamsJ - the method parameters
+         * @param filterIdsJ - the filter ids, or null
+         * @param filterIdsTypeJ - the filter ids type
+         *
+         * @return number of docs within the radius
+         */
+        jint RangeSearchCount(knn_jni::JNIUtilInterface *jniUtil, JNIEnv *env, jlong indexPointerJ, jfloatArray queryVectorJ,
+                              jfloat radiusJ, jobject methodParamsJ, jlongArray filterIdsJ, jint filterIdsTypeJ);
+
         /*
          * Perform a range search against the index located in memory at indexPointerJ.
          *
@@ -179,6 +432,49 @@ namespace knn_jni {
         jobjectArray RangeSearch(knn_jni::JNIUtilInterface *jniUtil, JNIEnv *env, jlong indexPointerJ, jfloatArray queryVectorJ,
                                  jfloat radiusJ, jobject methodParamsJ, jint maxResultWindowJ, jintArray parentIdsJ);
 
+        /*
+         * Perform a range search with filter against the binary index located in memory at indexPointerJ. Hits are
+         * the docs within radiusJ hamming distance of the query, and at most maxResultWindowJ of the closest are
+         * returned. For nested fields only the closest child of every parent is kept.
+         *
+         * @param indexPointerJ - pointer to the binary index
+         * @param queryVectorJ - the query code
+         * @param radiusJ - the hamming radius for the range search
+         * @param methodParamsJ - the method parameters
+         * @param maxResultsWindowJ - the maximum number of results to return
+         * @param filterIdsJ - the filter ids, or null
+         * @param filterIdsTypeJ - the filter ids type
+         * @param parentIdsJ - the parent ids, or null
+         *
+         * @return an array of KNNQueryResults
+         */
+        jobjectArray RangeSearchBinaryWithFilter(knn_jni::JNIUtilInterface *jniUtil, JNIEnv *env, jlong indexPointerJ,
+                                                 jbyteArray queryVectorJ, jfloat radiusJ, jobject methodParamsJ,
+                                                 jint maxResultWindowJ, jlongArray filterIdsJ, jint filterIdsTypeJ,
+                                                 jintArray parentIdsJ);
+
+        /*
+         * Same as RangeSearchBinaryWithFilter, but the results are written into caller provided arrays instead of
+         * being returned as KNNQueryResult objects. At most min(maxResultWindowJ, array length) results are written.
+         *
+         * @param resultIdsJ - output array for the doc ids
+         * @param resultDistancesJ - output array for the distances
+         *
+         * @return number of results found, at most maxResultWindowJ. When it is larger than the arrays, only the first
+         *         array length results are written
+         */
+        jint RangeSearchBinaryWithFilterIntoArrays(knn_jni::JNIUtilInterface *jniUtil, JNIEnv *env, jlong indexPointerJ,
+                                                   jbyteArray queryVectorJ, jfloat radiusJ, jobject methodParamsJ,
+                                                   jint maxResultWindowJ, jlongArray filterIdsJ, jint filterIdsTypeJ,
+                                                   jintArray parentIdsJ, jintArray resultIdsJ, jfloatArray resultDistancesJ);
+
+        /*
+         * Same as RangeSearchBinaryWithFilter, without a filter
+         */
+        jobjectArray RangeSearchBinary(knn_jni::JNIUtilInterface *jniUtil, JNIEnv *env, jlong indexPointerJ,
+                                       jbyteArray queryVectorJ, jfloat radiusJ, jobject methodParamsJ,
+                                       jint maxResultWindowJ, jintArray parentIdsJ);
+
         /**
          * Translates a space type string to a Faiss metric type
          *
@@ -134,6 +134,18 @@ namespace knn_jni {
 
         virtual void SetByteArrayRegion(JNIEnv *env, jbyteArray array, jsize start, jsize len, const jbyte * buf) = 0;
 
+        virtual void SetIntArrayRegion(JNIEnv *env, jintArray array, jsize start, jsize len, const jint * buf) = 0;
+
+        virtual void SetFloatArrayRegion(JNIEnv *env, jfloatArray array, jsize start, jsize len, const jfloat * buf) = 0;
+
+        virtual void GetIntArrayRegion(JNIEnv *env, jintArray array, jsize start, jsize len, jint * buf) = 0;
+
+        virtual void GetByteArrayRegion(JNIEnv *env, jbyteArray array, jsize start, jsize len, jbyte * buf) = 0;
+
+        virtual void GetFloatArrayRegion(JNIEnv *env, jfloatArray array, jsize start, jsize len, jfloat * buf) = 0;
+
+        virtual void GetLongArrayRegion(JNIEnv *env, jlongArray array, jsize start, jsize len, jlong * buf) = 0;
+
         virtual jobject GetObjectField(JNIEnv * env, jobject obj, jfieldID fieldID) = 0;
 
         virtual jclass FindClassFromJNIEnv(JNIEnv * env, const char *name) = 0;
@@ -203,6 +215,12 @@ namespace knn_jni {
         void ReleaseLongArrayElements(JNIEnv *env, jlongArray array, jlong *elems, jint mode) final;
         void SetObjectArrayElement(JNIEnv *env, jobjectArray array, jsize index, jobject val) final;
         void SetByteArrayRegion(JNIEnv *env, jbyteArray array, jsize start, jsize len, const jbyte * buf) final;
+        void SetIntArrayRegion(JNIEnv *env, jintArray array, jsize start, jsize len, const jint * buf) final;
+        void SetFloatArrayRegion(JNIEnv *env, jfloatArray array, jsize start, jsize len, const jfloat * buf) final;
+        void GetIntArrayRegion(JNIEnv *env, jintArray array, jsize start, jsize len, jint * buf) final;
+        void GetByteArrayRegion(JNIEnv *env, jbyteArray array, jsize start, jsize len, jbyte * buf) final;
+        void GetFloatArrayRegion(JNIEnv *env, jfloatArray array, jsize start, jsize len, jfloat * buf) final;
+        void GetLongArrayRegion(JNIEnv *env, jlongArray array, jsize start, jsize len, jlong * buf) final;
         void Convert2dJavaObjectArrayAndStoreToFloatVector(JNIEnv *env, jobjectArray array2dJ, int dim, std::vector<float> *vect) final;
         void Convert2dJavaObjectArrayAndStoreToBinaryVector(JNIEnv *env, jobjectArray array2dJ, int dim, std::vector<uint8_t> *vect) final;
         void Convert2dJavaObjectArrayAndStoreToByteVector(JNIEnv *env, jobjectArray array2dJ, int dim, std::vector<int8_t> *vect) final;
@@ -257,6 +275,7 @@ namespace knn_jni {
     extern const std::string PARAMETERS;
     extern const std::string TRAINING_DATASET_SIZE_LIMIT;
     extern const std::string INDEX_THREAD_QUANTITY;
+    extern const std::string MODEL_ID;
 
     extern const std::string L2;
     extern const std::string L1;
@@ -273,6 +292,7 @@ namespace knn_jni {
     extern const std::string EF_CONSTRUCTION;
     extern const std::string EF_CONSTRUCTION_NMSLIB;
     extern const std::string EF_SEARCH;
+    extern const std::string PARALLELISM;
 
     extern const std::string SPACE_TYPE_FAISS_INDEX_JAVA_KNN_CONSTANTS;
     extern const std::string QUANTIZATION_LEVEL_FAISS_INDEX_LOAD_PARAMETER_JAVA_KNN_CONSTANTS;
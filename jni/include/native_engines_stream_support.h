@@ -12,14 +12,17 @@
 #ifndef OPENSEARCH_KNN_JNI_STREAM_SUPPORT_H
 #define OPENSEARCH_KNN_JNI_STREAM_SUPPORT_H
 
+#include "crc32_util.h"
 #include "jni_util.h"
 #include "parameter_utils.h"
 #include "memory_util.h"
 
 #include <jni.h>
+#include <algorithm>
 #include <stdexcept>
 #include <iostream>
 #include <cstring>
+#include <vector>
 
 namespace knn_jni {
 namespace stream {
@@ -128,6 +131,15 @@ class NativeEngineIndexInputMediator {
  * This class delegates the provided index output to do IO processing.
  * In most cases, it is expected that IndexOutputWithBuffer was passed down to this,
  * which eventually have Lucene's IndexOutput to write bytes.
+ *
+ * Faiss writes an index with many small writes, such as a 4 bytes header or a single integer. Entering a critical
+ * section for each of them can stall GC, so the bytes are staged in a native buffer as large as the Java buffer, and
+ * copied to Java once it is full. Blocks of large payloads, such as codes, bypass the staging buffer and are copied to
+ * Java at once.
+ *
+ * The CRC32 Lucene checksums the file with is computed natively over the bytes handed over to Java, and passed along
+ * with them, so the Java side can check what reached IndexOutput without reading the file back. It resumes from the
+ * checksum of the bytes written through the same IndexOutputWithBuffer before.
  */
 class NativeEngineIndexOutputMediator {
  public:
@@ -142,37 +154,28 @@ class NativeEngineIndexOutputMediator {
                                                                  getBufferFieldId(_jni_interface, _env)))),
         writeBytesMethod(getWriteBytesMethod(_jni_interface, _env)),
         bufferLength(jni_interface->GetJavaBytesArrayLength(env, bufferArray)),
-        nextWriteIndex() {
+        stagingBuffer(bufferLength),
+        nextWriteIndex(),
+        checksum(getNativeChecksum(_jni_interface, _env, _indexOutput)) {
   }
 
   void writeBytes(const uint8_t * RESTRICT source, size_t nbytes) {
     auto left = nbytes;
     while (left > 0) {
-      const auto writeBytes = std::min(bufferLength - nextWriteIndex, left);
-
-      // === Critical Section Start ===
-
-      // Get primitive array pointer, no copy is happening in OpenJDK.
-      jbyte * RESTRICT primitiveArray =
-          (jbyte *) jni_interface->GetPrimitiveArrayCritical(env, bufferArray, nullptr);
-
-      // Copy the given bytes to Java byte[] address.
-      std::memcpy(primitiveArray + nextWriteIndex, source, writeBytes);
-
-      // Release the acquired primitive array pointer.
-      // 0 tells JVM to copy back the content, and to free the pointer. It will be ignored if we acquired an internal
-      // primitive array pointer instead of a copied version.
-      // From JNI docs:
-      // Mode 0 : copy back the content and free the elems buffer
-      // The mode argument provides information on how the array buffer should be released. mode has no effect if elems
-      // is not a copy of the elements in array.
-      jni_interface->ReleasePrimitiveArrayCritical(env, bufferArray, primitiveArray, 0);
-
-      // === Critical Section End ===
+      if (nextWriteIndex == 0 && left >= bufferLength) {
+        // Nothing is staged, so a full block goes straight to Java.
+        copyToJavaBuffer(source, bufferLength);
+        callWriteBytesInIndexOutput(bufferLength);
+        source += bufferLength;
+        left -= bufferLength;
+        continue;
+      }
 
+      const auto writeBytes = std::min(bufferLength - nextWriteIndex, left);
+      std::memcpy(stagingBuffer.data() + nextWriteIndex, source, writeBytes);
       nextWriteIndex += writeBytes;
       if (nextWriteIndex >= bufferLength) {
-        callWriteBytesInIndexOutput();
+        flushStagingBuffer();
       }
 
       source += writeBytes;
@@ -182,7 +185,7 @@ class NativeEngineIndexOutputMediator {
 
   void flush() {
     if (nextWriteIndex > 0) {
-      callWriteBytesInIndexOutput();
+      flushStagingBuffer();
     }
   }
 
@@ -195,24 +198,67 @@ class NativeEngineIndexOutputMediator {
 
   static jmethodID getWriteBytesMethod(JNIUtilInterface *jni_interface, JNIEnv *env) {
     static jmethodID WRITE_METHOD_ID =
-        jni_interface->GetMethodID(env, getIndexOutputWithBufferClass(jni_interface, env), "writeBytes", "(I)V");
+        jni_interface->GetMethodID(env, getIndexOutputWithBufferClass(jni_interface, env), "writeBytes", "(IJ)V");
     return WRITE_METHOD_ID;
   }
 
+  // `nativeChecksum` is a plain getter, which cannot throw.
+  static uint32_t getNativeChecksum(JNIUtilInterface *jni_interface, JNIEnv *env, jobject indexOutput) {
+    static jmethodID NATIVE_CHECKSUM_METHOD_ID =
+        jni_interface->GetMethodID(env, getIndexOutputWithBufferClass(jni_interface, env), "nativeChecksum", "()J");
+    const auto nativeChecksum = jni_interface->CallNonvirtualLongMethodA(env,
+                                                                         indexOutput,
+                                                                         getIndexOutputWithBufferClass(jni_interface, env),
+                                                                         NATIVE_CHECKSUM_METHOD_ID,
+                                                                         nullptr);
+    return (uint32_t) nativeChecksum;
+  }
+
   static jfieldID getBufferFieldId(JNIUtilInterface *jni_interface, JNIEnv *env) {
     static jfieldID BUFFER_FIELD_ID =
         jni_interface->GetFieldID(env, getIndexOutputWithBufferClass(jni_interface, env), "buffer", "[B");
     return BUFFER_FIELD_ID;
   }
 
-  void callWriteBytesInIndexOutput() {
+  void copyToJavaBuffer(const uint8_t * RESTRICT source, size_t nbytes) {
+    checksum.update(source, nbytes);
+
+    // === Critical Section Start ===
+
+    // Get primitive array pointer, no copy is happening in OpenJDK.
+    jbyte * RESTRICT primitiveArray =
+        (jbyte *) jni_interface->GetPrimitiveArrayCritical(env, bufferArray, nullptr);
+
+    // Copy the given bytes to Java byte[] address.
+    std::memcpy(primitiveArray, source, nbytes);
+
+    // Release the acquired primitive array pointer.
+    // 0 tells JVM to copy back the content, and to free the pointer. It will be ignored if we acquired an internal
+    // primitive array pointer instead of a copied version.
+    // From JNI docs:
+    // Mode 0 : copy back the content and free the elems buffer
+    // The mode argument provides information on how the array buffer should be released. mode has no effect if elems
+    // is not a copy of the elements in array.
+    jni_interface->ReleasePrimitiveArrayCritical(env, bufferArray, primitiveArray, 0);
+
+    // === Critical Section End ===
+  }
+
+  void flushStagingBuffer() {
+    copyToJavaBuffer(stagingBuffer.data(), nextWriteIndex);
+    callWriteBytesInIndexOutput(nextWriteIndex);
+    nextWriteIndex = 0;
+  }
+
+  void callWriteBytesInIndexOutput(size_t nbytes) {
     auto jclazz = getIndexOutputWithBufferClass(jni_interface, env);
-    // Initializing the first integer parameter of `writeBytes`.
-    // `i` represents an integer parameter.
-    jvalue args {.i = nextWriteIndex};
-    jni_interface->CallNonvirtualVoidMethodA(env, indexOutput, jclazz, writeBytesMethod, &args);
+    // Initializing the parameters of `writeBytes`, the number of bytes and the checksum of every byte so far.
+    // `i` represents an integer parameter, and `j` a long one.
+    jvalue args[2];
+    args[0].i = (jint) nbytes;
+    args[1].j = (jlong) checksum.getValue();
+    jni_interface->CallNonvirtualVoidMethodA(env, indexOutput, jclazz, writeBytesMethod, args);
     jni_interface->HasExceptionInStack(env, "Writing bytes via IndexOutput has failed.");
-    nextWriteIndex = 0;
   }
 
   JNIUtilInterface *jni_interface;
@@ -223,7 +269,11 @@ class NativeEngineIndexOutputMediator {
   jbyteArray bufferArray;
   jmethodID writeBytesMethod;
   size_t bufferLength;
-  int32_t nextWriteIndex;
+  // Bytes not copied to Java yet, the first `nextWriteIndex` of them are filled.
+  std::vector<uint8_t> stagingBuffer;
+  size_t nextWriteIndex;
+  // CRC32 of the bytes copied to Java.
+  knn_jni::util::Crc32 checksum;
 };  // NativeEngineIndexOutputMediator
 
 
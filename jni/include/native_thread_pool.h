@@ -0,0 +1,104 @@
+// SPDX-License-Identifier: Apache-2.0
+//
+// The OpenSearch Contributors require contributions made to
+// this file be licensed under the Apache-2.0 license or a
+// compatible open source license.
+//
+// Modifications Copyright OpenSearch Contributors. See
+// GitHub history for details.
+
+/**
+ * Bounded pool of native threads used to run searches off the Java search threads and to split the work of a single
+ * query. It is free of JNI so it can be shared by the engine wrappers and tested on its own.
+ */
+
+#ifndef OPENSEARCH_KNN_NATIVE_THREAD_POOL_H
+#define OPENSEARCH_KNN_NATIVE_THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace knn_jni {
+    class NativeThreadPool {
+    public:
+        /**
+         * Starts a pool with a fixed number of threads
+         *
+         * @param numThreads number of pool threads, may be 0 in which case every job runs on the calling thread
+         * @param pinThreads whether to pin pool thread i to core i, modulo the number of cores. Only honored on Linux
+         */
+        explicit NativeThreadPool(int numThreads, bool pinThreads = false);
+
+        ~NativeThreadPool();
+
+        NativeThreadPool(const NativeThreadPool &) = delete;
+        NativeThreadPool &operator=(const NativeThreadPool &) = delete;
+
+        /**
+         * Sets up the process wide pool. Only the first call made before the pool is used has an effect, later ones
+         * are ignored so running searches never lose their threads.
+         *
+         * @param numThreads number of pool threads, 0 or less for one thread less than the machine has cores
+         * @param pinThreads whether to pin the pool threads to cores
+         */
+        static void initialize(int numThreads, bool pinThreads);
+
+        /**
+         * Process wide pool shared by all queries. Unless initialize was called first, it holds one thread less than
+         * the machine has cores, as the threads waiting on it can take part in the work.
+         */
+        static NativeThreadPool &getInstance();
+
+        /**
+         * Queues a job to run on a pool thread. Jobs are spread over the threads' own queues, and a thread whose queue
+         * is empty steals from the others, so a thread stuck on a long job does not hold back the jobs queued behind
+         * it. With no pool threads the job runs before submit returns. Jobs must not throw.
+         *
+         * @param job function to run
+         */
+        void submit(std::function<void()> job);
+
+        /**
+         * Runs task(0) ... task(numTasks - 1) and returns once they have all run. The calling thread runs tasks too,
+         * so at most parallelism - 1 pool threads are asked to help and a query never waits on a busy pool to make
+         * progress. Tasks are handed out one at a time, so uneven tasks balance out. The first exception thrown by a
+         * task is rethrown on the calling thread once every task has finished.
+         *
+         * @param numTasks number of tasks
+         * @param parallelism maximum number of threads running tasks at the same time, including the calling thread
+         * @param task function called with the index of each task
+         */
+        void parallelFor(int numTasks, int parallelism, const std::function<void(int)> &task);
+
+        // Number of pool threads
+        int size() const;
+
+    private:
+        struct WorkerQueue {
+            std::mutex mutex;
+            std::deque<std::function<void()>> jobs;
+        };
+
+        void workerLoop(int worker, bool pinThread);
+
+        // Pops the next job of a worker's own queue, or steals the oldest job of another one
+        std::function<void()> takeJob(int worker);
+
+        std::vector<std::unique_ptr<WorkerQueue>> queues;
+        std::vector<std::thread> workers;
+        std::atomic<size_t> nextQueue;
+        // Queued jobs not yet claimed by a worker. Workers sleep while there are none
+        std::mutex pendingMutex;
+        std::condition_variable workAvailable;
+        size_t pendingJobs;
+        bool stopping;
+    };
+}
+
+#endif //OPENSEARCH_KNN_NATIVE_THREAD_POOL_H
@@ -47,6 +47,22 @@ namespace knn_jni {
         jobjectArray QueryIndex(knn_jni::JNIUtilInterface * jniUtil, JNIEnv * env, jlong indexPointerJ,
                                 jfloatArray queryVectorJ, jint kJ, jobject methodParamsJ);
 
+        // Execute a query against the index located in memory at indexPointerJ and write the ids and distances of
+        // the results into resultIdsJ and resultDistancesJ.
+        //
+        // Return the number of results found. When it is larger than the arrays, only the first array length results
+        // are written
+        jint QueryIndexIntoArrays(knn_jni::JNIUtilInterface * jniUtil, JNIEnv * env, jlong indexPointerJ,
+                                  jfloatArray queryVectorJ, jint kJ, jobject methodParamsJ, jintArray resultIdsJ,
+                                  jfloatArray resultDistancesJ);
+
+        // Same as QueryIndex, but the query time parameters come from a handle returned by
+        // knn_jni::commons::compileSearchParams instead of a Java map.
+        //
+        // Return an array of KNNQueryResults
+        jobjectArray QueryIndexWithSearchParams(knn_jni::JNIUtilInterface * jniUtil, JNIEnv * env, jlong indexPointerJ,
+                                                jfloatArray queryVectorJ, jint kJ, jlong searchParamsPointerJ);
+
         // Free the index located in memory at indexPointerJ
         void Free(jlong indexPointer);
 
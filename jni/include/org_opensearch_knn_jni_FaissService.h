@@ -44,6 +44,33 @@ JNIEXPORT jlong JNICALL Java_org_opensearch_knn_jni_FaissService_initByteIndex(J
                                                                                jlong numDocs, jint dimJ,
                                                                                jobject parametersJ);
 
+/*
+ * Class:     org_opensearch_knn_jni_FaissService
+ * Method:    estimateIndexMemory
+ * Signature: (JILjava/util/Map;)J
+ */
+JNIEXPORT jlong JNICALL Java_org_opensearch_knn_jni_FaissService_estimateIndexMemory(JNIEnv * env, jclass cls,
+                                                                                     jlong numDocs, jint dimJ,
+                                                                                     jobject parametersJ);
+
+/*
+ * Class:     org_opensearch_knn_jni_FaissService
+ * Method:    estimateBinaryIndexMemory
+ * Signature: (JILjava/util/Map;)J
+ */
+JNIEXPORT jlong JNICALL Java_org_opensearch_knn_jni_FaissService_estimateBinaryIndexMemory(JNIEnv * env, jclass cls,
+                                                                                           jlong numDocs, jint dimJ,
+                                                                                           jobject parametersJ);
+
+/*
+ * Class:     org_opensearch_knn_jni_FaissService
+ * Method:    estimateByteIndexMemory
+ * Signature: (JILjava/util/Map;)J
+ */
+JNIEXPORT jlong JNICALL Java_org_opensearch_knn_jni_FaissService_estimateByteIndexMemory(JNIEnv * env, jclass cls,
+                                                                                         jlong numDocs, jint dimJ,
+                                                                                         jobject parametersJ);
+
 /*
  * Class:     org_opensearch_knn_jni_FaissService
  * Method:    insertToIndex
@@ -70,6 +97,54 @@ JNIEXPORT void JNICALL Java_org_opensearch_knn_jni_FaissService_insertToByteInde
                                                                                   jlong vectorsAddressJ, jint dimJ,
                                                                                   jlong indexAddress, jint threadCount);
 
+/*
+ * Class:     org_opensearch_knn_jni_FaissService
+ * Method:    startInsertWorker
+ * Signature: (JII)J
+ */
+JNIEXPORT jlong JNICALL Java_org_opensearch_knn_jni_FaissService_startInsertWorker
+  (JNIEnv *, jclass, jlong, jint, jint);
+
+/*
+ * Class:     org_opensearch_knn_jni_FaissService
+ * Method:    startBinaryInsertWorker
+ * Signature: (JII)J
+ */
+JNIEXPORT jlong JNICALL Java_org_opensearch_knn_jni_FaissService_startBinaryInsertWorker
+  (JNIEnv *, jclass, jlong, jint, jint);
+
+/*
+ * Class:     org_opensearch_knn_jni_FaissService
+ * Method:    startByteInsertWorker
+ * Signature: (JII)J
+ */
+JNIEXPORT jlong JNICALL Java_org_opensearch_knn_jni_FaissService_startByteInsertWorker
+  (JNIEnv *, jclass, jlong, jint, jint);
+
+/*
+ * Class:     org_opensearch_knn_jni_FaissService
+ * Method:    submitInsertToIndex
+ * Signature: (J[IJ)J
+ */
+JNIEXPORT jlong JNICALL Java_org_opensearch_knn_jni_FaissService_submitInsertToIndex
+  (JNIEnv *, jclass, jlong, jintArray, jlong);
+
+/*
+ * Class:     org_opensearch_knn_jni_FaissService
+ * Method:    waitForInsertToIndex
+ * Signature: (JJ)V
+ */
+JNIEXPORT void JNICALL Java_org_opensearch_knn_jni_FaissService_waitForInsertToIndex
+  (JNIEnv *, jclass, jlong, jlong);
+
+/*
+ * Class:     org_opensearch_knn_jni_FaissService
+ * Method:    stopInsertWorker
+ * Signature: (J)V
+ */
+JNIEXPORT void JNICALL Java_org_opensearch_knn_jni_FaissService_stopInsertWorker
+  (JNIEnv *, jclass, jlong);
+
 /*
  * Class:     org_opensearch_knn_jni_FaissService
  * Method:    writeIndex
@@ -116,6 +191,14 @@ JNIEXPORT void JNICALL Java_org_opensearch_knn_jni_FaissService_createBinaryInde
 JNIEXPORT void JNICALL Java_org_opensearch_knn_jni_FaissService_createByteIndexFromTemplate
     (JNIEnv *, jclass, jintArray, jlong, jint, jobject, jbyteArray, jobject);
 
+/*
+ * Class:     org_opensearch_knn_jni_FaissService
+ * Method:    evictTemplateIndex
+ * Signature: (Ljava/lang/String;)V
+ */
+JNIEXPORT void JNICALL Java_org_opensearch_knn_jni_FaissService_evictTemplateIndex(JNIEnv * env, jclass cls,
+                                                                                   jstring modelIdJ);
+
 /*
  * Class:     org_opensearch_knn_jni_FaissService
  * Method:    loadIndex
@@ -124,6 +207,14 @@ JNIEXPORT void JNICALL Java_org_opensearch_knn_jni_FaissService_createByteIndexF
 JNIEXPORT jlong JNICALL Java_org_opensearch_knn_jni_FaissService_loadIndex
   (JNIEnv *, jclass, jstring);
 
+/*
+ * Class:     org_opensearch_knn_jni_FaissService
+ * Method:    loadIndexWithMmap
+ * Signature: (Ljava/lang/String;)J
+ */
+JNIEXPORT jlong JNICALL Java_org_opensearch_knn_jni_FaissService_loadIndexWithMmap
+  (JNIEnv *, jclass, jstring);
+
 /*
  * Class:     org_opensearch_knn_jni_FaissService
  * Method:    loadIndexWithStream
@@ -140,6 +231,14 @@ JNIEXPORT jlong JNICALL Java_org_opensearch_knn_jni_FaissService_loadIndexWithSt
 JNIEXPORT jlong JNICALL Java_org_opensearch_knn_jni_FaissService_loadBinaryIndex
   (JNIEnv *, jclass, jstring);
 
+/*
+ * Class:     org_opensearch_knn_jni_FaissService
+ * Method:    loadBinaryIndexWithMmap
+ * Signature: (Ljava/lang/String;)J
+ */
+JNIEXPORT jlong JNICALL Java_org_opensearch_knn_jni_FaissService_loadBinaryIndexWithMmap
+  (JNIEnv *, jclass, jstring);
+
 /*
  * Class:     org_opensearch_knn_jni_FaissService
  * Method:    loadBinaryIndexWithStream
@@ -148,6 +247,22 @@ JNIEXPORT jlong JNICALL Java_org_opensearch_knn_jni_FaissService_loadBinaryIndex
 JNIEXPORT jlong JNICALL Java_org_opensearch_knn_jni_FaissService_loadBinaryIndexWithStream
   (JNIEnv *, jclass, jobject);
 
+/*
+ * Class:     org_opensearch_knn_jni_FaissService
+ * Method:    loadIndexForMerge
+ * Signature: (Lorg/opensearch/knn/index/util/IndexInputWithBuffer;[IJLjava/util/Map;)J
+ */
+JNIEXPORT jlong JNICALL Java_org_opensearch_knn_jni_FaissService_loadIndexForMerge
+  (JNIEnv *, jclass, jobject, jintArray, jlong, jobject);
+
+/*
+ * Class:     org_opensearch_knn_jni_FaissService
+ * Method:    loadBinaryIndexForMerge
+ * Signature: (Lorg/opensearch/knn/index/util/IndexInputWithBuffer;[IJLjava/util/Map;)J
+ */
+JNIEXPORT jlong JNICALL Java_org_opensearch_knn_jni_FaissService_loadBinaryIndexForMerge
+  (JNIEnv *, jclass, jobject, jintArray, jlong, jobject);
+
 /*
  * Class:     org_opensearch_knn_jni_FaissService
  * Method:    loadIndexWithStreamADCParams
@@ -196,6 +311,38 @@ JNIEXPORT jobjectArray JNICALL Java_org_opensearch_knn_jni_FaissService_queryInd
 JNIEXPORT jobjectArray JNICALL Java_org_opensearch_knn_jni_FaissService_queryIndexWithFilter
   (JNIEnv *, jclass, jlong, jfloatArray, jint, jobject, jlongArray, jint, jintArray);
 
+/*
+ * Class:     org_opensearch_knn_jni_FaissService
+ * Method:    queryIndexIntoArrays
+ * Signature: (J[FILjava/util/Map;[JI[I[I[F)I
+ */
+JNIEXPORT jint JNICALL Java_org_opensearch_knn_jni_FaissService_queryIndexIntoArrays
+  (JNIEnv *, jclass, jlong, jfloatArray, jint, jobject, jlongArray, jint, jintArray, jintArray, jfloatArray);
+
+/*
+ * Class:     org_opensearch_knn_jni_FaissService
+ * Method:    queryIndexWithSearchParams
+ * Signature: (J[FIJ[JI[I)[Lorg/opensearch/knn/index/query/KNNQueryResult;
+ */
+JNIEXPORT jobjectArray JNICALL Java_org_opensearch_knn_jni_FaissService_queryIndexWithSearchParams
+  (JNIEnv *, jclass, jlong, jfloatArray, jint, jlong, jlongArray, jint, jintArray);
+
+/*
+ * Class:     org_opensearch_knn_jni_FaissService
+ * Method:    queryIndexWithSearchParamsIntoArrays
+ * Signature: (J[FIJ[JI[I[I[F)I
+ */
+JNIEXPORT jint JNICALL Java_org_opensearch_knn_jni_FaissService_queryIndexWithSearchParamsIntoArrays
+  (JNIEnv *, jclass, jlong, jfloatArray, jint, jlong, jlongArray, jint, jintArray, jintArray, jfloatArray);
+
+/*
+ * Class:     org_opensearch_knn_jni_FaissService
+ * Method:    queryIndexBatch
+ * Signature: (J[FILjava/util/Map;[JI[I[I[F)V
+ */
+JNIEXPORT void JNICALL Java_org_opensearch_knn_jni_FaissService_queryIndexBatch
+  (JNIEnv *, jclass, jlong, jfloatArray, jint, jobject, jlongArray, jint, jintArray, jintArray, jfloatArray);
+
 /*
  * Class:     org_opensearch_knn_jni_FaissService
  * Method:    queryBIndexWithFilter
@@ -204,6 +351,78 @@ JNIEXPORT jobjectArray JNICALL Java_org_opensearch_knn_jni_FaissService_queryInd
 JNIEXPORT jobjectArray JNICALL Java_org_opensearch_knn_jni_FaissService_queryBinaryIndexWithFilter
   (JNIEnv *, jclass, jlong, jbyteArray, jint, jobject, jlongArray, jint, jintArray);
 
+/*
+ * Class:     org_opensearch_knn_jni_FaissService
+ * Method:    queryBinaryIndexIntoArrays
+ * Signature: (J[BILjava/util/Map;[JI[I[I[F)I
+ */
+JNIEXPORT jint JNICALL Java_org_opensearch_knn_jni_FaissService_queryBinaryIndexIntoArrays
+  (JNIEnv *, jclass, jlong, jbyteArray, jint, jobject, jlongArray, jint, jintArray, jintArray, jfloatArray);
+
+/*
+ * Class:     org_opensearch_knn_jni_FaissService
+ * Method:    queryBinaryIndexWithSearchParams
+ * Signature: (J[BIJ[JI[I)[Lorg/opensearch/knn/index/query/KNNQueryResult;
+ */
+JNIEXPORT jobjectArray JNICALL Java_org_opensearch_knn_jni_FaissService_queryBinaryIndexWithSearchParams
+  (JNIEnv *, jclass, jlong, jbyteArray, jint, jlong, jlongArray, jint, jintArray);
+
+/*
+ * Class:     org_opensearch_knn_jni_FaissService
+ * Method:    exactSearch
+ * Signature: (J[FI[JI)[Lorg/opensearch/knn/index/query/KNNQueryResult;
+ */
+JNIEXPORT jobjectArray JNICALL Java_org_opensearch_knn_jni_FaissService_exactSearch
+  (JNIEnv *, jclass, jlong, jfloatArray, jint, jlongArray, jint);
+
+/*
+ * Class:     org_opensearch_knn_jni_FaissService
+ * Method:    exactSearchBinary
+ * Signature: (J[BI[JI)[Lorg/opensearch/knn/index/query/KNNQueryResult;
+ */
+JNIEXPORT jobjectArray JNICALL Java_org_opensearch_knn_jni_FaissService_exactSearchBinary
+  (JNIEnv *, jclass, jlong, jbyteArray, jint, jlongArray, jint);
+
+/*
+ * Class:     org_opensearch_knn_jni_FaissService
+ * Method:    submitQueryIndex
+ * Signature: (J[FILjava/util/Map;[JI[I)J
+ */
+JNIEXPORT jlong JNICALL Java_org_opensearch_knn_jni_FaissService_submitQueryIndex
+  (JNIEnv *, jclass, jlong, jfloatArray, jint, jobject, jlongArray, jint, jintArray);
+
+/*
+ * Class:     org_opensearch_knn_jni_FaissService
+ * Method:    queryIndexes
+ * Signature: ([J[I[FILjava/util/Map;[[J[I)[Lorg/opensearch/knn/index/query/KNNQueryResult;
+ */
+JNIEXPORT jobjectArray JNICALL Java_org_opensearch_knn_jni_FaissService_queryIndexes
+  (JNIEnv *, jclass, jlongArray, jintArray, jfloatArray, jint, jobject, jobjectArray, jintArray);
+
+/*
+ * Class:     org_opensearch_knn_jni_FaissService
+ * Method:    isSearchTaskDone
+ * Signature: (J)Z
+ */
+JNIEXPORT jboolean JNICALL Java_org_opensearch_knn_jni_FaissService_isSearchTaskDone
+  (JNIEnv *, jclass, jlong);
+
+/*
+ * Class:     org_opensearch_knn_jni_FaissService
+ * Method:    getSearchTaskResults
+ * Signature: (J)[Lorg/opensearch/knn/index/query/KNNQueryResult;
+ */
+JNIEXPORT jobjectArray JNICALL Java_org_opensearch_knn_jni_FaissService_getSearchTaskResults
+  (JNIEnv *, jclass, jlong);
+
+/*
+ * Class:     org_opensearch_knn_jni_FaissService
+ * Method:    freeSearchTask
+ * Signature: (J)V
+ */
+JNIEXPORT void JNICALL Java_org_opensearch_knn_jni_FaissService_freeSearchTask
+  (JNIEnv *, jclass, jlong);
+
 /*
  * Class:     org_opensearch_knn_jni_FaissService
  * Method:    free
@@ -223,10 +442,10 @@ JNIEXPORT void JNICALL Java_org_opensearch_knn_jni_FaissService_freeSharedIndexS
 /*
  * Class:     org_opensearch_knn_jni_FaissService
  * Method:    initLibrary
- * Signature: ()V
+ * Signature: (IZ)V
  */
 JNIEXPORT void JNICALL Java_org_opensearch_knn_jni_FaissService_initLibrary
-  (JNIEnv *, jclass);
+  (JNIEnv *, jclass, jint, jboolean);
 
 /*
  * Class:     org_opensearch_knn_jni_FaissService
@@ -252,6 +471,86 @@ JNIEXPORT jbyteArray JNICALL Java_org_opensearch_knn_jni_FaissService_trainBinar
 JNIEXPORT jbyteArray JNICALL Java_org_opensearch_knn_jni_FaissService_trainByteIndex
   (JNIEnv *, jclass, jobject, jint, jlong);
 
+/*
+ * Class:     org_opensearch_knn_jni_FaissService
+ * Method:    trainIndexWithStream
+ * Signature: (Ljava/util/Map;IJLorg/opensearch/knn/index/store/IndexOutputWithBuffer;)V
+ */
+JNIEXPORT void JNICALL Java_org_opensearch_knn_jni_FaissService_trainIndexWithStream
+  (JNIEnv *, jclass, jobject, jint, jlong, jobject);
+
+/*
+ * Class:     org_opensearch_knn_jni_FaissService
+ * Method:    trainBinaryIndexWithStream
+ * Signature: (Ljava/util/Map;IJLorg/opensearch/knn/index/store/IndexOutputWithBuffer;)V
+ */
+JNIEXPORT void JNICALL Java_org_opensearch_knn_jni_FaissService_trainBinaryIndexWithStream
+  (JNIEnv *, jclass, jobject, jint, jlong, jobject);
+
+/*
+ * Class:     org_opensearch_knn_jni_FaissService
+ * Method:    trainByteIndexWithStream
+ * Signature: (Ljava/util/Map;IJLorg/opensearch/knn/index/store/IndexOutputWithBuffer;)V
+ */
+JNIEXPORT void JNICALL Java_org_opensearch_knn_jni_FaissService_trainByteIndexWithStream
+  (JNIEnv *, jclass, jobject, jint, jlong, jobject);
+
+/*
+ * Class:     org_opensearch_knn_jni_FaissService
+ * Method:    initTrainingSession
+ * Signature: (Ljava/util/Map;I)J
+ */
+JNIEXPORT jlong JNICALL Java_org_opensearch_knn_jni_FaissService_initTrainingSession
+  (JNIEnv *, jclass, jobject, jint);
+
+/*
+ * Class:     org_opensearch_knn_jni_FaissService
+ * Method:    initBinaryTrainingSession
+ * Signature: (Ljava/util/Map;I)J
+ */
+JNIEXPORT jlong JNICALL Java_org_opensearch_knn_jni_FaissService_initBinaryTrainingSession
+  (JNIEnv *, jclass, jobject, jint);
+
+/*
+ * Class:     org_opensearch_knn_jni_FaissService
+ * Method:    initByteTrainingSession
+ * Signature: (Ljava/util/Map;I)J
+ */
+JNIEXPORT jlong JNICALL Java_org_opensearch_knn_jni_FaissService_initByteTrainingSession
+  (JNIEnv *, jclass, jobject, jint);
+
+/*
+ * Class:     org_opensearch_knn_jni_FaissService
+ * Method:    addTrainingVectors
+ * Signature: (JJ)V
+ */
+JNIEXPORT void JNICALL Java_org_opensearch_knn_jni_FaissService_addTrainingVectors
+  (JNIEnv *, jclass, jlong, jlong);
+
+/*
+ * Class:     org_opensearch_knn_jni_FaissService
+ * Method:    trainFromSession
+ * Signature: (J)[B
+ */
+JNIEXPORT jbyteArray JNICALL Java_org_opensearch_knn_jni_FaissService_trainFromSession
+  (JNIEnv *, jclass, jlong);
+
+/*
+ * Class:     org_opensearch_knn_jni_FaissService
+ * Method:    trainFromSessionWithStream
+ * Signature: (JLorg/opensearch/knn/index/store/IndexOutputWithBuffer;)V
+ */
+JNIEXPORT void JNICALL Java_org_opensearch_knn_jni_FaissService_trainFromSessionWithStream
+  (JNIEnv *, jclass, jlong, jobject);
+
+/*
+ * Class:     org_opensearch_knn_jni_FaissService
+ * Method:    freeTrainingSession
+ * Signature: (J)V
+ */
+JNIEXPORT void JNICALL Java_org_opensearch_knn_jni_FaissService_freeTrainingSession
+  (JNIEnv *, jclass, jlong);
+
 /*
  * Class:     org_opensearch_knn_jni_FaissService
  * Method:    transferVectors
@@ -276,6 +575,46 @@ JNIEXPORT jobjectArray JNICALL Java_org_opensearch_knn_jni_FaissService_rangeSea
 JNIEXPORT jobjectArray JNICALL Java_org_opensearch_knn_jni_FaissService_rangeSearchIndex
   (JNIEnv *, jclass, jlong, jfloatArray, jfloat, jobject, jint, jintArray);
 
+/*
+ * Class:     org_opensearch_knn_jni_FaissService
+ * Method:    rangeSearchIndexIntoArrays
+ * Signature: (J[FFLjava/util/Map;I[JI[I[I[F)I
+ */
+JNIEXPORT jint JNICALL Java_org_opensearch_knn_jni_FaissService_rangeSearchIndexIntoArrays
+  (JNIEnv *, jclass, jlong, jfloatArray, jfloat, jobject, jint, jlongArray, jint, jintArray, jintArray, jfloatArray);
+
+/*
+ * Class:     org_opensearch_knn_jni_FaissService
+ * Method:    rangeSearchIndexCount
+ * Signature: (J[FFLjava/util/Map;[JI)I
+ */
+JNIEXPORT jint JNICALL Java_org_opensearch_knn_jni_FaissService_rangeSearchIndexCount
+  (JNIEnv *, jclass, jlong, jfloatArray, jfloat, jobject, jlongArray, jint);
+
+/*
+ * Class:     org_opensearch_knn_jni_FaissService
+ * Method:    rangeSearchBinaryIndexWithFilter
+ * Signature: (J[BFLjava/util/Map;I[JI[I)[Lorg/opensearch/knn/index/query/KNNQueryResult;
+ */
+JNIEXPORT jobjectArray JNICALL Java_org_opensearch_knn_jni_FaissService_rangeSearchBinaryIndexWithFilter
+  (JNIEnv *, jclass, jlong, jbyteArray, jfloat, jobject, jint, jlongArray, jint, jintArray);
+
+/*
+ * Class:     org_opensearch_knn_jni_FaissService
+ * Method:    rangeSearchBinaryIndexIntoArrays
+ * Signature: (J[BFLjava/util/Map;I[JI[I[I[F)I
+ */
+JNIEXPORT jint JNICALL Java_org_opensearch_knn_jni_FaissService_rangeSearchBinaryIndexIntoArrays
+  (JNIEnv *, jclass, jlong, jbyteArray, jfloat, jobject, jint, jlongArray, jint, jintArray, jintArray, jfloatArray);
+
+/*
+ * Class:     org_opensearch_knn_jni_FaissService
+ * Method:    rangeSearchBinaryIndex
+ * Signature: (J[BFLjava/util/Map;I[I)[Lorg/opensearch/knn/index/query/KNNQueryResult;
+ */
+JNIEXPORT jobjectArray JNICALL Java_org_opensearch_knn_jni_FaissService_rangeSearchBinaryIndex
+  (JNIEnv *, jclass, jlong, jbyteArray, jfloat, jobject, jint, jintArray);
+
 #ifdef __cplusplus
 }
 #endif
@@ -66,6 +66,22 @@ JNIEXPORT void JNICALL Java_org_opensearch_knn_jni_JNICommons_freeBinaryVectorDa
 JNIEXPORT void JNICALL Java_org_opensearch_knn_jni_JNICommons_freeByteVectorData
 (JNIEnv *, jclass, jlong);
 
+/*
+* Class:     org_opensearch_knn_jni_JNICommons
+* Method:    compileSearchParams
+* Signature: (Ljava/util/Map;)J
+*/
+JNIEXPORT jlong JNICALL Java_org_opensearch_knn_jni_JNICommons_compileSearchParams
+(JNIEnv *, jclass, jobject);
+
+/*
+* Class:     org_opensearch_knn_jni_JNICommons
+* Method:    freeSearchParams
+* Signature: (J)V
+*/
+JNIEXPORT void JNICALL Java_org_opensearch_knn_jni_JNICommons_freeSearchParams
+(JNIEnv *, jclass, jlong);
+
 #ifdef __cplusplus
 }
 #endif
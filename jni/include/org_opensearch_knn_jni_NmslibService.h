@@ -50,6 +50,22 @@ JNIEXPORT jlong JNICALL Java_org_opensearch_knn_jni_NmslibService_loadIndexWithS
 JNIEXPORT jobjectArray JNICALL Java_org_opensearch_knn_jni_NmslibService_queryIndex
   (JNIEnv *, jclass, jlong, jfloatArray, jint, jobject);
 
+/*
+ * Class:     org_opensearch_knn_jni_NmslibService
+ * Method:    queryIndexIntoArrays
+ * Signature: (J[FILjava/util/Map;[I[F)I
+ */
+JNIEXPORT jint JNICALL Java_org_opensearch_knn_jni_NmslibService_queryIndexIntoArrays
+  (JNIEnv *, jclass, jlong, jfloatArray, jint, jobject, jintArray, jfloatArray);
+
+/*
+ * Class:     org_opensearch_knn_jni_NmslibService
+ * Method:    queryIndexWithSearchParams
+ * Signature: (J[FIJ)[Lorg/opensearch/knn/index/query/KNNQueryResult;
+ */
+JNIEXPORT jobjectArray JNICALL Java_org_opensearch_knn_jni_NmslibService_queryIndexWithSearchParams
+  (JNIEnv *, jclass, jlong, jfloatArray, jint, jlong);
+
 /*
  * Class:     org_opensearch_knn_jni_NmslibService
  * Method:    free
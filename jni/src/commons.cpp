@@ -10,6 +10,7 @@
  */
 #include <jni.h>
 
+#include <algorithm>
 #include <vector>
 
 #include "jni_util.h"
@@ -96,14 +97,98 @@ void knn_jni::commons::freeByteVectorData(jlong memoryAddressJ) {
     }
 }
 
-int knn_jni::commons::getIntegerMethodParameter(JNIEnv * env, knn_jni::JNIUtilInterface * jniUtil, std::unordered_map<std::string, jobject> methodParams, std::string methodParam, int defaultValue) {
+int knn_jni::commons::getIntegerMethodParameter(JNIEnv * env, knn_jni::JNIUtilInterface * jniUtil, const std::unordered_map<std::string, jobject> &methodParams, const std::string &methodParam, int defaultValue) {
     if (methodParams.empty()) {
         return defaultValue;
     }
     auto efSearchIt = methodParams.find(methodParam);
     if (efSearchIt != methodParams.end()) {
-        return jniUtil->ConvertJavaObjectToCppInteger(env, methodParams[methodParam]);
+        return jniUtil->ConvertJavaObjectToCppInteger(env, efSearchIt->second);
     }
 
     return defaultValue;
 }
+
+knn_jni::commons::SearchParams knn_jni::commons::parseSearchParams(knn_jni::JNIUtilInterface *jniUtil, JNIEnv *env,
+                                                                   jobject methodParamsJ) {
+    SearchParams searchParams;
+    if (methodParamsJ == nullptr) {
+        return searchParams;
+    }
+
+    auto methodParams = jniUtil->ConvertJavaMapToCppMap(env, methodParamsJ);
+    auto efSearchIt = methodParams.find(knn_jni::EF_SEARCH);
+    if (efSearchIt != methodParams.end()) {
+        searchParams.hasEfSearch = true;
+        searchParams.efSearch = jniUtil->ConvertJavaObjectToCppInteger(env, efSearchIt->second);
+    }
+    auto nprobesIt = methodParams.find(knn_jni::NPROBES);
+    if (nprobesIt != methodParams.end()) {
+        searchParams.hasNprobes = true;
+        searchParams.nprobes = jniUtil->ConvertJavaObjectToCppInteger(env, nprobesIt->second);
+    }
+    auto parallelismIt = methodParams.find(knn_jni::PARALLELISM);
+    if (parallelismIt != methodParams.end()) {
+        searchParams.hasParallelism = true;
+        searchParams.parallelism = jniUtil->ConvertJavaObjectToCppInteger(env, parallelismIt->second);
+    }
+    return searchParams;
+}
+
+jlong knn_jni::commons::compileSearchParams(knn_jni::JNIUtilInterface *jniUtil, JNIEnv *env, jobject methodParamsJ) {
+    return (jlong) new SearchParams(parseSearchParams(jniUtil, env, methodParamsJ));
+}
+
+const knn_jni::commons::SearchParams &knn_jni::commons::getSearchParams(jlong searchParamsPointerJ) {
+    static const SearchParams emptySearchParams;
+    if (searchParamsPointerJ == 0) {
+        return emptySearchParams;
+    }
+    return *reinterpret_cast<SearchParams *>(searchParamsPointerJ);
+}
+
+void knn_jni::commons::freeSearchParams(jlong searchParamsPointerJ) {
+    if (searchParamsPointerJ != 0) {
+        auto *searchParams = reinterpret_cast<SearchParams *>(searchParamsPointerJ);
+        delete searchParams;
+    }
+}
+
+jobjectArray knn_jni::commons::buildKNNQueryResults(knn_jni::JNIUtilInterface *jniUtil, JNIEnv *env, const int64_t *ids,
+                                                     const float *distances, int resultSize) {
+    jclass resultClass = jniUtil->FindClass(env, "org/opensearch/knn/index/query/KNNQueryResult");
+    jmethodID allArgs = jniUtil->FindMethod(env, "org/opensearch/knn/index/query/KNNQueryResult", "<init>");
+
+    jobjectArray results = jniUtil->NewObjectArray(env, resultSize, resultClass, nullptr);
+
+    jobject result;
+    for (int i = 0; i < resultSize; ++i) {
+        result = jniUtil->NewObject(env, resultClass, allArgs, static_cast<int>(ids[i]), distances[i]);
+        jniUtil->SetObjectArrayElement(env, results, i, result);
+        jniUtil->DeleteLocalRef(env, result);
+    }
+    return results;
+}
+
+jint knn_jni::commons::copyQueryResults(knn_jni::JNIUtilInterface *jniUtil, JNIEnv *env, const int64_t *ids,
+                                        const float *distances, int resultSize, jintArray resultIdsJ,
+                                        jfloatArray resultDistancesJ) {
+    if (resultIdsJ == nullptr || resultDistancesJ == nullptr) {
+        throw std::runtime_error("Result arrays cannot be null");
+    }
+
+    int capacity = std::min(jniUtil->GetJavaIntArrayLength(env, resultIdsJ),
+                            jniUtil->GetJavaFloatArrayLength(env, resultDistancesJ));
+    int numResults = std::min(resultSize, capacity);
+    if (numResults <= 0) {
+        return std::max(resultSize, 0);
+    }
+
+    // Reused across calls on the same thread so steady state queries do not allocate for the conversion
+    thread_local std::vector<jint> resultIds;
+    resultIds.assign(ids, ids + numResults);
+    jniUtil->SetIntArrayRegion(env, resultIdsJ, 0, numResults, resultIds.data());
+    jniUtil->SetFloatArrayRegion(env, resultDistancesJ, 0, numResults, distances);
+    // The full count is returned so the caller can tell a truncated copy from a genuinely small result
+    return resultSize;
+}
@@ -0,0 +1,164 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * The OpenSearch Contributors require contributions made to
+ * this file be licensed under the Apache-2.0 license or a
+ * compatible open source license.
+ *
+ * Modifications Copyright OpenSearch Contributors. See
+ * GitHub history for details.
+ */
+
+#include "crc32_util.h"
+
+#include <array>
+#include <cstring>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define KNN_CRC32_PCLMUL
+#include <immintrin.h>
+#endif
+
+namespace {
+    // Bit reflected polynomial of CRC32
+    constexpr uint32_t POLYNOMIAL = 0xEDB88320;
+
+    // Slicing by 8, TABLES[k][b] is the CRC of byte b followed by k zero bytes
+    using Crc32Tables = std::array<std::array<uint32_t, 256>, 8>;
+
+    const Crc32Tables &tables() {
+        static const Crc32Tables TABLES = [] {
+            Crc32Tables tables {};
+            for (uint32_t b = 0; b < 256; b++) {
+                uint32_t crc = b;
+                for (int bit = 0; bit < 8; bit++) {
+                    crc = (crc >> 1) ^ (POLYNOMIAL & (0 - (crc & 1)));
+                }
+                tables[0][b] = crc;
+            }
+            for (uint32_t b = 0; b < 256; b++) {
+                for (size_t k = 1; k < tables.size(); k++) {
+                    tables[k][b] = (tables[k - 1][b] >> 8) ^ tables[0][tables[k - 1][b] & 0xFF];
+                }
+            }
+            return tables;
+        }();
+        return TABLES;
+    }
+
+    // Takes and returns the CRC before its final inversion
+    uint32_t crc32Tables(uint32_t crc, const uint8_t *bytes, size_t length) {
+        const Crc32Tables &t = tables();
+        while (length >= 8) {
+            uint32_t low, high;
+            std::memcpy(&low, bytes, sizeof(low));
+            std::memcpy(&high, bytes + 4, sizeof(high));
+            low ^= crc;
+            crc = t[7][low & 0xFF] ^ t[6][(low >> 8) & 0xFF] ^ t[5][(low >> 16) & 0xFF] ^ t[4][low >> 24]
+                  ^ t[3][high & 0xFF] ^ t[2][(high >> 8) & 0xFF] ^ t[1][(high >> 16) & 0xFF] ^ t[0][high >> 24];
+            bytes += 8;
+            length -= 8;
+        }
+        while (length-- > 0) {
+            crc = (crc >> 8) ^ t[0][(crc ^ *bytes++) & 0xFF];
+        }
+        return crc;
+    }
+
+#ifdef KNN_CRC32_PCLMUL
+    // Folds 64 bytes at a time with carry-less multiplications, then reduces the remaining 128 bits with Barrett
+    // reduction, as described in "Fast CRC Computation for Generic Polynomials Using PCLMULQDQ Instruction" by Intel.
+    // Expects at least 64 bytes, in a multiple of 16. Takes and returns the CRC before its final inversion.
+    __attribute__((target("pclmul,sse4.1")))
+    uint32_t crc32Pclmul(uint32_t crc, const uint8_t *bytes, size_t length) {
+        alignas(16) static const uint64_t K1K2[] = {0x0154442bd4, 0x01c6e41596};
+        alignas(16) static const uint64_t K3K4[] = {0x01751997d0, 0x00ccaa009e};
+        alignas(16) static const uint64_t K5K0[] = {0x0163cd6124, 0x0000000000};
+        alignas(16) static const uint64_t POLY[] = {0x01db710641, 0x01f7011641};
+
+        __m128i x1 = _mm_loadu_si128((const __m128i *) (bytes + 0x00));
+        __m128i x2 = _mm_loadu_si128((const __m128i *) (bytes + 0x10));
+        __m128i x3 = _mm_loadu_si128((const __m128i *) (bytes + 0x20));
+        __m128i x4 = _mm_loadu_si128((const __m128i *) (bytes + 0x30));
+        x1 = _mm_xor_si128(x1, _mm_cvtsi32_si128(static_cast<int>(crc)));
+        __m128i k = _mm_load_si128((const __m128i *) K1K2);
+        bytes += 64;
+        length -= 64;
+
+        // Four lanes folded in parallel
+        while (length >= 64) {
+            const __m128i x5 = _mm_clmulepi64_si128(x1, k, 0x00);
+            const __m128i x6 = _mm_clmulepi64_si128(x2, k, 0x00);
+            const __m128i x7 = _mm_clmulepi64_si128(x3, k, 0x00);
+            const __m128i x8 = _mm_clmulepi64_si128(x4, k, 0x00);
+            x1 = _mm_clmulepi64_si128(x1, k, 0x11);
+            x2 = _mm_clmulepi64_si128(x2, k, 0x11);
+            x3 = _mm_clmulepi64_si128(x3, k, 0x11);
+            x4 = _mm_clmulepi64_si128(x4, k, 0x11);
+            x1 = _mm_xor_si128(_mm_xor_si128(x1, x5), _mm_loadu_si128((const __m128i *) (bytes + 0x00)));
+            x2 = _mm_xor_si128(_mm_xor_si128(x2, x6), _mm_loadu_si128((const __m128i *) (bytes + 0x10)));
+            x3 = _mm_xor_si128(_mm_xor_si128(x3, x7), _mm_loadu_si128((const __m128i *) (bytes + 0x20)));
+            x4 = _mm_xor_si128(_mm_xor_si128(x4, x8), _mm_loadu_si128((const __m128i *) (bytes + 0x30)));
+            bytes += 64;
+            length -= 64;
+        }
+
+        // The four lanes folded into one
+        k = _mm_load_si128((const __m128i *) K3K4);
+        for (const __m128i lane : {x2, x3, x4}) {
+            const __m128i x5 = _mm_clmulepi64_si128(x1, k, 0x00);
+            x1 = _mm_clmulepi64_si128(x1, k, 0x11);
+            x1 = _mm_xor_si128(_mm_xor_si128(x1, lane), x5);
+        }
+
+        // The remaining 16 bytes blocks
+        while (length >= 16) {
+            const __m128i x5 = _mm_clmulepi64_si128(x1, k, 0x00);
+            x1 = _mm_clmulepi64_si128(x1, k, 0x11);
+            x1 = _mm_xor_si128(_mm_xor_si128(x1, _mm_loadu_si128((const __m128i *) bytes)), x5);
+            bytes += 16;
+            length -= 16;
+        }
+
+        // 128 bits folded to 64 bits
+        const __m128i mask = _mm_setr_epi32(~0, 0, ~0, 0);
+        __m128i x5 = _mm_clmulepi64_si128(x1, k, 0x10);
+        x1 = _mm_xor_si128(_mm_srli_si128(x1, 8), x5);
+        k = _mm_loadl_epi64((const __m128i *) K5K0);
+        x5 = _mm_srli_si128(x1, 4);
+        x1 = _mm_and_si128(x1, mask);
+        x1 = _mm_xor_si128(_mm_clmulepi64_si128(x1, k, 0x00), x5);
+
+        // Barrett reduction to 32 bits
+        k = _mm_load_si128((const __m128i *) POLY);
+        x5 = _mm_and_si128(x1, mask);
+        x5 = _mm_clmulepi64_si128(x5, k, 0x10);
+        x5 = _mm_and_si128(x5, mask);
+        x5 = _mm_clmulepi64_si128(x5, k, 0x00);
+        x1 = _mm_xor_si128(x1, x5);
+        return static_cast<uint32_t>(_mm_extract_epi32(x1, 1));
+    }
+
+    bool hasPclmul() {
+        static const bool HAS_PCLMUL = __builtin_cpu_supports("pclmul") && __builtin_cpu_supports("sse4.1");
+        return HAS_PCLMUL;
+    }
+#endif
+}
+
+uint32_t knn_jni::util::crc32(uint32_t crc, const uint8_t *bytes, size_t length) {
+    crc = ~crc;
+#ifdef KNN_CRC32_PCLMUL
+    if (length >= 64 && hasPclmul()) {
+        const size_t folded = length & ~static_cast<size_t>(15);
+        crc = crc32Pclmul(crc, bytes, folded);
+        bytes += folded;
+        length -= folded;
+    }
+#endif
+    return ~crc32Tables(crc, bytes, length);
+}
+
+void knn_jni::util::Crc32::update(const uint8_t *bytes, size_t length) {
+    crc = knn_jni::util::crc32(crc, bytes, length);
+}
@@ -0,0 +1,258 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * The OpenSearch Contributors require contributions made to
+ * this file be licensed under the Apache-2.0 license or a
+ * compatible open source license.
+ *
+ * Modifications Copyright OpenSearch Contributors. See
+ * GitHub history for details.
+ */
+
+#include "faiss_index_int8.h"
+
+#include "faiss/IndexHNSW.h"
+#include "faiss/impl/HNSW.h"
+#include "faiss/utils/random.h"
+
+#include <algorithm>
+#include <cmath>
+#include <omp.h>
+#include <stdexcept>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace {
+    constexpr uint8_t SIGN_BIT = 0x80;
+
+#if defined(__AVX2__)
+    int32_t horizontalSum(__m256i v) {
+        __m128i sum = _mm_add_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+        sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+        sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+        return _mm_cvtsi128_si32(sum);
+    }
+#endif
+
+    // Links vertices n0 ... n0 + n - 1, whose codes are already in the storage, into the graph. Follows the faiss
+    // insertion order: highest level first, each level shuffled to get rid of the input order bias.
+    void addHNSWVertices(faiss::IndexHNSW &index, const faiss::IndexScalarQuantizer &storage, size_t n0, size_t n) {
+        faiss::HNSW &hnsw = index.hnsw;
+        const size_t ntotal = n0 + n;
+        hnsw.prepare_level_tab(n, false);
+
+        std::vector<omp_lock_t> locks(ntotal);
+        for (auto &lock : locks) {
+            omp_init_lock(&lock);
+        }
+
+        // Bucket the vertices by level
+        std::vector<int> histogram;
+        for (size_t i = 0; i < n; i++) {
+            const size_t level = hnsw.levels[n0 + i] - 1;
+            if (level >= histogram.size()) {
+                histogram.resize(level + 1, 0);
+            }
+            histogram[level]++;
+        }
+        std::vector<int> offsets(histogram.size() + 1, 0);
+        for (size_t i = 0; i + 1 < histogram.size(); i++) {
+            offsets[i + 1] = offsets[i] + histogram[i];
+        }
+        std::vector<faiss::HNSW::storage_idx_t> order(n);
+        for (size_t i = 0; i < n; i++) {
+            order[offsets[hnsw.levels[n0 + i] - 1]++] = n0 + i;
+        }
+
+        faiss::RandomGenerator rng(789);
+        int i1 = n;
+        for (int level = static_cast<int>(histogram.size()) - 1; level >= (index.init_level0 ? 0 : 1); level--) {
+            const int i0 = i1 - histogram[level];
+            for (int j = i0; j < i1; j++) {
+                std::swap(order[j], order[j + rng.rand_int(i1 - j)]);
+            }
+
+#pragma omp parallel if (i1 > i0 + 100)
+            {
+                faiss::VisitedTable visited(ntotal);
+                // The graph is built by smallest distance first
+                knn_jni::faiss_wrapper::Int8DirectDistanceComputer distanceComputer(storage, true);
+#pragma omp for schedule(static)
+                for (int i = i0; i < i1; i++) {
+                    const faiss::HNSW::storage_idx_t id = order[i];
+                    distanceComputer.set_query_code(storage.codes.data() + id * storage.code_size);
+                    hnsw.add_with_locks(distanceComputer, level, id, locks, visited,
+                                        index.keep_max_size_level0 && level == 0);
+                }
+            }
+            i1 = i0;
+        }
+
+        for (auto &lock : locks) {
+            omp_destroy_lock(&lock);
+        }
+    }
+}
+
+bool knn_jni::faiss_wrapper::isInt8DirectStorage(const faiss::Index *index) {
+    auto *scalarQuantizer = dynamic_cast<const faiss::IndexScalarQuantizer *>(index);
+    return scalarQuantizer != nullptr && scalarQuantizer->sq.qtype == faiss::ScalarQuantizer::QT_8bit_direct_signed;
+}
+
+bool knn_jni::faiss_wrapper::supportsInt8Add(const faiss::Index *index) {
+    auto *hnsw = dynamic_cast<const faiss::IndexHNSW *>(index);
+    return isInt8DirectStorage(hnsw != nullptr ? hnsw->storage : index);
+}
+
+void knn_jni::faiss_wrapper::encodeInt8Vectors(const int8_t *x, size_t n, size_t d, uint8_t *codes) {
+    const size_t length = n * d;
+    for (size_t i = 0; i < length; i++) {
+        codes[i] = static_cast<uint8_t>(x[i]) ^ SIGN_BIT;
+    }
+}
+
+int32_t knn_jni::faiss_wrapper::int8L2Sqr(const int8_t *x, const uint8_t *code, size_t d) {
+    size_t i = 0;
+    int32_t sum = 0;
+#if defined(__AVX512VNNI__) && defined(__AVX512BW__)
+    {
+        const __m256i signBit = _mm256_set1_epi8(static_cast<char>(SIGN_BIT));
+        __m512i acc = _mm512_setzero_si512();
+        for (; i + 32 <= d; i += 32) {
+            __m512i a = _mm512_cvtepi8_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(x + i)));
+            __m512i b = _mm512_cvtepi8_epi16(
+                    _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(code + i)), signBit));
+            __m512i diff = _mm512_sub_epi16(a, b);
+            acc = _mm512_dpwssd_epi32(acc, diff, diff);
+        }
+        sum += _mm512_reduce_add_epi32(acc);
+    }
+#endif
+#if defined(__AVX2__)
+    {
+        const __m128i signBit = _mm_set1_epi8(static_cast<char>(SIGN_BIT));
+        __m256i acc = _mm256_setzero_si256();
+        for (; i + 16 <= d; i += 16) {
+            __m256i a = _mm256_cvtepi8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i *>(x + i)));
+            __m256i b = _mm256_cvtepi8_epi16(
+                    _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i *>(code + i)), signBit));
+            __m256i diff = _mm256_sub_epi16(a, b);
+            acc = _mm256_add_epi32(acc, _mm256_madd_epi16(diff, diff));
+        }
+        sum += horizontalSum(acc);
+    }
+#endif
+    for (; i < d; i++) {
+        const int32_t diff = x[i] - static_cast<int8_t>(code[i] ^ SIGN_BIT);
+        sum += diff * diff;
+    }
+    return sum;
+}
+
+int32_t knn_jni::faiss_wrapper::int8InnerProduct(const int8_t *x, const uint8_t *code, size_t d) {
+    size_t i = 0;
+    int32_t sum = 0;
+#if defined(__AVX512VNNI__) && defined(__AVX512BW__)
+    {
+        // dpbusd multiplies unsigned by signed bytes, which the codes are once the 128 they are offset by is taken
+        // back out of the sum
+        const __m512i offset = _mm512_set1_epi8(static_cast<char>(SIGN_BIT));
+        __m512i acc = _mm512_setzero_si512();
+        __m512i offsetAcc = _mm512_setzero_si512();
+        for (; i + 64 <= d; i += 64) {
+            __m512i a = _mm512_loadu_si512(x + i);
+            __m512i b = _mm512_loadu_si512(code + i);
+            acc = _mm512_dpbusd_epi32(acc, b, a);
+            offsetAcc = _mm512_dpbusd_epi32(offsetAcc, offset, a);
+        }
+        sum += _mm512_reduce_add_epi32(acc) - _mm512_reduce_add_epi32(offsetAcc);
+    }
+#endif
+#if defined(__AVX2__)
+    {
+        // maddubs would saturate, so the bytes are widened to int16 first
+        const __m128i signBit = _mm_set1_epi8(static_cast<char>(SIGN_BIT));
+        __m256i acc = _mm256_setzero_si256();
+        for (; i + 16 <= d; i += 16) {
+            __m256i a = _mm256_cvtepi8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i *>(x + i)));
+            __m256i b = _mm256_cvtepi8_epi16(
+                    _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i *>(code + i)), signBit));
+            acc = _mm256_add_epi32(acc, _mm256_madd_epi16(a, b));
+        }
+        sum += horizontalSum(acc);
+    }
+#endif
+    for (; i < d; i++) {
+        sum += x[i] * static_cast<int8_t>(code[i] ^ SIGN_BIT);
+    }
+    return sum;
+}
+
+knn_jni::faiss_wrapper::Int8DirectDistanceComputer::Int8DirectDistanceComputer(
+        const faiss::IndexScalarQuantizer &storage, bool negated)
+    : FlatCodesDistanceComputer(storage.codes.data(), storage.code_size),
+      d(storage.d),
+      metric(storage.metric_type),
+      negated(negated),
+      query(storage.d),
+      symmetricQuery(storage.d) {
+}
+
+void knn_jni::faiss_wrapper::Int8DirectDistanceComputer::set_query(const float *x) {
+    for (size_t i = 0; i < d; i++) {
+        query[i] = static_cast<int8_t>(std::min(127.0f, std::max(-128.0f, std::nearbyint(x[i]))));
+    }
+}
+
+void knn_jni::faiss_wrapper::Int8DirectDistanceComputer::set_query_code(const uint8_t *code) {
+    for (size_t i = 0; i < d; i++) {
+        query[i] = static_cast<int8_t>(code[i] ^ SIGN_BIT);
+    }
+}
+
+float knn_jni::faiss_wrapper::Int8DirectDistanceComputer::distance_to_code(const uint8_t *code) {
+    if (metric == faiss::METRIC_INNER_PRODUCT) {
+        const float innerProduct = static_cast<float>(int8InnerProduct(query.data(), code, d));
+        return negated ? -innerProduct : innerProduct;
+    }
+    return static_cast<float>(int8L2Sqr(query.data(), code, d));
+}
+
+float knn_jni::faiss_wrapper::Int8DirectDistanceComputer::symmetric_dis(faiss::idx_t i, faiss::idx_t j) {
+    // Called a lot while the graph is built, so the decoded vector goes to a buffer owned by the computer
+    const uint8_t *codeI = codes + i * code_size;
+    for (size_t k = 0; k < d; k++) {
+        symmetricQuery[k] = static_cast<int8_t>(codeI[k] ^ SIGN_BIT);
+    }
+    const uint8_t *codeJ = codes + j * code_size;
+    if (metric == faiss::METRIC_INNER_PRODUCT) {
+        const float innerProduct = static_cast<float>(int8InnerProduct(symmetricQuery.data(), codeJ, d));
+        return negated ? -innerProduct : innerProduct;
+    }
+    return static_cast<float>(int8L2Sqr(symmetricQuery.data(), codeJ, d));
+}
+
+void knn_jni::faiss_wrapper::addInt8Vectors(faiss::Index *index, size_t n, const int8_t *x) {
+    auto *hnsw = dynamic_cast<faiss::IndexHNSW *>(index);
+    faiss::Index *storageIndex = hnsw != nullptr ? hnsw->storage : index;
+    if (!isInt8DirectStorage(storageIndex)) {
+        throw std::runtime_error("Index does not store QT_8bit_direct_signed codes");
+    }
+    if (n == 0) {
+        return;
+    }
+
+    auto *storage = static_cast<faiss::IndexScalarQuantizer *>(storageIndex);
+    const size_t n0 = storage->ntotal;
+    storage->codes.resize((n0 + n) * storage->code_size);
+    encodeInt8Vectors(x, n, storage->d, storage->codes.data() + n0 * storage->code_size);
+    storage->ntotal = n0 + n;
+    if (hnsw == nullptr) {
+        return;
+    }
+
+    addHNSWVertices(*hnsw, *storage, n0, n);
+    hnsw->ntotal = storage->ntotal;
+}
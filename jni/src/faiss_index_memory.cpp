@@ -0,0 +1,178 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * The OpenSearch Contributors require contributions made to
+ * this file be licensed under the Apache-2.0 license or a
+ * compatible open source license.
+ *
+ * Modifications Copyright OpenSearch Contributors. See
+ * GitHub history for details.
+ */
+
+#include "faiss_index_memory.h"
+
+#include "faiss/IndexBinaryFlat.h"
+#include "faiss/IndexBinaryHNSW.h"
+#include "faiss/IndexBinaryIVF.h"
+#include "faiss/IndexFlatCodes.h"
+#include "faiss/IndexHNSW.h"
+#include "faiss/IndexIDMap.h"
+#include "faiss/IndexIVF.h"
+#include "faiss/impl/maybe_owned_vector.h"
+#include "faiss/invlists/InvertedLists.h"
+
+#include <cmath>
+
+namespace {
+    // The levels drawn for the vertices vary around their expectation, so the neighbor slots get a small margin
+    constexpr double HNSW_NEIGHBOR_MARGIN = 1.02;
+
+    // Every inverted list is reserved an even share of the vectors, but lists fill unevenly. A list that outgrows its
+    // share is reallocated by doubling, so it can end up with up to twice the capacity it needs.
+    constexpr size_t IVF_LIST_MARGIN = 2;
+
+    // The vector caches a pointer to its data, so it is refreshed once the storage is reallocated. Views over memory
+    // faiss does not own, like a mapped file, cannot grow and are left alone.
+    template <typename T>
+    void reserve(faiss::MaybeOwnedVector<T> &vector, size_t size) {
+        if (!vector.is_owned) {
+            return;
+        }
+        vector.owned_data.reserve(size);
+        vector.resize(vector.size());
+    }
+
+    size_t hnswMemory(const faiss::HNSW &hnsw, size_t numVectors) {
+        return numVectors * (sizeof(int) + sizeof(size_t))
+               + knn_jni::faiss_wrapper::expectedHNSWNeighborSlots(hnsw, numVectors) * sizeof(faiss::HNSW::storage_idx_t);
+    }
+
+    void reserveHNSW(faiss::HNSW &hnsw, size_t numVectors) {
+        hnsw.levels.reserve(hnsw.levels.size() + numVectors);
+        hnsw.offsets.reserve(hnsw.offsets.size() + numVectors);
+        reserve(hnsw.neighbors,
+                hnsw.neighbors.size() + knn_jni::faiss_wrapper::expectedHNSWNeighborSlots(hnsw, numVectors));
+    }
+
+    // The assignment of the vectors to the lists is only known once they are added, so every list is reserved its even
+    // share of the vectors. Lists that outgrow it are covered by IVF_LIST_MARGIN in the estimate.
+    void reserveInvertedLists(faiss::InvertedLists *invlists, size_t numVectors) {
+        auto *arrayLists = dynamic_cast<faiss::ArrayInvertedLists *>(invlists);
+        if (arrayLists == nullptr || arrayLists->nlist == 0) {
+            return;
+        }
+        const size_t share = (numVectors + arrayLists->nlist - 1) / arrayLists->nlist;
+        for (size_t list = 0; list < arrayLists->nlist; list++) {
+            const size_t size = arrayLists->ids[list].size() + share;
+            reserve(arrayLists->ids[list], size);
+            reserve(arrayLists->codes[list], size * arrayLists->code_size);
+        }
+    }
+}
+
+size_t knn_jni::faiss_wrapper::expectedHNSWNeighborSlots(const faiss::HNSW &hnsw, size_t numVectors) {
+    // A vertex drawn at level l keeps the neighbors of levels 0 to l
+    double slotsPerVertex = 0;
+    for (size_t level = 0; level < hnsw.assign_probas.size(); level++) {
+        slotsPerVertex += hnsw.assign_probas[level] * hnsw.cum_nb_neighbors(level + 1);
+    }
+    return static_cast<size_t>(std::ceil(slotsPerVertex * numVectors * HNSW_NEIGHBOR_MARGIN));
+}
+
+size_t knn_jni::faiss_wrapper::estimateIndexMemory(const faiss::Index *index, size_t numVectors) {
+    if (index == nullptr || numVectors == 0) {
+        return 0;
+    }
+    if (auto *idMap = dynamic_cast<const faiss::IndexIDMap *>(index)) {
+        return numVectors * sizeof(faiss::idx_t) + estimateIndexMemory(idMap->index, numVectors);
+    }
+    if (auto *hnswIndex = dynamic_cast<const faiss::IndexHNSW *>(index)) {
+        return hnswMemory(hnswIndex->hnsw, numVectors) + estimateIndexMemory(hnswIndex->storage, numVectors);
+    }
+    if (auto *ivfIndex = dynamic_cast<const faiss::IndexIVF *>(index)) {
+        size_t memory = IVF_LIST_MARGIN * numVectors * (ivfIndex->code_size + sizeof(faiss::idx_t));
+        if (ivfIndex->direct_map.type == faiss::DirectMap::Array) {
+            memory += numVectors * sizeof(faiss::idx_t);
+        }
+        if (ivfIndex->quantizer != nullptr && static_cast<size_t>(ivfIndex->quantizer->ntotal) < ivfIndex->nlist) {
+            memory += estimateIndexMemory(ivfIndex->quantizer, ivfIndex->nlist - ivfIndex->quantizer->ntotal);
+        }
+        return memory;
+    }
+    if (auto *flatIndex = dynamic_cast<const faiss::IndexFlatCodes *>(index)) {
+        return numVectors * flatIndex->code_size;
+    }
+    // Anything else is assumed to keep the vectors as they are
+    return numVectors * index->d * sizeof(float);
+}
+
+size_t knn_jni::faiss_wrapper::estimateIndexMemory(const faiss::IndexBinary *index, size_t numVectors) {
+    if (index == nullptr || numVectors == 0) {
+        return 0;
+    }
+    if (auto *idMap = dynamic_cast<const faiss::IndexBinaryIDMap *>(index)) {
+        return numVectors * sizeof(faiss::idx_t) + estimateIndexMemory(idMap->index, numVectors);
+    }
+    if (auto *hnswIndex = dynamic_cast<const faiss::IndexBinaryHNSW *>(index)) {
+        return hnswMemory(hnswIndex->hnsw, numVectors) + estimateIndexMemory(hnswIndex->storage, numVectors);
+    }
+    if (auto *ivfIndex = dynamic_cast<const faiss::IndexBinaryIVF *>(index)) {
+        size_t memory = IVF_LIST_MARGIN * numVectors * (ivfIndex->code_size + sizeof(faiss::idx_t));
+        if (ivfIndex->direct_map.type == faiss::DirectMap::Array) {
+            memory += numVectors * sizeof(faiss::idx_t);
+        }
+        if (ivfIndex->quantizer != nullptr && static_cast<size_t>(ivfIndex->quantizer->ntotal) < ivfIndex->nlist) {
+            memory += estimateIndexMemory(ivfIndex->quantizer, ivfIndex->nlist - ivfIndex->quantizer->ntotal);
+        }
+        return memory;
+    }
+    return numVectors * index->code_size;
+}
+
+void knn_jni::faiss_wrapper::reserveIndexMemory(faiss::Index *index, size_t numVectors) {
+    if (index == nullptr || numVectors == 0) {
+        return;
+    }
+    if (auto *idMap = dynamic_cast<faiss::IndexIDMap *>(index)) {
+        idMap->id_map.reserve(idMap->id_map.size() + numVectors);
+        reserveIndexMemory(idMap->index, numVectors);
+    } else if (auto *hnswIndex = dynamic_cast<faiss::IndexHNSW *>(index)) {
+        reserveHNSW(hnswIndex->hnsw, numVectors);
+        reserveIndexMemory(hnswIndex->storage, numVectors);
+    } else if (auto *ivfIndex = dynamic_cast<faiss::IndexIVF *>(index)) {
+        reserveInvertedLists(ivfIndex->invlists, numVectors);
+        if (ivfIndex->direct_map.type == faiss::DirectMap::Array) {
+            ivfIndex->direct_map.array.reserve(ivfIndex->direct_map.array.size() + numVectors);
+        }
+        // Training adds the centroids to the quantizer
+        if (ivfIndex->quantizer != nullptr && static_cast<size_t>(ivfIndex->quantizer->ntotal) < ivfIndex->nlist) {
+            reserveIndexMemory(ivfIndex->quantizer, ivfIndex->nlist - ivfIndex->quantizer->ntotal);
+        }
+    } else if (auto *flatIndex = dynamic_cast<faiss::IndexFlatCodes *>(index)) {
+        reserve(flatIndex->codes, (flatIndex->ntotal + numVectors) * flatIndex->code_size);
+    }
+}
+
+void knn_jni::faiss_wrapper::reserveIndexMemory(faiss::IndexBinary *index, size_t numVectors) {
+    if (index == nullptr || numVectors == 0) {
+        return;
+    }
+    if (auto *idMap = dynamic_cast<faiss::IndexBinaryIDMap *>(index)) {
+        idMap->id_map.reserve(idMap->id_map.size() + numVectors);
+        reserveIndexMemory(idMap->index, numVectors);
+    } else if (auto *hnswIndex = dynamic_cast<faiss::IndexBinaryHNSW *>(index)) {
+        reserveHNSW(hnswIndex->hnsw, numVectors);
+        reserveIndexMemory(hnswIndex->storage, numVectors);
+    } else if (auto *ivfIndex = dynamic_cast<faiss::IndexBinaryIVF *>(index)) {
+        reserveInvertedLists(ivfIndex->invlists, numVectors);
+        if (ivfIndex->direct_map.type == faiss::DirectMap::Array) {
+            ivfIndex->direct_map.array.reserve(ivfIndex->direct_map.array.size() + numVectors);
+        }
+        // Training adds the centroids to the quantizer
+        if (ivfIndex->quantizer != nullptr && static_cast<size_t>(ivfIndex->quantizer->ntotal) < ivfIndex->nlist) {
+            reserveIndexMemory(ivfIndex->quantizer, ivfIndex->nlist - ivfIndex->quantizer->ntotal);
+        }
+    } else if (auto *flatIndex = dynamic_cast<faiss::IndexBinaryFlat *>(index)) {
+        reserve(flatIndex->xb, (flatIndex->ntotal + numVectors) * flatIndex->code_size);
+    }
+}
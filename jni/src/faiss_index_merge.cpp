@@ -0,0 +1,392 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * The OpenSearch Contributors require contributions made to
+ * this file be licensed under the Apache-2.0 license or a
+ * compatible open source license.
+ *
+ * Modifications Copyright OpenSearch Contributors. See
+ * GitHub history for details.
+ */
+
+#include "faiss_index_merge.h"
+
+#include "faiss/IndexBinaryFlat.h"
+#include "faiss/IndexBinaryHNSW.h"
+#include "faiss/IndexFlatCodes.h"
+#include "faiss/IndexHNSW.h"
+#include "faiss/MetricType.h"
+#include "faiss/impl/DistanceComputer.h"
+#include "faiss/impl/HNSW.h"
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <omp.h>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+    using storage_idx_t = faiss::HNSW::storage_idx_t;
+
+    // Distances of the storage turned into smaller is closer, the order the graph is built in
+    struct GraphDistanceComputer : faiss::DistanceComputer {
+        GraphDistanceComputer(faiss::DistanceComputer *base, bool negate) : base(base), negate(negate) {
+        }
+
+        void set_query(const float *x) override {
+            base->set_query(x);
+        }
+
+        float operator()(faiss::idx_t i) override {
+            return negate ? -(*base)(i) : (*base)(i);
+        }
+
+        float symmetric_dis(faiss::idx_t i, faiss::idx_t j) override {
+            return negate ? -base->symmetric_dis(i, j) : base->symmetric_dis(i, j);
+        }
+
+        std::unique_ptr<faiss::DistanceComputer> base;
+        bool negate;
+    };
+
+    // Graph of an HNSW index over flat codes, with a distance computer for each thread whose query is one of the
+    // vertices. Queries are made from the reconstructed vector, as some encoders have no symmetric distance.
+    struct FloatGraph {
+        struct Query {
+            explicit Query(const faiss::IndexFlatCodes &storage)
+                    : storage(storage), vector(storage.d),
+                      distances(storage.get_distance_computer(), faiss::is_similarity_metric(storage.metric_type)) {
+            }
+
+            void setVertex(storage_idx_t vertex) {
+                storage.reconstruct(vertex, vector.data());
+                distances.set_query(vector.data());
+            }
+
+            const faiss::IndexFlatCodes &storage;
+            std::vector<float> vector;
+            GraphDistanceComputer distances;
+        };
+
+        FloatGraph(faiss::IndexHNSW &index, faiss::IndexFlatCodes &storage) : index(index), storage(storage) {
+        }
+
+        faiss::HNSW &hnsw() { return index.hnsw; }
+
+        bool keepMaxSizeLevel0() const { return index.keep_max_size_level0; }
+
+        uint8_t *codes() { return storage.codes.data(); }
+
+        size_t codeSize() const { return storage.code_size; }
+
+        void resize(size_t ntotal) {
+            storage.codes.resize(ntotal * storage.code_size);
+            storage.ntotal = ntotal;
+            index.ntotal = ntotal;
+        }
+
+        Query query() const { return Query(storage); }
+
+        faiss::IndexHNSW &index;
+        faiss::IndexFlatCodes &storage;
+    };
+
+    struct BinaryGraph {
+        struct Query {
+            explicit Query(const faiss::IndexBinaryHNSW &index, const faiss::IndexBinaryFlat &storage)
+                    : storage(storage), distances(index.get_distance_computer()) {
+            }
+
+            void setVertex(storage_idx_t vertex) {
+                // Binary distance computers take the code of the query in place of a float vector
+                distances->set_query(reinterpret_cast<const float *>(storage.xb.data() + vertex * storage.code_size));
+            }
+
+            const faiss::IndexBinaryFlat &storage;
+            std::unique_ptr<faiss::DistanceComputer> distances;
+        };
+
+        BinaryGraph(faiss::IndexBinaryHNSW &index, faiss::IndexBinaryFlat &storage) : index(index), storage(storage) {
+        }
+
+        faiss::HNSW &hnsw() { return index.hnsw; }
+
+        bool keepMaxSizeLevel0() const { return false; }
+
+        uint8_t *codes() { return storage.xb.data(); }
+
+        size_t codeSize() const { return storage.code_size; }
+
+        void resize(size_t ntotal) {
+            storage.xb.resize(ntotal * storage.code_size);
+            storage.ntotal = ntotal;
+            index.ntotal = ntotal;
+        }
+
+        Query query() const { return Query(index, storage); }
+
+        faiss::IndexBinaryHNSW &index;
+        faiss::IndexBinaryFlat &storage;
+    };
+
+    faiss::DistanceComputer &distancesOf(FloatGraph::Query &query) {
+        return query.distances;
+    }
+
+    faiss::DistanceComputer &distancesOf(BinaryGraph::Query &query) {
+        return *query.distances;
+    }
+
+    // Move the codes of the kept vertices to the front, in order
+    template <typename GRAPH>
+    void compactCodes(GRAPH &graph, const std::vector<storage_idx_t> &newIds, size_t numKept) {
+        uint8_t *codes = graph.codes();
+        const size_t codeSize = graph.codeSize();
+        for (size_t i = 0; i < newIds.size(); i++) {
+            if (newIds[i] >= 0 && static_cast<size_t>(newIds[i]) != i) {
+                std::memmove(codes + newIds[i] * codeSize, codes + i * codeSize, codeSize);
+            }
+        }
+        graph.resize(numKept);
+    }
+
+    // Rebuild the neighbor lists over the kept vertices only. A list that lost neighbors fills the freed slots with
+    // the neighbors of the dropped ones, closest first. Expects the codes to be compacted already.
+    template <typename GRAPH>
+    void compactNeighbors(GRAPH &graph, const std::vector<storage_idx_t> &newIds, size_t numKept) {
+        faiss::HNSW &hnsw = graph.hnsw();
+        const size_t n = newIds.size();
+
+        std::vector<int> levels;
+        std::vector<size_t> offsets {0};
+        levels.reserve(numKept);
+        offsets.reserve(numKept + 1);
+        for (size_t i = 0; i < n; i++) {
+            if (newIds[i] >= 0) {
+                levels.push_back(hnsw.levels[i]);
+                offsets.push_back(offsets.back() + hnsw.cum_nb_neighbors(hnsw.levels[i]));
+            }
+        }
+        std::vector<storage_idx_t> neighbors(offsets.back(), -1);
+
+#pragma omp parallel
+        {
+            auto query = graph.query();
+            std::vector<storage_idx_t> candidates;
+            std::vector<std::pair<float, storage_idx_t>> closest;
+#pragma omp for schedule(dynamic, 256)
+            for (int64_t i = 0; i < static_cast<int64_t>(n); i++) {
+                const storage_idx_t newId = newIds[i];
+                if (newId < 0) {
+                    continue;
+                }
+                bool queryIsSet = false;
+                for (int level = 0; level < hnsw.levels[i]; level++) {
+                    size_t begin, end;
+                    hnsw.neighbor_range(i, level, &begin, &end);
+                    storage_idx_t *out = neighbors.data() + offsets[newId] + hnsw.cum_nb_neighbors(level);
+                    const size_t capacity = end - begin;
+
+                    size_t count = 0;
+                    bool lostNeighbors = false;
+                    for (size_t j = begin; j < end && hnsw.neighbors[j] >= 0; j++) {
+                        const storage_idx_t neighbor = newIds[hnsw.neighbors[j]];
+                        if (neighbor >= 0) {
+                            out[count++] = neighbor;
+                        } else {
+                            lostNeighbors = true;
+                        }
+                    }
+                    if (!lostNeighbors || count == capacity) {
+                        continue;
+                    }
+
+                    // Kept neighbors of the dropped neighbors
+                    candidates.clear();
+                    for (size_t j = begin; j < end && hnsw.neighbors[j] >= 0; j++) {
+                        const storage_idx_t dropped = hnsw.neighbors[j];
+                        if (newIds[dropped] >= 0) {
+                            continue;
+                        }
+                        size_t droppedBegin, droppedEnd;
+                        hnsw.neighbor_range(dropped, level, &droppedBegin, &droppedEnd);
+                        for (size_t k = droppedBegin; k < droppedEnd && hnsw.neighbors[k] >= 0; k++) {
+                            const storage_idx_t candidate = newIds[hnsw.neighbors[k]];
+                            if (candidate >= 0 && candidate != newId
+                                && std::find(out, out + count, candidate) == out + count
+                                && std::find(candidates.begin(), candidates.end(), candidate) == candidates.end()) {
+                                candidates.push_back(candidate);
+                            }
+                        }
+                    }
+
+                    const size_t freeSlots = capacity - count;
+                    if (candidates.size() > freeSlots) {
+                        if (!queryIsSet) {
+                            query.setVertex(newId);
+                            queryIsSet = true;
+                        }
+                        faiss::DistanceComputer &distances = distancesOf(query);
+                        closest.clear();
+                        for (storage_idx_t candidate : candidates) {
+                            closest.emplace_back(distances(candidate), candidate);
+                        }
+                        std::partial_sort(closest.begin(), closest.begin() + freeSlots, closest.end());
+                        for (size_t k = 0; k < freeSlots; k++) {
+                            candidates[k] = closest[k].second;
+                        }
+                        candidates.resize(freeSlots);
+                    }
+                    std::copy(candidates.begin(), candidates.end(), out + count);
+                }
+            }
+        }
+
+        // The entry point is kept unless it was dropped, then it moves to a vertex of the highest level left
+        if (hnsw.entry_point >= 0 && newIds[hnsw.entry_point] >= 0) {
+            hnsw.entry_point = newIds[hnsw.entry_point];
+        } else {
+            hnsw.entry_point = -1;
+            hnsw.max_level = -1;
+            for (size_t i = 0; i < levels.size(); i++) {
+                if (levels[i] - 1 > hnsw.max_level) {
+                    hnsw.max_level = levels[i] - 1;
+                    hnsw.entry_point = i;
+                }
+            }
+        }
+
+        hnsw.levels = std::move(levels);
+        hnsw.offsets = std::move(offsets);
+        hnsw.neighbors.resize(neighbors.size());
+        std::copy(neighbors.begin(), neighbors.end(), hnsw.neighbors.data());
+    }
+
+    // Vertices the search cannot reach any more, as it ends at level 0 with every vertex on it
+    std::vector<storage_idx_t> unreachableVertices(const faiss::HNSW &hnsw, size_t ntotal) {
+        std::vector<storage_idx_t> unreachable;
+        if (hnsw.entry_point < 0) {
+            return unreachable;
+        }
+        std::vector<bool> reached(ntotal, false);
+        std::vector<storage_idx_t> stack {hnsw.entry_point};
+        reached[hnsw.entry_point] = true;
+        while (!stack.empty()) {
+            const storage_idx_t vertex = stack.back();
+            stack.pop_back();
+            size_t begin, end;
+            hnsw.neighbor_range(vertex, 0, &begin, &end);
+            for (size_t j = begin; j < end && hnsw.neighbors[j] >= 0; j++) {
+                if (!reached[hnsw.neighbors[j]]) {
+                    reached[hnsw.neighbors[j]] = true;
+                    stack.push_back(hnsw.neighbors[j]);
+                }
+            }
+        }
+        for (size_t i = 0; i < ntotal; i++) {
+            if (!reached[i]) {
+                unreachable.push_back(i);
+            }
+        }
+        return unreachable;
+    }
+
+    // Link vertices into the graph again, from scratch, the way faiss links the vertices it adds
+    template <typename GRAPH>
+    void relinkVertices(GRAPH &graph, const std::vector<storage_idx_t> &vertices, size_t ntotal) {
+        faiss::HNSW &hnsw = graph.hnsw();
+        for (storage_idx_t vertex : vertices) {
+            for (int level = 0; level < hnsw.levels[vertex]; level++) {
+                size_t begin, end;
+                hnsw.neighbor_range(vertex, level, &begin, &end);
+                std::fill(hnsw.neighbors.data() + begin, hnsw.neighbors.data() + end, -1);
+            }
+        }
+
+        std::vector<omp_lock_t> locks(ntotal);
+        for (auto &lock : locks) {
+            omp_init_lock(&lock);
+        }
+#pragma omp parallel if (vertices.size() > 100)
+        {
+            faiss::VisitedTable visited(ntotal);
+            auto query = graph.query();
+#pragma omp for schedule(dynamic)
+            for (size_t i = 0; i < vertices.size(); i++) {
+                query.setVertex(vertices[i]);
+                hnsw.add_with_locks(distancesOf(query), hnsw.levels[vertices[i]] - 1, vertices[i], locks, visited,
+                                    graph.keepMaxSizeLevel0());
+            }
+        }
+        for (auto &lock : locks) {
+            omp_destroy_lock(&lock);
+        }
+    }
+
+    template <typename IDMAP, typename GRAPH>
+    void remapGraph(IDMAP *idMap, GRAPH &graph, const int32_t *docMap, size_t docMapSize) {
+        const size_t ntotal = idMap->ntotal;
+        std::vector<storage_idx_t> newIds(ntotal);
+        std::vector<faiss::idx_t> labels;
+        labels.reserve(ntotal);
+        for (size_t i = 0; i < ntotal; i++) {
+            const faiss::idx_t label = idMap->id_map[i];
+            if (label < 0 || static_cast<size_t>(label) >= docMapSize) {
+                throw std::runtime_error("Label " + std::to_string(label) + " is missing from the doc map of "
+                                         + std::to_string(docMapSize) + " docs");
+            }
+            if (docMap[label] >= 0) {
+                newIds[i] = labels.size();
+                labels.push_back(docMap[label]);
+            } else {
+                newIds[i] = -1;
+            }
+        }
+
+        const size_t numKept = labels.size();
+        idMap->id_map = std::move(labels);
+        idMap->ntotal = numKept;
+        if (numKept == ntotal) {
+            return;
+        }
+
+        compactCodes(graph, newIds, numKept);
+        compactNeighbors(graph, newIds, numKept);
+        const std::vector<storage_idx_t> unreachable = unreachableVertices(graph.hnsw(), numKept);
+        if (!unreachable.empty()) {
+            relinkVertices(graph, unreachable, numKept);
+        }
+    }
+}
+
+bool knn_jni::faiss_wrapper::supportsGraphReuse(const faiss::Index *index) {
+    auto *hnswIndex = dynamic_cast<const faiss::IndexHNSW *>(index);
+    return hnswIndex != nullptr && dynamic_cast<const faiss::IndexFlatCodes *>(hnswIndex->storage) != nullptr;
+}
+
+bool knn_jni::faiss_wrapper::supportsGraphReuse(const faiss::IndexBinary *index) {
+    auto *hnswIndex = dynamic_cast<const faiss::IndexBinaryHNSW *>(index);
+    return hnswIndex != nullptr && dynamic_cast<const faiss::IndexBinaryFlat *>(hnswIndex->storage) != nullptr;
+}
+
+void knn_jni::faiss_wrapper::remapGraphIndex(faiss::IndexIDMap *idMap, const int32_t *docMap, size_t docMapSize) {
+    if (idMap == nullptr || !supportsGraphReuse(idMap->index)) {
+        throw std::runtime_error("Only the graph of an HNSW index over flat codes can be remapped");
+    }
+    auto *hnswIndex = dynamic_cast<faiss::IndexHNSW *>(idMap->index);
+    FloatGraph graph(*hnswIndex, *dynamic_cast<faiss::IndexFlatCodes *>(hnswIndex->storage));
+    remapGraph(idMap, graph, docMap, docMapSize);
+}
+
+void knn_jni::faiss_wrapper::remapGraphIndex(faiss::IndexBinaryIDMap *idMap, const int32_t *docMap,
+                                             size_t docMapSize) {
+    if (idMap == nullptr || !supportsGraphReuse(idMap->index)) {
+        throw std::runtime_error("Only the graph of an HNSW index over flat codes can be remapped");
+    }
+    auto *hnswIndex = dynamic_cast<faiss::IndexBinaryHNSW *>(idMap->index);
+    BinaryGraph graph(*hnswIndex, *dynamic_cast<faiss::IndexBinaryFlat *>(hnswIndex->storage));
+    remapGraph(idMap, graph, docMap, docMapSize);
+}
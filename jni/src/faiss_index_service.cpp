@@ -9,6 +9,8 @@
 
 #include "faiss_index_service.h"
 #include "faiss_methods.h"
+#include "faiss_index_int8.h"
+#include "faiss_index_memory.h"
 #include "faiss/Index.h"
 #include "faiss/IndexBinary.h"
 #include "faiss/IndexHNSW.h"
@@ -53,19 +55,34 @@ void SetExtraParameters(knn_jni::JNIUtilInterface * jniUtil, JNIEnv *env,
     }
 }
 
+// Write the index and free it. When the index goes to IndexOutput, Faiss serializes it on a background thread while
+// this thread, the one allowed to call into Java, hands the bytes over to IndexOutput. The index is then freed as soon
+// as Faiss is done walking it, rather than once its last bytes reached IndexOutput.
+template<typename INDEX, typename WRITE>
+void WriteAndFreeIndex(faiss::IOWriter* writer, std::unique_ptr<INDEX>& index, WRITE write) {
+    auto openSearchIOWriter = dynamic_cast<knn_jni::stream::FaissOpenSearchIOWriter*>(writer);
+    if (openSearchIOWriter == nullptr) {
+        write(index.get(), writer);
+        return;
+    }
+
+    knn_jni::stream::writeInBackground(openSearchIOWriter, [&index, &write](faiss::IOWriter* ringWriter) {
+        write(index.get(), ringWriter);
+        index.reset();
+    });
+    openSearchIOWriter->flush();
+}
+
 IndexService::IndexService(std::unique_ptr<FaissMethods> _faissMethods) : faissMethods(std::move(_faissMethods)) {}
 
 void IndexService::allocIndex(faiss::Index * index, size_t dim, size_t numVectors) {
-    if (auto * indexHNSWSQ = dynamic_cast<faiss::IndexHNSWSQ *>(index)) {
-        if (auto * indexScalarQuantizer = dynamic_cast<faiss::IndexScalarQuantizer *>(indexHNSWSQ->storage)) {
-            indexScalarQuantizer->codes.owned_data.reserve(indexScalarQuantizer->code_size * numVectors);
-        }
-    }
-    if (auto * indexHNSW = dynamic_cast<faiss::IndexHNSW *>(index)) {
-        if(auto * indexFlat = dynamic_cast<faiss::IndexFlat *>(indexHNSW->storage)) {
-            indexFlat->codes.owned_data.reserve(indexFlat->code_size * numVectors);
-        }
-    }
+    reserveIndexMemory(index, numVectors);
+}
+
+size_t IndexService::estimateIndexMemory(faiss::MetricType metric, std::string indexDescription, int dim, size_t numVectors) {
+    std::unique_ptr<faiss::Index> index(faissMethods->indexFactory(dim, indexDescription.c_str(), metric));
+    // Every index is wrapped in an IDMap holding the labels
+    return numVectors * sizeof(faiss::idx_t) + knn_jni::faiss_wrapper::estimateIndexMemory(index.get(), numVectors);
 }
 
 jlong IndexService::initIndex(
@@ -98,7 +115,7 @@ jlong IndexService::initIndex(
     //Makes sure the index is deleted when the destructor is called, this cannot be passed in the constructor
     idMap->own_fields = true;
 
-    allocIndex(dynamic_cast<faiss::Index *>(idMap->index), dim, numVectors);
+    allocIndex(idMap.get(), dim, numVectors);
 
     //Release the ownership so as to make sure not delete the underlying index that is created. The index is needed later
     //in insert and write operations
@@ -146,10 +163,9 @@ void IndexService::writeIndex(
 
     try {
         // Write the index to disk
-        faissMethods->writeIndex(idMap.get(), writer);
-        if (auto openSearchIOWriter = dynamic_cast<knn_jni::stream::FaissOpenSearchIOWriter*>(writer)) {
-            openSearchIOWriter->flush();
-        }
+        WriteAndFreeIndex(writer, idMap, [this](const faiss::IndexIDMap* index, faiss::IOWriter* indexWriter) {
+            faissMethods->writeIndex(index, indexWriter);
+        });
     } catch(std::exception &e) {
         throw std::runtime_error("Failed to write index to disk");
     }
@@ -159,11 +175,10 @@ BinaryIndexService::BinaryIndexService(std::unique_ptr<FaissMethods> _faissMetho
   : IndexService(std::move(_faissMethods)) {
 }
 
-void BinaryIndexService::allocIndex(faiss::Index * index, size_t dim, size_t numVectors) {
-    if (auto * indexBinaryHNSW = dynamic_cast<faiss::IndexBinaryHNSW *>(index)) {
-        auto * indexBinaryFlat = dynamic_cast<faiss::IndexBinaryFlat *>(indexBinaryHNSW->storage);
-        indexBinaryFlat->xb.owned_data.reserve(dim * numVectors / 8);
-    }
+size_t BinaryIndexService::estimateIndexMemory(faiss::MetricType metric, std::string indexDescription, int dim, size_t numVectors) {
+    std::unique_ptr<faiss::IndexBinary> index(faissMethods->indexBinaryFactory(dim, indexDescription.c_str()));
+    // Every index is wrapped in an IDMap holding the labels
+    return numVectors * sizeof(faiss::idx_t) + knn_jni::faiss_wrapper::estimateIndexMemory(index.get(), numVectors);
 }
 
 jlong BinaryIndexService::initIndex(
@@ -195,7 +210,7 @@ jlong BinaryIndexService::initIndex(
     //Makes sure the index is deleted when the destructor is called
     idMap->own_fields = true;
 
-    allocIndex(dynamic_cast<faiss::Index *>(idMap->index), dim, numVectors);
+    reserveIndexMemory(idMap.get(), numVectors);
 
     //Release the ownership so as to make sure not delete the underlying index that is created. The index is needed later
     //in insert and write operations
@@ -243,10 +258,9 @@ void BinaryIndexService::writeIndex(
 
     try {
         // Write the index to disk
-        faissMethods->writeIndexBinary(idMap.get(), writer);
-        if (auto openSearchIOWriter = dynamic_cast<knn_jni::stream::FaissOpenSearchIOWriter*>(writer)) {
-            openSearchIOWriter->flush();
-        }
+        WriteAndFreeIndex(writer, idMap, [this](const faiss::IndexBinaryIDMap* index, faiss::IOWriter* indexWriter) {
+            faissMethods->writeIndexBinary(index, indexWriter);
+        });
     } catch(std::exception &e) {
         throw std::runtime_error("Failed to write index to disk");
     }
@@ -256,14 +270,6 @@ ByteIndexService::ByteIndexService(std::unique_ptr<FaissMethods> _faissMethods)
   : IndexService(std::move(_faissMethods)) {
 }
 
-void ByteIndexService::allocIndex(faiss::Index * index, size_t dim, size_t numVectors) {
-    if (auto * indexHNSWSQ = dynamic_cast<faiss::IndexHNSWSQ *>(index)) {
-        if(auto * indexScalarQuantizer = dynamic_cast<faiss::IndexScalarQuantizer *>(indexHNSWSQ->storage)) {
-            indexScalarQuantizer->codes.owned_data.reserve(indexScalarQuantizer->code_size * numVectors);
-        }
-    }
-}
-
 jlong ByteIndexService::initIndex(
         knn_jni::JNIUtilInterface * jniUtil,
         JNIEnv * env,
@@ -294,7 +300,7 @@ jlong ByteIndexService::initIndex(
     //Makes sure the index is deleted when the destructor is called, this cannot be passed in the constructor
     idMap->own_fields = true;
 
-    allocIndex(dynamic_cast<faiss::Index *>(idMap->index), dim, numVectors);
+    allocIndex(idMap.get(), dim, numVectors);
 
     //Release the ownership so as to make sure not delete the underlying index that is created. The index is needed later
     //in insert and write operations
@@ -330,6 +336,14 @@ void ByteIndexService::insertToIndex(
 
     faiss::IndexIDMap * idMap = reinterpret_cast<faiss::IndexIDMap *> (idMapAddress);
 
+    // Indexes storing int8 codes directly take the vectors as they are
+    if (knn_jni::faiss_wrapper::supportsInt8Add(idMap->index)) {
+        knn_jni::faiss_wrapper::addInt8Vectors(idMap->index, numVectors, inputVectors->data());
+        idMap->id_map.insert(idMap->id_map.end(), ids.begin(), ids.begin() + numVectors);
+        idMap->ntotal = idMap->index->ntotal;
+        return;
+    }
+
     // Add vectors in batches by casting int8 vectors into float with a batch size of 1000 to avoid additional memory spike.
     // Refer to this github issue for more details https://github.com/opensearch-project/k-NN/issues/1659#issuecomment-2307390255
     int batchSize = 1000;
@@ -360,10 +374,9 @@ void ByteIndexService::writeIndex(
 
     try {
         // Write the index to disk
-        faissMethods->writeIndex(idMap.get(), writer);
-        if (auto openSearchIOWriter = dynamic_cast<knn_jni::stream::FaissOpenSearchIOWriter*>(writer)) {
-            openSearchIOWriter->flush();
-        }
+        WriteAndFreeIndex(writer, idMap, [this](const faiss::IndexIDMap* index, faiss::IOWriter* indexWriter) {
+            faissMethods->writeIndex(index, indexWriter);
+        });
     } catch(std::exception &e) {
         throw std::runtime_error("Failed to write index to disk");
     }
@@ -0,0 +1,115 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * The OpenSearch Contributors require contributions made to
+ * this file be licensed under the Apache-2.0 license or a
+ * compatible open source license.
+ *
+ * Modifications Copyright OpenSearch Contributors. See
+ * GitHub history for details.
+ */
+
+#include "faiss_training_sample.h"
+
+#include "faiss/IndexBinaryHNSW.h"
+#include "faiss/IndexBinaryIVF.h"
+#include "faiss/IndexHNSW.h"
+#include "faiss/IndexIVF.h"
+#include "faiss/IndexIVFPQ.h"
+#include "faiss/IndexPQ.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace {
+    // Other encoders, like the scalar quantizers, only learn value ranges, which the sample of an 8 bit product
+    // quantizer pins down just as well
+    constexpr size_t DEFAULT_TRAINING_SAMPLE_SIZE = 256 * 256;
+
+    size_t productQuantizerSampleSize(const faiss::ProductQuantizer &pq) {
+        return pq.ksub * pq.cp.max_points_per_centroid;
+    }
+}
+
+size_t knn_jni::faiss_wrapper::trainingSampleSize(const faiss::Index *index) {
+    if (index == nullptr || index->is_trained) {
+        return 0;
+    }
+    if (auto *hnswIndex = dynamic_cast<const faiss::IndexHNSW *>(index)) {
+        return trainingSampleSize(hnswIndex->storage);
+    }
+    if (auto *pqIndex = dynamic_cast<const faiss::IndexPQ *>(index)) {
+        return productQuantizerSampleSize(pqIndex->pq);
+    }
+    if (auto *ivfIndex = dynamic_cast<const faiss::IndexIVF *>(index)) {
+        size_t sampleSize = ivfIndex->nlist * ivfIndex->cp.max_points_per_centroid;
+        if (auto *ivfPqIndex = dynamic_cast<const faiss::IndexIVFPQ *>(index)) {
+            sampleSize = std::max(sampleSize, productQuantizerSampleSize(ivfPqIndex->pq));
+        }
+        return sampleSize;
+    }
+    return DEFAULT_TRAINING_SAMPLE_SIZE;
+}
+
+size_t knn_jni::faiss_wrapper::trainingSampleSize(const faiss::IndexBinary *index) {
+    if (index == nullptr || index->is_trained) {
+        return 0;
+    }
+    if (auto *hnswIndex = dynamic_cast<const faiss::IndexBinaryHNSW *>(index)) {
+        return trainingSampleSize(hnswIndex->storage);
+    }
+    if (auto *ivfIndex = dynamic_cast<const faiss::IndexBinaryIVF *>(index)) {
+        return ivfIndex->nlist * ivfIndex->cp.max_points_per_centroid;
+    }
+    return 0;
+}
+
+knn_jni::faiss_wrapper::VectorReservoir::VectorReservoir(size_t codeSize, size_t capacity, uint64_t seed)
+        : codeSize(codeSize), maxSampled(capacity), generator(seed) {
+}
+
+double knn_jni::faiss_wrapper::VectorReservoir::randomUniform() {
+    // In (0, 1], so its logarithm is finite
+    return 1.0 - std::uniform_real_distribution<double>(0.0, 1.0)(generator);
+}
+
+void knn_jni::faiss_wrapper::VectorReservoir::drawNextSampled() {
+    weight *= std::exp(std::log(randomUniform()) / maxSampled);
+    const double skip = std::floor(std::log(randomUniform()) / std::log1p(-weight));
+    if (!(skip < static_cast<double>(std::numeric_limits<size_t>::max() - nextSampled - 1))) {
+        nextSampled = std::numeric_limits<size_t>::max();
+        return;
+    }
+    nextSampled += static_cast<size_t>(skip) + 1;
+}
+
+void knn_jni::faiss_wrapper::VectorReservoir::add(const uint8_t *vectors, size_t n) {
+    if (maxSampled == 0) {
+        total += n;
+        return;
+    }
+
+    // Fill the sample with the first vectors of the stream
+    const size_t filled = std::min(n, maxSampled - sampled);
+    if (filled > 0) {
+        codes.insert(codes.end(), vectors, vectors + filled * codeSize);
+        sampled += filled;
+        total += filled;
+        if (sampled == maxSampled) {
+            weight = 1.0;
+            nextSampled = total - 1;
+            drawNextSampled();
+        }
+    }
+
+    // Then only visit the vectors that replace a sampled one
+    const size_t end = total + (n - filled);
+    while (nextSampled < end) {
+        const size_t slot = std::uniform_int_distribution<size_t>(0, maxSampled - 1)(generator);
+        std::memcpy(codes.data() + slot * codeSize, vectors + (nextSampled - total + filled) * codeSize, codeSize);
+        drawNextSampled();
+    }
+    total = end;
+}
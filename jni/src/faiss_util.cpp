@@ -9,15 +9,304 @@
 
 #include "faiss_util.h"
 #include <algorithm>
+#include <cstring>
+#include <limits>
 
 std::unique_ptr<faiss::IDGrouperBitmap> faiss_util::buildIDGrouperBitmap(int *parentIdsArray,  int parentIdsLength, std::vector<uint64_t>* bitmap) {
     const int* maxValue = std::max_element(parentIdsArray, parentIdsArray + parentIdsLength);
     int num_bits = *maxValue + 1;
     int num_blocks = (num_bits >> 6) + 1; // div by 64
-    bitmap->resize(num_blocks, 0);
+    // The bitmap may be a reused buffer, so every block is cleared rather than only the new ones
+    bitmap->assign(num_blocks, 0);
     std::unique_ptr<faiss::IDGrouperBitmap> idGrouper(new faiss::IDGrouperBitmap(num_blocks, bitmap->data()));
     for (int i = 0; i < parentIdsLength; i++) {
         idGrouper->set_group(parentIdsArray[i]);
     }
     return idGrouper;
 }
+
+bool faiss_util::IDSelectorSortedArray::is_member(faiss::idx_t id) const {
+    if (n == 0 || id < ids[0] || id > ids[n - 1]) {
+        return false;
+    }
+    const int64_t first = ids[0];
+    const int64_t last = ids[n - 1];
+    size_t guess = 0;
+    if (last > first) {
+        guess = std::min(n - 1, static_cast<size_t>(static_cast<double>(id - first) / (last - first) * (n - 1)));
+    }
+    if (ids[guess] == id) {
+        return true;
+    }
+    if (ids[guess] < id) {
+        // Gallop right until ids[probe] >= id, ids[n - 1] >= id bounds the search
+        size_t previous = guess;
+        size_t step = 1;
+        size_t probe = guess + 1;
+        while (probe < n - 1 && ids[probe] < id) {
+            previous = probe;
+            step <<= 1;
+            probe = guess + step;
+        }
+        probe = std::min(probe, n - 1);
+        return std::binary_search(ids + previous + 1, ids + probe + 1, id);
+    }
+    // Gallop left until ids[probe] <= id, ids[0] <= id bounds the search
+    size_t previous = guess;
+    size_t step = 1;
+    size_t probe = guess - 1;
+    while (probe > 0 && ids[probe] > id) {
+        previous = probe;
+        step <<= 1;
+        probe = guess > step ? guess - step : 0;
+    }
+    return std::binary_search(ids + probe, ids + previous, id);
+}
+
+bool faiss_util::IDSelectorRanges::is_member(faiss::idx_t id) const {
+    // Find the last range beginning at or before id
+    size_t low = 0;
+    size_t high = numRanges;
+    while (low < high) {
+        const size_t mid = low + (high - low) / 2;
+        if (ranges[2 * mid] <= id) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low > 0 && id < ranges[2 * (low - 1) + 1];
+}
+
+faiss_util::IDSelectorRoaring::IDSelectorRoaring(size_t n, const int64_t *sortedIds) : firstChunk(0) {
+    constexpr size_t bitmapBytes = (1 << 16) / 8;
+    if (n == 0) {
+        return;
+    }
+    firstChunk = sortedIds[0] >> 16;
+    containers.assign((sortedIds[n - 1] >> 16) - firstChunk + 1, Container {EMPTY, 0, 0});
+
+    size_t begin = 0;
+    while (begin < n) {
+        const int64_t chunk = sortedIds[begin] >> 16;
+        size_t end = begin;
+        size_t cardinality = 0;
+        size_t runs = 0;
+        for (; end < n && (sortedIds[end] >> 16) == chunk; end++) {
+            if (end > begin && sortedIds[end] == sortedIds[end - 1]) {
+                continue;
+            }
+            cardinality++;
+            if (end == begin || sortedIds[end] != sortedIds[end - 1] + 1) {
+                runs++;
+            }
+        }
+
+        Container &container = containers[chunk - firstChunk];
+        const size_t arrayBytes = cardinality * sizeof(uint16_t);
+        if (runs * 2 * sizeof(uint16_t) <= std::min(arrayBytes, bitmapBytes)) {
+            container = {RUNS, static_cast<uint32_t>(lows.size()), static_cast<uint32_t>(runs)};
+            for (size_t i = begin; i < end; i++) {
+                if (i == begin || sortedIds[i] > sortedIds[i - 1] + 1) {
+                    lows.push_back(static_cast<uint16_t>(sortedIds[i]));
+                    lows.push_back(static_cast<uint16_t>(sortedIds[i]));
+                } else {
+                    lows.back() = static_cast<uint16_t>(sortedIds[i]);
+                }
+            }
+        } else if (arrayBytes <= bitmapBytes) {
+            container = {ARRAY, static_cast<uint32_t>(lows.size()), static_cast<uint32_t>(cardinality)};
+            for (size_t i = begin; i < end; i++) {
+                if (i == begin || sortedIds[i] != sortedIds[i - 1]) {
+                    lows.push_back(static_cast<uint16_t>(sortedIds[i]));
+                }
+            }
+        } else {
+            container = {BITMAP, static_cast<uint32_t>(words.size()), 0};
+            words.resize(words.size() + bitmapBytes / sizeof(uint64_t), 0);
+            uint64_t *bitmap = words.data() + container.offset;
+            for (size_t i = begin; i < end; i++) {
+                const uint16_t low = static_cast<uint16_t>(sortedIds[i]);
+                bitmap[low >> 6] |= 1ULL << (low & 63);
+            }
+        }
+        begin = end;
+    }
+}
+
+bool faiss_util::IDSelectorRoaring::is_member(faiss::idx_t id) const {
+    if (id < 0) {
+        return false;
+    }
+    const int64_t chunk = (id >> 16) - firstChunk;
+    if (chunk < 0 || chunk >= static_cast<int64_t>(containers.size())) {
+        return false;
+    }
+    const Container &container = containers[chunk];
+    const uint16_t low = static_cast<uint16_t>(id);
+    switch (container.type) {
+        case ARRAY: {
+            const uint16_t *array = lows.data() + container.offset;
+            return std::binary_search(array, array + container.size, low);
+        }
+        case BITMAP:
+            return (words[container.offset + (low >> 6)] >> (low & 63)) & 1ULL;
+        case RUNS: {
+            // Runs are pairs of first and last low bits, find the last run starting at or before low
+            const uint16_t *runs = lows.data() + container.offset;
+            size_t begin = 0;
+            size_t end = container.size;
+            while (begin < end) {
+                const size_t mid = begin + (end - begin) / 2;
+                if (runs[2 * mid] <= low) {
+                    begin = mid + 1;
+                } else {
+                    end = mid;
+                }
+            }
+            return begin > 0 && low <= runs[2 * (begin - 1) + 1];
+        }
+        default:
+            return false;
+    }
+}
+
+faiss_util::IdsSelectorKind faiss_util::chooseIdsSelector(const int64_t *ids, size_t n) {
+    if ((n > 0 && ids[0] < 0) || !std::is_sorted(ids, ids + n)) {
+        return IdsSelectorKind::UNSORTED;
+    }
+    if (n <= SORTED_ARRAY_SELECTOR_MAX_IDS) {
+        return IdsSelectorKind::SORTED_ARRAY;
+    }
+    return IdsSelectorKind::ROARING;
+}
+
+bool faiss_util::isExactSearchPreferred(int64_t filterCardinality, int64_t ntotal, int k, int efSearch) {
+    if (filterCardinality <= k) {
+        return true;
+    }
+    return filterCardinality * filterCardinality <= static_cast<int64_t>(std::max(k, efSearch)) * ntotal;
+}
+
+int faiss_util::chooseQueryParallelism(int requestedParallelism, int64_t work, int64_t minWorkPerTask) {
+    if (requestedParallelism <= 1 || work <= 0) {
+        return 1;
+    }
+    const int64_t maxTasks = std::max<int64_t>(1, work / std::max<int64_t>(1, minWorkPerTask));
+    return static_cast<int>(std::min<int64_t>(requestedParallelism, maxTasks));
+}
+
+faiss_util::BoundedRangeResultHandler::BoundedRangeResultHandler(float radius, size_t maxResults, RangeResultMode mode,
+                                                                  const faiss::IDGrouper *grouper)
+    : maxResults(maxResults), mode(mode), grouper(grouper), hits(0) {
+    threshold = maxResults == 0 && mode != RangeResultMode::COUNT ? std::numeric_limits<float>::lowest() : radius;
+}
+
+bool faiss_util::BoundedRangeResultHandler::add_result(float distance, int64_t id) {
+    if (!(distance < threshold)) {
+        return false;
+    }
+    if (grouper != nullptr) {
+        return addGroupedResult(distance, id);
+    }
+    hits++;
+    switch (mode) {
+        case RangeResultMode::COUNT:
+            return false;
+        default:
+            if (kept.size() == maxResults) {
+                std::pop_heap(kept.begin(), kept.end());
+                kept.back() = {distance, id};
+            } else {
+                kept.emplace_back(distance, id);
+            }
+            std::push_heap(kept.begin(), kept.end());
+            if (kept.size() == maxResults) {
+                threshold = kept.front().first;
+            }
+            return true;
+    }
+}
+
+bool faiss_util::BoundedRangeResultHandler::addGroupedResult(float distance, int64_t id) {
+    const int64_t group = grouper->get_group(id);
+    auto slot = groupSlots.find(group);
+    if (slot != groupSlots.end()) {
+        if (mode == RangeResultMode::COUNT || !(distance < kept[slot->second].first)) {
+            return false;
+        }
+        kept[slot->second] = {distance, id};
+        return true;
+    }
+
+    hits++;
+    if (mode == RangeResultMode::COUNT) {
+        groupSlots.emplace(group, 0);
+        return false;
+    }
+    groupSlots.emplace(group, kept.size());
+    kept.emplace_back(distance, id);
+    if (kept.size() == 2 * maxResults) {
+        // Groups past the best maxResults can only come back with a hit under the new threshold, which then competes
+        // with the kept ones like a new group
+        std::nth_element(kept.begin(), kept.begin() + (maxResults - 1), kept.end());
+        kept.resize(maxResults);
+        threshold = kept.back().first;
+        groupSlots.clear();
+        for (size_t i = 0; i < kept.size(); i++) {
+            groupSlots.emplace(grouper->get_group(kept[i].second), i);
+        }
+    }
+    return true;
+}
+
+size_t faiss_util::BoundedRangeResultHandler::count() const {
+    return hits;
+}
+
+size_t faiss_util::BoundedRangeResultHandler::finish(std::vector<float> *distances, std::vector<int64_t> *ids) {
+    std::sort(kept.begin(), kept.end());
+    if (kept.size() > maxResults) {
+        kept.resize(maxResults);
+    }
+    distances->resize(kept.size());
+    ids->resize(kept.size());
+    for (size_t i = 0; i < kept.size(); i++) {
+        (*distances)[i] = kept[i].first;
+        (*ids)[i] = kept[i].second;
+    }
+    const size_t resultSize = kept.size();
+    kept.clear();
+    groupSlots.clear();
+    return resultSize;
+}
+
+constexpr uint64_t FINGERPRINT_MULTIPLIER = 0x9E3779B97F4A7C15ULL;
+
+uint64_t faiss_util::fingerprint(const uint8_t *data, size_t length) {
+    Fingerprinter fingerprinter(length);
+    fingerprinter.update(data, length);
+    return fingerprinter.finish();
+}
+
+faiss_util::Fingerprinter::Fingerprinter(size_t length) : hash(length * FINGERPRINT_MULTIPLIER) {
+}
+
+void faiss_util::Fingerprinter::update(const uint8_t *data, size_t length) {
+    size_t i = 0;
+    for (; i + sizeof(uint64_t) <= length; i += sizeof(uint64_t)) {
+        uint64_t word;
+        std::memcpy(&word, data + i, sizeof(uint64_t));
+        hash = (hash ^ word) * FINGERPRINT_MULTIPLIER;
+        hash ^= hash >> 29;
+    }
+    if (i < length) {
+        uint64_t tail = 0;
+        std::memcpy(&tail, data + i, length - i);
+        hash = (hash ^ tail) * FINGERPRINT_MULTIPLIER;
+    }
+}
+
+uint64_t faiss_util::Fingerprinter::finish() const {
+    return hash ^ (hash >> 32);
+}
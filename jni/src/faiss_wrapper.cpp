@@ -15,27 +15,48 @@
 #include "faiss_index_service.h"
 #include "faiss_stream_support.h"
 #include "faiss_index_bq.h"
+#include "faiss_index_int8.h"
+#include "faiss_index_memory.h"
+#include "faiss_index_merge.h"
+#include "faiss_training_sample.h"
+#include "native_thread_pool.h"
 
 #include "faiss/impl/io.h"
 #include "faiss/index_factory.h"
 #include "faiss/index_io.h"
+#include "faiss/clone_index.h"
+#include "faiss/impl/FaissException.h"
 #include "faiss/IndexHNSW.h"
+#include "faiss/IndexIDMap.h"
 #include "faiss/IndexIVFFlat.h"
 #include "faiss/Index.h"
 #include "faiss/impl/IDSelector.h"
+#include "faiss/impl/DistanceComputer.h"
+#include "faiss/utils/Heap.h"
+#include "faiss/utils/distances.h"
+#include "faiss/utils/random.h"
+#include "faiss/IndexFlat.h"
 #include "faiss/IndexIVFPQ.h"
 #include "commons.h"
 #include "faiss/IndexBinaryIVF.h"
 #include "faiss/IndexBinaryHNSW.h"
 
 #include <algorithm>
+#include <cmath>
+#include <condition_variable>
+#include <exception>
 #include <jni.h>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 // Defines type of IDSelector
 enum FilterIdsSelectorType{
-    BITMAP = 0, BATCH = 1,
+    BITMAP = 0, BATCH = 1, RANGES = 2,
 };
 namespace faiss {
 
@@ -67,6 +88,350 @@ struct IDSelectorJlongBitmap : IDSelector {
 
 }  // namespace faiss
 
+// Buffers of the query path kept per search thread. The buffers only grow, so once a thread has served its largest
+// query the following ones reuse the memory instead of going through the allocator.
+struct SearchScratch {
+    std::vector<float> dis;
+    std::vector<int32_t> binaryDis;
+    std::vector<float> convertedDis;
+    std::vector<faiss::idx_t> ids;
+    std::vector<jint> resultIds;
+    std::vector<float> query;
+    std::vector<jlong> filterIds;
+    std::vector<jint> parentIds;
+};
+
+// Returns the scratch buffers of the calling thread
+SearchScratch &GetSearchScratch();
+
+// Parent grouper of a nested field, along with the number of parents and a fingerprint of all the parent ids it was
+// built from, to tell whether it matches the parent ids of a query.
+struct CachedIDGrouper {
+    int parentIdsLength;
+    uint64_t parentIdsFingerprint;
+    std::vector<uint64_t> bitmap;
+    std::unique_ptr<faiss::IDGrouperBitmap> grouper;
+};
+
+// Query queued on the native search thread pool. Pool threads cannot read Java arrays, so the query and filter are
+// copied when the task is submitted. The Java handle and the pool job each hold a reference, so whichever is done last
+// frees the task.
+struct SearchTask {
+    jlong indexPointer;
+    std::vector<float> query;
+    std::vector<jlong> filterIds;
+    jint filterIdsType;
+    bool hasFilter;
+    knn_jni::commons::SearchParams searchParams;
+    std::shared_ptr<const CachedIDGrouper> idGrouper;
+    int k;
+    std::vector<float> dis;
+    std::vector<faiss::idx_t> ids;
+
+    std::mutex mutex;
+    std::condition_variable finished;
+    bool done = false;
+    std::exception_ptr error;
+
+    void waitUntilDone() {
+        std::unique_lock<std::mutex> lock(mutex);
+        finished.wait(lock, [this]() { return done; });
+    }
+};
+
+// Background thread adding batches of vectors to one index for the length of a build, while the caller prepares its
+// next batch. Batches are queued and added one at a time and in order, on the same thread every time so the OpenMP
+// team it sets up is reused across batches. The ids are copied when a batch is submitted, the vectors are read in place.
+struct InsertWorker {
+    std::unique_ptr<knn_jni::faiss_wrapper::IndexService> indexService;
+    jlong indexAddress;
+    int dimension;
+    int threadCount;
+    std::mutex mutex;
+    std::condition_variable batchFinished;
+    int64_t submittedBatches = 0;
+    int64_t finishedBatches = 0;
+    // First failed insert. Later batches are skipped and every wait rethrows it
+    std::exception_ptr error;
+    bool stopping = false;
+    // Declared last so the thread is joined before the state it uses is destroyed
+    knn_jni::NativeThreadPool thread{1};
+};
+
+// Training vectors gathered across calls for an index trained once all of them were seen. Only a uniform sample sized
+// to what training the index makes use of is kept, so memory stays bounded whatever the number of vectors.
+struct TrainingSession {
+    std::unique_ptr<faiss::Index> index;
+    std::unique_ptr<faiss::IndexBinary> binaryIndex;
+    bool byteVectors = false;
+    int dimension;
+    int threadCount;
+    std::unique_ptr<knn_jni::faiss_wrapper::VectorReservoir> reservoir;
+};
+
+// Seed of the training sample, fixed so training twice on the same vectors gives the same model
+constexpr uint64_t TRAINING_SAMPLE_SEED = 1234;
+
+// Filter of a single query. Bitmap, range and small sorted id filters are only views over the Java array, so they are
+// kept inline. Only larger id filters, which are converted to roaring containers, and unsorted ones, which need a hash
+// set of the ids, allocate.
+struct QueryFilter {
+    faiss::IDSelectorJlongBitmap bitmapSelector {0, nullptr};
+    faiss_util::IDSelectorRanges rangesSelector {0, nullptr};
+    faiss_util::IDSelectorSortedArray sortedArraySelector {0, nullptr};
+    std::unique_ptr<faiss::IDSelector> builtSelector;
+
+    faiss::IDSelector *build(const jlong *filteredIdsArray, int filterIdsLength, jint filterIdsTypeJ) {
+        if (filterIdsTypeJ == BITMAP) {
+            bitmapSelector.n = filterIdsLength;
+            bitmapSelector.bitmap = filteredIdsArray;
+            return &bitmapSelector;
+        }
+        const faiss::idx_t* batchIndices = reinterpret_cast<const faiss::idx_t*>(filteredIdsArray);
+        if (filterIdsTypeJ == RANGES) {
+            rangesSelector.numRanges = filterIdsLength / 2;
+            rangesSelector.ranges = batchIndices;
+            return &rangesSelector;
+        }
+        switch (faiss_util::chooseIdsSelector(batchIndices, filterIdsLength)) {
+            case faiss_util::IdsSelectorKind::SORTED_ARRAY:
+                sortedArraySelector.n = filterIdsLength;
+                sortedArraySelector.ids = batchIndices;
+                return &sortedArraySelector;
+            case faiss_util::IdsSelectorKind::ROARING:
+                builtSelector.reset(new faiss_util::IDSelectorRoaring(filterIdsLength, batchIndices));
+                return builtSelector.get();
+            default:
+                builtSelector.reset(new faiss::IDSelectorBatch(filterIdsLength, batchIndices));
+                return builtSelector.get();
+        }
+    }
+
+    // Number of docs selected by a filter
+    static int64_t cardinality(const jlong *filteredIdsArray, int filterIdsLength, jint filterIdsTypeJ) {
+        if (filterIdsTypeJ == BATCH) {
+            return filterIdsLength;
+        }
+        int64_t count = 0;
+        if (filterIdsTypeJ == RANGES) {
+            for (int i = 0; i + 1 < filterIdsLength; i += 2) {
+                count += filteredIdsArray[i + 1] - filteredIdsArray[i];
+            }
+            return count;
+        }
+        for (int i = 0; i < filterIdsLength; i++) {
+            count += __builtin_popcountll(static_cast<uint64_t>(filteredIdsArray[i]));
+        }
+        return count;
+    }
+
+    // Calls consumer with every doc selected by a filter
+    template <typename Consumer>
+    static void forEachId(const jlong *filteredIdsArray, int filterIdsLength, jint filterIdsTypeJ, Consumer consumer) {
+        if (filterIdsTypeJ == BATCH) {
+            for (int i = 0; i < filterIdsLength; i++) {
+                consumer(filteredIdsArray[i]);
+            }
+        } else if (filterIdsTypeJ == RANGES) {
+            for (int i = 0; i + 1 < filterIdsLength; i += 2) {
+                for (int64_t id = filteredIdsArray[i]; id < filteredIdsArray[i + 1]; id++) {
+                    consumer(id);
+                }
+            }
+        } else {
+            for (int i = 0; i < filterIdsLength; i++) {
+                uint64_t word = filteredIdsArray[i];
+                while (word != 0) {
+                    consumer((static_cast<int64_t>(i) << 6) + __builtin_ctzll(word));
+                    word &= word - 1;
+                }
+            }
+        }
+    }
+};
+
+// Scores a query against the vectors of an index storage by internal id. Flat L2 and inner product storages go
+// through the faiss by_idx kernels, which score a whole block of ids per call. Any other storage, like SQ, BQ or binary
+// codes, goes through its own distance computer.
+struct ExactScorer {
+    const float *query;
+    const faiss::IndexFlat *flatStorage;
+    std::unique_ptr<faiss::DistanceComputer> distanceComputer;
+
+    ExactScorer(const faiss::Index *storage, const float *query)
+        : query(query), flatStorage(dynamic_cast<const faiss::IndexFlat *>(storage)) {
+        if (flatStorage == nullptr
+            || (flatStorage->metric_type != faiss::METRIC_L2 && flatStorage->metric_type != faiss::METRIC_INNER_PRODUCT)) {
+            flatStorage = nullptr;
+            distanceComputer.reset(storage->get_distance_computer());
+            distanceComputer->set_query(query);
+        }
+    }
+
+    // Binary storages only come with a distance computer, which takes the query code in place of floats
+    ExactScorer(faiss::DistanceComputer *binaryDistanceComputer, const uint8_t *query)
+        : query(reinterpret_cast<const float *>(query)), flatStorage(nullptr), distanceComputer(binaryDistanceComputer) {
+        distanceComputer->set_query(this->query);
+    }
+
+    void score(const faiss::idx_t *internalIds, size_t n, float *distances) {
+        if (flatStorage != nullptr) {
+            if (flatStorage->metric_type == faiss::METRIC_INNER_PRODUCT) {
+                faiss::fvec_inner_products_by_idx(distances, query, flatStorage->get_xb(), internalIds, flatStorage->d, 1, n);
+            } else {
+                faiss::fvec_L2sqr_by_idx(distances, query, flatStorage->get_xb(), internalIds, flatStorage->d, 1, n);
+            }
+            return;
+        }
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4) {
+            distanceComputer->distances_batch_4(internalIds[i], internalIds[i + 1], internalIds[i + 2], internalIds[i + 3],
+                                                distances[i], distances[i + 1], distances[i + 2], distances[i + 3]);
+        }
+        for (; i < n; i++) {
+            distances[i] = (*distanceComputer)(internalIds[i]);
+        }
+    }
+};
+
+// Negates the distances of a similarity storage, so that smaller is better like for L2. Faiss does the same for the
+// HNSW graph search of inner product indexes.
+struct NegatedDistanceComputer : faiss::DistanceComputer {
+    std::unique_ptr<faiss::DistanceComputer> distanceComputer;
+
+    explicit NegatedDistanceComputer(faiss::DistanceComputer *distanceComputer)
+        : distanceComputer(distanceComputer) {}
+
+    void set_query(const float *x) override {
+        distanceComputer->set_query(x);
+    }
+
+    float operator()(faiss::idx_t i) override {
+        return -(*distanceComputer)(i);
+    }
+
+    void distances_batch_4(const faiss::idx_t idx0, const faiss::idx_t idx1, const faiss::idx_t idx2,
+                           const faiss::idx_t idx3, float &dis0, float &dis1, float &dis2, float &dis3) override {
+        distanceComputer->distances_batch_4(idx0, idx1, idx2, idx3, dis0, dis1, dis2, dis3);
+        dis0 = -dis0;
+        dis1 = -dis1;
+        dis2 = -dis2;
+        dis3 = -dis3;
+    }
+
+    float symmetric_dis(faiss::idx_t i, faiss::idx_t j) override {
+        return -distanceComputer->symmetric_dis(i, j);
+    }
+};
+
+// Feeds the hits of an HNSW search, which always ranks smaller first, into a k sized heap kept in the order of the index
+// metric. The heap may come seeded with the k-th best distance of earlier searches, which then bounds this one.
+template <typename C>
+struct HeapResultHandler : faiss::ResultHandler<faiss::CMax<float, faiss::idx_t>> {
+    bool negated;
+    int k;
+    float *dis;
+    faiss::idx_t *ids;
+
+    HeapResultHandler(bool negated, int k, float *dis, faiss::idx_t *ids)
+        : negated(negated), k(k), dis(dis), ids(ids) {
+        threshold = negated ? -dis[0] : dis[0];
+    }
+
+    bool add_result(float distance, faiss::idx_t id) override {
+        if (!(distance < threshold)) {
+            return false;
+        }
+        faiss::heap_replace_top<C>(k, dis, ids, negated ? -distance : distance, id);
+        threshold = negated ? -dis[0] : dis[0];
+        return true;
+    }
+};
+
+// Critical view over a primitive Java array, so a search reads the query vector and the filter in place instead of
+// from a copy. While an array is pinned:
+//  - no other JNI call may be made from the thread, so every JNI call of a query, like reading its parameters or its
+//    parent ids, has to happen before the arrays are pinned, and its results are only built once they are released;
+//  - the thread may not block on another thread that calls into Java, so the search runs on the calling thread only;
+//  - the GC may be held off, so the arrays are released as soon as the search returns, and only searches whose work
+//    is bounded, a k-NN search or a range search capped by its result window, pin them.
+// Several arrays may be pinned at once. They are only read, so they are released with JNI_ABORT.
+template <typename T>
+class PinnedArray {
+public:
+    PinnedArray(knn_jni::JNIUtilInterface * jniUtil, JNIEnv *env, jarray arrayJ)
+        : jniUtil(jniUtil), env(env), arrayJ(arrayJ),
+          data(static_cast<T *>(jniUtil->GetPrimitiveArrayCritical(env, arrayJ, nullptr))) {
+        if (data == nullptr) {
+            throw std::runtime_error("Unable to pin Java array");
+        }
+    }
+
+    ~PinnedArray() {
+        jniUtil->ReleasePrimitiveArrayCritical(env, arrayJ, data, JNI_ABORT);
+    }
+
+    PinnedArray(const PinnedArray &) = delete;
+    PinnedArray &operator=(const PinnedArray &) = delete;
+
+    T *get() const {
+        return data;
+    }
+
+private:
+    knn_jni::JNIUtilInterface *jniUtil;
+    JNIEnv *env;
+    jarray arrayJ;
+    T *data;
+};
+
+// Copies a primitive Java array into copy. Arrays read over a batch of queries, or from another thread, are copied
+// rather than pinned.
+void CopyJavaArray(knn_jni::JNIUtilInterface *jniUtil, JNIEnv *env, jfloatArray arrayJ, std::vector<float> *copy) {
+    copy->resize(jniUtil->GetJavaFloatArrayLength(env, arrayJ));
+    jniUtil->GetFloatArrayRegion(env, arrayJ, 0, static_cast<jsize>(copy->size()), copy->data());
+}
+
+void CopyJavaArray(knn_jni::JNIUtilInterface *jniUtil, JNIEnv *env, jbyteArray arrayJ, std::vector<uint8_t> *copy) {
+    copy->resize(jniUtil->GetJavaBytesArrayLength(env, arrayJ));
+    jniUtil->GetByteArrayRegion(env, arrayJ, 0, static_cast<jsize>(copy->size()),
+                                reinterpret_cast<jbyte *>(copy->data()));
+}
+
+void CopyJavaArray(knn_jni::JNIUtilInterface *jniUtil, JNIEnv *env, jlongArray arrayJ, std::vector<jlong> *copy) {
+    copy->resize(jniUtil->GetJavaLongArrayLength(env, arrayJ));
+    jniUtil->GetLongArrayRegion(env, arrayJ, 0, static_cast<jsize>(copy->size()), copy->data());
+}
+
+// Filter ids or bitset of a query, pinned whatever its size or copied into the thread's search scratch. When the
+// filter is pinned the query vector has to be read after it. get() is null without a filter.
+class QueryFilterIds {
+public:
+    QueryFilterIds(knn_jni::JNIUtilInterface *jniUtil, JNIEnv *env, jlongArray filterIdsJ, int filterIdsLength,
+                   bool pin)
+        : data(nullptr) {
+        if (filterIdsJ == nullptr) {
+            return;
+        }
+        if (pin) {
+            pinned.reset(new PinnedArray<jlong>(jniUtil, env, filterIdsJ));
+            data = pinned->get();
+        } else {
+            std::vector<jlong> &copy = GetSearchScratch().filterIds;
+            CopyJavaArray(jniUtil, env, filterIdsJ, &copy);
+            data = copy.data();
+        }
+    }
+
+    const jlong *get() const {
+        return data;
+    }
+
+private:
+    std::unique_ptr<PinnedArray<jlong>> pinned;
+    const jlong *data;
+};
+
 
 // Translate space type to faiss metric
 faiss::MetricType TranslateSpaceToMetric(const std::string& spaceType);
@@ -81,13 +446,138 @@ void InternalTrainIndex(faiss::Index * index, faiss::idx_t n, const float* x);
 // Train a binary index with data provided
 void InternalTrainBinaryIndex(faiss::IndexBinary * index, faiss::idx_t n, const uint8_t* x);
 
+// Train an index with byte vectors, converting only the ones k-means looks at to float
+void InternalTrainByteIndex(faiss::Index * index, int numVectors, int dim, const int8_t* x);
+
+// Create the untrained index described by the training parameters
+std::unique_ptr<faiss::Index> CreateIndexForTraining(knn_jni::JNIUtilInterface * jniUtil, JNIEnv * env,
+                                                     std::unordered_map<std::string, jobject> &parametersCpp,
+                                                     jint dimensionJ);
+
+std::unique_ptr<faiss::IndexBinary> CreateBinaryIndexForTraining(knn_jni::JNIUtilInterface * jniUtil, JNIEnv * env,
+                                                                 std::unordered_map<std::string, jobject> &parametersCpp,
+                                                                 jint dimensionJ);
+
+// Number of threads the parameters ask for, or 0 when they leave it to OpenMP
+int GetThreadCount(knn_jni::JNIUtilInterface * jniUtil, JNIEnv * env,
+                           std::unordered_map<std::string, jobject> &parametersCpp);
+
+// Create the index described by parametersJ and train it, if it needs training, with the vectors at
+// trainVectorsPointerJ
+std::unique_ptr<faiss::Index> BuildTrainedIndex(knn_jni::JNIUtilInterface * jniUtil, JNIEnv * env, jobject parametersJ,
+                                                jint dimensionJ, jlong trainVectorsPointerJ);
+
+std::unique_ptr<faiss::IndexBinary> BuildTrainedBinaryIndex(knn_jni::JNIUtilInterface * jniUtil, JNIEnv * env,
+                                                            jobject parametersJ, jint dimensionJ,
+                                                            jlong trainVectorsPointerJ);
+
+std::unique_ptr<faiss::Index> BuildTrainedByteIndex(knn_jni::JNIUtilInterface * jniUtil, JNIEnv * env,
+                                                    jobject parametersJ, jint dimensionJ, jlong trainVectorsPointerJ);
+
+// Train the index of a training session on the vectors it sampled, unless it needs no training
+void TrainSessionIndex(TrainingSession *session);
+
+// Copy the doc map of a merge out of its Java array. It is read all through the remapping, which runs too long to pin
+// the array for.
+std::vector<int32_t> ReadDocMap(knn_jni::JNIUtilInterface * jniUtil, JNIEnv * env, jintArray docMapJ);
+
+// Apply the thread count of the merge parameters to the current thread, and release the parameters
+void SetMergeThreadCount(knn_jni::JNIUtilInterface * jniUtil, JNIEnv * env, jobject parametersJ);
+
+// Copy serialized bytes into a new Java byte array
+jbyteArray NewJavaByteArray(knn_jni::JNIUtilInterface * jniUtil, JNIEnv * env, const std::vector<uint8_t> &bytes);
+
 // Converts the int FilterIds to Faiss ids type array.
 void convertFilterIdsToFaissIdType(const int* filterIds, int filterIdsLength, faiss::idx_t* convertedFilterIds);
 
 // Concerts the FilterIds to BitMap
 void buildFilterIdsBitMap(const int* filterIds, int filterIdsLength, uint8_t* bitsetVector);
 
-std::unique_ptr<faiss::IDGrouperBitmap> buildIDGrouperBitmap(knn_jni::JNIUtilInterface * jniUtil, JNIEnv *env, jintArray parentIdsJ, std::vector<uint64_t>* bitmap);
+// Get the parent grouper of the index at indexPointerJ. The grouper is built on the first nested query and cached
+// until the index is freed, so later queries only check that parentIdsJ still matches it.
+std::shared_ptr<const CachedIDGrouper> getCachedIDGrouper(knn_jni::JNIUtilInterface * jniUtil, JNIEnv *env, jlong indexPointerJ, jintArray parentIdsJ);
+
+// Drop the cached parent grouper of the index at indexPointerJ
+void evictCachedIDGrouper(jlong indexPointerJ);
+
+// Whether the labels of the IDMap at indexPointerJ are sorted, so the internal id of a filtered doc can be found by
+// binary search. Checked on the first query and cached until the index is freed.
+bool hasSortedLabels(jlong indexPointerJ, const std::vector<faiss::idx_t> &labels);
+
+// Drop the cached label order of the index at indexPointerJ
+void evictSortedLabels(jlong indexPointerJ);
+
+// Model id of a build from a template, or an empty string when the parameters carry none
+std::string GetModelId(knn_jni::JNIUtilInterface * jniUtil, JNIEnv *env,
+                       const std::unordered_map<std::string, jobject> &parametersCpp);
+
+// Deserialize the trained template index of a model for a new segment. With a model id the template is only
+// deserialized once and kept, and every segment gets a clone of it, which copies the trained structures instead of
+// parsing them again. The Java array is only ever read in bounded chunks.
+template <typename INDEX>
+std::unique_ptr<INDEX> ReadTemplateIndex(knn_jni::JNIUtilInterface * jniUtil, JNIEnv *env, jbyteArray templateIndexJ,
+                                         const std::string &modelId);
+
+// Brute force the docs selected by the filter, or every doc when filteredIdsArray is null. labels are the IDMap labels.
+// When they are sorted the filtered docs are binary searched in them, otherwise every doc is checked against the
+// filter. The top k are stored into dis and ids, best first and padded with -1 like a faiss search.
+void ExactSearchWithFilter(ExactScorer &scorer, bool isSimilarity, const std::vector<faiss::idx_t> &labels,
+                           bool sortedLabels, const jlong *filteredIdsArray, int filterIdsLength, jint filterIdsTypeJ,
+                           int k, float *dis, faiss::idx_t *ids);
+
+// Brute force range search over the docs selected by the filter, or every doc when filteredIdsArray is null. Hits
+// are passed to handler with their internal ids, and similarity scores are negated first.
+void ExactRangeSearchWithFilter(ExactScorer &scorer, bool isSimilarity, const std::vector<faiss::idx_t> &labels,
+                                bool sortedLabels, const jlong *filteredIdsArray, int filterIdsLength,
+                                jint filterIdsTypeJ, faiss_util::BoundedRangeResultHandler &handler);
+
+// Storage of a float index that exact search can read vectors from
+const faiss::Index *GetExactSearchStorage(const faiss::Index *index);
+
+// Split the scan of an IVF or flat index into up to parallelism parts run on the native thread pool, and merge the top
+// k of every part into dis and ids. IVF indexes are split by probed inverted lists and flat ones by ranges of vectors.
+// Return false without searching when the index cannot be split or the query is too small to gain from it.
+bool ParallelSearchWithFilter(const faiss::IndexIDMap *indexReader, const float *query, int k, int parallelism,
+                              const faiss::IDSelector *selector, int nprobe, float *dis, faiss::idx_t *ids);
+
+// Search the float index and store the top k ids and distances into idsOut and disOut. Return the number of results
+int InternalQueryIndex_WithFilter(knn_jni::JNIUtilInterface * jniUtil, JNIEnv * env, jlong indexPointerJ,
+                                  jfloatArray queryVectorJ, jint kJ, const knn_jni::commons::SearchParams &searchParams, jlongArray filterIdsJ, jint filterIdsTypeJ,
+                                  jintArray parentIdsJ, std::vector<float>* disOut, std::vector<faiss::idx_t>* idsOut);
+
+// Search the float index with a query and filter already copied out of Java. The grouper, when set, is applied by HNSW
+// indexes only. Makes no JNI call, so it may run on any thread. The top k are stored into dis and ids, padded with -1
+void SearchIndexWithFilter(const faiss::IndexIDMap *indexReader, jlong indexPointerJ, const float *query, int k,
+                           const knn_jni::commons::SearchParams &searchParams, const jlong *filteredIdsArray,
+                           int filterIdsLength, jint filterIdsTypeJ, faiss::IDGrouper *grouper, float *dis,
+                           faiss::idx_t *ids);
+
+// Search one segment of a multi segment query into the k sized heap in dis and ids, ordered by C. The heap comes seeded
+// with the k-th best distance of the segments searched before, so only better hits are kept, and those are stored with
+// their labels. Makes no JNI call.
+template <typename C>
+void SearchSegmentIntoHeap(const faiss::IndexIDMap *indexReader, jlong indexPointerJ, const float *query, int k,
+                           const knn_jni::commons::SearchParams &searchParams, const jlong *filteredIdsArray,
+                           int filterIdsLength, jint filterIdsTypeJ, float *dis, faiss::idx_t *ids);
+
+// Search the binary index and store the top k ids and distances into idsOut and disOut. Return the number of results
+int InternalQueryBinaryIndex_WithFilter(knn_jni::JNIUtilInterface * jniUtil, JNIEnv * env, jlong indexPointerJ,
+                                        jbyteArray queryVectorJ, jint kJ, const knn_jni::commons::SearchParams &searchParams, jlongArray filterIdsJ, jint filterIdsTypeJ,
+                                        jintArray parentIdsJ, std::vector<int32_t>* disOut, std::vector<faiss::idx_t>* idsOut);
+
+// Run a range search on the float index and store the kept hits into idsOut and disOut, best first. At most
+// maxResultWindowJ hits are kept, picked by mode. Return the number of results, or the number of hits in COUNT mode
+int InternalRangeSearchWithFilter(knn_jni::JNIUtilInterface *jniUtil, JNIEnv *env, jlong indexPointerJ,
+                                  jfloatArray queryVectorJ, jfloat radiusJ, const knn_jni::commons::SearchParams &searchParams, jint maxResultWindowJ,
+                                  faiss_util::RangeResultMode mode, jlongArray filterIdsJ, jint filterIdsTypeJ, jintArray parentIdsJ,
+                                  std::vector<float>* disOut, std::vector<faiss::idx_t>* idsOut);
+
+// Same as InternalRangeSearchWithFilter for binary indexes, with a hamming radius
+int InternalRangeSearchBinaryWithFilter(knn_jni::JNIUtilInterface *jniUtil, JNIEnv *env, jlong indexPointerJ,
+                                        jbyteArray queryVectorJ, jfloat radiusJ, const knn_jni::commons::SearchParams &searchParams,
+                                        jint maxResultWindowJ, faiss_util::RangeResultMode mode, jlongArray filterIdsJ,
+                                        jint filterIdsTypeJ, jintArray parentIdsJ, std::vector<float>* disOut,
+                                        std::vector<faiss::idx_t>* idsOut);
 
 // Check if a loaded index is an IVFPQ index with l2 space type
 bool isIndexIVFPQL2(faiss::Index * index);
@@ -154,8 +644,36 @@ jlong knn_jni::faiss_wrapper::InitIndex(knn_jni::JNIUtilInterface * jniUtil, JNI
                                    std::move(subParametersCpp));
 }
 
-void knn_jni::faiss_wrapper::InsertToIndex(knn_jni::JNIUtilInterface * jniUtil, JNIEnv * env, jintArray idsJ, jlong vectorsAddressJ, jint dimJ,
-                                         jlong index_ptr, jint threadCount, IndexService* indexService) {
+jlong knn_jni::faiss_wrapper::EstimateIndexMemory(knn_jni::JNIUtilInterface * jniUtil, JNIEnv * env, jlong numDocs,
+                                                  jint dimJ, jobject parametersJ, IndexService* indexService) {
+    if (dimJ <= 0) {
+        throw std::runtime_error("Vectors dimensions cannot be less than or equal to 0");
+    }
+
+    if (numDocs < 0) {
+        throw std::runtime_error("Number of documents cannot be less than 0");
+    }
+
+    if (parametersJ == nullptr) {
+        throw std::runtime_error("Parameters cannot be null");
+    }
+
+    auto parametersCpp = jniUtil->ConvertJavaMapToCppMap(env, parametersJ);
+
+    jobject spaceTypeJ = knn_jni::GetJObjectFromMapOrThrow(parametersCpp, knn_jni::SPACE_TYPE);
+    std::string spaceTypeCpp(jniUtil->ConvertJavaObjectToCppString(env, spaceTypeJ));
+    faiss::MetricType metric = TranslateSpaceToMetric(spaceTypeCpp);
+    jniUtil->DeleteLocalRef(env, spaceTypeJ);
+
+    jobject indexDescriptionJ = knn_jni::GetJObjectFromMapOrThrow(parametersCpp, knn_jni::INDEX_DESCRIPTION);
+    std::string indexDescriptionCpp(jniUtil->ConvertJavaObjectToCppString(env, indexDescriptionJ));
+    jniUtil->DeleteLocalRef(env, indexDescriptionJ);
+
+    return static_cast<jlong>(indexService->estimateIndexMemory(metric, std::move(indexDescriptionCpp), (int) dimJ,
+                                                                static_cast<size_t>(numDocs)));
+}
+
+void CheckInsertArguments(jintArray idsJ, jlong vectorsAddressJ, jint dimJ) {
     if (idsJ == nullptr) {
         throw std::runtime_error("IDs cannot be null");
     }
@@ -167,6 +685,11 @@ void knn_jni::faiss_wrapper::InsertToIndex(knn_jni::JNIUtilInterface * jniUtil,
     if(dimJ <= 0) {
         throw std::runtime_error("Vectors dimensions cannot be less than or equal to 0");
     }
+}
+
+void knn_jni::faiss_wrapper::InsertToIndex(knn_jni::JNIUtilInterface * jniUtil, JNIEnv * env, jintArray idsJ, jlong vectorsAddressJ, jint dimJ,
+                                         jlong index_ptr, jint threadCount, IndexService* indexService) {
+    CheckInsertArguments(idsJ, vectorsAddressJ, dimJ);
 
     // Dimension
     int dim = (int)dimJ;
@@ -184,6 +707,90 @@ void knn_jni::faiss_wrapper::InsertToIndex(knn_jni::JNIUtilInterface * jniUtil,
     indexService->insertToIndex(dim, numIds, threadCount, vectorsAddress, ids, index_ptr);
 }
 
+jlong knn_jni::faiss_wrapper::StartInsertWorker(jlong index_ptr, jint dimJ, jint threadCount,
+                                                std::unique_ptr<IndexService> indexService) {
+    if (index_ptr == 0) {
+        throw std::runtime_error("Invalid pointer to index");
+    }
+
+    if (dimJ <= 0) {
+        throw std::runtime_error("Vectors dimensions cannot be less than or equal to 0");
+    }
+
+    std::unique_ptr<InsertWorker> worker(new InsertWorker());
+    worker->indexService = std::move(indexService);
+    worker->indexAddress = index_ptr;
+    worker->dimension = dimJ;
+    worker->threadCount = threadCount;
+    return reinterpret_cast<jlong>(worker.release());
+}
+
+jlong knn_jni::faiss_wrapper::SubmitInsertToIndex(knn_jni::JNIUtilInterface * jniUtil, JNIEnv * env, jlong insertWorkerJ,
+                                                 jintArray idsJ, jlong vectorsAddressJ) {
+    auto *worker = reinterpret_cast<InsertWorker *>(insertWorkerJ);
+    if (worker == nullptr) {
+        throw std::runtime_error("Invalid pointer to insert worker");
+    }
+    CheckInsertArguments(idsJ, vectorsAddressJ, worker->dimension);
+
+    auto ids = std::make_shared<std::vector<int64_t>>(jniUtil->ConvertJavaIntArrayToCppIntVector(env, idsJ));
+    int64_t batch;
+    {
+        std::lock_guard<std::mutex> lock(worker->mutex);
+        batch = ++worker->submittedBatches;
+    }
+    worker->thread.submit([worker, ids, vectorsAddressJ, batch]() {
+        bool skip;
+        {
+            std::lock_guard<std::mutex> lock(worker->mutex);
+            skip = worker->error != nullptr || worker->stopping;
+        }
+        std::exception_ptr error;
+        if (!skip) {
+            try {
+                // The thread count set by insertToIndex applies to this thread, which serves every batch of the build
+                worker->indexService->insertToIndex(worker->dimension, static_cast<int>(ids->size()), worker->threadCount,
+                                                    vectorsAddressJ, *ids, worker->indexAddress);
+            } catch (...) {
+                error = std::current_exception();
+            }
+        }
+        {
+            std::lock_guard<std::mutex> lock(worker->mutex);
+            if (error && worker->error == nullptr) {
+                worker->error = error;
+            }
+            worker->finishedBatches = batch;
+        }
+        worker->batchFinished.notify_all();
+    });
+    return static_cast<jlong>(batch);
+}
+
+void knn_jni::faiss_wrapper::WaitForInsertToIndex(jlong insertWorkerJ, jlong insertBatchJ) {
+    auto *worker = reinterpret_cast<InsertWorker *>(insertWorkerJ);
+    if (worker == nullptr) {
+        throw std::runtime_error("Invalid pointer to insert worker");
+    }
+    std::unique_lock<std::mutex> lock(worker->mutex);
+    worker->batchFinished.wait(lock, [worker, insertBatchJ]() { return worker->finishedBatches >= insertBatchJ; });
+    if (worker->error) {
+        std::rethrow_exception(worker->error);
+    }
+}
+
+void knn_jni::faiss_wrapper::StopInsertWorker(jlong insertWorkerJ) {
+    std::unique_ptr<InsertWorker> worker(reinterpret_cast<InsertWorker *>(insertWorkerJ));
+    if (worker == nullptr) {
+        throw std::runtime_error("Invalid pointer to insert worker");
+    }
+    {
+        std::lock_guard<std::mutex> lock(worker->mutex);
+        worker->stopping = true;
+    }
+    // Freeing the worker joins its thread once the batch being added is done, the batches still queued are skipped
+}
+
 void knn_jni::faiss_wrapper::WriteIndex(knn_jni::JNIUtilInterface * jniUtil, JNIEnv * env,
                                         jobject output, jlong index_ptr, IndexService* indexService) {
 
@@ -228,6 +835,7 @@ void knn_jni::faiss_wrapper::CreateIndexFromTemplate(knn_jni::JNIUtilInterface *
         auto threadCount = jniUtil->ConvertJavaObjectToCppInteger(env, parametersCpp[knn_jni::INDEX_THREAD_QUANTITY]);
         omp_set_num_threads(threadCount);
     }
+    const std::string modelId = GetModelId(jniUtil, env, parametersCpp);
     jniUtil->DeleteLocalRef(env, parametersJ);
 
     // Read data set
@@ -240,22 +848,12 @@ void knn_jni::faiss_wrapper::CreateIndexFromTemplate(knn_jni::JNIUtilInterface *
         throw std::runtime_error("Number of IDs does not match number of vectors");
     }
 
-    // Get vector of bytes from jbytearray
-    int indexBytesCount = jniUtil->GetJavaBytesArrayLength(env, templateIndexJ);
-    jbyte * indexBytesJ = jniUtil->GetByteArrayElements(env, templateIndexJ, nullptr);
-
-    faiss::VectorIOReader vectorIoReader;
-    for (int i = 0; i < indexBytesCount; i++) {
-        vectorIoReader.data.push_back((uint8_t) indexBytesJ[i]);
-    }
-    jniUtil->ReleaseByteArrayElements(env, templateIndexJ, indexBytesJ, JNI_ABORT);
-
     // Create faiss index
-    std::unique_ptr<faiss::Index> indexWriter;
-    indexWriter.reset(faiss::read_index(&vectorIoReader, 0));
+    std::unique_ptr<faiss::Index> indexWriter = ReadTemplateIndex<faiss::Index>(jniUtil, env, templateIndexJ, modelId);
 
     auto idVector = jniUtil->ConvertJavaIntArrayToCppIntVector(env, idsJ);
     faiss::IndexIDMap idMap =  faiss::IndexIDMap(indexWriter.get());
+    reserveIndexMemory(&idMap, numVectors);
     idMap.add_with_ids(numVectors, inputVectors->data(), idVector.data());
     // Releasing the vectorsAddressJ memory as that is not required once we have created the index.
     // This is not the ideal approach, please refer this gh issue for long term solution:
@@ -298,6 +896,7 @@ void knn_jni::faiss_wrapper::CreateBinaryIndexFromTemplate(knn_jni::JNIUtilInter
         auto threadCount = jniUtil->ConvertJavaObjectToCppInteger(env, parametersCpp[knn_jni::INDEX_THREAD_QUANTITY]);
         omp_set_num_threads(threadCount);
     }
+    const std::string modelId = GetModelId(jniUtil, env, parametersCpp);
     jniUtil->DeleteLocalRef(env, parametersJ);
 
     // Read data set
@@ -313,22 +912,13 @@ void knn_jni::faiss_wrapper::CreateBinaryIndexFromTemplate(knn_jni::JNIUtilInter
         throw std::runtime_error("Number of IDs does not match number of vectors");
     }
 
-    // Get vector of bytes from jbytearray
-    int indexBytesCount = jniUtil->GetJavaBytesArrayLength(env, templateIndexJ);
-    jbyte * indexBytesJ = jniUtil->GetByteArrayElements(env, templateIndexJ, nullptr);
-
-    faiss::VectorIOReader vectorIoReader;
-    for (int i = 0; i < indexBytesCount; i++) {
-        vectorIoReader.data.push_back((uint8_t) indexBytesJ[i]);
-    }
-    jniUtil->ReleaseByteArrayElements(env, templateIndexJ, indexBytesJ, JNI_ABORT);
-
     // Create faiss index
-    std::unique_ptr<faiss::IndexBinary> indexWriter;
-    indexWriter.reset(faiss::read_index_binary(&vectorIoReader, 0));
+    std::unique_ptr<faiss::IndexBinary> indexWriter =
+            ReadTemplateIndex<faiss::IndexBinary>(jniUtil, env, templateIndexJ, modelId);
 
     auto idVector = jniUtil->ConvertJavaIntArrayToCppIntVector(env, idsJ);
     faiss::IndexBinaryIDMap idMap =  faiss::IndexBinaryIDMap(indexWriter.get());
+    reserveIndexMemory(&idMap, numVectors);
     idMap.add_with_ids(numVectors, reinterpret_cast<const uint8_t*>(inputVectors->data()), idVector.data());
     // Releasing the vectorsAddressJ memory as that is not required once we have created the index.
     // This is not the ideal approach, please refer this gh issue for long term solution:
@@ -372,6 +962,7 @@ void knn_jni::faiss_wrapper::CreateByteIndexFromTemplate(knn_jni::JNIUtilInterfa
         auto threadCount = jniUtil->ConvertJavaObjectToCppInteger(env, it->second);
         omp_set_num_threads(threadCount);
     }
+    const std::string modelId = GetModelId(jniUtil, env, parametersCpp);
     jniUtil->DeleteLocalRef(env, parametersJ);
 
     // Read data set
@@ -385,32 +976,29 @@ void knn_jni::faiss_wrapper::CreateByteIndexFromTemplate(knn_jni::JNIUtilInterfa
         throw std::runtime_error("Number of IDs does not match number of vectors");
     }
 
-    // Get vector of bytes from jbytearray
-    int indexBytesCount = jniUtil->GetJavaBytesArrayLength(env, templateIndexJ);
-    jbyte * indexBytesJ = jniUtil->GetByteArrayElements(env, templateIndexJ, nullptr);
-
-    faiss::VectorIOReader vectorIoReader;
-    vectorIoReader.data.reserve(indexBytesCount);
-    for (int i = 0; i < indexBytesCount; i++) {
-        vectorIoReader.data.push_back((uint8_t) indexBytesJ[i]);
-    }
-    jniUtil->ReleaseByteArrayElements(env, templateIndexJ, indexBytesJ, JNI_ABORT);
-
     // Create faiss index
-    std::unique_ptr<faiss::Index> indexWriter (faiss::read_index(&vectorIoReader, 0));
+    std::unique_ptr<faiss::Index> indexWriter = ReadTemplateIndex<faiss::Index>(jniUtil, env, templateIndexJ, modelId);
 
     auto ids = jniUtil->ConvertJavaIntArrayToCppIntVector(env, idsJ);
     faiss::IndexIDMap idMap =  faiss::IndexIDMap(indexWriter.get());
+    reserveIndexMemory(&idMap, numVectors);
 
     // Add vectors in batches by casting int8 vectors into float with a batch size of 1000 to avoid additional memory spike.
     // Refer to this github issue for more details https://github.com/opensearch-project/k-NN/issues/1659#issuecomment-2307390255
+    // Templates storing int8 codes directly take the vectors without the conversion.
+    const bool int8Add = knn_jni::faiss_wrapper::supportsInt8Add(idMap.index);
+    if (int8Add) {
+        knn_jni::faiss_wrapper::addInt8Vectors(idMap.index, numVectors, inputVectors->data());
+        idMap.id_map.insert(idMap.id_map.end(), ids.begin(), ids.begin() + numVectors);
+        idMap.ntotal = idMap.index->ntotal;
+    }
+
     int batchSize = 1000;
-    std::vector <float> inputFloatVectors(batchSize * dim);
-    std::vector <int64_t> floatVectorsIds(batchSize);
-    int id = 0;
+    std::vector <float> inputFloatVectors(int8Add ? 0 : batchSize * dim);
+    std::vector <int64_t> floatVectorsIds(int8Add ? 0 : batchSize);
     auto iter = inputVectors->begin();
 
-    for (int id = 0; id < numVectors; id += batchSize) {
+    for (int id = 0; !int8Add && id < numVectors; id += batchSize) {
         if (numVectors - id < batchSize) {
             batchSize = numVectors - id;
         }
@@ -449,6 +1037,19 @@ jlong knn_jni::faiss_wrapper::LoadIndex(knn_jni::JNIUtilInterface * jniUtil, JNI
     return (jlong) indexReader;
 }
 
+jlong knn_jni::faiss_wrapper::LoadIndexWithMmap(knn_jni::JNIUtilInterface * jniUtil, JNIEnv * env, jstring indexPathJ) {
+    if (indexPathJ == nullptr) {
+        throw std::runtime_error("Index path cannot be null");
+    }
+
+    std::string indexPathCpp(jniUtil->ConvertJavaStringToCppString(env, indexPathJ));
+    // With IO_FLAG_MMAP_IFC, faiss maps the file and the vectors it reads into MaybeOwnedVector point into the
+    // mapping, whose owner is shared with them. Only the small structures, like the HNSW levels and offsets and the
+    // ids, are copied. The mapping is read only, which is fine since a loaded index is only searched.
+    faiss::Index* indexReader = faiss::read_index(indexPathCpp.c_str(), faiss::IO_FLAG_MMAP_IFC | faiss::IO_FLAG_READ_ONLY | faiss::IO_FLAG_PQ_SKIP_SDC_TABLE | faiss::IO_FLAG_SKIP_PRECOMPUTE_TABLE);
+    return (jlong) indexReader;
+}
+
 jlong knn_jni::faiss_wrapper::LoadIndexWithStream(faiss::IOReader* ioReader) {
     if (ioReader == nullptr)  {
         throw std::runtime_error("IOReader cannot be null");
@@ -563,6 +1164,16 @@ jlong knn_jni::faiss_wrapper::LoadBinaryIndex(knn_jni::JNIUtilInterface * jniUti
     return (jlong) indexReader;
 }
 
+jlong knn_jni::faiss_wrapper::LoadBinaryIndexWithMmap(knn_jni::JNIUtilInterface * jniUtil, JNIEnv * env, jstring indexPathJ) {
+    if (indexPathJ == nullptr) {
+        throw std::runtime_error("Index path cannot be null");
+    }
+
+    std::string indexPathCpp(jniUtil->ConvertJavaStringToCppString(env, indexPathJ));
+    faiss::IndexBinary* indexReader = faiss::read_index_binary(indexPathCpp.c_str(), faiss::IO_FLAG_MMAP_IFC | faiss::IO_FLAG_READ_ONLY | faiss::IO_FLAG_PQ_SKIP_SDC_TABLE | faiss::IO_FLAG_SKIP_PRECOMPUTE_TABLE);
+    return (jlong) indexReader;
+}
+
 jlong knn_jni::faiss_wrapper::LoadBinaryIndexWithStream(faiss::IOReader* ioReader) {
     if (ioReader == nullptr) {
         throw std::runtime_error("IOReader cannot be null");
@@ -582,6 +1193,52 @@ bool knn_jni::faiss_wrapper::IsSharedIndexStateRequired(jlong indexPointerJ) {
     return isIndexIVFPQL2(index);
 }
 
+jlong knn_jni::faiss_wrapper::LoadIndexForMerge(knn_jni::JNIUtilInterface * jniUtil, JNIEnv * env,
+                                                faiss::IOReader* ioReader, jintArray docMapJ, jlong numDocs,
+                                                jobject parametersJ) {
+    if (ioReader == nullptr) {
+        throw std::runtime_error("IOReader cannot be null");
+    }
+    std::vector<int32_t> docMap = ReadDocMap(jniUtil, env, docMapJ);
+    SetMergeThreadCount(jniUtil, env, parametersJ);
+
+    std::unique_ptr<faiss::Index> index(faiss::read_index(ioReader));
+    auto *idMap = dynamic_cast<faiss::IndexIDMap *>(index.get());
+    if (idMap == nullptr || !supportsGraphReuse(idMap->index)) {
+        return 0;
+    }
+
+    remapGraphIndex(idMap, docMap.data(), docMap.size());
+    if (numDocs > idMap->ntotal) {
+        reserveIndexMemory(idMap, numDocs - idMap->ntotal);
+    }
+    index.release();
+    return reinterpret_cast<jlong>(idMap);
+}
+
+jlong knn_jni::faiss_wrapper::LoadBinaryIndexForMerge(knn_jni::JNIUtilInterface * jniUtil, JNIEnv * env,
+                                                      faiss::IOReader* ioReader, jintArray docMapJ, jlong numDocs,
+                                                      jobject parametersJ) {
+    if (ioReader == nullptr) {
+        throw std::runtime_error("IOReader cannot be null");
+    }
+    std::vector<int32_t> docMap = ReadDocMap(jniUtil, env, docMapJ);
+    SetMergeThreadCount(jniUtil, env, parametersJ);
+
+    std::unique_ptr<faiss::IndexBinary> index(faiss::read_index_binary(ioReader));
+    auto *idMap = dynamic_cast<faiss::IndexBinaryIDMap *>(index.get());
+    if (idMap == nullptr || !supportsGraphReuse(idMap->index)) {
+        return 0;
+    }
+
+    remapGraphIndex(idMap, docMap.data(), docMap.size());
+    if (numDocs > idMap->ntotal) {
+        reserveIndexMemory(idMap, numDocs - idMap->ntotal);
+    }
+    index.release();
+    return reinterpret_cast<jlong>(idMap);
+}
+
 jlong knn_jni::faiss_wrapper::InitSharedIndexState(jlong indexPointerJ) {
     auto * index = reinterpret_cast<faiss::Index*>(indexPointerJ);
     if (!isIndexIVFPQL2(index)) {
@@ -632,6 +1289,56 @@ jobjectArray knn_jni::faiss_wrapper::QueryIndex(knn_jni::JNIUtilInterface * jniU
 
 jobjectArray knn_jni::faiss_wrapper::QueryIndex_WithFilter(knn_jni::JNIUtilInterface * jniUtil, JNIEnv * env, jlong indexPointerJ,
                                                 jfloatArray queryVectorJ, jint kJ, jobject methodParamsJ, jlongArray filterIdsJ, jint filterIdsTypeJ, jintArray parentIdsJ) {
+    SearchScratch &scratch = GetSearchScratch();
+    std::vector<float> &dis = scratch.dis;
+    std::vector<faiss::idx_t> &ids = scratch.ids;
+    int resultSize = InternalQueryIndex_WithFilter(jniUtil, env, indexPointerJ, queryVectorJ, kJ,
+                                                   knn_jni::commons::parseSearchParams(jniUtil, env, methodParamsJ), filterIdsJ,
+                                                   filterIdsTypeJ, parentIdsJ, &dis, &ids);
+    return knn_jni::commons::buildKNNQueryResults(jniUtil, env, ids.data(), dis.data(), resultSize);
+}
+
+jint knn_jni::faiss_wrapper::QueryIndex_WithFilterIntoArrays(knn_jni::JNIUtilInterface * jniUtil, JNIEnv * env, jlong indexPointerJ,
+                                                             jfloatArray queryVectorJ, jint kJ, jobject methodParamsJ, jlongArray filterIdsJ,
+                                                             jint filterIdsTypeJ, jintArray parentIdsJ, jintArray resultIdsJ,
+                                                             jfloatArray resultDistancesJ) {
+    SearchScratch &scratch = GetSearchScratch();
+    std::vector<float> &dis = scratch.dis;
+    std::vector<faiss::idx_t> &ids = scratch.ids;
+    int resultSize = InternalQueryIndex_WithFilter(jniUtil, env, indexPointerJ, queryVectorJ, kJ,
+                                                   knn_jni::commons::parseSearchParams(jniUtil, env, methodParamsJ), filterIdsJ,
+                                                   filterIdsTypeJ, parentIdsJ, &dis, &ids);
+    return knn_jni::commons::copyQueryResults(jniUtil, env, ids.data(), dis.data(), resultSize, resultIdsJ, resultDistancesJ);
+}
+
+jobjectArray knn_jni::faiss_wrapper::QueryIndex_WithSearchParams(knn_jni::JNIUtilInterface * jniUtil, JNIEnv * env, jlong indexPointerJ,
+                                                                 jfloatArray queryVectorJ, jint kJ, jlong searchParamsPointerJ,
+                                                                 jlongArray filterIdsJ, jint filterIdsTypeJ, jintArray parentIdsJ) {
+    SearchScratch &scratch = GetSearchScratch();
+    std::vector<float> &dis = scratch.dis;
+    std::vector<faiss::idx_t> &ids = scratch.ids;
+    int resultSize = InternalQueryIndex_WithFilter(jniUtil, env, indexPointerJ, queryVectorJ, kJ,
+                                                   knn_jni::commons::getSearchParams(searchParamsPointerJ),
+                                                   filterIdsJ, filterIdsTypeJ, parentIdsJ, &dis, &ids);
+    return knn_jni::commons::buildKNNQueryResults(jniUtil, env, ids.data(), dis.data(), resultSize);
+}
+
+jint knn_jni::faiss_wrapper::QueryIndex_WithSearchParamsIntoArrays(knn_jni::JNIUtilInterface * jniUtil, JNIEnv * env, jlong indexPointerJ,
+                                                                   jfloatArray queryVectorJ, jint kJ, jlong searchParamsPointerJ,
+                                                                   jlongArray filterIdsJ, jint filterIdsTypeJ, jintArray parentIdsJ,
+                                                                   jintArray resultIdsJ, jfloatArray resultDistancesJ) {
+    SearchScratch &scratch = GetSearchScratch();
+    std::vector<float> &dis = scratch.dis;
+    std::vector<faiss::idx_t> &ids = scratch.ids;
+    int resultSize = InternalQueryIndex_WithFilter(jniUtil, env, indexPointerJ, queryVectorJ, kJ,
+                                                   knn_jni::commons::getSearchParams(searchParamsPointerJ),
+                                                   filterIdsJ, filterIdsTypeJ, parentIdsJ, &dis, &ids);
+    return knn_jni::commons::copyQueryResults(jniUtil, env, ids.data(), dis.data(), resultSize, resultIdsJ, resultDistancesJ);
+}
+
+int InternalQueryIndex_WithFilter(knn_jni::JNIUtilInterface * jniUtil, JNIEnv * env, jlong indexPointerJ,
+                                  jfloatArray queryVectorJ, jint kJ, const knn_jni::commons::SearchParams &searchParams, jlongArray filterIdsJ, jint filterIdsTypeJ,
+                                  jintArray parentIdsJ, std::vector<float>* disOut, std::vector<faiss::idx_t>* idsOut) {
 
     if (queryVectorJ == nullptr) {
         throw std::runtime_error("Query Vector cannot be null");
@@ -643,95 +1350,31 @@ jobjectArray knn_jni::faiss_wrapper::QueryIndex_WithFilter(knn_jni::JNIUtilInter
         throw std::runtime_error("Invalid pointer to index");
     }
 
-    std::unordered_map<std::string, jobject> methodParams;
-    if (methodParamsJ != nullptr) {
-        methodParams = jniUtil->ConvertJavaMapToCppMap(env, methodParamsJ);
-    }
     // The ids vector will hold the top k ids from the search and the dis vector will hold the top k distances from
     // the query point
-    std::vector<float> dis(kJ);
-    std::vector<faiss::idx_t> ids(kJ);
-    float* rawQueryvector = jniUtil->GetFloatArrayElements(env, queryVectorJ, nullptr);
+    std::vector<float>& dis = *disOut;
+    std::vector<faiss::idx_t>& ids = *idsOut;
+    dis.resize(kJ);
+    ids.resize(kJ);
     /*
         Setting the omp_set_num_threads to 1 to make sure that no new OMP threads are getting created.
     */
     omp_set_num_threads(1);
-    // create the filterSearch params if the filterIdsJ is not a null pointer
-    if(filterIdsJ != nullptr) {
-        jlong *filteredIdsArray = jniUtil->GetLongArrayElements(env, filterIdsJ, nullptr);
-        int filterIdsLength = jniUtil->GetJavaLongArrayLength(env, filterIdsJ);
-        std::unique_ptr<faiss::IDSelector> idSelector;
-        if(filterIdsTypeJ == BITMAP) {
-            idSelector.reset(new faiss::IDSelectorJlongBitmap(filterIdsLength, filteredIdsArray));
-        } else {
-            faiss::idx_t* batchIndices = reinterpret_cast<faiss::idx_t*>(filteredIdsArray);
-            idSelector.reset(new faiss::IDSelectorBatch(filterIdsLength, batchIndices));
-        }
-        faiss::SearchParameters *searchParameters;
-        faiss::SearchParametersHNSW hnswParams;
-        faiss::SearchParametersIVF ivfParams;
-        std::unique_ptr<faiss::IDGrouperBitmap> idGrouper;
-        std::vector<uint64_t> idGrouperBitmap;
-        auto hnswReader = dynamic_cast<const faiss::IndexHNSW*>(indexReader->index);
-        if(hnswReader) {
-            // Query param efsearch supersedes ef_search provided during index setting.
-            hnswParams.efSearch = knn_jni::commons::getIntegerMethodParameter(env, jniUtil, methodParams, EF_SEARCH, hnswReader->hnsw.efSearch);
-            hnswParams.sel = idSelector.get();
-            if (parentIdsJ != nullptr) {
-                idGrouper = buildIDGrouperBitmap(jniUtil, env, parentIdsJ, &idGrouperBitmap);
-                hnswParams.grp = idGrouper.get();
-            }
-            searchParameters = &hnswParams;
-        } else {
-            auto ivfReader = dynamic_cast<const faiss::IndexIVF*>(indexReader->index);
-            auto ivfFlatReader = dynamic_cast<const faiss::IndexIVFFlat*>(indexReader->index);
-            
-            if(ivfReader || ivfFlatReader) {
-                int indexNprobe = ivfReader == nullptr ? ivfFlatReader->nprobe : ivfReader->nprobe;
-                ivfParams.nprobe = commons::getIntegerMethodParameter(env, jniUtil, methodParams, NPROBES, indexNprobe);
-                ivfParams.sel = idSelector.get();
-                searchParameters = &ivfParams;
-            }
-        }
-        try {
-            indexReader->search(1, rawQueryvector, kJ, dis.data(), ids.data(), searchParameters);
-        } catch (...) {
-            jniUtil->ReleaseFloatArrayElements(env, queryVectorJ, rawQueryvector, JNI_ABORT);
-            jniUtil->ReleaseLongArrayElements(env, filterIdsJ, filteredIdsArray, JNI_ABORT);
-            throw;
-        }
-        jniUtil->ReleaseLongArrayElements(env, filterIdsJ, filteredIdsArray, JNI_ABORT);
-    } else {
-        faiss::SearchParameters *searchParameters = nullptr;
-        faiss::SearchParametersHNSW hnswParams;
-        faiss::SearchParametersIVF ivfParams;
-        std::unique_ptr<faiss::IDGrouperBitmap> idGrouper;
-        std::vector<uint64_t> idGrouperBitmap;
-        auto hnswReader = dynamic_cast<const faiss::IndexHNSW*>(indexReader->index);
-        if(hnswReader != nullptr) {
-            // Query param efsearch supersedes ef_search provided during index setting.
-            hnswParams.efSearch = knn_jni::commons::getIntegerMethodParameter(env, jniUtil, methodParams, EF_SEARCH, hnswReader->hnsw.efSearch);
-            if (parentIdsJ != nullptr) {
-                idGrouper = buildIDGrouperBitmap(jniUtil, env, parentIdsJ, &idGrouperBitmap);
-                hnswParams.grp = idGrouper.get();
-            }
-            searchParameters = &hnswParams;
-        } else {
-            auto ivfReader = dynamic_cast<const faiss::IndexIVF*>(indexReader->index);
-            if (ivfReader) {
-                int indexNprobe = ivfReader->nprobe;
-                ivfParams.nprobe = commons::getIntegerMethodParameter(env, jniUtil, methodParams, NPROBES, indexNprobe);
-                searchParameters = &ivfParams;
-            }
-        }
-        try {
-            indexReader->search(1, rawQueryvector, kJ, dis.data(), ids.data(), searchParameters);
-        } catch (...) {
-            jniUtil->ReleaseFloatArrayElements(env, queryVectorJ, rawQueryvector, JNI_ABORT);
-            throw;
-        }
+
+    // Only HNSW searches apply the parent grouper
+    std::shared_ptr<const CachedIDGrouper> idGrouper;
+    if (parentIdsJ != nullptr && dynamic_cast<const faiss::IndexHNSW*>(indexReader->index) != nullptr) {
+        idGrouper = getCachedIDGrouper(jniUtil, env, indexPointerJ, parentIdsJ);
     }
-    jniUtil->ReleaseFloatArrayElements(env, queryVectorJ, rawQueryvector, JNI_ABORT);
+    const int filterIdsLength = filterIdsJ == nullptr ? 0 : jniUtil->GetJavaLongArrayLength(env, filterIdsJ);
+
+    // No JNI calls past this point until the arrays are released
+    QueryFilterIds filteredIdsArray(jniUtil, env, filterIdsJ, filterIdsLength, true);
+    PinnedArray<float> rawQueryvector(jniUtil, env, queryVectorJ);
+    SearchIndexWithFilter(indexReader, indexPointerJ, rawQueryvector.get(), kJ, searchParams,
+                          filteredIdsArray.get(), filterIdsLength,
+                          filterIdsTypeJ, idGrouper == nullptr ? nullptr : idGrouper->grouper.get(), dis.data(),
+                          ids.data());
 
     // If there are not k results, the results will be padded with -1. Find the first -1, and set result size to that
     // index
@@ -740,22 +1383,208 @@ jobjectArray knn_jni::faiss_wrapper::QueryIndex_WithFilter(knn_jni::JNIUtilInter
     if (it != ids.end()) {
         resultSize = it - ids.begin();
     }
+    return resultSize;
+}
 
-    jclass resultClass = jniUtil->FindClass(env,"org/opensearch/knn/index/query/KNNQueryResult");
-    jmethodID allArgs = jniUtil->FindMethod(env, "org/opensearch/knn/index/query/KNNQueryResult", "<init>");
-
-    jobjectArray results = jniUtil->NewObjectArray(env, resultSize, resultClass, nullptr);
+void SearchIndexWithFilter(const faiss::IndexIDMap *indexReader, jlong indexPointerJ, const float *query, int k,
+                           const knn_jni::commons::SearchParams &searchParams, const jlong *filteredIdsArray,
+                           int filterIdsLength, jint filterIdsTypeJ, faiss::IDGrouper *grouper, float *dis,
+                           faiss::idx_t *ids) {
+    faiss::SearchParameters *searchParameters = nullptr;
+    faiss::SearchParametersHNSW hnswParams;
+    faiss::SearchParametersIVF ivfParams;
+    auto hnswReader = dynamic_cast<const faiss::IndexHNSW*>(indexReader->index);
+    if (hnswReader != nullptr) {
+        // Query param efsearch supersedes ef_search provided during index setting.
+        hnswParams.efSearch = searchParams.getEfSearch(hnswReader->hnsw.efSearch);
+        hnswParams.grp = grouper;
+        searchParameters = &hnswParams;
+    } else if (auto ivfReader = dynamic_cast<const faiss::IndexIVF*>(indexReader->index)) {
+        ivfParams.nprobe = searchParams.getNprobes(ivfReader->nprobe);
+        searchParameters = &ivfParams;
+    }
+
+    // A very selective filter is brute forced against the HNSW storage instead. Nested queries are left to HNSW,
+    // which applies the parent grouper.
+    if (filteredIdsArray != nullptr && hnswReader != nullptr && hnswReader->storage != nullptr && grouper == nullptr
+        && faiss_util::isExactSearchPreferred(QueryFilter::cardinality(filteredIdsArray, filterIdsLength, filterIdsTypeJ),
+                                              indexReader->ntotal, k, hnswParams.efSearch)
+        && hasSortedLabels(indexPointerJ, indexReader->id_map)) {
+        ExactScorer scorer(hnswReader->storage, query);
+        ExactSearchWithFilter(scorer, indexReader->metric_type == faiss::METRIC_INNER_PRODUCT, indexReader->id_map,
+                              true, filteredIdsArray, filterIdsLength, filterIdsTypeJ, k, dis, ids);
+        return;
+    }
+
+    // HNSW over byte vectors is walked with the integer distance computer. Nested queries still go through faiss.
+    if (hnswReader != nullptr && grouper == nullptr && knn_jni::faiss_wrapper::isInt8DirectStorage(hnswReader->storage)) {
+        if (indexReader->metric_type == faiss::METRIC_INNER_PRODUCT) {
+            faiss::heap_heapify<faiss::CMin<float, faiss::idx_t>>(k, dis, ids);
+            SearchSegmentIntoHeap<faiss::CMin<float, faiss::idx_t>>(indexReader, indexPointerJ, query, k, searchParams,
+                                                                    filteredIdsArray, filterIdsLength, filterIdsTypeJ,
+                                                                    dis, ids);
+            faiss::heap_reorder<faiss::CMin<float, faiss::idx_t>>(k, dis, ids);
+        } else {
+            faiss::heap_heapify<faiss::CMax<float, faiss::idx_t>>(k, dis, ids);
+            SearchSegmentIntoHeap<faiss::CMax<float, faiss::idx_t>>(indexReader, indexPointerJ, query, k, searchParams,
+                                                                    filteredIdsArray, filterIdsLength, filterIdsTypeJ,
+                                                                    dis, ids);
+            faiss::heap_reorder<faiss::CMax<float, faiss::idx_t>>(k, dis, ids);
+        }
+        return;
+    }
 
-    jobject result;
-    for(int i = 0; i < resultSize; ++i) {
-        result = jniUtil->NewObject(env, resultClass, allArgs, ids[i], dis[i]);
-        jniUtil->SetObjectArrayElement(env, results, i, result);
+    QueryFilter queryFilter;
+    faiss::IDSelector *idSelector = nullptr;
+    if (filteredIdsArray != nullptr) {
+        idSelector = queryFilter.build(filteredIdsArray, filterIdsLength, filterIdsTypeJ);
+        hnswParams.sel = idSelector;
+        ivfParams.sel = idSelector;
+    }
+    if (!ParallelSearchWithFilter(indexReader, query, k, searchParams.getParallelism(1), idSelector, ivfParams.nprobe,
+                                  dis, ids)) {
+        indexReader->search(1, query, k, dis, ids, searchParameters);
     }
-    return results;
 }
 
-jobjectArray knn_jni::faiss_wrapper::QueryBinaryIndex_WithFilter(knn_jni::JNIUtilInterface * jniUtil, JNIEnv * env, jlong indexPointerJ,
-                                                jbyteArray queryVectorJ, jint kJ, jobject methodParamsJ, jlongArray filterIdsJ, jint filterIdsTypeJ, jintArray parentIdsJ) {
+void knn_jni::faiss_wrapper::QueryIndexBatch(knn_jni::JNIUtilInterface * jniUtil, JNIEnv * env, jlong indexPointerJ,
+                                             jfloatArray queryVectorsJ, jint kJ, jobject methodParamsJ, jlongArray filterIdsJ,
+                                             jint filterIdsTypeJ, jintArray parentIdsJ, jintArray resultIdsJ,
+                                             jfloatArray resultDistancesJ) {
+
+    if (queryVectorsJ == nullptr) {
+        throw std::runtime_error("Query Vectors cannot be null");
+    }
+
+    if (resultIdsJ == nullptr || resultDistancesJ == nullptr) {
+        throw std::runtime_error("Result arrays cannot be null");
+    }
+
+    if (kJ <= 0) {
+        throw std::runtime_error("k must be greater than 0");
+    }
+
+    auto *indexReader = reinterpret_cast<faiss::IndexIDMap *>(indexPointerJ);
+
+    if (indexReader == nullptr) {
+        throw std::runtime_error("Invalid pointer to index");
+    }
+
+    // All query vectors are packed back to back in a single array, so the number of queries is implied by the
+    // dimension of the index
+    const int queryVectorsLength = jniUtil->GetJavaFloatArrayLength(env, queryVectorsJ);
+    if (queryVectorsLength == 0 || queryVectorsLength % indexReader->d != 0) {
+        throw std::runtime_error("Query vectors length must be a non-zero multiple of the index dimension");
+    }
+    const faiss::idx_t numQueries = queryVectorsLength / indexReader->d;
+    const size_t numResults = static_cast<size_t>(numQueries) * kJ;
+
+    if (static_cast<size_t>(jniUtil->GetJavaIntArrayLength(env, resultIdsJ)) < numResults
+        || static_cast<size_t>(jniUtil->GetJavaFloatArrayLength(env, resultDistancesJ)) < numResults) {
+        throw std::runtime_error("Result arrays must hold at least numQueries * k entries");
+    }
+
+    const knn_jni::commons::SearchParams searchParams = knn_jni::commons::parseSearchParams(jniUtil, env, methodParamsJ);
+
+    SearchScratch &scratch = GetSearchScratch();
+
+    // Search parameters and grouper are set up once and shared by every query in the batch
+    const int filterIdsLength = filterIdsJ == nullptr ? 0 : jniUtil->GetJavaLongArrayLength(env, filterIdsJ);
+    faiss::SearchParameters *searchParameters = nullptr;
+    faiss::SearchParameters defaultParams;
+    faiss::SearchParametersHNSW hnswParams;
+    faiss::SearchParametersIVF ivfParams;
+    std::shared_ptr<const CachedIDGrouper> idGrouper;
+    if (auto hnswReader = dynamic_cast<const faiss::IndexHNSW*>(indexReader->index)) {
+        // Query param efsearch supersedes ef_search provided during index setting.
+        hnswParams.efSearch = searchParams.getEfSearch(hnswReader->hnsw.efSearch);
+        if (parentIdsJ != nullptr) {
+            idGrouper = getCachedIDGrouper(jniUtil, env, indexPointerJ, parentIdsJ);
+            hnswParams.grp = idGrouper->grouper.get();
+        }
+        searchParameters = &hnswParams;
+    } else if (auto ivfReader = dynamic_cast<const faiss::IndexIVF*>(indexReader->index)) {
+        ivfParams.nprobe = searchParams.getNprobes(ivfReader->nprobe);
+        searchParameters = &ivfParams;
+    } else if (filterIdsJ != nullptr) {
+        searchParameters = &defaultParams;
+    }
+
+    std::vector<float> &dis = scratch.dis;
+    std::vector<faiss::idx_t> &ids = scratch.ids;
+    dis.resize(numResults);
+    ids.resize(numResults);
+
+    /*
+        Setting the omp_set_num_threads to 1 to make sure that no new OMP threads are getting created.
+    */
+    omp_set_num_threads(1);
+    {
+        // A batch runs many searches, so its queries and filter are copied rather than pinned
+        QueryFilterIds filteredIdsArray(jniUtil, env, filterIdsJ, filterIdsLength, false);
+        QueryFilter queryFilter;
+        if (filterIdsJ != nullptr) {
+            faiss::IDSelector *idSelector = queryFilter.build(filteredIdsArray.get(), filterIdsLength, filterIdsTypeJ);
+            hnswParams.sel = idSelector;
+            ivfParams.sel = idSelector;
+            defaultParams.sel = idSelector;
+        }
+        CopyJavaArray(jniUtil, env, queryVectorsJ, &scratch.query);
+        indexReader->search(numQueries, scratch.query.data(), kJ, dis.data(), ids.data(), searchParameters);
+    }
+
+    // Results stay laid out per query with k slots each; missing results keep the -1 id faiss pads them with
+    std::vector<jint> &resultIds = scratch.resultIds;
+    resultIds.assign(ids.begin(), ids.begin() + numResults);
+    jniUtil->SetIntArrayRegion(env, resultIdsJ, 0, numResults, resultIds.data());
+    jniUtil->SetFloatArrayRegion(env, resultDistancesJ, 0, numResults, dis.data());
+}
+
+jobjectArray knn_jni::faiss_wrapper::QueryBinaryIndex_WithFilter(knn_jni::JNIUtilInterface * jniUtil, JNIEnv * env, jlong indexPointerJ,
+                                                jbyteArray queryVectorJ, jint kJ, jobject methodParamsJ, jlongArray filterIdsJ, jint filterIdsTypeJ, jintArray parentIdsJ) {
+    SearchScratch &scratch = GetSearchScratch();
+    std::vector<int32_t> &dis = scratch.binaryDis;
+    std::vector<faiss::idx_t> &ids = scratch.ids;
+    int resultSize = InternalQueryBinaryIndex_WithFilter(jniUtil, env, indexPointerJ, queryVectorJ, kJ,
+                                                   knn_jni::commons::parseSearchParams(jniUtil, env, methodParamsJ), filterIdsJ,
+                                                         filterIdsTypeJ, parentIdsJ, &dis, &ids);
+    std::vector<float> &distances = scratch.convertedDis;
+    distances.assign(dis.begin(), dis.begin() + resultSize);
+    return knn_jni::commons::buildKNNQueryResults(jniUtil, env, ids.data(), distances.data(), resultSize);
+}
+
+jint knn_jni::faiss_wrapper::QueryBinaryIndex_WithFilterIntoArrays(knn_jni::JNIUtilInterface * jniUtil, JNIEnv * env, jlong indexPointerJ,
+                                                                   jbyteArray queryVectorJ, jint kJ, jobject methodParamsJ, jlongArray filterIdsJ,
+                                                                   jint filterIdsTypeJ, jintArray parentIdsJ, jintArray resultIdsJ,
+                                                                   jfloatArray resultDistancesJ) {
+    SearchScratch &scratch = GetSearchScratch();
+    std::vector<int32_t> &dis = scratch.binaryDis;
+    std::vector<faiss::idx_t> &ids = scratch.ids;
+    int resultSize = InternalQueryBinaryIndex_WithFilter(jniUtil, env, indexPointerJ, queryVectorJ, kJ,
+                                                   knn_jni::commons::parseSearchParams(jniUtil, env, methodParamsJ), filterIdsJ,
+                                                         filterIdsTypeJ, parentIdsJ, &dis, &ids);
+    std::vector<float> &distances = scratch.convertedDis;
+    distances.assign(dis.begin(), dis.begin() + resultSize);
+    return knn_jni::commons::copyQueryResults(jniUtil, env, ids.data(), distances.data(), resultSize, resultIdsJ, resultDistancesJ);
+}
+
+jobjectArray knn_jni::faiss_wrapper::QueryBinaryIndex_WithSearchParams(knn_jni::JNIUtilInterface * jniUtil, JNIEnv * env, jlong indexPointerJ,
+                                                                       jbyteArray queryVectorJ, jint kJ, jlong searchParamsPointerJ,
+                                                                       jlongArray filterIdsJ, jint filterIdsTypeJ, jintArray parentIdsJ) {
+    SearchScratch &scratch = GetSearchScratch();
+    std::vector<int32_t> &dis = scratch.binaryDis;
+    std::vector<faiss::idx_t> &ids = scratch.ids;
+    int resultSize = InternalQueryBinaryIndex_WithFilter(jniUtil, env, indexPointerJ, queryVectorJ, kJ,
+                                                         knn_jni::commons::getSearchParams(searchParamsPointerJ),
+                                                         filterIdsJ, filterIdsTypeJ, parentIdsJ, &dis, &ids);
+    std::vector<float> &distances = scratch.convertedDis;
+    distances.assign(dis.begin(), dis.begin() + resultSize);
+    return knn_jni::commons::buildKNNQueryResults(jniUtil, env, ids.data(), distances.data(), resultSize);
+}
+
+int InternalQueryBinaryIndex_WithFilter(knn_jni::JNIUtilInterface * jniUtil, JNIEnv * env, jlong indexPointerJ,
+                                        jbyteArray queryVectorJ, jint kJ, const knn_jni::commons::SearchParams &searchParams, jlongArray filterIdsJ, jint filterIdsTypeJ,
+                                        jintArray parentIdsJ, std::vector<int32_t>* disOut, std::vector<faiss::idx_t>* idsOut) {
 
     if (queryVectorJ == nullptr) {
         throw std::runtime_error("Query Vector cannot be null");
@@ -767,118 +1596,430 @@ jobjectArray knn_jni::faiss_wrapper::QueryBinaryIndex_WithFilter(knn_jni::JNIUti
         throw std::runtime_error("Invalid pointer to index");
     }
 
-    std::unordered_map<std::string, jobject> methodParams;
-    if (methodParamsJ != nullptr) {
-        methodParams = jniUtil->ConvertJavaMapToCppMap(env, methodParamsJ);
-    }
 
     // The ids vector will hold the top k ids from the search and the dis vector will hold the top k distances from
     // the query point
-    std::vector<int32_t> dis(kJ);
-    std::vector<faiss::idx_t> ids(kJ);
-    int8_t* rawQueryvector = jniUtil->GetByteArrayElements(env, queryVectorJ, nullptr);
+    std::vector<int32_t>& dis = *disOut;
+    std::vector<faiss::idx_t>& ids = *idsOut;
+    dis.resize(kJ);
+    ids.resize(kJ);
     /*
         Setting the omp_set_num_threads to 1 to make sure that no new OMP threads are getting created.
     */
     omp_set_num_threads(1);
     // create the filterSearch params if the filterIdsJ is not a null pointer
     if(filterIdsJ != nullptr) {
-        jlong *filteredIdsArray = jniUtil->GetLongArrayElements(env, filterIdsJ, nullptr);
         int filterIdsLength = jniUtil->GetJavaLongArrayLength(env, filterIdsJ);
-        std::unique_ptr<faiss::IDSelector> idSelector;
-        if(filterIdsTypeJ == BITMAP) {
-            idSelector.reset(new faiss::IDSelectorJlongBitmap(filterIdsLength, filteredIdsArray));
-        } else {
-            faiss::idx_t* batchIndices = reinterpret_cast<faiss::idx_t*>(filteredIdsArray);
-            idSelector.reset(new faiss::IDSelectorBatch(filterIdsLength, batchIndices));
-        }
-        faiss::SearchParameters *searchParameters;
+        faiss::SearchParameters *searchParameters = nullptr;
         faiss::SearchParametersHNSW hnswParams;
         faiss::SearchParametersIVF ivfParams;
-        std::unique_ptr<faiss::IDGrouperBitmap> idGrouper;
-        std::vector<uint64_t> idGrouperBitmap;
+        std::shared_ptr<const CachedIDGrouper> idGrouper;
         auto hnswReader = dynamic_cast<const faiss::IndexBinaryHNSW*>(indexReader->index);
         if(hnswReader) {
             // Query param efsearch supersedes ef_search provided during index setting.
-            hnswParams.efSearch = knn_jni::commons::getIntegerMethodParameter(env, jniUtil, methodParams, EF_SEARCH, hnswReader->hnsw.efSearch);
-            hnswParams.sel = idSelector.get();
+            hnswParams.efSearch = searchParams.getEfSearch(hnswReader->hnsw.efSearch);
             if (parentIdsJ != nullptr) {
-                idGrouper = buildIDGrouperBitmap(jniUtil, env, parentIdsJ, &idGrouperBitmap);
-                hnswParams.grp = idGrouper.get();
+                idGrouper = getCachedIDGrouper(jniUtil, env, indexPointerJ, parentIdsJ);
+                hnswParams.grp = idGrouper->grouper.get();
             }
             searchParameters = &hnswParams;
         } else {
             auto ivfReader = dynamic_cast<const faiss::IndexBinaryIVF*>(indexReader->index);
             if(ivfReader) {
-                ivfParams.sel = idSelector.get();
                 searchParameters = &ivfParams;
             }
         }
-        try {
-            indexReader->search(1, reinterpret_cast<uint8_t*>(rawQueryvector), kJ, dis.data(), ids.data(), searchParameters);
-        } catch (...) {
-            jniUtil->ReleaseByteArrayElements(env, queryVectorJ, rawQueryvector, JNI_ABORT);
-            jniUtil->ReleaseLongArrayElements(env, filterIdsJ, filteredIdsArray, JNI_ABORT);
-            throw;
+
+        // A very selective filter is brute forced against the HNSW storage instead. Nested queries are left to HNSW,
+        // which applies the parent grouper.
+        const bool canSearchExactly = hnswReader != nullptr && hnswReader->storage != nullptr && parentIdsJ == nullptr
+                                      && hasSortedLabels(indexPointerJ, indexReader->id_map);
+
+        // No JNI calls past this point until the arrays are released
+        QueryFilterIds filteredIdsArray(jniUtil, env, filterIdsJ, filterIdsLength, true);
+        PinnedArray<uint8_t> rawQueryvector(jniUtil, env, queryVectorJ);
+        if (canSearchExactly && faiss_util::isExactSearchPreferred(
+                QueryFilter::cardinality(filteredIdsArray.get(), filterIdsLength, filterIdsTypeJ),
+                indexReader->ntotal, kJ, hnswParams.efSearch)) {
+            // Hamming distances are computed as floats, they are converted back once the top k are known
+            ExactScorer scorer(hnswReader->get_distance_computer(), rawQueryvector.get());
+            std::vector<float> &exactDis = GetSearchScratch().dis;
+            exactDis.resize(kJ);
+            ExactSearchWithFilter(scorer, false, indexReader->id_map, true, filteredIdsArray.get(), filterIdsLength,
+                                  filterIdsTypeJ, kJ, exactDis.data(), ids.data());
+            for (int i = 0; i < kJ; i++) {
+                dis[i] = ids[i] == -1 ? 0 : static_cast<int32_t>(exactDis[i]);
+            }
+        } else {
+            QueryFilter queryFilter;
+            faiss::IDSelector *idSelector = queryFilter.build(filteredIdsArray.get(), filterIdsLength, filterIdsTypeJ);
+            hnswParams.sel = idSelector;
+            ivfParams.sel = idSelector;
+            indexReader->search(1, rawQueryvector.get(), kJ, dis.data(), ids.data(), searchParameters);
         }
-        jniUtil->ReleaseLongArrayElements(env, filterIdsJ, filteredIdsArray, JNI_ABORT);
     } else {
         faiss::SearchParameters *searchParameters = nullptr;
         faiss::SearchParametersHNSW hnswParams;
         faiss::SearchParametersIVF ivfParams;
-        std::unique_ptr<faiss::IDGrouperBitmap> idGrouper;
-        std::vector<uint64_t> idGrouperBitmap;
+        std::shared_ptr<const CachedIDGrouper> idGrouper;
         auto ivfReader = dynamic_cast<const faiss::IndexBinaryIVF*>(indexReader->index);
         // TODO currently, search parameter is not supported in binary index
-        // To avoid test failure, we skip setting ef search when methodPramsJ is null temporary
+        // To avoid test failure, we skip setting ef search when no ef_search is provided temporary
         if (ivfReader) {
             int indexNprobe = ivfReader->nprobe;
-            ivfParams.nprobe = commons::getIntegerMethodParameter(env, jniUtil, methodParams, NPROBES, indexNprobe);
+            ivfParams.nprobe = searchParams.getNprobes(indexNprobe);
             searchParameters = &ivfParams;
         } else {
             auto hnswReader = dynamic_cast<const faiss::IndexBinaryHNSW*>(indexReader->index);
-            if(hnswReader != nullptr && (methodParamsJ != nullptr || parentIdsJ != nullptr)) {
+            if(hnswReader != nullptr && (searchParams.hasEfSearch || parentIdsJ != nullptr)) {
                // Query param efsearch supersedes ef_search provided during index setting.
-               hnswParams.efSearch = knn_jni::commons::getIntegerMethodParameter(env, jniUtil, methodParams, EF_SEARCH, hnswReader->hnsw.efSearch);
+               hnswParams.efSearch = searchParams.getEfSearch(hnswReader->hnsw.efSearch);
                if (parentIdsJ != nullptr) {
-                   idGrouper = buildIDGrouperBitmap(jniUtil, env, parentIdsJ, &idGrouperBitmap);
-                   hnswParams.grp = idGrouper.get();
+                   idGrouper = getCachedIDGrouper(jniUtil, env, indexPointerJ, parentIdsJ);
+                   hnswParams.grp = idGrouper->grouper.get();
                }
                searchParameters = &hnswParams;
             }
         }
 
+        PinnedArray<uint8_t> rawQueryvector(jniUtil, env, queryVectorJ);
+        indexReader->search(1, rawQueryvector.get(), kJ, dis.data(), ids.data(), searchParameters);
+    }
+
+    // If there are not k results, the results will be padded with -1. Find the first -1, and set result size to that
+    // index
+    int resultSize = kJ;
+    auto it = std::find(ids.begin(), ids.end(), -1);
+    if (it != ids.end()) {
+        resultSize = it - ids.begin();
+    }
+    return resultSize;
+}
+
+jobjectArray knn_jni::faiss_wrapper::ExactSearch(knn_jni::JNIUtilInterface * jniUtil, JNIEnv * env, jlong indexPointerJ,
+                                                 jfloatArray queryVectorJ, jint kJ, jlongArray filterIdsJ, jint filterIdsTypeJ) {
+    if (queryVectorJ == nullptr) {
+        throw std::runtime_error("Query Vector cannot be null");
+    }
+
+    if (kJ <= 0) {
+        throw std::runtime_error("k must be greater than 0");
+    }
+
+    auto *indexReader = reinterpret_cast<faiss::IndexIDMap *>(indexPointerJ);
+
+    if (indexReader == nullptr) {
+        throw std::runtime_error("Invalid pointer to index");
+    }
+
+    if (jniUtil->GetJavaFloatArrayLength(env, queryVectorJ) != indexReader->d) {
+        throw std::runtime_error("Query vector dimension does not match the index dimension");
+    }
+
+    const faiss::Index *storage = GetExactSearchStorage(indexReader->index);
+    const int filterIdsLength = filterIdsJ == nullptr ? 0 : jniUtil->GetJavaLongArrayLength(env, filterIdsJ);
+    const bool sortedLabels = hasSortedLabels(indexPointerJ, indexReader->id_map);
+
+    SearchScratch &scratch = GetSearchScratch();
+    std::vector<float> &dis = scratch.dis;
+    std::vector<faiss::idx_t> &ids = scratch.ids;
+    dis.resize(kJ);
+    ids.resize(kJ);
+    {
+        // No JNI calls in this scope, the arrays are pinned until it ends
+        QueryFilterIds filteredIdsArray(jniUtil, env, filterIdsJ, filterIdsLength, true);
+        PinnedArray<float> rawQueryVector(jniUtil, env, queryVectorJ);
+        ExactScorer scorer(storage, rawQueryVector.get());
+        ExactSearchWithFilter(scorer, indexReader->metric_type == faiss::METRIC_INNER_PRODUCT, indexReader->id_map,
+                              sortedLabels, filteredIdsArray.get(), filterIdsLength,
+                              filterIdsTypeJ, kJ, dis.data(), ids.data());
+    }
+
+    int resultSize = std::find(ids.begin(), ids.end(), -1) - ids.begin();
+    return knn_jni::commons::buildKNNQueryResults(jniUtil, env, ids.data(), dis.data(), resultSize);
+}
+
+jobjectArray knn_jni::faiss_wrapper::ExactSearchBinary(knn_jni::JNIUtilInterface * jniUtil, JNIEnv * env, jlong indexPointerJ,
+                                                       jbyteArray queryVectorJ, jint kJ, jlongArray filterIdsJ,
+                                                       jint filterIdsTypeJ) {
+    if (queryVectorJ == nullptr) {
+        throw std::runtime_error("Query Vector cannot be null");
+    }
+
+    if (kJ <= 0) {
+        throw std::runtime_error("k must be greater than 0");
+    }
+
+    auto *indexReader = reinterpret_cast<faiss::IndexBinaryIDMap *>(indexPointerJ);
+
+    if (indexReader == nullptr) {
+        throw std::runtime_error("Invalid pointer to index");
+    }
+
+    if (jniUtil->GetJavaBytesArrayLength(env, queryVectorJ) != indexReader->code_size) {
+        throw std::runtime_error("Query vector dimension does not match the index dimension");
+    }
+
+    auto hnswReader = dynamic_cast<const faiss::IndexBinaryHNSW *>(indexReader->index);
+    if (hnswReader == nullptr) {
+        throw std::runtime_error("Exact search is only supported for binary HNSW indexes");
+    }
+    const int filterIdsLength = filterIdsJ == nullptr ? 0 : jniUtil->GetJavaLongArrayLength(env, filterIdsJ);
+    const bool sortedLabels = hasSortedLabels(indexPointerJ, indexReader->id_map);
+
+    SearchScratch &scratch = GetSearchScratch();
+    std::vector<float> &dis = scratch.dis;
+    std::vector<faiss::idx_t> &ids = scratch.ids;
+    dis.resize(kJ);
+    ids.resize(kJ);
+    {
+        // No JNI calls in this scope, the arrays are pinned until it ends
+        QueryFilterIds filteredIdsArray(jniUtil, env, filterIdsJ, filterIdsLength, true);
+        PinnedArray<uint8_t> rawQueryVector(jniUtil, env, queryVectorJ);
+        ExactScorer scorer(hnswReader->get_distance_computer(), rawQueryVector.get());
+        ExactSearchWithFilter(scorer, false, indexReader->id_map, sortedLabels, filteredIdsArray.get(),
+                              filterIdsLength, filterIdsTypeJ, kJ, dis.data(), ids.data());
+    }
+
+    int resultSize = std::find(ids.begin(), ids.end(), -1) - ids.begin();
+    return knn_jni::commons::buildKNNQueryResults(jniUtil, env, ids.data(), dis.data(), resultSize);
+}
+
+jlong knn_jni::faiss_wrapper::SubmitQueryIndex(knn_jni::JNIUtilInterface * jniUtil, JNIEnv * env, jlong indexPointerJ,
+                                               jfloatArray queryVectorJ, jint kJ, jobject methodParamsJ,
+                                               jlongArray filterIdsJ, jint filterIdsTypeJ, jintArray parentIdsJ) {
+    if (queryVectorJ == nullptr) {
+        throw std::runtime_error("Query Vector cannot be null");
+    }
+
+    if (kJ <= 0) {
+        throw std::runtime_error("k must be greater than 0");
+    }
+
+    auto *indexReader = reinterpret_cast<faiss::IndexIDMap *>(indexPointerJ);
+
+    if (indexReader == nullptr) {
+        throw std::runtime_error("Invalid pointer to index");
+    }
+
+    const int queryVectorLength = jniUtil->GetJavaFloatArrayLength(env, queryVectorJ);
+    if (queryVectorLength != indexReader->d) {
+        throw std::runtime_error("Query vector dimension does not match the index dimension");
+    }
+
+    auto task = std::make_shared<SearchTask>();
+    task->indexPointer = indexPointerJ;
+    task->k = kJ;
+    task->searchParams = knn_jni::commons::parseSearchParams(jniUtil, env, methodParamsJ);
+    task->hasFilter = filterIdsJ != nullptr;
+    task->filterIdsType = filterIdsTypeJ;
+    if (parentIdsJ != nullptr && dynamic_cast<const faiss::IndexHNSW*>(indexReader->index) != nullptr) {
+        task->idGrouper = getCachedIDGrouper(jniUtil, env, indexPointerJ, parentIdsJ);
+    }
+
+    if (filterIdsJ != nullptr) {
+        CopyJavaArray(jniUtil, env, filterIdsJ, &task->filterIds);
+    }
+    CopyJavaArray(jniUtil, env, queryVectorJ, &task->query);
+
+    knn_jni::NativeThreadPool::getInstance().submit([task]() {
+        // Pool threads start with the process wide OpenMP settings
+        omp_set_num_threads(1);
         try {
-            indexReader->search(1, reinterpret_cast<uint8_t*>(rawQueryvector), kJ, dis.data(), ids.data(), searchParameters);
+            task->dis.resize(task->k);
+            task->ids.resize(task->k);
+            SearchIndexWithFilter(reinterpret_cast<const faiss::IndexIDMap *>(task->indexPointer), task->indexPointer,
+                                  task->query.data(), task->k, task->searchParams,
+                                  task->hasFilter ? task->filterIds.data() : nullptr,
+                                  static_cast<int>(task->filterIds.size()), task->filterIdsType,
+                                  task->idGrouper == nullptr ? nullptr : task->idGrouper->grouper.get(),
+                                  task->dis.data(), task->ids.data());
         } catch (...) {
-            jniUtil->ReleaseByteArrayElements(env, queryVectorJ, rawQueryvector, JNI_ABORT);
-            throw;
+            task->error = std::current_exception();
+        }
+        std::lock_guard<std::mutex> lock(task->mutex);
+        task->done = true;
+        task->finished.notify_all();
+    });
+    return reinterpret_cast<jlong>(new std::shared_ptr<SearchTask>(std::move(task)));
+}
+
+jobjectArray knn_jni::faiss_wrapper::QueryIndexes(knn_jni::JNIUtilInterface * jniUtil, JNIEnv * env,
+                                                  jlongArray indexPointersJ, jintArray docBasesJ,
+                                                  jfloatArray queryVectorJ, jint kJ, jobject methodParamsJ,
+                                                  jobjectArray filterIdsJ, jintArray filterIdsTypesJ) {
+    if (indexPointersJ == nullptr || docBasesJ == nullptr) {
+        throw std::runtime_error("Index pointers and doc bases cannot be null");
+    }
+
+    if (queryVectorJ == nullptr) {
+        throw std::runtime_error("Query Vector cannot be null");
+    }
+
+    if (kJ <= 0) {
+        throw std::runtime_error("k must be greater than 0");
+    }
+
+    std::vector<jlong> indexPointers;
+    CopyJavaArray(jniUtil, env, indexPointersJ, &indexPointers);
+    const int numSegments = static_cast<int>(indexPointers.size());
+    std::vector<int64_t> docBases = jniUtil->ConvertJavaIntArrayToCppIntVector(env, docBasesJ);
+    if (docBases.size() != static_cast<size_t>(numSegments)) {
+        throw std::runtime_error("Every index needs a doc base");
+    }
+    std::vector<int64_t> filterIdsTypes;
+    if (filterIdsJ != nullptr) {
+        if (filterIdsTypesJ == nullptr || jniUtil->GetJavaObjectArrayLength(env, filterIdsJ) != numSegments) {
+            throw std::runtime_error("Every index needs a filter and a filter type, the filter may be null");
+        }
+        filterIdsTypes = jniUtil->ConvertJavaIntArrayToCppIntVector(env, filterIdsTypesJ);
+        if (filterIdsTypes.size() != static_cast<size_t>(numSegments)) {
+            throw std::runtime_error("Every index needs a filter and a filter type, the filter may be null");
         }
     }
-    jniUtil->ReleaseByteArrayElements(env, queryVectorJ, rawQueryvector, JNI_ABORT);
 
-    // If there are not k results, the results will be padded with -1. Find the first -1, and set result size to that
-    // index
+    faiss::MetricType metric = faiss::METRIC_L2;
+    const int queryVectorLength = jniUtil->GetJavaFloatArrayLength(env, queryVectorJ);
+    for (int i = 0; i < numSegments; i++) {
+        auto *indexReader = reinterpret_cast<faiss::IndexIDMap *>(indexPointers[i]);
+        if (indexReader == nullptr) {
+            throw std::runtime_error("Invalid pointer to index");
+        }
+        if (indexReader->d != queryVectorLength) {
+            throw std::runtime_error("Query vector dimension does not match the index dimension");
+        }
+        if (i == 0) {
+            metric = indexReader->metric_type;
+        } else if (indexReader->metric_type != metric) {
+            throw std::runtime_error("All indexes must use the same metric");
+        }
+    }
+
+    // The segments are searched one after the other, so the query is copied rather than pinned over all of them
+    std::vector<float> query;
+    CopyJavaArray(jniUtil, env, queryVectorJ, &query);
+    knn_jni::commons::SearchParams searchParams = knn_jni::commons::parseSearchParams(jniUtil, env, methodParamsJ);
+
+    omp_set_num_threads(1);
+
+    // Hits of all the segments, with doc ids offset by their segment's doc base
+    std::vector<float> dis(kJ);
+    std::vector<faiss::idx_t> ids(kJ);
+    std::vector<float> segmentDis(kJ);
+    std::vector<faiss::idx_t> segmentIds(kJ);
+    const bool isSimilarity = metric == faiss::METRIC_INNER_PRODUCT;
+    if (isSimilarity) {
+        faiss::heap_heapify<faiss::CMin<float, faiss::idx_t>>(kJ, dis.data(), ids.data());
+    } else {
+        faiss::heap_heapify<faiss::CMax<float, faiss::idx_t>>(kJ, dis.data(), ids.data());
+    }
+
+    for (int i = 0; i < numSegments; i++) {
+        auto *indexReader = reinterpret_cast<const faiss::IndexIDMap *>(indexPointers[i]);
+        jlongArray segmentFilterIdsJ = filterIdsJ == nullptr
+                ? nullptr : static_cast<jlongArray>(jniUtil->GetObjectArrayElement(env, filterIdsJ, i));
+        const int filterIdsLength = segmentFilterIdsJ == nullptr
+                ? 0 : jniUtil->GetJavaLongArrayLength(env, segmentFilterIdsJ);
+
+        // The segment heap starts out holding the k-th best distance found so far, so the segment only contributes
+        // hits that beat it
+        std::fill(segmentDis.begin(), segmentDis.end(), dis[0]);
+        std::fill(segmentIds.begin(), segmentIds.end(), -1);
+        {
+            // No JNI calls until the filter is released
+            QueryFilterIds filteredIdsArray(jniUtil, env, segmentFilterIdsJ, filterIdsLength, true);
+            const jlong *filter = filteredIdsArray.get();
+            const jint filterIdsType = filterIdsJ == nullptr ? 0 : static_cast<jint>(filterIdsTypes[i]);
+            if (isSimilarity) {
+                SearchSegmentIntoHeap<faiss::CMin<float, faiss::idx_t>>(
+                        indexReader, indexPointers[i], query.data(), kJ, searchParams, filter, filterIdsLength,
+                        filterIdsType, segmentDis.data(), segmentIds.data());
+            } else {
+                SearchSegmentIntoHeap<faiss::CMax<float, faiss::idx_t>>(
+                        indexReader, indexPointers[i], query.data(), kJ, searchParams, filter, filterIdsLength,
+                        filterIdsType, segmentDis.data(), segmentIds.data());
+            }
+        }
+        if (segmentFilterIdsJ != nullptr) {
+            jniUtil->DeleteLocalRef(env, segmentFilterIdsJ);
+        }
+
+        // Hits of the segment beat the k-th best distance it started from, but not necessarily the one reached while
+        // they are merged
+        for (int j = 0; j < kJ; j++) {
+            if (segmentIds[j] < 0) {
+                continue;
+            }
+            if (isSimilarity) {
+                if (segmentDis[j] <= dis[0]) {
+                    continue;
+                }
+                faiss::heap_replace_top<faiss::CMin<float, faiss::idx_t>>(kJ, dis.data(), ids.data(), segmentDis[j],
+                                                                         docBases[i] + segmentIds[j]);
+            } else {
+                if (segmentDis[j] >= dis[0]) {
+                    continue;
+                }
+                faiss::heap_replace_top<faiss::CMax<float, faiss::idx_t>>(kJ, dis.data(), ids.data(), segmentDis[j],
+                                                                         docBases[i] + segmentIds[j]);
+            }
+        }
+    }
+
+    if (isSimilarity) {
+        faiss::heap_reorder<faiss::CMin<float, faiss::idx_t>>(kJ, dis.data(), ids.data());
+    } else {
+        faiss::heap_reorder<faiss::CMax<float, faiss::idx_t>>(kJ, dis.data(), ids.data());
+    }
     int resultSize = kJ;
     auto it = std::find(ids.begin(), ids.end(), -1);
     if (it != ids.end()) {
         resultSize = it - ids.begin();
     }
+    return knn_jni::commons::buildKNNQueryResults(jniUtil, env, ids.data(), dis.data(), resultSize);
+}
+
+jboolean knn_jni::faiss_wrapper::IsSearchTaskDone(jlong searchTaskPointerJ) {
+    auto *task = reinterpret_cast<std::shared_ptr<SearchTask> *>(searchTaskPointerJ);
+    if (task == nullptr) {
+        throw std::runtime_error("Invalid pointer to search task");
+    }
+    std::lock_guard<std::mutex> lock((*task)->mutex);
+    return (*task)->done;
+}
 
-    jclass resultClass = jniUtil->FindClass(env,"org/opensearch/knn/index/query/KNNQueryResult");
-    jmethodID allArgs = jniUtil->FindMethod(env, "org/opensearch/knn/index/query/KNNQueryResult", "<init>");
+jobjectArray knn_jni::faiss_wrapper::GetSearchTaskResults(knn_jni::JNIUtilInterface * jniUtil, JNIEnv * env,
+                                                          jlong searchTaskPointerJ) {
+    std::unique_ptr<std::shared_ptr<SearchTask>> task(reinterpret_cast<std::shared_ptr<SearchTask> *>(searchTaskPointerJ));
+    if (task == nullptr) {
+        throw std::runtime_error("Invalid pointer to search task");
+    }
+    (*task)->waitUntilDone();
+    if ((*task)->error) {
+        std::rethrow_exception((*task)->error);
+    }
 
-    jobjectArray results = jniUtil->NewObjectArray(env, resultSize, resultClass, nullptr);
+    const std::vector<faiss::idx_t> &ids = (*task)->ids;
+    int resultSize = (*task)->k;
+    auto it = std::find(ids.begin(), ids.end(), -1);
+    if (it != ids.end()) {
+        resultSize = it - ids.begin();
+    }
+    return knn_jni::commons::buildKNNQueryResults(jniUtil, env, ids.data(), (*task)->dis.data(), resultSize);
+}
 
-    jobject result;
-    for(int i = 0; i < resultSize; ++i) {
-        result = jniUtil->NewObject(env, resultClass, allArgs, ids[i], dis[i]);
-        jniUtil->SetObjectArrayElement(env, results, i, result);
+void knn_jni::faiss_wrapper::FreeSearchTask(jlong searchTaskPointerJ) {
+    std::unique_ptr<std::shared_ptr<SearchTask>> task(reinterpret_cast<std::shared_ptr<SearchTask> *>(searchTaskPointerJ));
+    if (task == nullptr) {
+        return;
     }
-    return results;
+    // The search reads the index, so the task only lets go once it has finished
+    (*task)->waitUntilDone();
 }
 
 void knn_jni::faiss_wrapper::Free(jlong indexPointer, jboolean isBinaryIndexJ) {
+    evictCachedIDGrouper(indexPointer);
+    evictSortedLabels(indexPointer);
     bool isBinaryIndex = static_cast<bool>(isBinaryIndexJ);
     if (isBinaryIndex) {
         auto *indexWrapper = reinterpret_cast<faiss::IndexBinary*>(indexPointer);
@@ -899,21 +2040,296 @@ void knn_jni::faiss_wrapper::FreeSharedIndexState(jlong shareIndexStatePointerJ)
     delete alignTable;
 }
 
-void knn_jni::faiss_wrapper::InitLibrary() {
+void knn_jni::faiss_wrapper::InitLibrary(jint searchThreadPoolSizeJ, jboolean pinSearchThreadsJ) {
     //set thread 1 cause ES has Search thread
     //TODO make it different at search and write
     //	omp_set_num_threads(1);
+    knn_jni::NativeThreadPool::initialize(searchThreadPoolSizeJ, pinSearchThreadsJ);
 }
 
 jbyteArray knn_jni::faiss_wrapper::TrainIndex(knn_jni::JNIUtilInterface * jniUtil, JNIEnv * env, jobject parametersJ,
                                               jint dimensionJ, jlong trainVectorsPointerJ) {
-    // First, we need to build the index
+    std::unique_ptr<faiss::Index> indexWriter = BuildTrainedIndex(jniUtil, env, parametersJ, dimensionJ,
+                                                                  trainVectorsPointerJ);
+
+    // Now that indexWriter is trained, we just load the bytes into an array and return
+    faiss::VectorIOWriter vectorIoWriter;
+    faiss::write_index(indexWriter.get(), &vectorIoWriter);
+    return NewJavaByteArray(jniUtil, env, vectorIoWriter.data);
+}
+
+jbyteArray knn_jni::faiss_wrapper::TrainBinaryIndex(knn_jni::JNIUtilInterface * jniUtil, JNIEnv * env, jobject parametersJ,
+                                              jint dimensionJ, jlong trainVectorsPointerJ) {
+    std::unique_ptr<faiss::IndexBinary> indexWriter = BuildTrainedBinaryIndex(jniUtil, env, parametersJ, dimensionJ,
+                                                                              trainVectorsPointerJ);
+
+    // Now that indexWriter is trained, we just load the bytes into an array and return
+    faiss::VectorIOWriter vectorIoWriter;
+    faiss::write_index_binary(indexWriter.get(), &vectorIoWriter);
+    return NewJavaByteArray(jniUtil, env, vectorIoWriter.data);
+}
+
+jbyteArray knn_jni::faiss_wrapper::TrainByteIndex(knn_jni::JNIUtilInterface * jniUtil, JNIEnv * env, jobject parametersJ,
+                                              jint dimensionJ, jlong trainVectorsPointerJ) {
+    std::unique_ptr<faiss::Index> indexWriter = BuildTrainedByteIndex(jniUtil, env, parametersJ, dimensionJ,
+                                                                      trainVectorsPointerJ);
+
+    // Now that indexWriter is trained, we just load the bytes into an array and return
+    faiss::VectorIOWriter vectorIoWriter;
+    faiss::write_index(indexWriter.get(), &vectorIoWriter);
+    return NewJavaByteArray(jniUtil, env, vectorIoWriter.data);
+}
+
+void knn_jni::faiss_wrapper::TrainIndexWithStream(knn_jni::JNIUtilInterface * jniUtil, JNIEnv * env, jobject parametersJ,
+                                                  jint dimensionJ, jlong trainVectorsPointerJ, jobject output) {
+    if (output == nullptr) {
+        throw std::runtime_error("Index output stream cannot be null");
+    }
+
+    std::unique_ptr<faiss::Index> indexWriter = BuildTrainedIndex(jniUtil, env, parametersJ, dimensionJ,
+                                                                  trainVectorsPointerJ);
+
+    // Serialize the trained index straight into the IndexOutput
+    knn_jni::stream::NativeEngineIndexOutputMediator mediator {jniUtil, env, output};
+    knn_jni::stream::FaissOpenSearchIOWriter writer {&mediator};
+    faiss::write_index(indexWriter.get(), &writer);
+    mediator.flush();
+}
+
+void knn_jni::faiss_wrapper::TrainBinaryIndexWithStream(knn_jni::JNIUtilInterface * jniUtil, JNIEnv * env,
+                                                        jobject parametersJ, jint dimensionJ,
+                                                        jlong trainVectorsPointerJ, jobject output) {
+    if (output == nullptr) {
+        throw std::runtime_error("Index output stream cannot be null");
+    }
+
+    std::unique_ptr<faiss::IndexBinary> indexWriter = BuildTrainedBinaryIndex(jniUtil, env, parametersJ, dimensionJ,
+                                                                              trainVectorsPointerJ);
+
+    // Serialize the trained index straight into the IndexOutput
+    knn_jni::stream::NativeEngineIndexOutputMediator mediator {jniUtil, env, output};
+    knn_jni::stream::FaissOpenSearchIOWriter writer {&mediator};
+    faiss::write_index_binary(indexWriter.get(), &writer);
+    mediator.flush();
+}
+
+void knn_jni::faiss_wrapper::TrainByteIndexWithStream(knn_jni::JNIUtilInterface * jniUtil, JNIEnv * env,
+                                                      jobject parametersJ, jint dimensionJ,
+                                                      jlong trainVectorsPointerJ, jobject output) {
+    if (output == nullptr) {
+        throw std::runtime_error("Index output stream cannot be null");
+    }
+
+    std::unique_ptr<faiss::Index> indexWriter = BuildTrainedByteIndex(jniUtil, env, parametersJ, dimensionJ,
+                                                                      trainVectorsPointerJ);
+
+    // Serialize the trained index straight into the IndexOutput
+    knn_jni::stream::NativeEngineIndexOutputMediator mediator {jniUtil, env, output};
+    knn_jni::stream::FaissOpenSearchIOWriter writer {&mediator};
+    faiss::write_index(indexWriter.get(), &writer);
+    mediator.flush();
+}
+
+jlong knn_jni::faiss_wrapper::InitTrainingSession(knn_jni::JNIUtilInterface * jniUtil, JNIEnv * env,
+                                                 jobject parametersJ, jint dimensionJ, TrainingVectorType vectorType) {
     if (parametersJ == nullptr) {
         throw std::runtime_error("Parameters cannot be null");
     }
 
     auto parametersCpp = jniUtil->ConvertJavaMapToCppMap(env, parametersJ);
+    std::unique_ptr<TrainingSession> session(new TrainingSession());
+    session->dimension = dimensionJ;
+    session->threadCount = GetThreadCount(jniUtil, env, parametersCpp);
+
+    size_t codeSize;
+    size_t sampleSize;
+    if (vectorType == TrainingVectorType::BINARY) {
+        session->binaryIndex = CreateBinaryIndexForTraining(jniUtil, env, parametersCpp, dimensionJ);
+        codeSize = dimensionJ / 8;
+        sampleSize = trainingSampleSize(session->binaryIndex.get());
+    } else {
+        session->index = CreateIndexForTraining(jniUtil, env, parametersCpp, dimensionJ);
+        session->byteVectors = vectorType == TrainingVectorType::BYTE;
+        codeSize = session->byteVectors ? dimensionJ : dimensionJ * sizeof(float);
+        sampleSize = trainingSampleSize(session->index.get());
+    }
+    jniUtil->DeleteLocalRef(env, parametersJ);
+
+    session->reservoir.reset(new VectorReservoir(codeSize, sampleSize, TRAINING_SAMPLE_SEED));
+    return reinterpret_cast<jlong>(session.release());
+}
+
+void knn_jni::faiss_wrapper::AddTrainingVectors(jlong sessionPointerJ, jlong vectorsPointerJ) {
+    auto *session = reinterpret_cast<TrainingSession *>(sessionPointerJ);
+    if (session == nullptr) {
+        throw std::runtime_error("Training session cannot be null");
+    }
+    if (vectorsPointerJ == 0) {
+        throw std::runtime_error("Training vectors cannot be null");
+    }
+
+    // The vectors are stored like the ones handed to the Train functions, in a vector of the element type
+    const uint8_t *vectors;
+    size_t numBytes;
+    if (session->binaryIndex != nullptr) {
+        auto *binaryVectors = reinterpret_cast<std::vector<uint8_t> *>(vectorsPointerJ);
+        vectors = binaryVectors->data();
+        numBytes = binaryVectors->size();
+    } else if (session->byteVectors) {
+        auto *byteVectors = reinterpret_cast<std::vector<int8_t> *>(vectorsPointerJ);
+        vectors = reinterpret_cast<const uint8_t *>(byteVectors->data());
+        numBytes = byteVectors->size();
+    } else {
+        auto *floatVectors = reinterpret_cast<std::vector<float> *>(vectorsPointerJ);
+        vectors = reinterpret_cast<const uint8_t *>(floatVectors->data());
+        numBytes = floatVectors->size() * sizeof(float);
+    }
+
+    session->reservoir->add(vectors, numBytes / session->reservoir->vectorSize());
+}
+
+// Train the index of the session on its sample
+void TrainSessionIndex(TrainingSession *session) {
+    if (session == nullptr) {
+        throw std::runtime_error("Training session cannot be null");
+    }
+    // Set thread count if it was passed in as a parameter. Setting this variable will only impact the current thread
+    if (session->threadCount > 0) {
+        omp_set_num_threads(session->threadCount);
+    }
+
+    const knn_jni::faiss_wrapper::VectorReservoir &reservoir = *session->reservoir;
+    const bool trained = session->binaryIndex != nullptr ? session->binaryIndex->is_trained : session->index->is_trained;
+    if (trained) {
+        return;
+    }
+    if (reservoir.size() == 0) {
+        throw std::runtime_error("No training vectors were added to the training session");
+    }
+
+    if (session->binaryIndex != nullptr) {
+        InternalTrainBinaryIndex(session->binaryIndex.get(), reservoir.size(), reservoir.data());
+    } else if (session->byteVectors) {
+        InternalTrainByteIndex(session->index.get(), static_cast<int>(reservoir.size()), session->dimension,
+                               reinterpret_cast<const int8_t *>(reservoir.data()));
+    } else {
+        InternalTrainIndex(session->index.get(), reservoir.size(), reinterpret_cast<const float *>(reservoir.data()));
+    }
+}
+
+jbyteArray knn_jni::faiss_wrapper::TrainFromSession(knn_jni::JNIUtilInterface * jniUtil, JNIEnv * env,
+                                                    jlong sessionPointerJ) {
+    auto *session = reinterpret_cast<TrainingSession *>(sessionPointerJ);
+    TrainSessionIndex(session);
+
+    faiss::VectorIOWriter vectorIoWriter;
+    if (session->binaryIndex != nullptr) {
+        faiss::write_index_binary(session->binaryIndex.get(), &vectorIoWriter);
+    } else {
+        faiss::write_index(session->index.get(), &vectorIoWriter);
+    }
+    return NewJavaByteArray(jniUtil, env, vectorIoWriter.data);
+}
+
+void knn_jni::faiss_wrapper::TrainFromSessionWithStream(knn_jni::JNIUtilInterface * jniUtil, JNIEnv * env,
+                                                        jlong sessionPointerJ, jobject output) {
+    if (output == nullptr) {
+        throw std::runtime_error("Index output stream cannot be null");
+    }
+
+    auto *session = reinterpret_cast<TrainingSession *>(sessionPointerJ);
+    TrainSessionIndex(session);
+
+    // Serialize the trained index straight into the IndexOutput
+    knn_jni::stream::NativeEngineIndexOutputMediator mediator {jniUtil, env, output};
+    knn_jni::stream::FaissOpenSearchIOWriter writer {&mediator};
+    if (session->binaryIndex != nullptr) {
+        faiss::write_index_binary(session->binaryIndex.get(), &writer);
+    } else {
+        faiss::write_index(session->index.get(), &writer);
+    }
+    mediator.flush();
+}
+
+void knn_jni::faiss_wrapper::FreeTrainingSession(jlong sessionPointerJ) {
+    delete reinterpret_cast<TrainingSession *>(sessionPointerJ);
+}
+
+faiss::MetricType knn_jni::faiss_wrapper::TranslateSpaceToMetric(const std::string& spaceType) {
+    if (spaceType == knn_jni::L2) {
+        return faiss::METRIC_L2;
+    }
+
+    if (spaceType == knn_jni::INNER_PRODUCT) {
+        return faiss::METRIC_INNER_PRODUCT;
+    }
+
+    // This case occurs when the space type is passed in to an ADC transformed index. The vectors are guaranteed to be normalized during indexing, so cosine is equivalent to inner product.
+    if (spaceType == knn_jni::COSINESIMIL) {
+        return faiss::METRIC_INNER_PRODUCT;
+    }
+
+    // Space type is not used for binary index. Use L2 just to avoid an error.
+    if (spaceType == knn_jni::HAMMING) {
+        return faiss::METRIC_L2;
+    }
+
+    throw std::runtime_error("Invalid spaceType: " + spaceType);
+}
+
+void SetExtraParameters(knn_jni::JNIUtilInterface * jniUtil, JNIEnv *env,
+                        const std::unordered_map<std::string, jobject>& parametersCpp, faiss::Index * index) {
+
+    std::unordered_map<std::string,jobject>::const_iterator value;
+    if (auto * indexIvf = dynamic_cast<faiss::IndexIVF*>(index)) {
+        if ((value = parametersCpp.find(knn_jni::NPROBES)) != parametersCpp.end()) {
+            indexIvf->nprobe = jniUtil->ConvertJavaObjectToCppInteger(env, value->second);
+        }
+
+        if ((value = parametersCpp.find(knn_jni::COARSE_QUANTIZER)) != parametersCpp.end()
+                && indexIvf->quantizer != nullptr) {
+            auto subParametersCpp = jniUtil->ConvertJavaMapToCppMap(env, value->second);
+            SetExtraParameters(jniUtil, env, subParametersCpp, indexIvf->quantizer);
+        }
+    }
+
+    if (auto * indexHnsw = dynamic_cast<faiss::IndexHNSW*>(index)) {
+
+        if ((value = parametersCpp.find(knn_jni::EF_CONSTRUCTION)) != parametersCpp.end()) {
+            indexHnsw->hnsw.efConstruction = jniUtil->ConvertJavaObjectToCppInteger(env, value->second);
+        }
+
+        if ((value = parametersCpp.find(knn_jni::EF_SEARCH)) != parametersCpp.end()) {
+            indexHnsw->hnsw.efSearch = jniUtil->ConvertJavaObjectToCppInteger(env, value->second);
+        }
+    }
+}
+
+void InternalTrainIndex(faiss::Index * index, faiss::idx_t n, const float* x) {
+    if (auto * indexIvf = dynamic_cast<faiss::IndexIVF*>(index)) {
+        if (indexIvf->quantizer_trains_alone == 2) {
+            InternalTrainIndex(indexIvf->quantizer, n, x);
+        }
+        indexIvf->make_direct_map();
+    }
+
+    if (!index->is_trained) {
+        index->train(n, x);
+    }
+}
+
+void InternalTrainBinaryIndex(faiss::IndexBinary * index, faiss::idx_t n, const uint8_t* x) {
+    if (auto * indexIvf = dynamic_cast<faiss::IndexBinaryIVF*>(index)) {
+        indexIvf->make_direct_map();
+    }
+    if (!index->is_trained) {
+        index->train(n, x);
+    }
+}
 
+std::unique_ptr<faiss::Index> CreateIndexForTraining(knn_jni::JNIUtilInterface * jniUtil, JNIEnv * env,
+                                                     std::unordered_map<std::string, jobject> &parametersCpp,
+                                                     jint dimensionJ) {
     jobject spaceTypeJ = knn_jni::GetJObjectFromMapOrThrow(parametersCpp, knn_jni::SPACE_TYPE);
     std::string spaceTypeCpp(jniUtil->ConvertJavaObjectToCppString(env, spaceTypeJ));
     faiss::MetricType metric = TranslateSpaceToMetric(spaceTypeCpp);
@@ -932,12 +2348,6 @@ jbyteArray knn_jni::faiss_wrapper::TrainIndex(knn_jni::JNIUtilInterface * jniUti
         indexHnswPq->storage->metric_type = metric;
     }
 
-    // Set thread count if it is passed in as a parameter. Setting this variable will only impact the current thread
-    if (parametersCpp.find(knn_jni::INDEX_THREAD_QUANTITY) != parametersCpp.end()) {
-        auto threadCount = jniUtil->ConvertJavaObjectToCppInteger(env, parametersCpp[knn_jni::INDEX_THREAD_QUANTITY]);
-        omp_set_num_threads(threadCount);
-    }
-
     // Add extra parameters that cant be configured with the index factory
     if (parametersCpp.find(knn_jni::PARAMETERS) != parametersCpp.end()) {
         jobject subParametersJ = parametersCpp[knn_jni::PARAMETERS];
@@ -945,232 +2355,738 @@ jbyteArray knn_jni::faiss_wrapper::TrainIndex(knn_jni::JNIUtilInterface * jniUti
         SetExtraParameters(jniUtil, env, subParametersCpp, indexWriter.get());
         jniUtil->DeleteLocalRef(env, subParametersJ);
     }
+    return indexWriter;
+}
 
-    // Train index if needed
-    auto *trainingVectorsPointerCpp = reinterpret_cast<std::vector<float>*>(trainVectorsPointerJ);
-    int numVectors = trainingVectorsPointerCpp->size()/(int) dimensionJ;
-    if(!indexWriter->is_trained) {
-        InternalTrainIndex(indexWriter.get(), numVectors, trainingVectorsPointerCpp->data());
+std::unique_ptr<faiss::IndexBinary> CreateBinaryIndexForTraining(knn_jni::JNIUtilInterface * jniUtil, JNIEnv * env,
+                                                                 std::unordered_map<std::string, jobject> &parametersCpp,
+                                                                 jint dimensionJ) {
+    if (dimensionJ % 8 != 0) {
+        throw std::runtime_error("Dimensions should be multiple of 8");
     }
-    jniUtil->DeleteLocalRef(env, parametersJ);
 
-    // Now that indexWriter is trained, we just load the bytes into an array and return
-    faiss::VectorIOWriter vectorIoWriter;
-    faiss::write_index(indexWriter.get(), &vectorIoWriter);
+    // Create faiss index
+    jobject indexDescriptionJ = knn_jni::GetJObjectFromMapOrThrow(parametersCpp, knn_jni::INDEX_DESCRIPTION);
+    std::string indexDescriptionCpp(jniUtil->ConvertJavaObjectToCppString(env, indexDescriptionJ));
+
+    std::unique_ptr<faiss::IndexBinary> indexWriter;
+    indexWriter.reset(faiss::index_binary_factory((int) dimensionJ, indexDescriptionCpp.c_str()));
+    return indexWriter;
+}
 
-    // Wrap in smart pointer
-    std::unique_ptr<jbyte[]> jbytesBuffer;
-    jbytesBuffer.reset(new jbyte[vectorIoWriter.data.size()]);
-    int c = 0;
-    for (auto b : vectorIoWriter.data) {
-        jbytesBuffer[c++] = (jbyte) b;
+int GetThreadCount(knn_jni::JNIUtilInterface * jniUtil, JNIEnv * env,
+                           std::unordered_map<std::string, jobject> &parametersCpp) {
+    if (parametersCpp.find(knn_jni::INDEX_THREAD_QUANTITY) == parametersCpp.end()) {
+        return 0;
     }
+    return jniUtil->ConvertJavaObjectToCppInteger(env, parametersCpp[knn_jni::INDEX_THREAD_QUANTITY]);
+}
 
-    jbyteArray ret = jniUtil->NewByteArray(env, vectorIoWriter.data.size());
-    jniUtil->SetByteArrayRegion(env, ret, 0, vectorIoWriter.data.size(), jbytesBuffer.get());
-    return ret;
+void InternalTrainByteIndex(faiss::Index * index, int numVectors, int dim, const int8_t* x) {
+    // k-means only looks at max_points_per_centroid vectors per centroid, so only that many are converted to float
+    // instead of the whole training set. The sample is drawn with the seed faiss would use for it.
+    std::vector<int> sample;
+    if (auto *indexIvf = dynamic_cast<faiss::IndexIVF *>(index)) {
+        const size_t maxTrainingVectors = indexIvf->nlist * indexIvf->cp.max_points_per_centroid;
+        if (static_cast<size_t>(numVectors) > maxTrainingVectors) {
+            std::vector<int> permutation(numVectors);
+            faiss::rand_perm(permutation.data(), numVectors, indexIvf->cp.seed);
+            sample.assign(permutation.begin(), permutation.begin() + maxTrainingVectors);
+        }
+    }
+    const int numTrainingVectors = sample.empty() ? numVectors : static_cast<int>(sample.size());
+
+    std::vector <float> trainingFloatVectors(static_cast<size_t>(numTrainingVectors) * dim);
+    for (int i = 0; i < numTrainingVectors; ++i) {
+        const int8_t *vector = x + static_cast<size_t>(sample.empty() ? i : sample[i]) * dim;
+        std::copy(vector, vector + dim, trainingFloatVectors.begin() + static_cast<size_t>(i) * dim);
+    }
+    InternalTrainIndex(index, numTrainingVectors, trainingFloatVectors.data());
 }
 
-jbyteArray knn_jni::faiss_wrapper::TrainBinaryIndex(knn_jni::JNIUtilInterface * jniUtil, JNIEnv * env, jobject parametersJ,
-                                              jint dimensionJ, jlong trainVectorsPointerJ) {
+std::unique_ptr<faiss::Index> BuildTrainedIndex(knn_jni::JNIUtilInterface * jniUtil, JNIEnv * env, jobject parametersJ,
+                                                jint dimensionJ, jlong trainVectorsPointerJ) {
     // First, we need to build the index
     if (parametersJ == nullptr) {
         throw std::runtime_error("Parameters cannot be null");
     }
 
     auto parametersCpp = jniUtil->ConvertJavaMapToCppMap(env, parametersJ);
+    std::unique_ptr<faiss::Index> indexWriter = CreateIndexForTraining(jniUtil, env, parametersCpp, dimensionJ);
 
-    jobject spaceTypeJ = knn_jni::GetJObjectFromMapOrThrow(parametersCpp, knn_jni::SPACE_TYPE);
-    std::string spaceTypeCpp(jniUtil->ConvertJavaObjectToCppString(env, spaceTypeJ));
-    faiss::MetricType metric = TranslateSpaceToMetric(spaceTypeCpp);
+    // Set thread count if it is passed in as a parameter. Setting this variable will only impact the current thread
+    if (int threadCount = GetThreadCount(jniUtil, env, parametersCpp)) {
+        omp_set_num_threads(threadCount);
+    }
 
-    // Create faiss index
-    jobject indexDescriptionJ = knn_jni::GetJObjectFromMapOrThrow(parametersCpp, knn_jni::INDEX_DESCRIPTION);
-    std::string indexDescriptionCpp(jniUtil->ConvertJavaObjectToCppString(env, indexDescriptionJ));
+    // Train index if needed
+    auto *trainingVectorsPointerCpp = reinterpret_cast<std::vector<float>*>(trainVectorsPointerJ);
+    int numVectors = trainingVectorsPointerCpp->size()/(int) dimensionJ;
+    if(!indexWriter->is_trained) {
+        InternalTrainIndex(indexWriter.get(), numVectors, trainingVectorsPointerCpp->data());
+    }
+    jniUtil->DeleteLocalRef(env, parametersJ);
+
+    return indexWriter;
+}
+
+std::unique_ptr<faiss::IndexBinary> BuildTrainedBinaryIndex(knn_jni::JNIUtilInterface * jniUtil, JNIEnv * env,
+                                                            jobject parametersJ, jint dimensionJ,
+                                                            jlong trainVectorsPointerJ) {
+    // First, we need to build the index
+    if (parametersJ == nullptr) {
+        throw std::runtime_error("Parameters cannot be null");
+    }
 
-    std::unique_ptr<faiss::IndexBinary> indexWriter;
-    indexWriter.reset(faiss::index_binary_factory((int) dimensionJ, indexDescriptionCpp.c_str()));
+    auto parametersCpp = jniUtil->ConvertJavaMapToCppMap(env, parametersJ);
+    std::unique_ptr<faiss::IndexBinary> indexWriter = CreateBinaryIndexForTraining(jniUtil, env, parametersCpp,
+                                                                                   dimensionJ);
 
     // Set thread count if it is passed in as a parameter. Setting this variable will only impact the current thread
-    if(parametersCpp.find(knn_jni::INDEX_THREAD_QUANTITY) != parametersCpp.end()) {
-        auto threadCount = jniUtil->ConvertJavaObjectToCppInteger(env, parametersCpp[knn_jni::INDEX_THREAD_QUANTITY]);
+    if (int threadCount = GetThreadCount(jniUtil, env, parametersCpp)) {
         omp_set_num_threads(threadCount);
     }
 
     // Train index if needed
-    int dim = (int)dimensionJ;
-    if (dim % 8 != 0) {
-        throw std::runtime_error("Dimensions should be multiple of 8");
-    }
     auto *trainingVectorsPointerCpp = reinterpret_cast<std::vector<uint8_t>*>(trainVectorsPointerJ);
-    int numVectors = (int) (trainingVectorsPointerCpp->size() / (dim / 8));
+    int numVectors = (int) (trainingVectorsPointerCpp->size() / (dimensionJ / 8));
     if(!indexWriter->is_trained) {
         InternalTrainBinaryIndex(indexWriter.get(), numVectors, trainingVectorsPointerCpp->data());
     }
     jniUtil->DeleteLocalRef(env, parametersJ);
 
-    // Now that indexWriter is trained, we just load the bytes into an array and return
-    faiss::VectorIOWriter vectorIoWriter;
-    faiss::write_index_binary(indexWriter.get(), &vectorIoWriter);
-
-    // Wrap in smart pointer
-    std::unique_ptr<jbyte[]> jbytesBuffer;
-    jbytesBuffer.reset(new jbyte[vectorIoWriter.data.size()]);
-    int c = 0;
-    for (auto b : vectorIoWriter.data) {
-        jbytesBuffer[c++] = (jbyte) b;
-    }
-
-    jbyteArray ret = jniUtil->NewByteArray(env, vectorIoWriter.data.size());
-    jniUtil->SetByteArrayRegion(env, ret, 0, vectorIoWriter.data.size(), jbytesBuffer.get());
-    return ret;
+    return indexWriter;
 }
 
-jbyteArray knn_jni::faiss_wrapper::TrainByteIndex(knn_jni::JNIUtilInterface * jniUtil, JNIEnv * env, jobject parametersJ,
-                                              jint dimensionJ, jlong trainVectorsPointerJ) {
+std::unique_ptr<faiss::Index> BuildTrainedByteIndex(knn_jni::JNIUtilInterface * jniUtil, JNIEnv * env,
+                                                    jobject parametersJ, jint dimensionJ, jlong trainVectorsPointerJ) {
     // First, we need to build the index
     if (parametersJ == nullptr) {
         throw std::runtime_error("Parameters cannot be null");
     }
 
     auto parametersCpp = jniUtil->ConvertJavaMapToCppMap(env, parametersJ);
-
-    jobject spaceTypeJ = knn_jni::GetJObjectFromMapOrThrow(parametersCpp, knn_jni::SPACE_TYPE);
-    std::string spaceTypeCpp(jniUtil->ConvertJavaObjectToCppString(env, spaceTypeJ));
-    faiss::MetricType metric = TranslateSpaceToMetric(spaceTypeCpp);
-
-    // Create faiss index
-    jobject indexDescriptionJ = knn_jni::GetJObjectFromMapOrThrow(parametersCpp, knn_jni::INDEX_DESCRIPTION);
-    std::string indexDescriptionCpp(jniUtil->ConvertJavaObjectToCppString(env, indexDescriptionJ));
-
-    std::unique_ptr<faiss::Index> indexWriter;
-    indexWriter.reset(faiss::index_factory((int) dimensionJ, indexDescriptionCpp.c_str(), metric));
+    std::unique_ptr<faiss::Index> indexWriter = CreateIndexForTraining(jniUtil, env, parametersCpp, dimensionJ);
 
     // Set thread count if it is passed in as a parameter. Setting this variable will only impact the current thread
-    if (parametersCpp.find(knn_jni::INDEX_THREAD_QUANTITY) != parametersCpp.end()) {
-        auto threadCount = jniUtil->ConvertJavaObjectToCppInteger(env, parametersCpp[knn_jni::INDEX_THREAD_QUANTITY]);
+    if (int threadCount = GetThreadCount(jniUtil, env, parametersCpp)) {
         omp_set_num_threads(threadCount);
     }
 
-    // Add extra parameters that cant be configured with the index factory
-    if (parametersCpp.find(knn_jni::PARAMETERS) != parametersCpp.end()) {
-        jobject subParametersJ = parametersCpp[knn_jni::PARAMETERS];
-        auto subParametersCpp = jniUtil->ConvertJavaMapToCppMap(env, subParametersJ);
-        SetExtraParameters(jniUtil, env, subParametersCpp, indexWriter.get());
-        jniUtil->DeleteLocalRef(env, subParametersJ);
-    }
-
     // Train index if needed
     auto *trainingVectorsPointerCpp = reinterpret_cast<std::vector<int8_t>*>(trainVectorsPointerJ);
     int numVectors = trainingVectorsPointerCpp->size()/(int) dimensionJ;
+    if (!indexWriter->is_trained) {
+        InternalTrainByteIndex(indexWriter.get(), numVectors, dimensionJ, trainingVectorsPointerCpp->data());
+    }
+    jniUtil->DeleteLocalRef(env, parametersJ);
+
+    return indexWriter;
+}
 
-    auto iter = trainingVectorsPointerCpp->begin();
-    std::vector <float> trainingFloatVectors(numVectors * dimensionJ);
-    for(int i=0; i < numVectors * dimensionJ; ++i, ++iter) {
-    trainingFloatVectors[i] = static_cast<float>(*iter);
+std::vector<int32_t> ReadDocMap(knn_jni::JNIUtilInterface * jniUtil, JNIEnv * env, jintArray docMapJ) {
+    if (docMapJ == nullptr) {
+        throw std::runtime_error("Doc map cannot be null");
     }
+    std::vector<int32_t> docMap(jniUtil->GetJavaIntArrayLength(env, docMapJ));
+    jniUtil->GetIntArrayRegion(env, docMapJ, 0, docMap.size(), reinterpret_cast<jint *>(docMap.data()));
+    return docMap;
+}
 
-    if (!indexWriter->is_trained) {
-     InternalTrainIndex(indexWriter.get(), numVectors, trainingFloatVectors.data());
+void SetMergeThreadCount(knn_jni::JNIUtilInterface * jniUtil, JNIEnv * env, jobject parametersJ) {
+    if (parametersJ == nullptr) {
+        throw std::runtime_error("Parameters cannot be null");
+    }
+    auto parametersCpp = jniUtil->ConvertJavaMapToCppMap(env, parametersJ);
+    // Setting this variable will only impact the current thread
+    if (int threadCount = GetThreadCount(jniUtil, env, parametersCpp)) {
+        omp_set_num_threads(threadCount);
     }
     jniUtil->DeleteLocalRef(env, parametersJ);
+}
 
-    // Now that indexWriter is trained, we just load the bytes into an array and return
-    faiss::VectorIOWriter vectorIoWriter;
-    faiss::write_index(indexWriter.get(), &vectorIoWriter);
+jbyteArray NewJavaByteArray(knn_jni::JNIUtilInterface * jniUtil, JNIEnv * env, const std::vector<uint8_t> &bytes) {
+    if (bytes.size() > static_cast<size_t>(std::numeric_limits<jsize>::max())) {
+        throw std::runtime_error("Serialized index of " + std::to_string(bytes.size())
+                                 + " bytes does not fit in a Java byte array");
+    }
+    jbyteArray ret = jniUtil->NewByteArray(env, static_cast<jsize>(bytes.size()));
+    jniUtil->SetByteArrayRegion(env, ret, 0, static_cast<jsize>(bytes.size()),
+                                reinterpret_cast<const jbyte *>(bytes.data()));
+    return ret;
+}
+
+SearchScratch &GetSearchScratch() {
+    thread_local SearchScratch scratch;
+    return scratch;
+}
 
-    // Wrap in smart pointer
-    std::unique_ptr<jbyte[]> jbytesBuffer;
-    jbytesBuffer.reset(new jbyte[vectorIoWriter.data.size()]);
-    int c = 0;
-    for (auto b : vectorIoWriter.data) {
-        jbytesBuffer[c++] = (jbyte) b;
+// Parent groupers keyed by index pointer. Groupers are read only once built, so queries share them without locking
+static std::shared_mutex idGrouperCacheMutex;
+static std::unordered_map<jlong, std::shared_ptr<const CachedIDGrouper>> idGrouperCache;
+
+std::shared_ptr<const CachedIDGrouper> getCachedIDGrouper(knn_jni::JNIUtilInterface * jniUtil, JNIEnv *env, jlong indexPointerJ, jintArray parentIdsJ) {
+    // The parent ids are read in full on every query, hashing them is far cheaper than rebuilding the grouper
+    const int parentIdsLength = jniUtil->GetJavaIntArrayLength(env, parentIdsJ);
+    std::vector<jint> &parentIds = GetSearchScratch().parentIds;
+    parentIds.resize(parentIdsLength);
+    jniUtil->GetIntArrayRegion(env, parentIdsJ, 0, parentIdsLength, parentIds.data());
+    const uint64_t parentIdsFingerprint = faiss_util::fingerprint(reinterpret_cast<const uint8_t *>(parentIds.data()),
+                                                                  parentIds.size() * sizeof(jint));
+
+    {
+        std::shared_lock<std::shared_mutex> lock(idGrouperCacheMutex);
+        auto it = idGrouperCache.find(indexPointerJ);
+        if (it != idGrouperCache.end() && it->second->parentIdsLength == parentIdsLength
+            && it->second->parentIdsFingerprint == parentIdsFingerprint) {
+            return it->second;
+        }
     }
 
-    jbyteArray ret = jniUtil->NewByteArray(env, vectorIoWriter.data.size());
-    jniUtil->SetByteArrayRegion(env, ret, 0, vectorIoWriter.data.size(), jbytesBuffer.get());
-    return ret;
+    // Concurrent first queries may each build the grouper, the last one to finish is kept
+    auto cachedIDGrouper = std::make_shared<CachedIDGrouper>();
+    cachedIDGrouper->parentIdsLength = parentIdsLength;
+    cachedIDGrouper->parentIdsFingerprint = parentIdsFingerprint;
+    cachedIDGrouper->grouper = faiss_util::buildIDGrouperBitmap(parentIds.data(), parentIdsLength,
+                                                                &cachedIDGrouper->bitmap);
+
+    std::unique_lock<std::shared_mutex> lock(idGrouperCacheMutex);
+    idGrouperCache[indexPointerJ] = cachedIDGrouper;
+    return cachedIDGrouper;
+}
+
+void evictCachedIDGrouper(jlong indexPointerJ) {
+    std::unique_lock<std::shared_mutex> lock(idGrouperCacheMutex);
+    idGrouperCache.erase(indexPointerJ);
 }
 
+static std::shared_mutex sortedLabelsCacheMutex;
+static std::unordered_map<jlong, bool> sortedLabelsCache;
 
-faiss::MetricType knn_jni::faiss_wrapper::TranslateSpaceToMetric(const std::string& spaceType) {
-    if (spaceType == knn_jni::L2) {
-        return faiss::METRIC_L2;
+bool hasSortedLabels(jlong indexPointerJ, const std::vector<faiss::idx_t> &labels) {
+    {
+        std::shared_lock<std::shared_mutex> lock(sortedLabelsCacheMutex);
+        auto it = sortedLabelsCache.find(indexPointerJ);
+        if (it != sortedLabelsCache.end()) {
+            return it->second;
+        }
     }
 
-    if (spaceType == knn_jni::INNER_PRODUCT) {
-        return faiss::METRIC_INNER_PRODUCT;
+    const bool sorted = std::is_sorted(labels.begin(), labels.end());
+    std::unique_lock<std::shared_mutex> lock(sortedLabelsCacheMutex);
+    sortedLabelsCache[indexPointerJ] = sorted;
+    return sorted;
+}
+
+void evictSortedLabels(jlong indexPointerJ) {
+    std::unique_lock<std::shared_mutex> lock(sortedLabelsCacheMutex);
+    sortedLabelsCache.erase(indexPointerJ);
+}
+
+std::string GetModelId(knn_jni::JNIUtilInterface * jniUtil, JNIEnv *env,
+                       const std::unordered_map<std::string, jobject> &parametersCpp) {
+    auto it = parametersCpp.find(knn_jni::MODEL_ID);
+    if (it == parametersCpp.end() || it->second == nullptr) {
+        return "";
     }
+    return jniUtil->ConvertJavaObjectToCppString(env, it->second);
+}
 
-    // This case occurs when the space type is passed in to an ADC transformed index. The vectors are guaranteed to be normalized during indexing, so cosine is equivalent to inner product.
-    if (spaceType == knn_jni::COSINESIMIL) {
-        return faiss::METRIC_INNER_PRODUCT;
+// Reads a serialized index straight out of a Java byte array. Every read copies the requested bytes into the structure
+// faiss is filling, so the array is never copied as a whole.
+class JavaByteArrayIOReader : public faiss::IOReader {
+public:
+    JavaByteArrayIOReader(knn_jni::JNIUtilInterface * jniUtil, JNIEnv *env, jbyteArray arrayJ)
+        : jniUtil(jniUtil), env(env), arrayJ(arrayJ), length(jniUtil->GetJavaBytesArrayLength(env, arrayJ)),
+          position(0) {
     }
 
-    // Space type is not used for binary index. Use L2 just to avoid an error.
-    if (spaceType == knn_jni::HAMMING) {
-        return faiss::METRIC_L2;
+    size_t operator()(void *ptr, size_t size, size_t nitems) override {
+        if (size == 0) {
+            return 0;
+        }
+        nitems = std::min(nitems, (length - position) / size);
+        const size_t bytes = size * nitems;
+        if (bytes > 0) {
+            jniUtil->GetByteArrayRegion(env, arrayJ, position, bytes, static_cast<jbyte *>(ptr));
+            position += bytes;
+        }
+        return nitems;
     }
 
-    throw std::runtime_error("Invalid spaceType: " + spaceType);
+private:
+    knn_jni::JNIUtilInterface * jniUtil;
+    JNIEnv *env;
+    jbyteArray arrayJ;
+    size_t length;
+    size_t position;
+};
+
+// Deserialized templates keyed by model id. A model id can be used again once its model is deleted, so the length and
+// fingerprint of the serialized template tell whether a cached one still matches. Cached templates are never modified,
+// so builds clone them without holding the lock.
+template <typename INDEX>
+struct CachedTemplate {
+    size_t length;
+    uint64_t fingerprint;
+    uint64_t lastUsed;
+    std::shared_ptr<const INDEX> index;
+};
+
+// A template of a large model takes hundreds of MB, so only the most recently used ones are kept, up to this many
+// serialized bytes in all. A deserialized template takes about as much memory as its serialized bytes.
+constexpr size_t MAX_CACHED_TEMPLATE_BYTES = 512L * 1024 * 1024;
+
+// The template bytes are fingerprinted in chunks of this size, copied out of the Java array, so the GC is never held
+// off for the whole template
+constexpr size_t TEMPLATE_FINGERPRINT_CHUNK_BYTES = 1024 * 1024;
+
+template <typename INDEX>
+struct TemplateCache {
+    std::mutex mutex;
+    std::unordered_map<std::string, CachedTemplate<INDEX>> templates;
+    size_t bytes = 0;
+    uint64_t clock = 0;
+};
+
+uint64_t FingerprintJavaByteArray(knn_jni::JNIUtilInterface * jniUtil, JNIEnv *env, jbyteArray arrayJ, size_t length) {
+    faiss_util::Fingerprinter fingerprinter(length);
+    std::vector<uint8_t> chunk(std::min(length, TEMPLATE_FINGERPRINT_CHUNK_BYTES));
+    for (size_t position = 0; position < length; position += chunk.size()) {
+        const size_t chunkLength = std::min(chunk.size(), length - position);
+        jniUtil->GetByteArrayRegion(env, arrayJ, position, chunkLength, reinterpret_cast<jbyte *>(chunk.data()));
+        fingerprinter.update(chunk.data(), chunkLength);
+    }
+    return fingerprinter.finish();
 }
 
-void SetExtraParameters(knn_jni::JNIUtilInterface * jniUtil, JNIEnv *env,
-                        const std::unordered_map<std::string, jobject>& parametersCpp, faiss::Index * index) {
+template <typename INDEX>
+TemplateCache<INDEX> &GetTemplateCache() {
+    static TemplateCache<INDEX> cache;
+    return cache;
+}
 
-    std::unordered_map<std::string,jobject>::const_iterator value;
-    if (auto * indexIvf = dynamic_cast<faiss::IndexIVF*>(index)) {
-        if ((value = parametersCpp.find(knn_jni::NPROBES)) != parametersCpp.end()) {
-            indexIvf->nprobe = jniUtil->ConvertJavaObjectToCppInteger(env, value->second);
-        }
+template <typename INDEX>
+INDEX *DeserializeIndex(faiss::IOReader *reader);
 
-        if ((value = parametersCpp.find(knn_jni::COARSE_QUANTIZER)) != parametersCpp.end()
-                && indexIvf->quantizer != nullptr) {
-            auto subParametersCpp = jniUtil->ConvertJavaMapToCppMap(env, value->second);
-            SetExtraParameters(jniUtil, env, subParametersCpp, indexIvf->quantizer);
+template <>
+faiss::Index *DeserializeIndex<faiss::Index>(faiss::IOReader *reader) {
+    return faiss::read_index(reader, 0);
+}
+
+template <>
+faiss::IndexBinary *DeserializeIndex<faiss::IndexBinary>(faiss::IOReader *reader) {
+    return faiss::read_index_binary(reader, 0);
+}
+
+faiss::Index *CloneIndex(const faiss::Index *index) {
+    return faiss::clone_index(index);
+}
+
+faiss::IndexBinary *CloneIndex(const faiss::IndexBinary *index) {
+    return faiss::clone_binary_index(index);
+}
+
+template <typename INDEX>
+std::unique_ptr<INDEX> ReadTemplateIndex(knn_jni::JNIUtilInterface * jniUtil, JNIEnv *env, jbyteArray templateIndexJ,
+                                         const std::string &modelId) {
+    if (modelId.empty()) {
+        JavaByteArrayIOReader reader(jniUtil, env, templateIndexJ);
+        return std::unique_ptr<INDEX>(DeserializeIndex<INDEX>(&reader));
+    }
+
+    const size_t length = jniUtil->GetJavaBytesArrayLength(env, templateIndexJ);
+    const uint64_t fingerprint = FingerprintJavaByteArray(jniUtil, env, templateIndexJ, length);
+
+    TemplateCache<INDEX> &cache = GetTemplateCache<INDEX>();
+    std::shared_ptr<const INDEX> cachedIndex;
+    {
+        std::lock_guard<std::mutex> lock(cache.mutex);
+        auto it = cache.templates.find(modelId);
+        if (it != cache.templates.end() && it->second.length == length && it->second.fingerprint == fingerprint) {
+            it->second.lastUsed = ++cache.clock;
+            cachedIndex = it->second.index;
         }
     }
+    if (cachedIndex != nullptr) {
+        return std::unique_ptr<INDEX>(CloneIndex(cachedIndex.get()));
+    }
+
+    JavaByteArrayIOReader reader(jniUtil, env, templateIndexJ);
+    std::unique_ptr<INDEX> index(DeserializeIndex<INDEX>(&reader));
+    if (length > MAX_CACHED_TEMPLATE_BYTES) {
+        return index;
+    }
+    std::unique_ptr<INDEX> clone;
+    try {
+        clone.reset(CloneIndex(index.get()));
+    } catch (const faiss::FaissException &) {
+        // faiss cannot clone every index type, those are deserialized for every build
+        return index;
+    }
+
+    // Concurrent first builds of a model may each deserialize it, the last one to finish is kept
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    auto previous = cache.templates.find(modelId);
+    if (previous != cache.templates.end()) {
+        cache.bytes -= previous->second.length;
+        cache.templates.erase(previous);
+    }
+    while (cache.bytes + length > MAX_CACHED_TEMPLATE_BYTES) {
+        auto leastRecentlyUsed = std::min_element(cache.templates.begin(), cache.templates.end(),
+                                                  [](const auto &a, const auto &b) {
+                                                      return a.second.lastUsed < b.second.lastUsed;
+                                                  });
+        cache.bytes -= leastRecentlyUsed->second.length;
+        cache.templates.erase(leastRecentlyUsed);
+    }
+    cache.templates[modelId] = CachedTemplate<INDEX>{length, fingerprint, ++cache.clock,
+                                                     std::shared_ptr<const INDEX>(index.release())};
+    cache.bytes += length;
+    return clone;
+}
 
-    if (auto * indexHnsw = dynamic_cast<faiss::IndexHNSW*>(index)) {
+template <typename INDEX>
+void EvictCachedTemplate(TemplateCache<INDEX> &cache, const std::string &modelId) {
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    auto it = cache.templates.find(modelId);
+    if (it != cache.templates.end()) {
+        cache.bytes -= it->second.length;
+        cache.templates.erase(it);
+    }
+}
 
-        if ((value = parametersCpp.find(knn_jni::EF_CONSTRUCTION)) != parametersCpp.end()) {
-            indexHnsw->hnsw.efConstruction = jniUtil->ConvertJavaObjectToCppInteger(env, value->second);
+void knn_jni::faiss_wrapper::EvictTemplateIndex(const std::string &modelId) {
+    EvictCachedTemplate(GetTemplateCache<faiss::Index>(), modelId);
+    EvictCachedTemplate(GetTemplateCache<faiss::IndexBinary>(), modelId);
+}
+
+template <typename Consumer>
+void ForEachExactSearchCandidate(const std::vector<faiss::idx_t> &labels, bool sortedLabels,
+                                 const jlong *filteredIdsArray, int filterIdsLength, jint filterIdsTypeJ,
+                                 Consumer consumer) {
+    if (filteredIdsArray == nullptr) {
+        for (size_t i = 0; i < labels.size(); i++) {
+            consumer(i);
+        }
+    } else if (sortedLabels) {
+        QueryFilter::forEachId(filteredIdsArray, filterIdsLength, filterIdsTypeJ, [&](int64_t label) {
+            auto it = std::lower_bound(labels.begin(), labels.end(), label);
+            if (it != labels.end() && *it == label) {
+                consumer(it - labels.begin());
+            }
+        });
+    } else {
+        QueryFilter queryFilter;
+        const faiss::IDSelector *selector = queryFilter.build(filteredIdsArray, filterIdsLength, filterIdsTypeJ);
+        for (size_t i = 0; i < labels.size(); i++) {
+            if (selector->is_member(labels[i])) {
+                consumer(i);
+            }
+        }
+    }
+}
+
+// Scores the internal ids passed by forEachCandidate to its consumer into the k sized heap in dis and ids, which may
+// already hold hits
+template <typename C, typename CandidateEnumerator>
+void ExactSearchIntoHeap(ExactScorer &scorer, const std::vector<faiss::idx_t> &labels, int k, float *dis,
+                         faiss::idx_t *ids, CandidateEnumerator forEachCandidate) {
+    // Candidates are scored in blocks, so flat storages compute a whole block in one kernel call
+    constexpr size_t blockSize = 64;
+    faiss::idx_t internalIds[blockSize];
+    float distances[blockSize];
+    size_t blockLength = 0;
+    auto flush = [&]() {
+        scorer.score(internalIds, blockLength, distances);
+        for (size_t i = 0; i < blockLength; i++) {
+            if (C::cmp(dis[0], distances[i])) {
+                faiss::heap_replace_top<C>(k, dis, ids, distances[i], labels[internalIds[i]]);
+            }
+        }
+        blockLength = 0;
+    };
+    auto add = [&](faiss::idx_t internalId) {
+        internalIds[blockLength++] = internalId;
+        if (blockLength == blockSize) {
+            flush();
         }
+    };
 
-        if ((value = parametersCpp.find(knn_jni::EF_SEARCH)) != parametersCpp.end()) {
-            indexHnsw->hnsw.efSearch = jniUtil->ConvertJavaObjectToCppInteger(env, value->second);
+    forEachCandidate(add);
+    if (blockLength > 0) {
+        flush();
+    }
+}
+
+// Scores the internal ids passed by forEachCandidate to its consumer and keeps the top k labels in dis and ids
+template <typename C, typename CandidateEnumerator>
+void ExactSearchTopK(ExactScorer &scorer, const std::vector<faiss::idx_t> &labels, int k, float *dis,
+                     faiss::idx_t *ids, CandidateEnumerator forEachCandidate) {
+    faiss::heap_heapify<C>(k, dis, ids);
+    ExactSearchIntoHeap<C>(scorer, labels, k, dis, ids, forEachCandidate);
+    faiss::heap_reorder<C>(k, dis, ids);
+}
+
+template <typename C>
+void ExactSearchWithFilter(ExactScorer &scorer, const std::vector<faiss::idx_t> &labels, bool sortedLabels,
+                           const jlong *filteredIdsArray, int filterIdsLength, jint filterIdsTypeJ, int k, float *dis,
+                           faiss::idx_t *ids) {
+    ExactSearchTopK<C>(scorer, labels, k, dis, ids, [&](auto &add) {
+        ForEachExactSearchCandidate(labels, sortedLabels, filteredIdsArray, filterIdsLength, filterIdsTypeJ, add);
+    });
+}
+
+void ExactSearchWithFilter(ExactScorer &scorer, bool isSimilarity, const std::vector<faiss::idx_t> &labels,
+                           bool sortedLabels, const jlong *filteredIdsArray, int filterIdsLength, jint filterIdsTypeJ,
+                           int k, float *dis, faiss::idx_t *ids) {
+    if (isSimilarity) {
+        ExactSearchWithFilter<faiss::CMin<float, faiss::idx_t>>(scorer, labels, sortedLabels, filteredIdsArray,
+                                                                filterIdsLength, filterIdsTypeJ, k, dis, ids);
+    } else {
+        ExactSearchWithFilter<faiss::CMax<float, faiss::idx_t>>(scorer, labels, sortedLabels, filteredIdsArray,
+                                                                filterIdsLength, filterIdsTypeJ, k, dis, ids);
+    }
+}
+
+void ExactRangeSearchWithFilter(ExactScorer &scorer, bool isSimilarity, const std::vector<faiss::idx_t> &labels,
+                                bool sortedLabels, const jlong *filteredIdsArray, int filterIdsLength,
+                                jint filterIdsTypeJ, faiss_util::BoundedRangeResultHandler &handler) {
+    constexpr size_t blockSize = 64;
+    faiss::idx_t internalIds[blockSize];
+    float distances[blockSize];
+    size_t blockLength = 0;
+    auto flush = [&]() {
+        scorer.score(internalIds, blockLength, distances);
+        for (size_t i = 0; i < blockLength; i++) {
+            const float distance = isSimilarity ? -distances[i] : distances[i];
+            if (distance < handler.threshold) {
+                handler.add_result(distance, internalIds[i]);
+            }
         }
+        blockLength = 0;
+    };
+    auto add = [&](faiss::idx_t internalId) {
+        internalIds[blockLength++] = internalId;
+        if (blockLength == blockSize) {
+            flush();
+        }
+    };
+
+    ForEachExactSearchCandidate(labels, sortedLabels, filteredIdsArray, filterIdsLength, filterIdsTypeJ, add);
+    if (blockLength > 0) {
+        flush();
     }
 }
 
-void InternalTrainIndex(faiss::Index * index, faiss::idx_t n, const float* x) {
-    if (auto * indexIvf = dynamic_cast<faiss::IndexIVF*>(index)) {
-        if (indexIvf->quantizer_trains_alone == 2) {
-            InternalTrainIndex(indexIvf->quantizer, n, x);
+const faiss::Index *GetExactSearchStorage(const faiss::Index *index) {
+    if (auto hnswIndex = dynamic_cast<const faiss::IndexHNSW *>(index)) {
+        if (hnswIndex->storage == nullptr) {
+            throw std::runtime_error("HNSW index has no storage to search exactly");
         }
-        indexIvf->make_direct_map();
+        return hnswIndex->storage;
+    }
+    if (dynamic_cast<const faiss::IndexFlatCodes *>(index) != nullptr) {
+        return index;
     }
+    throw std::runtime_error("Exact search is only supported for HNSW and flat indexes");
+}
 
-    if (!index->is_trained) {
-        index->train(n, x);
+// Merges the top k of every part of a parallel search, each sorted and padded with -1, into the top k overall
+template <typename C>
+void MergeTopK(int numParts, int k, const float *partDis, const faiss::idx_t *partIds, float *dis, faiss::idx_t *ids) {
+    faiss::heap_heapify<C>(k, dis, ids);
+    for (size_t i = 0; i < static_cast<size_t>(numParts) * k; i++) {
+        if (partIds[i] >= 0 && C::cmp(dis[0], partDis[i])) {
+            faiss::heap_replace_top<C>(k, dis, ids, partDis[i], partIds[i]);
+        }
     }
+    faiss::heap_reorder<C>(k, dis, ids);
 }
 
-void InternalTrainBinaryIndex(faiss::IndexBinary * index, faiss::idx_t n, const uint8_t* x) {
-    if (auto * indexIvf = dynamic_cast<faiss::IndexBinaryIVF*>(index)) {
-        indexIvf->make_direct_map();
+bool ParallelSearchWithFilter(const faiss::IndexIDMap *indexReader, const float *query, int k, int parallelism,
+                              const faiss::IDSelector *selector, int nprobe, float *dis, faiss::idx_t *ids) {
+    if (parallelism <= 1) {
+        return false;
     }
-    if (!index->is_trained) {
-        index->train(n, x);
+    const bool isSimilarity = indexReader->metric_type == faiss::METRIC_INNER_PRODUCT;
+    const std::vector<faiss::idx_t> &labels = indexReader->id_map;
+    auto merge = [&](int numParts, const std::vector<float> &partDis, const std::vector<faiss::idx_t> &partIds) {
+        if (isSimilarity) {
+            MergeTopK<faiss::CMin<float, faiss::idx_t>>(numParts, k, partDis.data(), partIds.data(), dis, ids);
+        } else {
+            MergeTopK<faiss::CMax<float, faiss::idx_t>>(numParts, k, partDis.data(), partIds.data(), dis, ids);
+        }
+    };
+
+    if (auto ivfIndex = dynamic_cast<const faiss::IndexIVF *>(indexReader->index)) {
+        nprobe = std::min<int>(nprobe, ivfIndex->nlist);
+        const int numParts = faiss_util::chooseQueryParallelism(parallelism, nprobe, 1);
+        if (numParts <= 1) {
+            return false;
+        }
+        // Lists are assigned once and every part scans its own slice of them, nearest lists first
+        std::vector<float> coarseDis(nprobe);
+        std::vector<faiss::idx_t> coarseIds(nprobe);
+        ivfIndex->quantizer->search(1, query, nprobe, coarseDis.data(), coarseIds.data());
+
+        faiss::IDSelectorTranslated translatedSelector(labels, selector);
+        std::vector<float> partDis(static_cast<size_t>(numParts) * k);
+        std::vector<faiss::idx_t> partIds(static_cast<size_t>(numParts) * k);
+        knn_jni::NativeThreadPool::getInstance().parallelFor(numParts, numParts, [&](int part) {
+            // Pool threads start with the process wide OpenMP settings
+            omp_set_num_threads(1);
+            const int begin = static_cast<int64_t>(nprobe) * part / numParts;
+            const int end = static_cast<int64_t>(nprobe) * (part + 1) / numParts;
+            faiss::SearchParametersIVF partParams;
+            partParams.nprobe = end - begin;
+            partParams.sel = selector == nullptr ? nullptr : &translatedSelector;
+            ivfIndex->search_preassigned(1, query, k, coarseIds.data() + begin, coarseDis.data() + begin,
+                                         partDis.data() + static_cast<size_t>(part) * k,
+                                         partIds.data() + static_cast<size_t>(part) * k, false, &partParams);
+        });
+        merge(numParts, partDis, partIds);
+        // Inverted lists hold internal ids
+        for (int i = 0; i < k; i++) {
+            if (ids[i] >= 0) {
+                ids[i] = labels[ids[i]];
+            }
+        }
+        return true;
+    }
+
+    if (auto flatIndex = dynamic_cast<const faiss::IndexFlatCodes *>(indexReader->index)) {
+        const int numParts = faiss_util::chooseQueryParallelism(parallelism, indexReader->ntotal,
+                                                                faiss_util::MIN_VECTORS_PER_SCAN_TASK);
+        if (numParts <= 1) {
+            return false;
+        }
+        const size_t ntotal = labels.size();
+        std::vector<float> partDis(static_cast<size_t>(numParts) * k);
+        std::vector<faiss::idx_t> partIds(static_cast<size_t>(numParts) * k);
+        knn_jni::NativeThreadPool::getInstance().parallelFor(numParts, numParts, [&](int part) {
+            omp_set_num_threads(1);
+            const size_t begin = ntotal * part / numParts;
+            const size_t end = ntotal * (part + 1) / numParts;
+            // Distance computers hold the query, so every part scores with its own
+            ExactScorer scorer(flatIndex, query);
+            auto forEachCandidate = [&](auto &add) {
+                for (size_t i = begin; i < end; i++) {
+                    if (selector == nullptr || selector->is_member(labels[i])) {
+                        add(i);
+                    }
+                }
+            };
+            float *heapDis = partDis.data() + static_cast<size_t>(part) * k;
+            faiss::idx_t *heapIds = partIds.data() + static_cast<size_t>(part) * k;
+            if (isSimilarity) {
+                ExactSearchTopK<faiss::CMin<float, faiss::idx_t>>(scorer, labels, k, heapDis, heapIds, forEachCandidate);
+            } else {
+                ExactSearchTopK<faiss::CMax<float, faiss::idx_t>>(scorer, labels, k, heapDis, heapIds, forEachCandidate);
+            }
+        });
+        merge(numParts, partDis, partIds);
+        return true;
     }
+    return false;
 }
 
-std::unique_ptr<faiss::IDGrouperBitmap> buildIDGrouperBitmap(knn_jni::JNIUtilInterface * jniUtil, JNIEnv *env, jintArray parentIdsJ, std::vector<uint64_t>* bitmap) {
-    int *parentIdsArray = jniUtil->GetIntArrayElements(env, parentIdsJ, nullptr);
-    int parentIdsLength = jniUtil->GetJavaIntArrayLength(env, parentIdsJ);
-    std::unique_ptr<faiss::IDGrouperBitmap> idGrouper = faiss_util::buildIDGrouperBitmap(parentIdsArray, parentIdsLength, bitmap);
-    jniUtil->ReleaseIntArrayElements(env, parentIdsJ, parentIdsArray, JNI_ABORT);
-    return idGrouper;
+template <typename C>
+void SearchSegmentIntoHeap(const faiss::IndexIDMap *indexReader, jlong indexPointerJ, const float *query, int k,
+                           const knn_jni::commons::SearchParams &searchParams, const jlong *filteredIdsArray,
+                           int filterIdsLength, jint filterIdsTypeJ, float *dis, faiss::idx_t *ids) {
+    const bool isSimilarity = indexReader->metric_type == faiss::METRIC_INNER_PRODUCT;
+    const std::vector<faiss::idx_t> &labels = indexReader->id_map;
+    QueryFilter queryFilter;
+    const faiss::IDSelector *selector = nullptr;
+    // HNSW graphs and inverted lists hold internal ids, while the filter holds labels
+    std::unique_ptr<faiss::IDSelectorTranslated> translatedSelector;
+    if (filteredIdsArray != nullptr) {
+        selector = queryFilter.build(filteredIdsArray, filterIdsLength, filterIdsTypeJ);
+        translatedSelector.reset(new faiss::IDSelectorTranslated(labels, selector));
+    }
+    auto toLabels = [&]() {
+        for (int i = 0; i < k; i++) {
+            if (ids[i] >= 0) {
+                ids[i] = labels[ids[i]];
+            }
+        }
+    };
+
+    auto hnswReader = dynamic_cast<const faiss::IndexHNSW *>(indexReader->index);
+    if (hnswReader != nullptr && hnswReader->storage != nullptr) {
+        faiss::SearchParametersHNSW hnswParams;
+        // faiss takes k to be 1 for a custom result handler, so ef_search is raised to k here like IndexHNSW::search does
+        hnswParams.efSearch = std::max(searchParams.getEfSearch(hnswReader->hnsw.efSearch), k);
+        hnswParams.sel = translatedSelector.get();
+        std::unique_ptr<faiss::DistanceComputer> distanceComputer;
+        if (knn_jni::faiss_wrapper::isInt8DirectStorage(hnswReader->storage)) {
+            // Byte vectors are compared in integers, without decoding the codes to float
+            distanceComputer.reset(new knn_jni::faiss_wrapper::Int8DirectDistanceComputer(
+                    *static_cast<const faiss::IndexScalarQuantizer *>(hnswReader->storage), isSimilarity));
+        } else {
+            distanceComputer.reset(hnswReader->storage->get_distance_computer());
+            if (isSimilarity) {
+                distanceComputer.reset(new NegatedDistanceComputer(distanceComputer.release()));
+            }
+        }
+        distanceComputer->set_query(query);
+        faiss::VisitedTable visitedTable(hnswReader->ntotal);
+        HeapResultHandler<C> handler(isSimilarity, k, dis, ids);
+        hnswReader->hnsw.search(*distanceComputer, handler, visitedTable, &hnswParams);
+        toLabels();
+        return;
+    }
+
+    if (auto ivfReader = dynamic_cast<const faiss::IndexIVF *>(indexReader->index)) {
+        // Scan the probed lists straight into the seeded heap. IndexIVF::search would start from an empty heap.
+        const int nprobe = std::min<int>(searchParams.getNprobes(ivfReader->nprobe), ivfReader->nlist);
+        std::vector<float> coarseDis(nprobe);
+        std::vector<faiss::idx_t> coarseIds(nprobe);
+        ivfReader->quantizer->search(1, query, nprobe, coarseDis.data(), coarseIds.data());
+        std::unique_ptr<faiss::InvertedListScanner> scanner(
+                ivfReader->get_InvertedListScanner(false, translatedSelector.get()));
+        scanner->set_query(query);
+        for (int i = 0; i < nprobe; i++) {
+            const faiss::idx_t listNo = coarseIds[i];
+            if (listNo < 0) {
+                continue;
+            }
+            const size_t listSize = ivfReader->invlists->list_size(listNo);
+            if (listSize == 0) {
+                continue;
+            }
+            scanner->set_list(listNo, coarseDis[i]);
+            faiss::InvertedLists::ScopedCodes codes(ivfReader->invlists, listNo);
+            faiss::InvertedLists::ScopedIds listIds(ivfReader->invlists, listNo);
+            scanner->scan_codes(listSize, codes.get(), listIds.get(), dis, ids, k);
+        }
+        toLabels();
+        return;
+    }
+
+    if (auto flatReader = dynamic_cast<const faiss::IndexFlatCodes *>(indexReader->index)) {
+        ExactScorer scorer(flatReader, query);
+        ExactSearchIntoHeap<C>(scorer, labels, k, dis, ids, [&](auto &add) {
+            for (size_t i = 0; i < labels.size(); i++) {
+                if (selector == nullptr || selector->is_member(labels[i])) {
+                    add(i);
+                }
+            }
+        });
+        return;
+    }
+
+    // Other indexes are searched on their own and their top k merged in
+    std::vector<float> segmentDis(k);
+    std::vector<faiss::idx_t> segmentIds(k);
+    SearchIndexWithFilter(indexReader, indexPointerJ, query, k, searchParams, filteredIdsArray, filterIdsLength,
+                          filterIdsTypeJ, nullptr, segmentDis.data(), segmentIds.data());
+    for (int i = 0; i < k; i++) {
+        if (segmentIds[i] >= 0 && C::cmp(dis[0], segmentDis[i])) {
+            faiss::heap_replace_top<C>(k, dis, ids, segmentDis[i], segmentIds[i]);
+        }
+    }
 }
 
 bool isIndexIVFPQL2(faiss::Index * index) {
@@ -1212,6 +3128,72 @@ jobjectArray knn_jni::faiss_wrapper::RangeSearch(knn_jni::JNIUtilInterface *jniU
 
 jobjectArray knn_jni::faiss_wrapper::RangeSearchWithFilter(knn_jni::JNIUtilInterface *jniUtil, JNIEnv *env, jlong indexPointerJ,
                                                            jfloatArray queryVectorJ, jfloat radiusJ, jobject methodParamsJ, jint maxResultWindowJ, jlongArray filterIdsJ, jint filterIdsTypeJ, jintArray parentIdsJ) {
+    SearchScratch &scratch = GetSearchScratch();
+    int resultSize = InternalRangeSearchWithFilter(jniUtil, env, indexPointerJ, queryVectorJ, radiusJ,
+                                                   knn_jni::commons::parseSearchParams(jniUtil, env, methodParamsJ), maxResultWindowJ,
+                                                   faiss_util::RangeResultMode::BEST, filterIdsJ, filterIdsTypeJ, parentIdsJ,
+                                                   &scratch.dis, &scratch.ids);
+    return knn_jni::commons::buildKNNQueryResults(jniUtil, env, scratch.ids.data(), scratch.dis.data(), resultSize);
+}
+
+jint knn_jni::faiss_wrapper::RangeSearchWithFilterIntoArrays(knn_jni::JNIUtilInterface *jniUtil, JNIEnv *env, jlong indexPointerJ,
+                                                             jfloatArray queryVectorJ, jfloat radiusJ, jobject methodParamsJ, jint maxResultWindowJ,
+                                                             jlongArray filterIdsJ, jint filterIdsTypeJ, jintArray parentIdsJ,
+                                                             jintArray resultIdsJ, jfloatArray resultDistancesJ) {
+    SearchScratch &scratch = GetSearchScratch();
+    int resultSize = InternalRangeSearchWithFilter(jniUtil, env, indexPointerJ, queryVectorJ, radiusJ,
+                                                   knn_jni::commons::parseSearchParams(jniUtil, env, methodParamsJ), maxResultWindowJ,
+                                                   faiss_util::RangeResultMode::BEST, filterIdsJ, filterIdsTypeJ, parentIdsJ,
+                                                   &scratch.dis, &scratch.ids);
+    return knn_jni::commons::copyQueryResults(jniUtil, env, scratch.ids.data(), scratch.dis.data(), resultSize, resultIdsJ, resultDistancesJ);
+}
+
+jint knn_jni::faiss_wrapper::RangeSearchCount(knn_jni::JNIUtilInterface *jniUtil, JNIEnv *env, jlong indexPointerJ,
+                                              jfloatArray queryVectorJ, jfloat radiusJ, jobject methodParamsJ,
+                                              jlongArray filterIdsJ, jint filterIdsTypeJ) {
+    SearchScratch &scratch = GetSearchScratch();
+    return InternalRangeSearchWithFilter(jniUtil, env, indexPointerJ, queryVectorJ, radiusJ,
+                                         knn_jni::commons::parseSearchParams(jniUtil, env, methodParamsJ), 0,
+                                         faiss_util::RangeResultMode::COUNT, filterIdsJ, filterIdsTypeJ, nullptr,
+                                         &scratch.dis, &scratch.ids);
+}
+
+jobjectArray knn_jni::faiss_wrapper::RangeSearchBinary(knn_jni::JNIUtilInterface *jniUtil, JNIEnv *env, jlong indexPointerJ,
+                                                       jbyteArray queryVectorJ, jfloat radiusJ, jobject methodParamsJ,
+                                                       jint maxResultWindowJ, jintArray parentIdsJ) {
+    return knn_jni::faiss_wrapper::RangeSearchBinaryWithFilter(jniUtil, env, indexPointerJ, queryVectorJ, radiusJ, methodParamsJ,
+                                                               maxResultWindowJ, nullptr, 0, parentIdsJ);
+}
+
+jobjectArray knn_jni::faiss_wrapper::RangeSearchBinaryWithFilter(knn_jni::JNIUtilInterface *jniUtil, JNIEnv *env, jlong indexPointerJ,
+                                                                 jbyteArray queryVectorJ, jfloat radiusJ, jobject methodParamsJ,
+                                                                 jint maxResultWindowJ, jlongArray filterIdsJ, jint filterIdsTypeJ,
+                                                                 jintArray parentIdsJ) {
+    SearchScratch &scratch = GetSearchScratch();
+    int resultSize = InternalRangeSearchBinaryWithFilter(jniUtil, env, indexPointerJ, queryVectorJ, radiusJ,
+                                                         knn_jni::commons::parseSearchParams(jniUtil, env, methodParamsJ),
+                                                         maxResultWindowJ, faiss_util::RangeResultMode::BEST, filterIdsJ,
+                                                         filterIdsTypeJ, parentIdsJ, &scratch.dis, &scratch.ids);
+    return knn_jni::commons::buildKNNQueryResults(jniUtil, env, scratch.ids.data(), scratch.dis.data(), resultSize);
+}
+
+jint knn_jni::faiss_wrapper::RangeSearchBinaryWithFilterIntoArrays(knn_jni::JNIUtilInterface *jniUtil, JNIEnv *env, jlong indexPointerJ,
+                                                                   jbyteArray queryVectorJ, jfloat radiusJ, jobject methodParamsJ,
+                                                                   jint maxResultWindowJ, jlongArray filterIdsJ, jint filterIdsTypeJ,
+                                                                   jintArray parentIdsJ, jintArray resultIdsJ,
+                                                                   jfloatArray resultDistancesJ) {
+    SearchScratch &scratch = GetSearchScratch();
+    int resultSize = InternalRangeSearchBinaryWithFilter(jniUtil, env, indexPointerJ, queryVectorJ, radiusJ,
+                                                         knn_jni::commons::parseSearchParams(jniUtil, env, methodParamsJ),
+                                                         maxResultWindowJ, faiss_util::RangeResultMode::BEST, filterIdsJ,
+                                                         filterIdsTypeJ, parentIdsJ, &scratch.dis, &scratch.ids);
+    return knn_jni::commons::copyQueryResults(jniUtil, env, scratch.ids.data(), scratch.dis.data(), resultSize, resultIdsJ, resultDistancesJ);
+}
+
+int InternalRangeSearchWithFilter(knn_jni::JNIUtilInterface *jniUtil, JNIEnv *env, jlong indexPointerJ,
+                                  jfloatArray queryVectorJ, jfloat radiusJ, const knn_jni::commons::SearchParams &searchParams, jint maxResultWindowJ,
+                                  faiss_util::RangeResultMode mode, jlongArray filterIdsJ, jint filterIdsTypeJ, jintArray parentIdsJ,
+                                  std::vector<float>* disOut, std::vector<faiss::idx_t>* idsOut) {
     if (queryVectorJ == nullptr) {
         throw std::runtime_error("Query Vector cannot be null");
     }
@@ -1222,103 +3204,226 @@ jobjectArray knn_jni::faiss_wrapper::RangeSearchWithFilter(knn_jni::JNIUtilInter
         throw std::runtime_error("Invalid pointer to indexReader");
     }
 
-    float *rawQueryVector = jniUtil->GetFloatArrayElements(env, queryVectorJ, nullptr);
-
-    std::unordered_map<std::string, jobject> methodParams;
-    if (methodParamsJ != nullptr) {
-        methodParams = jniUtil->ConvertJavaMapToCppMap(env, methodParamsJ);
-    }
-
-    // The res will be freed by ~RangeSearchResult() in FAISS
-    // The second parameter is always true, as lims is allocated by FAISS
-    faiss::RangeSearchResult res(1, true);
-
-    if (filterIdsJ != nullptr) {
-        jlong *filteredIdsArray = jniUtil->GetLongArrayElements(env, filterIdsJ, nullptr);
-        int filterIdsLength = jniUtil->GetJavaLongArrayLength(env, filterIdsJ);
-        std::unique_ptr<faiss::IDSelector> idSelector;
-        if (filterIdsTypeJ == BITMAP) {
-            idSelector.reset(new faiss::IDSelectorJlongBitmap(filterIdsLength, filteredIdsArray));
-        } else {
-            faiss::idx_t* batchIndices = reinterpret_cast<faiss::idx_t*>(filteredIdsArray);
-            idSelector.reset(new faiss::IDSelectorBatch(filterIdsLength, batchIndices));
-        }
-        faiss::SearchParameters *searchParameters;
+    const int filterIdsLength = filterIdsJ == nullptr ? 0 : jniUtil->GetJavaLongArrayLength(env, filterIdsJ);
+    std::shared_ptr<const CachedIDGrouper> idGrouper;
+    if (parentIdsJ != nullptr) {
+        idGrouper = getCachedIDGrouper(jniUtil, env, indexPointerJ, parentIdsJ);
+    }
+    auto hnswReader = dynamic_cast<const faiss::IndexHNSW*>(indexReader->index);
+    auto flatReader = dynamic_cast<const faiss::IndexFlatCodes*>(indexReader->index);
+    auto ivfReader = dynamic_cast<const faiss::IndexIVF*>(indexReader->index);
+    // HNSW, flat and IVF indexes pass internal ids to the handler, other indexes pass labels
+    const bool internalIds = (hnswReader != nullptr && hnswReader->storage != nullptr) || flatReader != nullptr
+            || ivfReader != nullptr;
+
+    // Hits are collected with smaller is better for every metric, so similarity scores are negated until the end.
+    // Nested docs are grouped by the handler, which only keeps the closest child of every parent.
+    const bool isSimilarity = indexReader->metric_type == faiss::METRIC_INNER_PRODUCT;
+    std::unique_ptr<faiss::IDGrouperTranslated> translatedGrouper;
+    const faiss::IDGrouper *grouper = idGrouper ? idGrouper->grouper.get() : nullptr;
+    if (grouper != nullptr && internalIds) {
+        translatedGrouper.reset(new faiss::IDGrouperTranslated(indexReader->id_map, grouper));
+        grouper = translatedGrouper.get();
+    }
+    // No JNI calls past this point until the arrays are released
+    QueryFilterIds filteredIdsArray(jniUtil, env, filterIdsJ, filterIdsLength, true);
+    PinnedArray<float> rawQueryVector(jniUtil, env, queryVectorJ);
+    faiss_util::BoundedRangeResultHandler handler(isSimilarity ? -radiusJ : radiusJ, std::max(maxResultWindowJ, 0),
+                                                  mode, grouper);
+
+    if (hnswReader != nullptr && hnswReader->storage != nullptr) {
+        // Drive the HNSW search with the bounded handler directly. Going through IndexHNSW::range_search would collect
+        // every hit under the radius in a RangeSearchResult first.
         faiss::SearchParametersHNSW hnswParams;
-        faiss::SearchParametersIVF ivfParams;
-        std::unique_ptr<faiss::IDGrouperBitmap> idGrouper;
-        std::vector<uint64_t> idGrouperBitmap;
-        auto hnswReader = dynamic_cast<const faiss::IndexHNSW*>(indexReader->index);
-        if (hnswReader) {
-            // Query param ef_search supersedes ef_search provided during index setting.
-            hnswParams.efSearch = knn_jni::commons::getIntegerMethodParameter(env, jniUtil, methodParams, EF_SEARCH, hnswReader->hnsw.efSearch);
-            hnswParams.sel = idSelector.get();
-            if (parentIdsJ != nullptr) {
-                idGrouper = buildIDGrouperBitmap(jniUtil, env, parentIdsJ, &idGrouperBitmap);
-                hnswParams.grp = idGrouper.get();
+        // Query param ef_search supersedes ef_search provided during index setting.
+        hnswParams.efSearch = searchParams.getEfSearch(hnswReader->hnsw.efSearch);
+        std::unique_ptr<faiss::DistanceComputer> distanceComputer(hnswReader->storage->get_distance_computer());
+        if (isSimilarity) {
+            distanceComputer.reset(new NegatedDistanceComputer(distanceComputer.release()));
+        }
+        faiss::VisitedTable visitedTable(hnswReader->ntotal);
+
+        QueryFilter queryFilter;
+        std::unique_ptr<faiss::IDSelectorTranslated> translatedSelector;
+        if (filteredIdsArray.get() != nullptr) {
+            // The filter holds labels, while the HNSW graph is searched by internal id
+            translatedSelector.reset(new faiss::IDSelectorTranslated(
+                    indexReader->id_map, queryFilter.build(filteredIdsArray.get(), filterIdsLength, filterIdsTypeJ)));
+            hnswParams.sel = translatedSelector.get();
+        }
+        distanceComputer->set_query(rawQueryVector.get());
+        hnswReader->hnsw.search(*distanceComputer, handler, visitedTable, &hnswParams);
+    } else if (flatReader != nullptr) {
+        // Flat indexes are scanned exactly, every candidate going straight into the handler
+        const bool sortedLabels = hasSortedLabels(indexPointerJ, indexReader->id_map);
+        ExactScorer scorer(flatReader, rawQueryVector.get());
+        ExactRangeSearchWithFilter(scorer, isSimilarity, indexReader->id_map, sortedLabels, filteredIdsArray.get(),
+                                   filterIdsLength, filterIdsTypeJ, handler);
+    } else if (ivfReader != nullptr) {
+        // Scan the probed lists straight into the bounded handler. IndexIVF::range_search would collect every hit
+        // under the radius in a RangeSearchResult first.
+        const int nprobe = std::min<int>(searchParams.getNprobes(ivfReader->nprobe), ivfReader->nlist);
+        std::vector<float> coarseDis(nprobe);
+        std::vector<faiss::idx_t> coarseIds(nprobe);
+        ivfReader->quantizer->search(1, rawQueryVector.get(), nprobe, coarseDis.data(), coarseIds.data());
+
+        QueryFilter queryFilter;
+        std::unique_ptr<faiss::IDSelectorTranslated> translatedSelector;
+        if (filteredIdsArray.get() != nullptr) {
+            // The filter holds labels, while the inverted lists hold internal ids
+            translatedSelector.reset(new faiss::IDSelectorTranslated(
+                    indexReader->id_map, queryFilter.build(filteredIdsArray.get(), filterIdsLength, filterIdsTypeJ)));
+        }
+        std::unique_ptr<faiss::InvertedListScanner> scanner(ivfReader->get_InvertedListScanner(false, nullptr));
+        scanner->set_query(rawQueryVector.get());
+        for (int i = 0; i < nprobe; i++) {
+            const faiss::idx_t listNo = coarseIds[i];
+            if (listNo < 0) {
+                continue;
             }
-            searchParameters = &hnswParams;
-        } else {
-            auto ivfReader = dynamic_cast<const faiss::IndexIVF*>(indexReader->index);
-            auto ivfFlatReader = dynamic_cast<const faiss::IndexIVFFlat*>(indexReader->index);
-            if(ivfReader || ivfFlatReader) {
-                ivfParams.sel = idSelector.get();
-                searchParameters = &ivfParams;
+            const size_t listSize = ivfReader->invlists->list_size(listNo);
+            if (listSize == 0) {
+                continue;
+            }
+            scanner->set_list(listNo, coarseDis[i]);
+            faiss::InvertedLists::ScopedCodes codes(ivfReader->invlists, listNo);
+            faiss::InvertedLists::ScopedIds listIds(ivfReader->invlists, listNo);
+            // Codes are scored one at a time so that the handler bounds the hits as they are found
+            const uint8_t *code = codes.get();
+            for (size_t j = 0; j < listSize; j++, code += ivfReader->code_size) {
+                const faiss::idx_t id = listIds.get()[j];
+                if (translatedSelector != nullptr && !translatedSelector->is_member(id)) {
+                    continue;
+                }
+                const float distance = scanner->distance_to_code(code);
+                handler.add_result(isSimilarity ? -distance : distance, id);
             }
         }
-        try {
-            indexReader->range_search(1, rawQueryVector, radiusJ, &res, searchParameters);
-        } catch (...) {
-            jniUtil->ReleaseFloatArrayElements(env, queryVectorJ, rawQueryVector, JNI_ABORT);
-            jniUtil->ReleaseLongArrayElements(env, filterIdsJ, filteredIdsArray, JNI_ABORT);
-            throw;
-        }
-        jniUtil->ReleaseLongArrayElements(env, filterIdsJ, filteredIdsArray, JNI_ABORT);
     } else {
+        // Other indexes only support range search through a RangeSearchResult, so their hits are bounded once the
+        // search returns
+        // The res will be freed by ~RangeSearchResult() in FAISS
+        // The second parameter is always true, as lims is allocated by FAISS
+        faiss::RangeSearchResult res(1, true);
         faiss::SearchParameters *searchParameters = nullptr;
         faiss::SearchParametersHNSW hnswParams;
-        std::unique_ptr<faiss::IDGrouperBitmap> idGrouper;
-        std::vector<uint64_t> idGrouperBitmap;
-        auto hnswReader = dynamic_cast<const faiss::IndexHNSW*>(indexReader->index);
-        if(hnswReader!= nullptr) {
+        if (hnswReader != nullptr) {
             // Query param ef_search supersedes ef_search provided during index setting.
-            hnswParams.efSearch = knn_jni::commons::getIntegerMethodParameter(env, jniUtil, methodParams, EF_SEARCH, hnswReader->hnsw.efSearch);
-            if (parentIdsJ != nullptr) {
-                idGrouper = buildIDGrouperBitmap(jniUtil, env, parentIdsJ, &idGrouperBitmap);
-                hnswParams.grp = idGrouper.get();
+            hnswParams.efSearch = searchParams.getEfSearch(hnswReader->hnsw.efSearch);
+            if (idGrouper) {
+                hnswParams.grp = idGrouper->grouper.get();
             }
             searchParameters = &hnswParams;
         }
-        try {
-            indexReader->range_search(1, rawQueryVector, radiusJ, &res, searchParameters);
-        } catch (...) {
-            jniUtil->ReleaseFloatArrayElements(env, queryVectorJ, rawQueryVector, JNI_ABORT);
-            throw;
+
+        QueryFilter queryFilter;
+        if (filteredIdsArray.get() != nullptr) {
+            hnswParams.sel = queryFilter.build(filteredIdsArray.get(), filterIdsLength, filterIdsTypeJ);
+        }
+        indexReader->range_search(1, rawQueryVector.get(), radiusJ, &res, searchParameters);
+
+        // lims is structured to support batched queries, it has a length of nq + 1 (where nq is the number of queries),
+        // lims[i] - lims[i-1] gives the number of results for the i-th query. With a single query we used in k-NN,
+        // res.lims[0] is always 0, and res.lims[1] gives the total number of matching entries found.
+        for (size_t i = 0; i < res.lims[1]; i++) {
+            handler.add_result(isSimilarity ? -res.distances[i] : res.distances[i], res.labels[i]);
+        }
+    }
+
+    if (mode == faiss_util::RangeResultMode::COUNT) {
+        return handler.count();
+    }
+
+    int resultSize = handler.finish(disOut, idsOut);
+    for (int i = 0; i < resultSize; i++) {
+        if (internalIds) {
+            (*idsOut)[i] = indexReader->id_map[(*idsOut)[i]];
         }
+        if (isSimilarity) {
+            (*disOut)[i] = -(*disOut)[i];
+        }
+    }
+    return resultSize;
+}
+
+int InternalRangeSearchBinaryWithFilter(knn_jni::JNIUtilInterface *jniUtil, JNIEnv *env, jlong indexPointerJ,
+                                        jbyteArray queryVectorJ, jfloat radiusJ, const knn_jni::commons::SearchParams &searchParams,
+                                        jint maxResultWindowJ, faiss_util::RangeResultMode mode, jlongArray filterIdsJ,
+                                        jint filterIdsTypeJ, jintArray parentIdsJ, std::vector<float>* disOut,
+                                        std::vector<faiss::idx_t>* idsOut) {
+    if (queryVectorJ == nullptr) {
+        throw std::runtime_error("Query Vector cannot be null");
     }
-    jniUtil->ReleaseFloatArrayElements(env, queryVectorJ, rawQueryVector, JNI_ABORT);
 
-    // lims is structured to support batched queries, it has a length of nq + 1 (where nq is the number of queries),
-    // lims[i] - lims[i-1] gives the number of results for the i-th query. With a single query we used in k-NN,
-    // res.lims[0] is always 0, and res.lims[1] gives the total number of matching entries found.
-    int resultSize = res.lims[1];
+    auto *indexReader = reinterpret_cast<faiss::IndexBinaryIDMap *>(indexPointerJ);
+
+    if (indexReader == nullptr) {
+        throw std::runtime_error("Invalid pointer to index");
+    }
 
-    // Limit the result size to maxResultWindowJ so that we don't return more than the max result window
-    // TODO: In the future, we should prevent this via FAISS's ResultHandler.
-    if (resultSize > maxResultWindowJ) {
-        resultSize = maxResultWindowJ;
+    const int filterIdsLength = filterIdsJ == nullptr ? 0 : jniUtil->GetJavaLongArrayLength(env, filterIdsJ);
+    std::shared_ptr<const CachedIDGrouper> idGrouper;
+    if (parentIdsJ != nullptr) {
+        idGrouper = getCachedIDGrouper(jniUtil, env, indexPointerJ, parentIdsJ);
     }
+    auto hnswReader = dynamic_cast<const faiss::IndexBinaryHNSW*>(indexReader->index);
+    // HNSW indexes pass internal ids to the handler, other indexes pass labels
+    const bool internalIds = hnswReader != nullptr;
 
-    jclass resultClass = jniUtil->FindClass(env,"org/opensearch/knn/index/query/KNNQueryResult");
-    jmethodID allArgs = jniUtil->FindMethod(env, "org/opensearch/knn/index/query/KNNQueryResult", "<init>");
+    std::unique_ptr<faiss::IDGrouperTranslated> translatedGrouper;
+    const faiss::IDGrouper *grouper = idGrouper ? idGrouper->grouper.get() : nullptr;
+    if (grouper != nullptr && internalIds) {
+        translatedGrouper.reset(new faiss::IDGrouperTranslated(indexReader->id_map, grouper));
+        grouper = translatedGrouper.get();
+    }
+    // No JNI calls past this point until the arrays are released
+    QueryFilterIds filteredIdsArray(jniUtil, env, filterIdsJ, filterIdsLength, true);
+    PinnedArray<uint8_t> rawQueryVector(jniUtil, env, queryVectorJ);
+    faiss_util::BoundedRangeResultHandler handler(radiusJ, std::max(maxResultWindowJ, 0), mode, grouper);
 
-    jobjectArray results = jniUtil->NewObjectArray(env, resultSize, resultClass, nullptr);
+    if (hnswReader != nullptr) {
+        faiss::SearchParametersHNSW hnswParams;
+        // Query param ef_search supersedes ef_search provided during index setting.
+        hnswParams.efSearch = searchParams.getEfSearch(hnswReader->hnsw.efSearch);
+        std::unique_ptr<faiss::DistanceComputer> distanceComputer(hnswReader->get_distance_computer());
+        faiss::VisitedTable visitedTable(hnswReader->ntotal);
+
+        QueryFilter queryFilter;
+        std::unique_ptr<faiss::IDSelectorTranslated> translatedSelector;
+        if (filteredIdsArray.get() != nullptr) {
+            translatedSelector.reset(new faiss::IDSelectorTranslated(
+                    indexReader->id_map, queryFilter.build(filteredIdsArray.get(), filterIdsLength, filterIdsTypeJ)));
+            hnswParams.sel = translatedSelector.get();
+        }
+        // Binary distance computers take the query code in place of floats
+        distanceComputer->set_query(reinterpret_cast<const float *>(rawQueryVector.get()));
+        hnswReader->hnsw.search(*distanceComputer, handler, visitedTable, &hnswParams);
+    } else {
+        // Binary IVF and flat indexes do not take search parameters for range search, so the filter is applied to
+        // their hits instead
+        faiss::RangeSearchResult res(1, true);
+        QueryFilter queryFilter;
+        const faiss::IDSelector *idSelector = filteredIdsArray.get() != nullptr
+                ? queryFilter.build(filteredIdsArray.get(), filterIdsLength, filterIdsTypeJ) : nullptr;
+        // Hamming distances are integers, so the hits under radiusJ are the hits under its ceiling
+        indexReader->range_search(1, rawQueryVector.get(), static_cast<int>(std::ceil(radiusJ)), &res);
+
+        for (size_t i = 0; i < res.lims[1]; i++) {
+            if (idSelector == nullptr || idSelector->is_member(res.labels[i])) {
+                handler.add_result(res.distances[i], res.labels[i]);
+            }
+        }
+    }
 
-    jobject result;
-    for (int i = 0; i < resultSize; ++i) {
-        result = jniUtil->NewObject(env, resultClass, allArgs, res.labels[i], res.distances[i]);
-        jniUtil->SetObjectArrayElement(env, results, i, result);
+    if (mode == faiss_util::RangeResultMode::COUNT) {
+        return handler.count();
     }
 
-    return results;
+    int resultSize = handler.finish(disOut, idsOut);
+    if (internalIds) {
+        for (int i = 0; i < resultSize; i++) {
+            (*idsOut)[i] = indexReader->id_map[(*idsOut)[i]];
+        }
+    }
+    return resultSize;
 }
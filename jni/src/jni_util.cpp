@@ -582,6 +582,36 @@ void knn_jni::JNIUtil::SetByteArrayRegion(JNIEnv *env, jbyteArray array, jsize s
     this->HasExceptionInStack(env, "Unable to set byte array region");
 }
 
+void knn_jni::JNIUtil::SetIntArrayRegion(JNIEnv *env, jintArray array, jsize start, jsize len, const jint * buf) {
+    env->SetIntArrayRegion(array, start, len, buf);
+    this->HasExceptionInStack(env, "Unable to set int array region");
+}
+
+void knn_jni::JNIUtil::SetFloatArrayRegion(JNIEnv *env, jfloatArray array, jsize start, jsize len, const jfloat * buf) {
+    env->SetFloatArrayRegion(array, start, len, buf);
+    this->HasExceptionInStack(env, "Unable to set float array region");
+}
+
+void knn_jni::JNIUtil::GetIntArrayRegion(JNIEnv *env, jintArray array, jsize start, jsize len, jint * buf) {
+    env->GetIntArrayRegion(array, start, len, buf);
+    this->HasExceptionInStack(env, "Unable to get int array region");
+}
+
+void knn_jni::JNIUtil::GetByteArrayRegion(JNIEnv *env, jbyteArray array, jsize start, jsize len, jbyte * buf) {
+    env->GetByteArrayRegion(array, start, len, buf);
+    this->HasExceptionInStack(env, "Unable to get byte array region");
+}
+
+void knn_jni::JNIUtil::GetFloatArrayRegion(JNIEnv *env, jfloatArray array, jsize start, jsize len, jfloat * buf) {
+    env->GetFloatArrayRegion(array, start, len, buf);
+    this->HasExceptionInStack(env, "Unable to get float array region");
+}
+
+void knn_jni::JNIUtil::GetLongArrayRegion(JNIEnv *env, jlongArray array, jsize start, jsize len, jlong * buf) {
+    env->GetLongArrayRegion(array, start, len, buf);
+    this->HasExceptionInStack(env, "Unable to get long array region");
+}
+
 jobject knn_jni::JNIUtil::GetObjectField(JNIEnv * env, jobject obj, jfieldID fieldID) {
     return env->GetObjectField(obj, fieldID);
 }
@@ -640,6 +670,7 @@ const std::string knn_jni::INDEX_DESCRIPTION = "index_description";
 const std::string knn_jni::PARAMETERS = "parameters";
 const std::string knn_jni::TRAINING_DATASET_SIZE_LIMIT = "training_dataset_size_limit";
 const std::string knn_jni::INDEX_THREAD_QUANTITY = "indexThreadQty";
+const std::string knn_jni::MODEL_ID = "model_id";
 
 const std::string knn_jni::L2 = "l2";
 const std::string knn_jni::L1 = "l1";
@@ -656,6 +687,7 @@ const std::string knn_jni::M_NMSLIB = "M";
 const std::string knn_jni::EF_CONSTRUCTION = "ef_construction";
 const std::string knn_jni::EF_CONSTRUCTION_NMSLIB = "efConstruction";
 const std::string knn_jni::EF_SEARCH = "ef_search";
+const std::string knn_jni::PARALLELISM = "parallelism";
 
 const std::string knn_jni::SPACE_TYPE_FAISS_INDEX_JAVA_KNN_CONSTANTS = "space_type";
 const std::string knn_jni::QUANTIZATION_LEVEL_FAISS_INDEX_LOAD_PARAMETER_JAVA_KNN_CONSTANTS = "quantization_level";
\ No newline at end of file
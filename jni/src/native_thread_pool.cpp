@@ -0,0 +1,194 @@
+// SPDX-License-Identifier: Apache-2.0
+//
+// The OpenSearch Contributors require contributions made to
+// this file be licensed under the Apache-2.0 license or a
+// compatible open source license.
+//
+// Modifications Copyright OpenSearch Contributors. See
+// GitHub history for details.
+
+#include "native_thread_pool.h"
+
+#include <algorithm>
+#include <exception>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace {
+    // Progress of a parallelFor call. Pool threads hold it through a shared pointer, so a helper that only gets to run
+    // after the caller has returned finds no task left and never touches the caller's stack.
+    struct ParallelForState {
+        std::atomic<int> nextTask {0};
+        int numTasks;
+        const std::function<void(int)> *task;
+        std::mutex mutex;
+        std::condition_variable allFinished;
+        int finishedTasks = 0;
+        std::exception_ptr error;
+
+        void runTasks() {
+            int i;
+            while ((i = nextTask.fetch_add(1)) < numTasks) {
+                std::exception_ptr taskError;
+                try {
+                    (*task)(i);
+                } catch (...) {
+                    taskError = std::current_exception();
+                }
+                std::lock_guard<std::mutex> lock(mutex);
+                if (taskError && !error) {
+                    error = taskError;
+                }
+                if (++finishedTasks == numTasks) {
+                    allFinished.notify_all();
+                }
+            }
+        }
+    };
+
+    int defaultPoolSize() {
+        return std::max(1, static_cast<int>(std::thread::hardware_concurrency()) - 1);
+    }
+
+    std::mutex instanceMutex;
+    std::unique_ptr<knn_jni::NativeThreadPool> instance;
+}
+
+knn_jni::NativeThreadPool::NativeThreadPool(int numThreads, bool pinThreads)
+    : nextQueue(0), pendingJobs(0), stopping(false) {
+    for (int i = 0; i < numThreads; i++) {
+        queues.emplace_back(new WorkerQueue());
+    }
+    for (int i = 0; i < numThreads; i++) {
+        workers.emplace_back(&NativeThreadPool::workerLoop, this, i, pinThreads);
+    }
+}
+
+knn_jni::NativeThreadPool::~NativeThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(pendingMutex);
+        stopping = true;
+    }
+    workAvailable.notify_all();
+    for (auto &worker : workers) {
+        worker.join();
+    }
+}
+
+void knn_jni::NativeThreadPool::initialize(int numThreads, bool pinThreads) {
+    std::lock_guard<std::mutex> lock(instanceMutex);
+    if (instance == nullptr) {
+        instance.reset(new NativeThreadPool(numThreads > 0 ? numThreads : defaultPoolSize(), pinThreads));
+    }
+}
+
+knn_jni::NativeThreadPool &knn_jni::NativeThreadPool::getInstance() {
+    std::lock_guard<std::mutex> lock(instanceMutex);
+    if (instance == nullptr) {
+        instance.reset(new NativeThreadPool(defaultPoolSize()));
+    }
+    return *instance;
+}
+
+void knn_jni::NativeThreadPool::submit(std::function<void()> job) {
+    if (workers.empty()) {
+        job();
+        return;
+    }
+    WorkerQueue &queue = *queues[nextQueue.fetch_add(1) % queues.size()];
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.jobs.push_back(std::move(job));
+    }
+    {
+        std::lock_guard<std::mutex> lock(pendingMutex);
+        pendingJobs++;
+    }
+    workAvailable.notify_one();
+}
+
+void knn_jni::NativeThreadPool::parallelFor(int numTasks, int parallelism, const std::function<void(int)> &task) {
+    if (numTasks <= 0) {
+        return;
+    }
+    const int numHelpers = std::min({parallelism - 1, numTasks - 1, size()});
+    if (numHelpers <= 0) {
+        for (int i = 0; i < numTasks; i++) {
+            task(i);
+        }
+        return;
+    }
+
+    auto state = std::make_shared<ParallelForState>();
+    state->numTasks = numTasks;
+    state->task = &task;
+    for (int i = 0; i < numHelpers; i++) {
+        submit([state]() { state->runTasks(); });
+    }
+
+    state->runTasks();
+
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->allFinished.wait(lock, [&state]() { return state->finishedTasks == state->numTasks; });
+    if (state->error) {
+        std::rethrow_exception(state->error);
+    }
+}
+
+int knn_jni::NativeThreadPool::size() const {
+    return static_cast<int>(workers.size());
+}
+
+void knn_jni::NativeThreadPool::workerLoop(int worker, bool pinThread) {
+#ifdef __linux__
+    if (pinThread) {
+        const int numCores = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+        cpu_set_t cpuSet;
+        CPU_ZERO(&cpuSet);
+        CPU_SET(worker % numCores, &cpuSet);
+        // Pinning is best effort, a thread that cannot be pinned still serves jobs
+        pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet);
+    }
+#endif
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(pendingMutex);
+            workAvailable.wait(lock, [this]() { return stopping || pendingJobs > 0; });
+            if (pendingJobs == 0) {
+                return;
+            }
+            // Claiming a job up front guarantees one is left in some queue for this worker
+            pendingJobs--;
+        }
+        takeJob(worker)();
+    }
+}
+
+std::function<void()> knn_jni::NativeThreadPool::takeJob(int worker) {
+    const size_t numQueues = queues.size();
+    while (true) {
+        {
+            WorkerQueue &own = *queues[worker];
+            std::lock_guard<std::mutex> lock(own.mutex);
+            if (!own.jobs.empty()) {
+                std::function<void()> job = std::move(own.jobs.front());
+                own.jobs.pop_front();
+                return job;
+            }
+        }
+        for (size_t i = 1; i < numQueues; i++) {
+            WorkerQueue &victim = *queues[(worker + i) % numQueues];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (!victim.jobs.empty()) {
+                std::function<void()> job = std::move(victim.jobs.front());
+                victim.jobs.pop_front();
+                return job;
+            }
+        }
+        // Queues are scanned one at a time, so the claimed job may have landed in a queue already scanned
+        std::this_thread::yield();
+    }
+}
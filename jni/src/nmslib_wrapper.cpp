@@ -26,12 +26,17 @@
 
 #include <jni.h>
 #include <string>
+#include <vector>
 
 #include "hnswquery.h"
 #include "method/hnsw.h"
 
 std::string TranslateSpaceType(const std::string &spaceType);
 
+// Search the index and store the ids and distances of the neighbors, closest first, into idsOut and distancesOut
+void InternalQueryIndex(knn_jni::JNIUtilInterface *jniUtil, JNIEnv *env, jlong indexPointerJ, jfloatArray queryVectorJ,
+                        jint kJ, const knn_jni::commons::SearchParams &searchParams, std::vector<int64_t> *idsOut, std::vector<float> *distancesOut);
+
 // We do not use label functionality of nmslib so we pass default label. Setting as a const allows us to avoid a few
 // allocations
 const similarity::LabelType DEFAULT_LABEL = -1;
@@ -292,6 +297,34 @@ jlong knn_jni::nmslib_wrapper::LoadIndexWithStream(knn_jni::JNIUtilInterface *jn
 
 jobjectArray knn_jni::nmslib_wrapper::QueryIndex(knn_jni::JNIUtilInterface *jniUtil, JNIEnv *env, jlong indexPointerJ,
                                                  jfloatArray queryVectorJ, jint kJ, jobject methodParamsJ) {
+  std::vector<int64_t> ids;
+  std::vector<float> distances;
+  InternalQueryIndex(jniUtil, env, indexPointerJ, queryVectorJ, kJ, knn_jni::commons::parseSearchParams(jniUtil, env, methodParamsJ),
+                     &ids, &distances);
+  return knn_jni::commons::buildKNNQueryResults(jniUtil, env, ids.data(), distances.data(), ids.size());
+}
+
+jint knn_jni::nmslib_wrapper::QueryIndexIntoArrays(knn_jni::JNIUtilInterface *jniUtil, JNIEnv *env, jlong indexPointerJ,
+                                                   jfloatArray queryVectorJ, jint kJ, jobject methodParamsJ,
+                                                   jintArray resultIdsJ, jfloatArray resultDistancesJ) {
+  std::vector<int64_t> ids;
+  std::vector<float> distances;
+  InternalQueryIndex(jniUtil, env, indexPointerJ, queryVectorJ, kJ, knn_jni::commons::parseSearchParams(jniUtil, env, methodParamsJ),
+                     &ids, &distances);
+  return knn_jni::commons::copyQueryResults(jniUtil, env, ids.data(), distances.data(), ids.size(), resultIdsJ, resultDistancesJ);
+}
+
+jobjectArray knn_jni::nmslib_wrapper::QueryIndexWithSearchParams(knn_jni::JNIUtilInterface *jniUtil, JNIEnv *env, jlong indexPointerJ,
+                                                                 jfloatArray queryVectorJ, jint kJ, jlong searchParamsPointerJ) {
+  std::vector<int64_t> ids;
+  std::vector<float> distances;
+  InternalQueryIndex(jniUtil, env, indexPointerJ, queryVectorJ, kJ, knn_jni::commons::getSearchParams(searchParamsPointerJ),
+                     &ids, &distances);
+  return knn_jni::commons::buildKNNQueryResults(jniUtil, env, ids.data(), distances.data(), ids.size());
+}
+
+void InternalQueryIndex(knn_jni::JNIUtilInterface *jniUtil, JNIEnv *env, jlong indexPointerJ, jfloatArray queryVectorJ,
+                        jint kJ, const knn_jni::commons::SearchParams &searchParams, std::vector<int64_t> *idsOut, std::vector<float> *distancesOut) {
 
   if (queryVectorJ == nullptr) {
     throw std::runtime_error("Query Vector cannot be null");
@@ -316,12 +349,8 @@ jobjectArray knn_jni::nmslib_wrapper::QueryIndex(knn_jni::JNIUtilInterface *jniU
   }
 
   jniUtil->ReleaseFloatArrayElements(env, queryVectorJ, rawQueryvector, JNI_ABORT);
-  std::unordered_map<std::string, jobject> methodParams;
-  if (methodParamsJ != nullptr) {
-    methodParams = jniUtil->ConvertJavaMapToCppMap(env, methodParamsJ);
-  }
 
-  int queryEfSearch = knn_jni::commons::getIntegerMethodParameter(env, jniUtil, methodParams, EF_SEARCH, -1);
+  int queryEfSearch = searchParams.getEfSearch(-1);
   std::unique_ptr<similarity::KNNQuery<float>> query;
   std::unique_ptr<similarity::KNNQueue<float>> neighbors;
   if (queryEfSearch == -1) {
@@ -334,22 +363,12 @@ jobjectArray knn_jni::nmslib_wrapper::QueryIndex(knn_jni::JNIUtilInterface *jniU
   neighbors.reset(query->Result()->Clone());
 
   int resultSize = neighbors->Size();
-  jclass resultClass = jniUtil->FindClass(env, "org/opensearch/knn/index/query/KNNQueryResult");
-  jmethodID allArgs = jniUtil->FindMethod(env, "org/opensearch/knn/index/query/KNNQueryResult", "<init>");
-
-  jobjectArray results = jniUtil->NewObjectArray(env, resultSize, resultClass, nullptr);
-
-  jobject result;
-  float distance;
-  long id;
+  idsOut->reserve(resultSize);
+  distancesOut->reserve(resultSize);
   for (int i = 0; i < resultSize; ++i) {
-    distance = neighbors->TopDistance();
-    id = neighbors->Pop()->id();
-    result = jniUtil->NewObject(env, resultClass, allArgs, id, distance);
-    jniUtil->SetObjectArrayElement(env, results, i, result);
+    distancesOut->push_back(neighbors->TopDistance());
+    idsOut->push_back(neighbors->Pop()->id());
   }
-
-  return results;
 }
 
 void knn_jni::nmslib_wrapper::Free(jlong indexPointerJ) {
@@ -82,6 +82,48 @@ JNIEXPORT jlong JNICALL Java_org_opensearch_knn_jni_FaissService_initByteIndex(J
     return (jlong)0;
 }
 
+JNIEXPORT jlong JNICALL Java_org_opensearch_knn_jni_FaissService_estimateIndexMemory(JNIEnv * env, jclass cls,
+                                                                                     jlong numDocs, jint dimJ,
+                                                                                     jobject parametersJ)
+{
+    try {
+        std::unique_ptr<knn_jni::faiss_wrapper::FaissMethods> faissMethods(new knn_jni::faiss_wrapper::FaissMethods());
+        knn_jni::faiss_wrapper::IndexService indexService(std::move(faissMethods));
+        return knn_jni::faiss_wrapper::EstimateIndexMemory(&jniUtil, env, numDocs, dimJ, parametersJ, &indexService);
+    } catch (...) {
+        jniUtil.CatchCppExceptionAndThrowJava(env);
+    }
+    return (jlong)0;
+}
+
+JNIEXPORT jlong JNICALL Java_org_opensearch_knn_jni_FaissService_estimateBinaryIndexMemory(JNIEnv * env, jclass cls,
+                                                                                           jlong numDocs, jint dimJ,
+                                                                                           jobject parametersJ)
+{
+    try {
+        std::unique_ptr<knn_jni::faiss_wrapper::FaissMethods> faissMethods(new knn_jni::faiss_wrapper::FaissMethods());
+        knn_jni::faiss_wrapper::BinaryIndexService binaryIndexService(std::move(faissMethods));
+        return knn_jni::faiss_wrapper::EstimateIndexMemory(&jniUtil, env, numDocs, dimJ, parametersJ, &binaryIndexService);
+    } catch (...) {
+        jniUtil.CatchCppExceptionAndThrowJava(env);
+    }
+    return (jlong)0;
+}
+
+JNIEXPORT jlong JNICALL Java_org_opensearch_knn_jni_FaissService_estimateByteIndexMemory(JNIEnv * env, jclass cls,
+                                                                                         jlong numDocs, jint dimJ,
+                                                                                         jobject parametersJ)
+{
+    try {
+        std::unique_ptr<knn_jni::faiss_wrapper::FaissMethods> faissMethods(new knn_jni::faiss_wrapper::FaissMethods());
+        knn_jni::faiss_wrapper::ByteIndexService byteIndexService(std::move(faissMethods));
+        return knn_jni::faiss_wrapper::EstimateIndexMemory(&jniUtil, env, numDocs, dimJ, parametersJ, &byteIndexService);
+    } catch (...) {
+        jniUtil.CatchCppExceptionAndThrowJava(env);
+    }
+    return (jlong)0;
+}
+
 JNIEXPORT void JNICALL Java_org_opensearch_knn_jni_FaissService_insertToIndex(JNIEnv * env, jclass cls, jintArray idsJ,
                                                                               jlong vectorsAddressJ, jint dimJ,
                                                                               jlong indexAddress, jint threadCount)
@@ -124,6 +166,80 @@ JNIEXPORT void JNICALL Java_org_opensearch_knn_jni_FaissService_insertToByteInde
     }
 }
 
+JNIEXPORT jlong JNICALL Java_org_opensearch_knn_jni_FaissService_startInsertWorker(JNIEnv * env, jclass cls, jlong indexAddress,
+                                                                                   jint dimJ, jint threadCount)
+{
+    try {
+        std::unique_ptr<knn_jni::faiss_wrapper::FaissMethods> faissMethods(new knn_jni::faiss_wrapper::FaissMethods());
+        std::unique_ptr<knn_jni::faiss_wrapper::IndexService> indexService(
+                new knn_jni::faiss_wrapper::IndexService(std::move(faissMethods)));
+        return knn_jni::faiss_wrapper::StartInsertWorker(indexAddress, dimJ, threadCount, std::move(indexService));
+    } catch (...) {
+        jniUtil.CatchCppExceptionAndThrowJava(env);
+    }
+    return (jlong)0;
+}
+
+JNIEXPORT jlong JNICALL Java_org_opensearch_knn_jni_FaissService_startBinaryInsertWorker(JNIEnv * env, jclass cls, jlong indexAddress,
+                                                                                         jint dimJ, jint threadCount)
+{
+    try {
+        std::unique_ptr<knn_jni::faiss_wrapper::FaissMethods> faissMethods(new knn_jni::faiss_wrapper::FaissMethods());
+        std::unique_ptr<knn_jni::faiss_wrapper::IndexService> indexService(
+                new knn_jni::faiss_wrapper::BinaryIndexService(std::move(faissMethods)));
+        return knn_jni::faiss_wrapper::StartInsertWorker(indexAddress, dimJ, threadCount, std::move(indexService));
+    } catch (...) {
+        jniUtil.CatchCppExceptionAndThrowJava(env);
+    }
+    return (jlong)0;
+}
+
+JNIEXPORT jlong JNICALL Java_org_opensearch_knn_jni_FaissService_startByteInsertWorker(JNIEnv * env, jclass cls, jlong indexAddress,
+                                                                                       jint dimJ, jint threadCount)
+{
+    try {
+        std::unique_ptr<knn_jni::faiss_wrapper::FaissMethods> faissMethods(new knn_jni::faiss_wrapper::FaissMethods());
+        std::unique_ptr<knn_jni::faiss_wrapper::IndexService> indexService(
+                new knn_jni::faiss_wrapper::ByteIndexService(std::move(faissMethods)));
+        return knn_jni::faiss_wrapper::StartInsertWorker(indexAddress, dimJ, threadCount, std::move(indexService));
+    } catch (...) {
+        jniUtil.CatchCppExceptionAndThrowJava(env);
+    }
+    return (jlong)0;
+}
+
+JNIEXPORT jlong JNICALL Java_org_opensearch_knn_jni_FaissService_submitInsertToIndex(JNIEnv * env, jclass cls,
+                                                                                     jlong insertWorkerJ, jintArray idsJ,
+                                                                                     jlong vectorsAddressJ)
+{
+    try {
+        return knn_jni::faiss_wrapper::SubmitInsertToIndex(&jniUtil, env, insertWorkerJ, idsJ, vectorsAddressJ);
+    } catch (...) {
+        jniUtil.CatchCppExceptionAndThrowJava(env);
+    }
+    return (jlong)0;
+}
+
+JNIEXPORT void JNICALL Java_org_opensearch_knn_jni_FaissService_waitForInsertToIndex(JNIEnv * env, jclass cls,
+                                                                                     jlong insertWorkerJ, jlong insertBatchJ)
+{
+    try {
+        knn_jni::faiss_wrapper::WaitForInsertToIndex(insertWorkerJ, insertBatchJ);
+    } catch (...) {
+        jniUtil.CatchCppExceptionAndThrowJava(env);
+    }
+}
+
+JNIEXPORT void JNICALL Java_org_opensearch_knn_jni_FaissService_stopInsertWorker(JNIEnv * env, jclass cls,
+                                                                                 jlong insertWorkerJ)
+{
+    try {
+        knn_jni::faiss_wrapper::StopInsertWorker(insertWorkerJ);
+    } catch (...) {
+        jniUtil.CatchCppExceptionAndThrowJava(env);
+    }
+}
+
 JNIEXPORT void JNICALL Java_org_opensearch_knn_jni_FaissService_writeIndex(JNIEnv * env,
                                                                            jclass cls,
                                                                            jlong indexAddress,
@@ -235,6 +351,16 @@ JNIEXPORT void JNICALL Java_org_opensearch_knn_jni_FaissService_createByteIndexF
     }
 }
 
+JNIEXPORT void JNICALL Java_org_opensearch_knn_jni_FaissService_evictTemplateIndex(JNIEnv * env, jclass cls,
+                                                                                   jstring modelIdJ)
+{
+    try {
+        knn_jni::faiss_wrapper::EvictTemplateIndex(jniUtil.ConvertJavaStringToCppString(env, modelIdJ));
+    } catch (...) {
+        jniUtil.CatchCppExceptionAndThrowJava(env);
+    }
+}
+
 JNIEXPORT jlong JNICALL Java_org_opensearch_knn_jni_FaissService_loadIndex(JNIEnv * env, jclass cls, jstring indexPathJ)
 {
   try {
@@ -245,6 +371,16 @@ JNIEXPORT jlong JNICALL Java_org_opensearch_knn_jni_FaissService_loadIndex(JNIEn
   return NULL;
 }
 
+JNIEXPORT jlong JNICALL Java_org_opensearch_knn_jni_FaissService_loadIndexWithMmap(JNIEnv * env, jclass cls, jstring indexPathJ)
+{
+    try {
+        return knn_jni::faiss_wrapper::LoadIndexWithMmap(&jniUtil, env, indexPathJ);
+    } catch (...) {
+        jniUtil.CatchCppExceptionAndThrowJava(env);
+    }
+    return NULL;
+}
+
 JNIEXPORT jlong JNICALL Java_org_opensearch_knn_jni_FaissService_loadIndexWithStream(JNIEnv * env,
                                                                                      jclass cls,
                                                                                      jobject readStream)
@@ -277,6 +413,16 @@ JNIEXPORT jlong JNICALL Java_org_opensearch_knn_jni_FaissService_loadBinaryIndex
     return NULL;
 }
 
+JNIEXPORT jlong JNICALL Java_org_opensearch_knn_jni_FaissService_loadBinaryIndexWithMmap(JNIEnv * env, jclass cls, jstring indexPathJ)
+{
+    try {
+        return knn_jni::faiss_wrapper::LoadBinaryIndexWithMmap(&jniUtil, env, indexPathJ);
+    } catch (...) {
+        jniUtil.CatchCppExceptionAndThrowJava(env);
+    }
+    return NULL;
+}
+
 JNIEXPORT jlong JNICALL Java_org_opensearch_knn_jni_FaissService_loadBinaryIndexWithStream(JNIEnv * env,
                                                                                            jclass cls,
                                                                                            jobject readStream)
@@ -298,6 +444,46 @@ JNIEXPORT jlong JNICALL Java_org_opensearch_knn_jni_FaissService_loadBinaryIndex
 
     return NULL;
 }
+
+JNIEXPORT jlong JNICALL Java_org_opensearch_knn_jni_FaissService_loadIndexForMerge(JNIEnv * env,
+                                                                                   jclass cls,
+                                                                                   jobject readStream,
+                                                                                   jintArray docMapJ,
+                                                                                   jlong numDocs,
+                                                                                   jobject parametersJ)
+{
+    try {
+        // Note that `readStream` is `IndexInputWithBuffer` type.
+        knn_jni::stream::NativeEngineIndexInputMediator mediator {&jniUtil, env, readStream};
+        knn_jni::stream::FaissOpenSearchIOReader faissOpenSearchIOReader {&mediator};
+
+        return knn_jni::faiss_wrapper::LoadIndexForMerge(&jniUtil, env, &faissOpenSearchIOReader, docMapJ, numDocs, parametersJ);
+    } catch (...) {
+        jniUtil.CatchCppExceptionAndThrowJava(env);
+    }
+
+    return NULL;
+}
+
+JNIEXPORT jlong JNICALL Java_org_opensearch_knn_jni_FaissService_loadBinaryIndexForMerge(JNIEnv * env,
+                                                                                         jclass cls,
+                                                                                         jobject readStream,
+                                                                                         jintArray docMapJ,
+                                                                                         jlong numDocs,
+                                                                                         jobject parametersJ)
+{
+    try {
+        // Note that `readStream` is `IndexInputWithBuffer` type.
+        knn_jni::stream::NativeEngineIndexInputMediator mediator {&jniUtil, env, readStream};
+        knn_jni::stream::FaissOpenSearchIOReader faissOpenSearchIOReader {&mediator};
+
+        return knn_jni::faiss_wrapper::LoadBinaryIndexForMerge(&jniUtil, env, &faissOpenSearchIOReader, docMapJ, numDocs, parametersJ);
+    } catch (...) {
+        jniUtil.CatchCppExceptionAndThrowJava(env);
+    }
+
+    return NULL;
+}
 JNIEXPORT jlong JNICALL Java_org_opensearch_knn_jni_FaissService_loadIndexWithStreamADCParams
 (JNIEnv * env, jclass cls, jobject readStreamJ, jobject parametersJ) {
     try {
@@ -371,6 +557,58 @@ JNIEXPORT jobjectArray JNICALL Java_org_opensearch_knn_jni_FaissService_queryInd
 
 }
 
+JNIEXPORT jint JNICALL Java_org_opensearch_knn_jni_FaissService_queryIndexIntoArrays
+  (JNIEnv * env, jclass cls, jlong indexPointerJ, jfloatArray queryVectorJ, jint kJ, jobject methodParamsJ, jlongArray filteredIdsJ, jint filterIdsTypeJ,
+   jintArray parentIdsJ, jintArray resultIdsJ, jfloatArray resultDistancesJ) {
+
+      try {
+          return knn_jni::faiss_wrapper::QueryIndex_WithFilterIntoArrays(&jniUtil, env, indexPointerJ, queryVectorJ, kJ, methodParamsJ, filteredIdsJ,
+                                                                         filterIdsTypeJ, parentIdsJ, resultIdsJ, resultDistancesJ);
+      } catch (...) {
+          jniUtil.CatchCppExceptionAndThrowJava(env);
+      }
+      return 0;
+}
+
+JNIEXPORT jobjectArray JNICALL Java_org_opensearch_knn_jni_FaissService_queryIndexWithSearchParams
+  (JNIEnv * env, jclass cls, jlong indexPointerJ, jfloatArray queryVectorJ, jint kJ, jlong searchParamsPointerJ, jlongArray filteredIdsJ,
+   jint filterIdsTypeJ, jintArray parentIdsJ) {
+
+      try {
+          return knn_jni::faiss_wrapper::QueryIndex_WithSearchParams(&jniUtil, env, indexPointerJ, queryVectorJ, kJ, searchParamsPointerJ,
+                                                                     filteredIdsJ, filterIdsTypeJ, parentIdsJ);
+      } catch (...) {
+          jniUtil.CatchCppExceptionAndThrowJava(env);
+      }
+      return nullptr;
+}
+
+JNIEXPORT jint JNICALL Java_org_opensearch_knn_jni_FaissService_queryIndexWithSearchParamsIntoArrays
+  (JNIEnv * env, jclass cls, jlong indexPointerJ, jfloatArray queryVectorJ, jint kJ, jlong searchParamsPointerJ, jlongArray filteredIdsJ,
+   jint filterIdsTypeJ, jintArray parentIdsJ, jintArray resultIdsJ, jfloatArray resultDistancesJ) {
+
+      try {
+          return knn_jni::faiss_wrapper::QueryIndex_WithSearchParamsIntoArrays(&jniUtil, env, indexPointerJ, queryVectorJ, kJ, searchParamsPointerJ,
+                                                                               filteredIdsJ, filterIdsTypeJ, parentIdsJ, resultIdsJ,
+                                                                               resultDistancesJ);
+      } catch (...) {
+          jniUtil.CatchCppExceptionAndThrowJava(env);
+      }
+      return 0;
+}
+
+JNIEXPORT void JNICALL Java_org_opensearch_knn_jni_FaissService_queryIndexBatch
+  (JNIEnv * env, jclass cls, jlong indexPointerJ, jfloatArray queryVectorsJ, jint kJ, jobject methodParamsJ, jlongArray filteredIdsJ, jint filterIdsTypeJ,
+   jintArray parentIdsJ, jintArray resultIdsJ, jfloatArray resultDistancesJ) {
+
+      try {
+          knn_jni::faiss_wrapper::QueryIndexBatch(&jniUtil, env, indexPointerJ, queryVectorsJ, kJ, methodParamsJ, filteredIdsJ, filterIdsTypeJ, parentIdsJ,
+                                                  resultIdsJ, resultDistancesJ);
+      } catch (...) {
+          jniUtil.CatchCppExceptionAndThrowJava(env);
+      }
+}
+
 JNIEXPORT jobjectArray JNICALL Java_org_opensearch_knn_jni_FaissService_queryBinaryIndexWithFilter
   (JNIEnv * env, jclass cls, jlong indexPointerJ, jbyteArray queryVectorJ, jint kJ, jobject methodParamsJ, jlongArray filteredIdsJ, jint filterIdsTypeJ,  jintArray parentIdsJ) {
 
@@ -383,6 +621,116 @@ JNIEXPORT jobjectArray JNICALL Java_org_opensearch_knn_jni_FaissService_queryBin
 
 }
 
+JNIEXPORT jint JNICALL Java_org_opensearch_knn_jni_FaissService_queryBinaryIndexIntoArrays
+  (JNIEnv * env, jclass cls, jlong indexPointerJ, jbyteArray queryVectorJ, jint kJ, jobject methodParamsJ, jlongArray filteredIdsJ, jint filterIdsTypeJ,
+   jintArray parentIdsJ, jintArray resultIdsJ, jfloatArray resultDistancesJ) {
+
+      try {
+          return knn_jni::faiss_wrapper::QueryBinaryIndex_WithFilterIntoArrays(&jniUtil, env, indexPointerJ, queryVectorJ, kJ, methodParamsJ, filteredIdsJ,
+                                                                               filterIdsTypeJ, parentIdsJ, resultIdsJ, resultDistancesJ);
+      } catch (...) {
+          jniUtil.CatchCppExceptionAndThrowJava(env);
+      }
+      return 0;
+}
+
+JNIEXPORT jobjectArray JNICALL Java_org_opensearch_knn_jni_FaissService_queryBinaryIndexWithSearchParams
+  (JNIEnv * env, jclass cls, jlong indexPointerJ, jbyteArray queryVectorJ, jint kJ, jlong searchParamsPointerJ, jlongArray filteredIdsJ,
+   jint filterIdsTypeJ, jintArray parentIdsJ) {
+
+      try {
+          return knn_jni::faiss_wrapper::QueryBinaryIndex_WithSearchParams(&jniUtil, env, indexPointerJ, queryVectorJ, kJ, searchParamsPointerJ,
+                                                                           filteredIdsJ, filterIdsTypeJ, parentIdsJ);
+      } catch (...) {
+          jniUtil.CatchCppExceptionAndThrowJava(env);
+      }
+      return nullptr;
+}
+
+JNIEXPORT jobjectArray JNICALL Java_org_opensearch_knn_jni_FaissService_exactSearch
+  (JNIEnv * env, jclass cls, jlong indexPointerJ, jfloatArray queryVectorJ, jint kJ, jlongArray filteredIdsJ,
+   jint filterIdsTypeJ) {
+
+      try {
+          return knn_jni::faiss_wrapper::ExactSearch(&jniUtil, env, indexPointerJ, queryVectorJ, kJ, filteredIdsJ,
+                                                     filterIdsTypeJ);
+      } catch (...) {
+          jniUtil.CatchCppExceptionAndThrowJava(env);
+      }
+      return nullptr;
+}
+
+JNIEXPORT jobjectArray JNICALL Java_org_opensearch_knn_jni_FaissService_exactSearchBinary
+  (JNIEnv * env, jclass cls, jlong indexPointerJ, jbyteArray queryVectorJ, jint kJ, jlongArray filteredIdsJ,
+   jint filterIdsTypeJ) {
+
+      try {
+          return knn_jni::faiss_wrapper::ExactSearchBinary(&jniUtil, env, indexPointerJ, queryVectorJ, kJ, filteredIdsJ,
+                                                           filterIdsTypeJ);
+      } catch (...) {
+          jniUtil.CatchCppExceptionAndThrowJava(env);
+      }
+      return nullptr;
+}
+
+JNIEXPORT jlong JNICALL Java_org_opensearch_knn_jni_FaissService_submitQueryIndex
+  (JNIEnv * env, jclass cls, jlong indexPointerJ, jfloatArray queryVectorJ, jint kJ, jobject methodParamsJ,
+   jlongArray filteredIdsJ, jint filterIdsTypeJ, jintArray parentIdsJ) {
+
+      try {
+          return knn_jni::faiss_wrapper::SubmitQueryIndex(&jniUtil, env, indexPointerJ, queryVectorJ, kJ, methodParamsJ,
+                                                          filteredIdsJ, filterIdsTypeJ, parentIdsJ);
+      } catch (...) {
+          jniUtil.CatchCppExceptionAndThrowJava(env);
+      }
+      return 0;
+}
+
+JNIEXPORT jobjectArray JNICALL Java_org_opensearch_knn_jni_FaissService_queryIndexes
+  (JNIEnv * env, jclass cls, jlongArray indexPointersJ, jintArray docBasesJ, jfloatArray queryVectorJ, jint kJ,
+   jobject methodParamsJ, jobjectArray filteredIdsJ, jintArray filterIdsTypesJ) {
+
+      try {
+          return knn_jni::faiss_wrapper::QueryIndexes(&jniUtil, env, indexPointersJ, docBasesJ, queryVectorJ, kJ,
+                                                      methodParamsJ, filteredIdsJ, filterIdsTypesJ);
+      } catch (...) {
+          jniUtil.CatchCppExceptionAndThrowJava(env);
+      }
+      return nullptr;
+}
+
+JNIEXPORT jboolean JNICALL Java_org_opensearch_knn_jni_FaissService_isSearchTaskDone
+  (JNIEnv * env, jclass cls, jlong searchTaskPointerJ) {
+
+      try {
+          return knn_jni::faiss_wrapper::IsSearchTaskDone(searchTaskPointerJ);
+      } catch (...) {
+          jniUtil.CatchCppExceptionAndThrowJava(env);
+      }
+      return false;
+}
+
+JNIEXPORT jobjectArray JNICALL Java_org_opensearch_knn_jni_FaissService_getSearchTaskResults
+  (JNIEnv * env, jclass cls, jlong searchTaskPointerJ) {
+
+      try {
+          return knn_jni::faiss_wrapper::GetSearchTaskResults(&jniUtil, env, searchTaskPointerJ);
+      } catch (...) {
+          jniUtil.CatchCppExceptionAndThrowJava(env);
+      }
+      return nullptr;
+}
+
+JNIEXPORT void JNICALL Java_org_opensearch_knn_jni_FaissService_freeSearchTask
+  (JNIEnv * env, jclass cls, jlong searchTaskPointerJ) {
+
+      try {
+          knn_jni::faiss_wrapper::FreeSearchTask(searchTaskPointerJ);
+      } catch (...) {
+          jniUtil.CatchCppExceptionAndThrowJava(env);
+      }
+}
+
 JNIEXPORT void JNICALL Java_org_opensearch_knn_jni_FaissService_free(JNIEnv * env, jclass cls, jlong indexPointerJ, jboolean isBinaryIndexJ)
 {
     try {
@@ -402,10 +750,12 @@ JNIEXPORT void JNICALL Java_org_opensearch_knn_jni_FaissService_freeSharedIndexS
     }
 }
 
-JNIEXPORT void JNICALL Java_org_opensearch_knn_jni_FaissService_initLibrary(JNIEnv * env, jclass cls)
+JNIEXPORT void JNICALL Java_org_opensearch_knn_jni_FaissService_initLibrary(JNIEnv * env, jclass cls,
+                                                                             jint searchThreadPoolSizeJ,
+                                                                             jboolean pinSearchThreadsJ)
 {
     try {
-        knn_jni::faiss_wrapper::InitLibrary();
+        knn_jni::faiss_wrapper::InitLibrary(searchThreadPoolSizeJ, pinSearchThreadsJ);
     } catch (...) {
         jniUtil.CatchCppExceptionAndThrowJava(env);
     }
@@ -450,6 +800,127 @@ JNIEXPORT jbyteArray JNICALL Java_org_opensearch_knn_jni_FaissService_trainByteI
     return nullptr;
 }
 
+JNIEXPORT void JNICALL Java_org_opensearch_knn_jni_FaissService_trainIndexWithStream(JNIEnv * env, jclass cls,
+                                                                                     jobject parametersJ,
+                                                                                     jint dimensionJ,
+                                                                                     jlong trainVectorsPointerJ,
+                                                                                     jobject output)
+{
+    try {
+        knn_jni::faiss_wrapper::TrainIndexWithStream(&jniUtil, env, parametersJ, dimensionJ, trainVectorsPointerJ, output);
+    } catch (...) {
+        jniUtil.CatchCppExceptionAndThrowJava(env);
+    }
+}
+
+JNIEXPORT void JNICALL Java_org_opensearch_knn_jni_FaissService_trainBinaryIndexWithStream(JNIEnv * env, jclass cls,
+                                                                                           jobject parametersJ,
+                                                                                           jint dimensionJ,
+                                                                                           jlong trainVectorsPointerJ,
+                                                                                           jobject output)
+{
+    try {
+        knn_jni::faiss_wrapper::TrainBinaryIndexWithStream(&jniUtil, env, parametersJ, dimensionJ, trainVectorsPointerJ, output);
+    } catch (...) {
+        jniUtil.CatchCppExceptionAndThrowJava(env);
+    }
+}
+
+JNIEXPORT void JNICALL Java_org_opensearch_knn_jni_FaissService_trainByteIndexWithStream(JNIEnv * env, jclass cls,
+                                                                                         jobject parametersJ,
+                                                                                         jint dimensionJ,
+                                                                                         jlong trainVectorsPointerJ,
+                                                                                         jobject output)
+{
+    try {
+        knn_jni::faiss_wrapper::TrainByteIndexWithStream(&jniUtil, env, parametersJ, dimensionJ, trainVectorsPointerJ, output);
+    } catch (...) {
+        jniUtil.CatchCppExceptionAndThrowJava(env);
+    }
+}
+
+JNIEXPORT jlong JNICALL Java_org_opensearch_knn_jni_FaissService_initTrainingSession(JNIEnv * env, jclass cls,
+                                                                                     jobject parametersJ,
+                                                                                     jint dimensionJ)
+{
+    try {
+        return knn_jni::faiss_wrapper::InitTrainingSession(&jniUtil, env, parametersJ, dimensionJ,
+                                                           knn_jni::faiss_wrapper::TrainingVectorType::FLOAT);
+    } catch (...) {
+        jniUtil.CatchCppExceptionAndThrowJava(env);
+    }
+    return 0;
+}
+
+JNIEXPORT jlong JNICALL Java_org_opensearch_knn_jni_FaissService_initBinaryTrainingSession(JNIEnv * env, jclass cls,
+                                                                                           jobject parametersJ,
+                                                                                           jint dimensionJ)
+{
+    try {
+        return knn_jni::faiss_wrapper::InitTrainingSession(&jniUtil, env, parametersJ, dimensionJ,
+                                                           knn_jni::faiss_wrapper::TrainingVectorType::BINARY);
+    } catch (...) {
+        jniUtil.CatchCppExceptionAndThrowJava(env);
+    }
+    return 0;
+}
+
+JNIEXPORT jlong JNICALL Java_org_opensearch_knn_jni_FaissService_initByteTrainingSession(JNIEnv * env, jclass cls,
+                                                                                         jobject parametersJ,
+                                                                                         jint dimensionJ)
+{
+    try {
+        return knn_jni::faiss_wrapper::InitTrainingSession(&jniUtil, env, parametersJ, dimensionJ,
+                                                           knn_jni::faiss_wrapper::TrainingVectorType::BYTE);
+    } catch (...) {
+        jniUtil.CatchCppExceptionAndThrowJava(env);
+    }
+    return 0;
+}
+
+JNIEXPORT void JNICALL Java_org_opensearch_knn_jni_FaissService_addTrainingVectors(JNIEnv * env, jclass cls,
+                                                                                   jlong sessionPointerJ,
+                                                                                   jlong vectorsPointerJ)
+{
+    try {
+        knn_jni::faiss_wrapper::AddTrainingVectors(sessionPointerJ, vectorsPointerJ);
+    } catch (...) {
+        jniUtil.CatchCppExceptionAndThrowJava(env);
+    }
+}
+
+JNIEXPORT jbyteArray JNICALL Java_org_opensearch_knn_jni_FaissService_trainFromSession(JNIEnv * env, jclass cls,
+                                                                                       jlong sessionPointerJ)
+{
+    try {
+        return knn_jni::faiss_wrapper::TrainFromSession(&jniUtil, env, sessionPointerJ);
+    } catch (...) {
+        jniUtil.CatchCppExceptionAndThrowJava(env);
+    }
+    return nullptr;
+}
+
+JNIEXPORT void JNICALL Java_org_opensearch_knn_jni_FaissService_trainFromSessionWithStream(JNIEnv * env, jclass cls,
+                                                                                           jlong sessionPointerJ,
+                                                                                           jobject output)
+{
+    try {
+        knn_jni::faiss_wrapper::TrainFromSessionWithStream(&jniUtil, env, sessionPointerJ, output);
+    } catch (...) {
+        jniUtil.CatchCppExceptionAndThrowJava(env);
+    }
+}
+
+JNIEXPORT void JNICALL Java_org_opensearch_knn_jni_FaissService_freeTrainingSession(JNIEnv * env, jclass cls,
+                                                                                    jlong sessionPointerJ)
+{
+    try {
+        knn_jni::faiss_wrapper::FreeTrainingSession(sessionPointerJ);
+    } catch (...) {
+        jniUtil.CatchCppExceptionAndThrowJava(env);
+    }
+}
+
 JNIEXPORT jlong JNICALL Java_org_opensearch_knn_jni_FaissService_transferVectors(JNIEnv * env, jclass cls,
                                                                                  jlong vectorsPointerJ,
                                                                                  jobjectArray vectorsJ)
@@ -495,3 +966,85 @@ JNIEXPORT jobjectArray JNICALL Java_org_opensearch_knn_jni_FaissService_rangeSea
     }
     return nullptr;
 }
+
+JNIEXPORT jint JNICALL Java_org_opensearch_knn_jni_FaissService_rangeSearchIndexIntoArrays(JNIEnv * env, jclass cls,
+                                                                                           jlong indexPointerJ,
+                                                                                           jfloatArray queryVectorJ,
+                                                                                           jfloat radiusJ, jobject methodParamsJ, jint maxResultWindowJ,
+                                                                                           jlongArray filterIdsJ, jint filterIdsTypeJ, jintArray parentIdsJ,
+                                                                                           jintArray resultIdsJ, jfloatArray resultDistancesJ)
+{
+    try {
+        return knn_jni::faiss_wrapper::RangeSearchWithFilterIntoArrays(&jniUtil, env, indexPointerJ, queryVectorJ, radiusJ, methodParamsJ, maxResultWindowJ,
+                                                                       filterIdsJ, filterIdsTypeJ, parentIdsJ, resultIdsJ, resultDistancesJ);
+    } catch (...) {
+        jniUtil.CatchCppExceptionAndThrowJava(env);
+    }
+    return 0;
+}
+
+JNIEXPORT jint JNICALL Java_org_opensearch_knn_jni_FaissService_rangeSearchIndexCount(JNIEnv * env, jclass cls,
+                                                                                      jlong indexPointerJ,
+                                                                                      jfloatArray queryVectorJ,
+                                                                                      jfloat radiusJ, jobject methodParamsJ,
+                                                                                      jlongArray filterIdsJ, jint filterIdsTypeJ)
+{
+    try {
+        return knn_jni::faiss_wrapper::RangeSearchCount(&jniUtil, env, indexPointerJ, queryVectorJ, radiusJ, methodParamsJ,
+                                                        filterIdsJ, filterIdsTypeJ);
+    } catch (...) {
+        jniUtil.CatchCppExceptionAndThrowJava(env);
+    }
+    return 0;
+}
+
+JNIEXPORT jobjectArray JNICALL Java_org_opensearch_knn_jni_FaissService_rangeSearchBinaryIndexWithFilter(JNIEnv * env, jclass cls,
+                                                                                                         jlong indexPointerJ,
+                                                                                                         jbyteArray queryVectorJ,
+                                                                                                         jfloat radiusJ, jobject methodParamsJ,
+                                                                                                         jint maxResultWindowJ,
+                                                                                                         jlongArray filterIdsJ, jint filterIdsTypeJ,
+                                                                                                         jintArray parentIdsJ)
+{
+    try {
+        return knn_jni::faiss_wrapper::RangeSearchBinaryWithFilter(&jniUtil, env, indexPointerJ, queryVectorJ, radiusJ, methodParamsJ,
+                                                                   maxResultWindowJ, filterIdsJ, filterIdsTypeJ, parentIdsJ);
+    } catch (...) {
+        jniUtil.CatchCppExceptionAndThrowJava(env);
+    }
+    return nullptr;
+}
+
+JNIEXPORT jint JNICALL Java_org_opensearch_knn_jni_FaissService_rangeSearchBinaryIndexIntoArrays(JNIEnv * env, jclass cls,
+                                                                                                 jlong indexPointerJ,
+                                                                                                 jbyteArray queryVectorJ,
+                                                                                                 jfloat radiusJ, jobject methodParamsJ,
+                                                                                                 jint maxResultWindowJ,
+                                                                                                 jlongArray filterIdsJ, jint filterIdsTypeJ,
+                                                                                                 jintArray parentIdsJ, jintArray resultIdsJ,
+                                                                                                 jfloatArray resultDistancesJ)
+{
+    try {
+        return knn_jni::faiss_wrapper::RangeSearchBinaryWithFilterIntoArrays(&jniUtil, env, indexPointerJ, queryVectorJ, radiusJ,
+                                                                             methodParamsJ, maxResultWindowJ, filterIdsJ, filterIdsTypeJ,
+                                                                             parentIdsJ, resultIdsJ, resultDistancesJ);
+    } catch (...) {
+        jniUtil.CatchCppExceptionAndThrowJava(env);
+    }
+    return 0;
+}
+
+JNIEXPORT jobjectArray JNICALL Java_org_opensearch_knn_jni_FaissService_rangeSearchBinaryIndex(JNIEnv * env, jclass cls,
+                                                                                               jlong indexPointerJ,
+                                                                                               jbyteArray queryVectorJ,
+                                                                                               jfloat radiusJ, jobject methodParamsJ,
+                                                                                               jint maxResultWindowJ, jintArray parentIdsJ)
+{
+    try {
+        return knn_jni::faiss_wrapper::RangeSearchBinary(&jniUtil, env, indexPointerJ, queryVectorJ, radiusJ, methodParamsJ,
+                                                         maxResultWindowJ, parentIdsJ);
+    } catch (...) {
+        jniUtil.CatchCppExceptionAndThrowJava(env);
+    }
+    return nullptr;
+}
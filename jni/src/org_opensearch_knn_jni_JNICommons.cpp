@@ -103,3 +103,24 @@ JNIEXPORT void JNICALL Java_org_opensearch_knn_jni_JNICommons_freeByteVectorData
         jniUtil.CatchCppExceptionAndThrowJava(env);
     }
 }
+
+JNIEXPORT jlong JNICALL Java_org_opensearch_knn_jni_JNICommons_compileSearchParams(JNIEnv * env, jclass cls,
+                                                                                  jobject methodParamsJ)
+{
+    try {
+        return knn_jni::commons::compileSearchParams(&jniUtil, env, methodParamsJ);
+    } catch (...) {
+        jniUtil.CatchCppExceptionAndThrowJava(env);
+    }
+    return 0;
+}
+
+JNIEXPORT void JNICALL Java_org_opensearch_knn_jni_JNICommons_freeSearchParams(JNIEnv * env, jclass cls,
+                                                                              jlong searchParamsPointerJ)
+{
+    try {
+        return knn_jni::commons::freeSearchParams(searchParamsPointerJ);
+    } catch (...) {
+        jniUtil.CatchCppExceptionAndThrowJava(env);
+    }
+}
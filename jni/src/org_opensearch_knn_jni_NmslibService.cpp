@@ -86,6 +86,38 @@ JNIEXPORT jobjectArray JNICALL Java_org_opensearch_knn_jni_NmslibService_queryIn
   return nullptr;
 }
 
+JNIEXPORT jint JNICALL Java_org_opensearch_knn_jni_NmslibService_queryIndexIntoArrays(JNIEnv *env,
+                                                                                      jclass cls,
+                                                                                      jlong indexPointerJ,
+                                                                                      jfloatArray queryVectorJ,
+                                                                                      jint kJ,
+                                                                                      jobject methodParamsJ,
+                                                                                      jintArray resultIdsJ,
+                                                                                      jfloatArray resultDistancesJ) {
+  try {
+    return knn_jni::nmslib_wrapper::QueryIndexIntoArrays(&jniUtil, env, indexPointerJ, queryVectorJ, kJ, methodParamsJ,
+                                                         resultIdsJ, resultDistancesJ);
+  } catch (...) {
+    jniUtil.CatchCppExceptionAndThrowJava(env);
+  }
+  return 0;
+}
+
+JNIEXPORT jobjectArray JNICALL Java_org_opensearch_knn_jni_NmslibService_queryIndexWithSearchParams(JNIEnv *env,
+                                                                                                    jclass cls,
+                                                                                                    jlong indexPointerJ,
+                                                                                                    jfloatArray queryVectorJ,
+                                                                                                    jint kJ,
+                                                                                                    jlong searchParamsPointerJ) {
+  try {
+    return knn_jni::nmslib_wrapper::QueryIndexWithSearchParams(&jniUtil, env, indexPointerJ, queryVectorJ, kJ,
+                                                               searchParamsPointerJ);
+  } catch (...) {
+    jniUtil.CatchCppExceptionAndThrowJava(env);
+  }
+  return nullptr;
+}
+
 JNIEXPORT void JNICALL Java_org_opensearch_knn_jni_NmslibService_free(JNIEnv *env, jclass cls, jlong indexPointerJ) {
   try {
     return knn_jni::nmslib_wrapper::Free(indexPointerJ);
@@ -200,3 +200,35 @@ TEST(CommonTests, GetIntegerMethodParam) {
     int actualValue3 = knn_jni::commons::getIntegerMethodParameter(jniEnv, &mockJNIUtil, methodParams2, knn_jni::EF_SEARCH, 1);
     EXPECT_EQ(1, actualValue3);
 }
+
+TEST(CommonTests, CompileSearchParams) {
+    JNIEnv *jniEnv = nullptr;
+    testing::NiceMock<test_util::MockJNIUtil> mockJNIUtil;
+
+    std::unordered_map<std::string, jobject> methodParams;
+    int efSearch = 10;
+    int nprobes = 3;
+    int parallelism = 4;
+    methodParams[knn_jni::EF_SEARCH] = reinterpret_cast<jobject>(&efSearch);
+    methodParams[knn_jni::NPROBES] = reinterpret_cast<jobject>(&nprobes);
+    methodParams[knn_jni::PARALLELISM] = reinterpret_cast<jobject>(&parallelism);
+
+    jlong searchParamsPointer = knn_jni::commons::compileSearchParams(&mockJNIUtil, jniEnv,
+                                                                      reinterpret_cast<jobject>(&methodParams));
+    const knn_jni::commons::SearchParams &searchParams = knn_jni::commons::getSearchParams(searchParamsPointer);
+    EXPECT_EQ(efSearch, searchParams.getEfSearch(1));
+    EXPECT_EQ(nprobes, searchParams.getNprobes(1));
+    EXPECT_EQ(parallelism, searchParams.getParallelism(1));
+    knn_jni::commons::freeSearchParams(searchParamsPointer);
+
+    // Missing parameters and a null handle fall back to the defaults
+    std::unordered_map<std::string, jobject> emptyParams;
+    knn_jni::commons::SearchParams parsed = knn_jni::commons::parseSearchParams(&mockJNIUtil, jniEnv,
+                                                                                reinterpret_cast<jobject>(&emptyParams));
+    EXPECT_FALSE(parsed.hasEfSearch);
+    EXPECT_EQ(1, parsed.getEfSearch(1));
+    EXPECT_EQ(1, parsed.getNprobes(1));
+    EXPECT_EQ(1, parsed.getParallelism(1));
+    EXPECT_FALSE(knn_jni::commons::parseSearchParams(&mockJNIUtil, jniEnv, nullptr).hasNprobes);
+    EXPECT_EQ(1, knn_jni::commons::getSearchParams(0).getEfSearch(1));
+}
@@ -0,0 +1,76 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * The OpenSearch Contributors require contributions made to
+ * this file be licensed under the Apache-2.0 license or a
+ * compatible open source license.
+ *
+ * Modifications Copyright OpenSearch Contributors. See
+ * GitHub history for details.
+ */
+
+#include "crc32_util.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "test_util.h"
+
+namespace {
+    // One bit at a time, the definition of CRC32
+    uint32_t ReferenceCrc32(const uint8_t *bytes, size_t length) {
+        uint32_t crc = 0xFFFFFFFF;
+        for (size_t i = 0; i < length; i++) {
+            crc ^= bytes[i];
+            for (int bit = 0; bit < 8; bit++) {
+                crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+            }
+        }
+        return ~crc;
+    }
+}
+
+TEST(Crc32UtilTest, MatchesJavaCrc32) {
+    // java.util.zip.CRC32 of "123456789"
+    const std::string check = "123456789";
+    ASSERT_EQ(0xCBF43926, knn_jni::util::crc32(0, (const uint8_t *) check.data(), check.size()));
+    ASSERT_EQ(0, knn_jni::util::crc32(0, nullptr, 0));
+
+    std::vector<uint8_t> bytes(3000);
+    for (auto &byte : bytes) {
+        byte = test_util::RandomInt(0, 255);
+    }
+    // Lengths around the 16 and 64 bytes blocks, at unaligned offsets
+    for (size_t length = 0; length < 300; length++) {
+        for (size_t offset = 0; offset < 4; offset++) {
+            ASSERT_EQ(ReferenceCrc32(bytes.data() + offset, length),
+                      knn_jni::util::crc32(0, bytes.data() + offset, length));
+        }
+    }
+    ASSERT_EQ(ReferenceCrc32(bytes.data(), bytes.size()), knn_jni::util::crc32(0, bytes.data(), bytes.size()));
+}
+
+TEST(Crc32UtilTest, UpdatesIncrementally) {
+    std::vector<uint8_t> bytes(100000);
+    for (auto &byte : bytes) {
+        byte = test_util::RandomInt(0, 255);
+    }
+
+    knn_jni::util::Crc32 crc;
+    size_t middle = 0;
+    for (size_t offset = 0, size = 1; offset < bytes.size(); offset += size, size = size * 7 % 3001 + 1) {
+        size = std::min(size, bytes.size() - offset);
+        crc.update(bytes.data() + offset, size);
+        if (offset < bytes.size() / 2) {
+            middle = offset + size;
+        }
+    }
+    ASSERT_EQ(ReferenceCrc32(bytes.data(), bytes.size()), crc.getValue());
+
+    // Resumed from the checksum of the first bytes
+    knn_jni::util::Crc32 resumed(knn_jni::util::crc32(0, bytes.data(), middle));
+    resumed.update(bytes.data() + middle, bytes.size() - middle);
+    ASSERT_EQ(crc.getValue(), resumed.getValue());
+}
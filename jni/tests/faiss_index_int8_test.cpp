@@ -0,0 +1,248 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * The OpenSearch Contributors require contributions made to
+ * this file be licensed under the Apache-2.0 license or a
+ * compatible open source license.
+ *
+ * Modifications Copyright OpenSearch Contributors. See
+ * GitHub history for details.
+ */
+
+#include "faiss_index_int8.h"
+#include "faiss_index_service.h"
+#include "faiss_methods.h"
+#include "faiss_wrapper.h"
+#include "jni_util.h"
+
+#include <algorithm>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "test_util.h"
+#include "faiss/IndexHNSW.h"
+#include "faiss/IndexIDMap.h"
+#include "faiss/IndexScalarQuantizer.h"
+#include "faiss/index_factory.h"
+
+using ::testing::NiceMock;
+
+namespace {
+    int32_t ReferenceL2Sqr(const int8_t *x, const int8_t *y, size_t d) {
+        int32_t sum = 0;
+        for (size_t i = 0; i < d; i++) {
+            sum += (x[i] - y[i]) * (x[i] - y[i]);
+        }
+        return sum;
+    }
+
+    int32_t ReferenceInnerProduct(const int8_t *x, const int8_t *y, size_t d) {
+        int32_t sum = 0;
+        for (size_t i = 0; i < d; i++) {
+            sum += x[i] * y[i];
+        }
+        return sum;
+    }
+}
+
+TEST(FaissIndexInt8Test, KernelsMatchReference) {
+    for (size_t dim : {1, 15, 16, 17, 33, 64, 100, 130, 768}) {
+        std::vector<int8_t> x = test_util::RandomByteVectors(dim, 1, -128, 127);
+        std::vector<int8_t> y = test_util::RandomByteVectors(dim, 1, -128, 127);
+        std::vector<uint8_t> code(dim);
+        knn_jni::faiss_wrapper::encodeInt8Vectors(y.data(), 1, dim, code.data());
+
+        ASSERT_EQ(ReferenceL2Sqr(x.data(), y.data(), dim), knn_jni::faiss_wrapper::int8L2Sqr(x.data(), code.data(), dim));
+        ASSERT_EQ(ReferenceInnerProduct(x.data(), y.data(), dim),
+                  knn_jni::faiss_wrapper::int8InnerProduct(x.data(), code.data(), dim));
+
+        // The extremes do not overflow the intermediate sums
+        std::vector<int8_t> low(dim, -128);
+        std::vector<int8_t> high(dim, 127);
+        knn_jni::faiss_wrapper::encodeInt8Vectors(high.data(), 1, dim, code.data());
+        ASSERT_EQ(ReferenceL2Sqr(low.data(), high.data(), dim),
+                  knn_jni::faiss_wrapper::int8L2Sqr(low.data(), code.data(), dim));
+        ASSERT_EQ(ReferenceInnerProduct(low.data(), high.data(), dim),
+                  knn_jni::faiss_wrapper::int8InnerProduct(low.data(), code.data(), dim));
+    }
+}
+
+TEST(FaissIndexInt8Test, EncodesLikeScalarQuantizer) {
+    const int dim = 37;
+    const int numVectors = 20;
+    std::vector<int8_t> vectors = test_util::RandomByteVectors(dim, numVectors, -128, 127);
+    std::vector<float> floatVectors(vectors.begin(), vectors.end());
+
+    faiss::IndexScalarQuantizer index(dim, faiss::ScalarQuantizer::QT_8bit_direct_signed);
+    ASSERT_TRUE(knn_jni::faiss_wrapper::isInt8DirectStorage(&index));
+    std::vector<uint8_t> expected(index.code_size * numVectors);
+    index.sa_encode(numVectors, floatVectors.data(), expected.data());
+
+    std::vector<uint8_t> codes(index.code_size * numVectors);
+    knn_jni::faiss_wrapper::encodeInt8Vectors(vectors.data(), numVectors, dim, codes.data());
+    ASSERT_EQ(expected, codes);
+
+    faiss::IndexScalarQuantizer uniform(dim, faiss::ScalarQuantizer::QT_8bit_uniform);
+    ASSERT_FALSE(knn_jni::faiss_wrapper::isInt8DirectStorage(&uniform));
+    ASSERT_FALSE(knn_jni::faiss_wrapper::supportsInt8Add(&uniform));
+}
+
+TEST(FaissIndexInt8Test, DistanceComputerMatchesFaiss) {
+    const int dim = 50;
+    const int numVectors = 30;
+    std::vector<int8_t> vectors = test_util::RandomByteVectors(dim, numVectors, -128, 127);
+    std::vector<float> query(dim);
+    for (int i = 0; i < dim; i++) {
+        query[i] = static_cast<float>(test_util::RandomInt(-128, 127));
+    }
+
+    for (auto metric : {faiss::METRIC_L2, faiss::METRIC_INNER_PRODUCT}) {
+        faiss::IndexScalarQuantizer index(dim, faiss::ScalarQuantizer::QT_8bit_direct_signed, metric);
+        knn_jni::faiss_wrapper::addInt8Vectors(&index, numVectors, vectors.data());
+        ASSERT_EQ(numVectors, index.ntotal);
+
+        std::unique_ptr<faiss::DistanceComputer> expected(index.get_distance_computer());
+        expected->set_query(query.data());
+        knn_jni::faiss_wrapper::Int8DirectDistanceComputer actual(index);
+        actual.set_query(query.data());
+        for (int i = 0; i < numVectors; i++) {
+            ASSERT_FLOAT_EQ((*expected)(i), actual(i));
+            ASSERT_FLOAT_EQ(expected->symmetric_dis(i, 0), actual.symmetric_dis(i, 0));
+        }
+
+        knn_jni::faiss_wrapper::Int8DirectDistanceComputer negated(index, true);
+        negated.set_query(query.data());
+        ASSERT_FLOAT_EQ(metric == faiss::METRIC_INNER_PRODUCT ? -actual(3) : actual(3), negated(3));
+    }
+}
+
+TEST(FaissIndexInt8Test, HNSWBuiltFromInt8FindsNeighbors) {
+    const int dim = 24;
+    const int numVectors = 500;
+    const int k = 10;
+    std::vector<int8_t> vectors = test_util::RandomByteVectors(dim, numVectors, -128, 127);
+
+    for (auto metric : {faiss::METRIC_L2, faiss::METRIC_INNER_PRODUCT}) {
+        std::unique_ptr<faiss::Index> index(faiss::index_factory(dim, "HNSW16,SQ8_direct_signed", metric));
+        ASSERT_TRUE(knn_jni::faiss_wrapper::supportsInt8Add(index.get()));
+        // Added in two calls, so the second one links into an existing graph
+        knn_jni::faiss_wrapper::addInt8Vectors(index.get(), numVectors / 2, vectors.data());
+        knn_jni::faiss_wrapper::addInt8Vectors(index.get(), numVectors - numVectors / 2,
+                                               vectors.data() + (numVectors / 2) * dim);
+        ASSERT_EQ(numVectors, index->ntotal);
+
+        auto *hnswIndex = dynamic_cast<faiss::IndexHNSW *>(index.get());
+        hnswIndex->hnsw.efSearch = 100;
+        auto *storage = dynamic_cast<faiss::IndexScalarQuantizer *>(hnswIndex->storage);
+        knn_jni::faiss_wrapper::Int8DirectDistanceComputer distanceComputer(*storage, true);
+
+        int found = 0;
+        for (int q = 0; q < 10; q++) {
+            std::vector<float> query(vectors.begin() + q * dim, vectors.begin() + (q + 1) * dim);
+            std::vector<float> dis(k);
+            std::vector<faiss::idx_t> ids(k);
+            index->search(1, query.data(), k, dis.data(), ids.data());
+
+            // Brute force with the same integer distances, smaller first
+            distanceComputer.set_query(query.data());
+            std::vector<std::pair<float, faiss::idx_t>> exact;
+            for (int i = 0; i < numVectors; i++) {
+                exact.emplace_back(distanceComputer(i), i);
+            }
+            std::sort(exact.begin(), exact.end());
+            for (int i = 0; i < k; i++) {
+                found += std::count(ids.begin(), ids.end(), exact[i].second);
+            }
+        }
+        ASSERT_GE(found, 90);
+    }
+}
+
+TEST(FaissIndexInt8Test, QueryWithKLargerThanEfSearchReturnsK) {
+    const int dim = 24;
+    const int numVectors = 500;
+    const int k = 50;
+    std::vector<int8_t> vectors = test_util::RandomByteVectors(dim, numVectors, -128, 127);
+    int efSearch = 5;
+    std::unordered_map<std::string, jobject> methodParams;
+    methodParams[knn_jni::EF_SEARCH] = reinterpret_cast<jobject>(&efSearch);
+
+    NiceMock<JNIEnv> jniEnv;
+    NiceMock<test_util::MockJNIUtil> mockJNIUtil;
+    for (auto metric : {faiss::METRIC_L2, faiss::METRIC_INNER_PRODUCT}) {
+        std::unique_ptr<faiss::Index> index(faiss::index_factory(dim, "HNSW16,SQ8_direct_signed", metric));
+        knn_jni::faiss_wrapper::addInt8Vectors(index.get(), numVectors, vectors.data());
+        faiss::IndexIDMap idMap(index.get());
+        for (faiss::idx_t i = 0; i < numVectors; i++) {
+            idMap.id_map.push_back(i);
+        }
+        idMap.ntotal = numVectors;
+
+        auto *storage = dynamic_cast<faiss::IndexScalarQuantizer *>(dynamic_cast<faiss::IndexHNSW *>(index.get())->storage);
+        knn_jni::faiss_wrapper::Int8DirectDistanceComputer distanceComputer(*storage, true);
+
+        int found = 0;
+        for (int q = 0; q < 10; q++) {
+            std::vector<float> query(vectors.begin() + q * dim, vectors.begin() + (q + 1) * dim);
+            std::unique_ptr<std::vector<std::pair<int, float> *>> results(
+                    reinterpret_cast<std::vector<std::pair<int, float> *> *>(
+                            knn_jni::faiss_wrapper::QueryIndex(
+                                    &mockJNIUtil, &jniEnv, reinterpret_cast<jlong>(&idMap),
+                                    reinterpret_cast<jfloatArray>(&query), k,
+                                    reinterpret_cast<jobject>(&methodParams), nullptr)));
+
+            // The graph is searched with max(ef_search, k) candidates, like IndexHNSW::search does
+            ASSERT_EQ(k, results->size());
+            distanceComputer.set_query(query.data());
+            std::vector<std::pair<float, faiss::idx_t>> exact;
+            for (int i = 0; i < numVectors; i++) {
+                exact.emplace_back(distanceComputer(i), i);
+            }
+            std::sort(exact.begin(), exact.end());
+            for (int i = 0; i < k; i++) {
+                for (auto *result : *results) {
+                    found += result->first == exact[i].second;
+                }
+            }
+
+            for (auto *result : *results) {
+                delete result;
+            }
+        }
+        ASSERT_GE(found, 10 * k * 0.9);
+    }
+}
+
+TEST(FaissIndexInt8Test, ByteIndexServiceAddsWithoutFloatConversion) {
+    const int dim = 16;
+    const int numIds = 300;
+    std::vector<int8_t> vectors = test_util::RandomByteVectors(dim, numIds, -128, 127);
+    std::vector<int64_t> ids;
+    for (int i = 0; i < numIds; i++) {
+        ids.push_back(i * 3);
+    }
+
+    JNIEnv *jniEnv = nullptr;
+    NiceMock<test_util::MockJNIUtil> mockJNIUtil;
+    std::unique_ptr<knn_jni::faiss_wrapper::FaissMethods> faissMethods(new knn_jni::faiss_wrapper::FaissMethods());
+    knn_jni::faiss_wrapper::ByteIndexService indexService(std::move(faissMethods));
+    std::unordered_map<std::string, jobject> parametersMap;
+    jlong indexAddress = indexService.initIndex(&mockJNIUtil, jniEnv, faiss::METRIC_L2, "HNSW16,SQ8_direct_signed",
+                                                dim, numIds, 1, parametersMap);
+    std::unique_ptr<faiss::IndexIDMap> idMap(reinterpret_cast<faiss::IndexIDMap *>(indexAddress));
+    indexService.insertToIndex(dim, numIds, 1, reinterpret_cast<int64_t>(&vectors), ids, indexAddress);
+
+    ASSERT_EQ(numIds, idMap->ntotal);
+    ASSERT_EQ(ids, idMap->id_map);
+
+    // A stored vector is its own nearest neighbor, reported with its label
+    std::vector<float> query(vectors.begin() + 7 * dim, vectors.begin() + 8 * dim);
+    float distance;
+    faiss::idx_t label;
+    idMap->search(1, query.data(), 1, &distance, &label);
+    ASSERT_EQ(21, label);
+    ASSERT_FLOAT_EQ(0, distance);
+}
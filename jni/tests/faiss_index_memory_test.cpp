@@ -0,0 +1,136 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * The OpenSearch Contributors require contributions made to
+ * this file be licensed under the Apache-2.0 license or a
+ * compatible open source license.
+ *
+ * Modifications Copyright OpenSearch Contributors. See
+ * GitHub history for details.
+ */
+
+#include "faiss_index_memory.h"
+#include "faiss_index_service.h"
+#include "faiss_methods.h"
+
+#include <memory>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "test_util.h"
+#include "faiss/IndexBinaryFlat.h"
+#include "faiss/IndexBinaryHNSW.h"
+#include "faiss/IndexFlat.h"
+#include "faiss/IndexHNSW.h"
+#include "faiss/IndexIDMap.h"
+#include "faiss/IndexIVFFlat.h"
+#include "faiss/index_factory.h"
+
+TEST(FaissIndexMemoryTest, HNSWReservationHoldsAllVectors) {
+    const int dim = 16;
+    const int numVectors = 2000;
+    std::vector<float> vectors = test_util::RandomVectors(dim, numVectors, -10, 10);
+    std::vector<faiss::idx_t> ids = test_util::Range(numVectors);
+
+    for (const char *description : {"HNSW16,Flat", "HNSW32,SQ8_direct_signed"}) {
+        std::unique_ptr<faiss::Index> index(faiss::index_factory(dim, description, faiss::METRIC_L2));
+        faiss::IndexIDMap idMap(index.get());
+        const size_t estimate = knn_jni::faiss_wrapper::estimateIndexMemory(&idMap, numVectors);
+        knn_jni::faiss_wrapper::reserveIndexMemory(&idMap, numVectors);
+
+        auto *hnswIndex = dynamic_cast<faiss::IndexHNSW *>(index.get());
+        auto *storage = dynamic_cast<faiss::IndexFlatCodes *>(hnswIndex->storage);
+        const void *labels = idMap.id_map.data();
+        const void *codes = storage->codes.data();
+        const void *levels = hnswIndex->hnsw.levels.data();
+        const void *offsets = hnswIndex->hnsw.offsets.data();
+        const void *neighbors = hnswIndex->hnsw.neighbors.data();
+
+        // Added in batches like the index build does
+        for (int i = 0; i < numVectors; i += 500) {
+            idMap.add_with_ids(500, vectors.data() + i * dim, ids.data() + i);
+        }
+
+        // Nothing was moved while the vectors were added
+        ASSERT_EQ(labels, idMap.id_map.data());
+        ASSERT_EQ(codes, storage->codes.data());
+        ASSERT_EQ(levels, hnswIndex->hnsw.levels.data());
+        ASSERT_EQ(offsets, hnswIndex->hnsw.offsets.data());
+        ASSERT_EQ(neighbors, hnswIndex->hnsw.neighbors.data());
+
+        const size_t actual = idMap.id_map.size() * sizeof(faiss::idx_t)
+                              + storage->codes.size()
+                              + hnswIndex->hnsw.levels.size() * sizeof(int)
+                              + hnswIndex->hnsw.offsets.size() * sizeof(size_t)
+                              + hnswIndex->hnsw.neighbors.size() * sizeof(faiss::HNSW::storage_idx_t);
+        ASSERT_GE(estimate * 1.05, actual);
+        ASSERT_LE(estimate, actual * 1.05);
+    }
+}
+
+TEST(FaissIndexMemoryTest, IVFEstimateCountsListsAndCentroids) {
+    const int dim = 8;
+    const int nlist = 4;
+    const int numVectors = 1000;
+    std::vector<float> vectors = test_util::RandomVectors(dim, numVectors, -10, 10);
+    std::vector<faiss::idx_t> ids = test_util::Range(numVectors);
+
+    faiss::IndexFlatL2 quantizer(dim);
+    faiss::IndexIVFFlat index(&quantizer, dim, nlist);
+    faiss::IndexIDMap idMap(&index);
+
+    // The labels, and the lists with room for uneven ones to double
+    const size_t lists = numVectors * sizeof(faiss::idx_t)
+                         + 2 * numVectors * (sizeof(faiss::idx_t) + dim * sizeof(float));
+
+    // The centroids only exist once the index is trained
+    const size_t untrained = knn_jni::faiss_wrapper::estimateIndexMemory(&idMap, numVectors);
+    ASSERT_EQ(lists + nlist * dim * sizeof(float), untrained);
+
+    // The centroids are reserved along with the rest, so training does not move them
+    knn_jni::faiss_wrapper::reserveIndexMemory(&idMap, numVectors);
+    ASSERT_EQ(nlist * dim * sizeof(float), quantizer.codes.owned_data.capacity());
+    const void *centroids = quantizer.codes.data();
+    index.train(numVectors, vectors.data());
+    ASSERT_EQ(centroids, quantizer.codes.data());
+
+    const size_t trained = knn_jni::faiss_wrapper::estimateIndexMemory(&idMap, numVectors);
+    ASSERT_EQ(lists, trained);
+
+    idMap.add_with_ids(numVectors, vectors.data(), ids.data());
+    ASSERT_EQ(numVectors, idMap.ntotal);
+}
+
+TEST(FaissIndexMemoryTest, BinaryHNSWReservationHoldsAllVectors) {
+    const int dim = 64;
+    const int numVectors = 1000;
+    std::vector<uint8_t> vectors(numVectors * dim / 8);
+    for (auto &vector : vectors) {
+        vector = test_util::RandomInt(0, 255);
+    }
+    std::vector<faiss::idx_t> ids = test_util::Range(numVectors);
+
+    faiss::IndexBinaryHNSW index(dim, 16);
+    faiss::IndexBinaryIDMap idMap(&index);
+    const size_t estimate = knn_jni::faiss_wrapper::estimateIndexMemory(&idMap, numVectors);
+    ASSERT_GE(estimate, numVectors * (dim / 8 + sizeof(faiss::idx_t)));
+
+    knn_jni::faiss_wrapper::reserveIndexMemory(&idMap, numVectors);
+    auto *storage = dynamic_cast<faiss::IndexBinaryFlat *>(index.storage);
+    const void *labels = idMap.id_map.data();
+    const void *codes = storage->xb.data();
+    idMap.add_with_ids(numVectors, vectors.data(), ids.data());
+    ASSERT_EQ(labels, idMap.id_map.data());
+    ASSERT_EQ(codes, storage->xb.data());
+}
+
+TEST(FaissIndexMemoryTest, EstimateCoversMoreVectorsThanAnInt) {
+    const int dim = 8;
+    const size_t numVectors = 3000000000UL;
+    std::unique_ptr<knn_jni::faiss_wrapper::FaissMethods> faissMethods(new knn_jni::faiss_wrapper::FaissMethods());
+    knn_jni::faiss_wrapper::IndexService indexService(std::move(faissMethods));
+
+    // The labels and the flat codes of every vector
+    ASSERT_EQ(numVectors * (sizeof(faiss::idx_t) + dim * sizeof(float)),
+              indexService.estimateIndexMemory(faiss::METRIC_L2, "Flat", dim, numVectors));
+}
@@ -0,0 +1,182 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * The OpenSearch Contributors require contributions made to
+ * this file be licensed under the Apache-2.0 license or a
+ * compatible open source license.
+ *
+ * Modifications Copyright OpenSearch Contributors. See
+ * GitHub history for details.
+ */
+
+#include "faiss_index_merge.h"
+
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "test_util.h"
+#include "faiss/IndexBinaryFlat.h"
+#include "faiss/IndexBinaryHNSW.h"
+#include "faiss/IndexFlat.h"
+#include "faiss/IndexHNSW.h"
+#include "faiss/IndexIDMap.h"
+#include "faiss/IndexIVFFlat.h"
+#include "faiss/index_factory.h"
+
+namespace {
+    // Every third doc is deleted, the others move to twice their doc id
+    std::vector<int32_t> DocMapWithDeletes(int32_t numDocs) {
+        std::vector<int32_t> docMap(numDocs);
+        for (int32_t i = 0; i < numDocs; i++) {
+            docMap[i] = i % 3 == 0 ? -1 : i * 2;
+        }
+        return docMap;
+    }
+
+    std::vector<faiss::HNSW::storage_idx_t> Neighbors(const faiss::HNSW &hnsw) {
+        return {hnsw.neighbors.data(), hnsw.neighbors.data() + hnsw.neighbors.size()};
+    }
+}
+
+TEST(FaissIndexMergeTest, RemapDropsDeletedVectorsAndKeepsGraph) {
+    const int dim = 16;
+    const int numVectors = 1000;
+    const int numAdded = 200;
+    std::vector<float> vectors = test_util::RandomVectors(dim, numVectors + numAdded, -10, 10);
+    std::vector<faiss::idx_t> ids = test_util::Range(numVectors);
+
+    for (auto metric : {faiss::METRIC_L2, faiss::METRIC_INNER_PRODUCT}) {
+        std::unique_ptr<faiss::Index> index(faiss::index_factory(dim, "HNSW16,Flat", metric));
+        faiss::IndexIDMap idMap(index.get());
+        idMap.add_with_ids(numVectors, vectors.data(), ids.data());
+        ASSERT_TRUE(knn_jni::faiss_wrapper::supportsGraphReuse(idMap.index));
+
+        std::vector<int32_t> docMap = DocMapWithDeletes(numVectors);
+        knn_jni::faiss_wrapper::remapGraphIndex(&idMap, docMap.data(), docMap.size());
+
+        auto *hnswIndex = dynamic_cast<faiss::IndexHNSW *>(index.get());
+        const int numKept = numVectors - (numVectors + 2) / 3;
+        ASSERT_EQ(numKept, idMap.ntotal);
+        ASSERT_EQ(numKept, hnswIndex->ntotal);
+        ASSERT_EQ(numKept, hnswIndex->storage->ntotal);
+        ASSERT_EQ(numKept, hnswIndex->hnsw.levels.size());
+        ASSERT_EQ(numKept + 1, hnswIndex->hnsw.offsets.size());
+        ASSERT_EQ(hnswIndex->hnsw.offsets.back(), hnswIndex->hnsw.neighbors.size());
+
+        // Kept vectors are in their old order, labelled with their new doc id, and every one is still found
+        hnswIndex->hnsw.efSearch = 100;
+        int position = 0;
+        int found = 0;
+        for (int doc = 0; doc < numVectors; doc++) {
+            if (docMap[doc] < 0) {
+                continue;
+            }
+            ASSERT_EQ(docMap[doc], idMap.id_map[position++]);
+
+            // The inner product of a vector with itself is not always the largest, so it is looked up among a few
+            float distances[5];
+            faiss::idx_t labels[5];
+            idMap.search(1, vectors.data() + doc * dim, 5, distances, labels);
+            for (faiss::idx_t label : labels) {
+                found += label == docMap[doc];
+            }
+        }
+        ASSERT_GE(found, numKept * 0.95);
+
+        // The merged segment goes on adding its other vectors to the graph
+        std::vector<faiss::idx_t> newIds(numAdded);
+        for (int i = 0; i < numAdded; i++) {
+            newIds[i] = numVectors * 2 + i;
+        }
+        idMap.add_with_ids(numAdded, vectors.data() + numVectors * dim, newIds.data());
+        ASSERT_EQ(numKept + numAdded, idMap.ntotal);
+
+        float distance;
+        faiss::idx_t label;
+        idMap.search(1, vectors.data() + (numVectors + 7) * dim, 1, &distance, &label);
+        if (metric == faiss::METRIC_L2) {
+            ASSERT_EQ(numVectors * 2 + 7, label);
+        }
+    }
+}
+
+TEST(FaissIndexMergeTest, RemapWithoutDeletesOnlyRelabels) {
+    const int dim = 8;
+    const int numVectors = 300;
+    std::vector<float> vectors = test_util::RandomVectors(dim, numVectors, -10, 10);
+    std::vector<faiss::idx_t> ids = test_util::Range(numVectors);
+
+    std::unique_ptr<faiss::Index> index(faiss::index_factory(dim, "HNSW8,Flat", faiss::METRIC_L2));
+    faiss::IndexIDMap idMap(index.get());
+    idMap.add_with_ids(numVectors, vectors.data(), ids.data());
+    auto *hnswIndex = dynamic_cast<faiss::IndexHNSW *>(index.get());
+    const std::vector<faiss::HNSW::storage_idx_t> neighbors = Neighbors(hnswIndex->hnsw);
+
+    std::vector<int32_t> docMap(numVectors);
+    for (int i = 0; i < numVectors; i++) {
+        docMap[i] = numVectors - 1 - i;
+    }
+    knn_jni::faiss_wrapper::remapGraphIndex(&idMap, docMap.data(), docMap.size());
+
+    ASSERT_EQ(numVectors, idMap.ntotal);
+    for (int i = 0; i < numVectors; i++) {
+        ASSERT_EQ(numVectors - 1 - i, idMap.id_map[i]);
+    }
+    ASSERT_EQ(neighbors, Neighbors(hnswIndex->hnsw));
+
+    // A label the doc map does not cover is refused
+    std::vector<int32_t> shortDocMap(numVectors - 1, 0);
+    ASSERT_THROW(knn_jni::faiss_wrapper::remapGraphIndex(&idMap, shortDocMap.data(), shortDocMap.size()),
+                 std::runtime_error);
+}
+
+TEST(FaissIndexMergeTest, BinaryRemapDropsDeletedVectors) {
+    const int dim = 64;
+    const int numVectors = 600;
+    std::vector<uint8_t> vectors(numVectors * dim / 8);
+    for (auto &vector : vectors) {
+        vector = test_util::RandomInt(0, 255);
+    }
+    std::vector<faiss::idx_t> ids = test_util::Range(numVectors);
+
+    faiss::IndexBinaryHNSW index(dim, 16);
+    faiss::IndexBinaryIDMap idMap(&index);
+    idMap.add_with_ids(numVectors, vectors.data(), ids.data());
+    ASSERT_TRUE(knn_jni::faiss_wrapper::supportsGraphReuse(idMap.index));
+
+    std::vector<int32_t> docMap = DocMapWithDeletes(numVectors);
+    knn_jni::faiss_wrapper::remapGraphIndex(&idMap, docMap.data(), docMap.size());
+
+    const int numKept = numVectors - numVectors / 3;
+    ASSERT_EQ(numKept, idMap.ntotal);
+    ASSERT_EQ(numKept, index.storage->ntotal);
+
+    index.hnsw.efSearch = 100;
+    int found = 0;
+    for (int doc = 1; doc < numVectors; doc += 3) {
+        int32_t distance;
+        faiss::idx_t label;
+        idMap.search(1, vectors.data() + doc * dim / 8, 1, &distance, &label);
+        found += label == docMap[doc];
+    }
+    ASSERT_GE(found, numVectors / 3 * 0.95);
+}
+
+TEST(FaissIndexMergeTest, OnlyGraphsOverFlatCodesAreReused) {
+    const int dim = 8;
+    faiss::IndexFlatL2 quantizer(dim);
+    faiss::IndexIVFFlat ivfIndex(&quantizer, dim, 4);
+    ASSERT_FALSE(knn_jni::faiss_wrapper::supportsGraphReuse(&ivfIndex));
+
+    std::unique_ptr<faiss::Index> flatIndex(faiss::index_factory(dim, "Flat", faiss::METRIC_L2));
+    ASSERT_FALSE(knn_jni::faiss_wrapper::supportsGraphReuse(flatIndex.get()));
+
+    std::unique_ptr<faiss::Index> hnswIndex(faiss::index_factory(dim, "HNSW8,SQ8", faiss::METRIC_L2));
+    ASSERT_TRUE(knn_jni::faiss_wrapper::supportsGraphReuse(hnswIndex.get()));
+
+    faiss::IndexIDMap idMap(&ivfIndex);
+    std::vector<int32_t> docMap(1, 0);
+    ASSERT_THROW(knn_jni::faiss_wrapper::remapGraphIndex(&idMap, docMap.data(), docMap.size()), std::runtime_error);
+}
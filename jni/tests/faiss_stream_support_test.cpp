@@ -102,3 +102,122 @@ TEST(FaissStreamSupportTest, FaissOpenSearchIOReaderCopy) {
     ASSERT_EQ(javaIndexInputMock.readTargetBytes, readBuffer);
   }  // End for
 }
+
+TEST(FaissStreamSupportTest, NativeEngineIndexOutputMediatorCoalescesWrites) {
+  // Set up mockings
+  NiceMock<MockJNIUtil> mockJni;
+  std::vector<char> javaBuffer(1024);
+  std::string written;
+  uint32_t checksum = 0;
+  int criticalSections = 0;
+  EXPECT_CALL(mockJni, GetJavaBytesArrayLength(_, _))
+      .WillRepeatedly(Return(javaBuffer.size()));
+  EXPECT_CALL(mockJni, GetPrimitiveArrayCritical(_, _, _))
+      .WillRepeatedly([&javaBuffer, &criticalSections](JNIEnv *env, jarray array, jboolean *isCopy) {
+        criticalSections++;
+        return (jbyte *) javaBuffer.data();
+      });
+  EXPECT_CALL(mockJni, CallNonvirtualVoidMethodA(_, _, _, _, _))
+      .WillRepeatedly([&javaBuffer, &written, &checksum](JNIEnv *env,
+                                                         jobject obj,
+                                                         jclass clazz,
+                                                         jmethodID methodID,
+                                                         jvalue *args) {
+        written.append(javaBuffer.data(), args[0].i);
+        checksum = (uint32_t) args[1].j;
+      });
+
+  NiceMock<JNIEnv> jniEnv;
+  // It's a dummy value, which will not be used. If we pass a null, then NPE will be raised.
+  jobject jobjectDummy = reinterpret_cast<jobject>(1);
+  knn_jni::stream::NativeEngineIndexOutputMediator mediator{&mockJni, &jniEnv, jobjectDummy};
+
+  // Small writes like the headers of faiss, then a large payload, then a trailer
+  std::string expected;
+  for (int32_t i = 0; i < 1000; i++) {
+    mediator.writeBytes((const uint8_t *) &i, sizeof(i));
+    expected.append((const char *) &i, sizeof(i));
+  }
+  const std::string payload = JavaIndexInputMock::makeRandomBytes(5000);
+  mediator.writeBytes((const uint8_t *) payload.data(), payload.size());
+  expected += payload;
+  mediator.writeBytes((const uint8_t *) "end", 3);
+  expected += "end";
+  mediator.flush();
+
+  // The Java buffer is only touched once per block it holds
+  ASSERT_EQ(expected, written);
+  ASSERT_EQ((expected.size() + javaBuffer.size() - 1) / javaBuffer.size(), criticalSections);
+
+  // Java is given the checksum of every byte written
+  ASSERT_EQ(knn_jni::util::crc32(0, (const uint8_t *) expected.data(), expected.size()), checksum);
+}
+
+TEST(FaissStreamSupportTest, NativeEngineIndexOutputMediatorResumesChecksum) {
+  NiceMock<MockJNIUtil> mockJni;
+  std::vector<char> javaBuffer(64);
+  uint32_t checksum = 0;
+  EXPECT_CALL(mockJni, GetJavaBytesArrayLength(_, _))
+      .WillRepeatedly(Return(javaBuffer.size()));
+  EXPECT_CALL(mockJni, GetPrimitiveArrayCritical(_, _, _))
+      .WillRepeatedly(Return((jbyte *) javaBuffer.data()));
+  // The checksum kept in IndexOutputWithBuffer
+  EXPECT_CALL(mockJni, CallNonvirtualLongMethodA(_, _, _, _, _))
+      .WillRepeatedly([&checksum](JNIEnv *env, jobject obj, jclass clazz, jmethodID methodID, jvalue *args) {
+        return (jlong) checksum;
+      });
+  EXPECT_CALL(mockJni, CallNonvirtualVoidMethodA(_, _, _, _, _))
+      .WillRepeatedly([&checksum](JNIEnv *env, jobject obj, jclass clazz, jmethodID methodID, jvalue *args) {
+        checksum = (uint32_t) args[1].j;
+      });
+
+  NiceMock<JNIEnv> jniEnv;
+  jobject jobjectDummy = reinterpret_cast<jobject>(1);
+  const std::string content = JavaIndexInputMock::makeRandomBytes(1000);
+  // Two writers one after the other, as when an index is written in several native calls
+  for (size_t offset : {0, 300}) {
+    knn_jni::stream::NativeEngineIndexOutputMediator mediator{&mockJni, &jniEnv, jobjectDummy};
+    const size_t size = offset == 0 ? 300 : content.size() - 300;
+    mediator.writeBytes((const uint8_t *) content.data() + offset, size);
+    mediator.flush();
+  }
+
+  ASSERT_EQ(knn_jni::util::crc32(0, (const uint8_t *) content.data(), content.size()), checksum);
+}
+
+TEST(FaissStreamSupportTest, WriteInBackgroundKeepsTheOrderOfWrites) {
+  const std::string content = JavaIndexInputMock::makeRandomBytes(100000);
+  for (auto numBlocks : std::vector<size_t>{1, 3}) {
+    faiss::VectorIOWriter output;
+    knn_jni::stream::writeInBackground(&output, [&content](faiss::IOWriter *writer) {
+      // Uneven writes, some of them spanning several blocks
+      for (size_t offset = 0, size = 1; offset < content.size(); offset += size, size = size * 7 % 3001 + 1) {
+        size = std::min(size, content.size() - offset);
+        (*writer)(content.data() + offset, 1, size);
+      }
+    }, 1000, numBlocks);
+
+    ASSERT_EQ(content, std::string(output.data.begin(), output.data.end()));
+  }
+}
+
+TEST(FaissStreamSupportTest, WriteInBackgroundStopsOnError) {
+  const std::string content = JavaIndexInputMock::makeRandomBytes(100000);
+
+  // Faiss failing in the middle of the index
+  faiss::VectorIOWriter output;
+  ASSERT_THROW(knn_jni::stream::writeInBackground(&output, [&content](faiss::IOWriter *writer) {
+    (*writer)(content.data(), 1, 5000);
+    throw std::runtime_error("Faiss failed");
+  }, 1000, 2), std::runtime_error);
+
+  // The output failing while Faiss waits for a free block
+  struct FailingIOWriter : faiss::IOWriter {
+    size_t operator()(const void *ptr, size_t size, size_t nitems) override {
+      throw test_util::StreamIOError();
+    }
+  } failingOutput;
+  ASSERT_THROW(knn_jni::stream::writeInBackground(&failingOutput, [&content](faiss::IOWriter *writer) {
+    (*writer)(content.data(), 1, content.size());
+  }, 1000, 2), test_util::StreamIOError);
+}
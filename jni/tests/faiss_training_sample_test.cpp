@@ -0,0 +1,107 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * The OpenSearch Contributors require contributions made to
+ * this file be licensed under the Apache-2.0 license or a
+ * compatible open source license.
+ *
+ * Modifications Copyright OpenSearch Contributors. See
+ * GitHub history for details.
+ */
+
+#include "faiss_training_sample.h"
+
+#include <cstring>
+#include <memory>
+#include <set>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "test_util.h"
+#include "faiss/IndexBinaryIVF.h"
+#include "faiss/index_factory.h"
+
+namespace {
+    // Feeds the positions 0 to n - 1 of a stream to the reservoir, in batches of random sizes
+    void AddPositions(knn_jni::faiss_wrapper::VectorReservoir &reservoir, uint64_t n) {
+        uint64_t position = 0;
+        while (position < n) {
+            const uint64_t batchSize = std::min<uint64_t>(n - position, test_util::RandomInt(1, 300));
+            std::vector<uint64_t> batch(batchSize);
+            for (uint64_t i = 0; i < batchSize; i++) {
+                batch[i] = position + i;
+            }
+            reservoir.add(reinterpret_cast<const uint8_t *>(batch.data()), batchSize);
+            position += batchSize;
+        }
+    }
+
+    std::vector<uint64_t> Sample(const knn_jni::faiss_wrapper::VectorReservoir &reservoir) {
+        std::vector<uint64_t> sample(reservoir.size());
+        std::memcpy(sample.data(), reservoir.data(), sample.size() * sizeof(uint64_t));
+        return sample;
+    }
+}
+
+TEST(FaissTrainingSampleTest, KeepsEverythingBelowCapacity) {
+    knn_jni::faiss_wrapper::VectorReservoir reservoir(sizeof(uint64_t), 1000, 1234);
+    AddPositions(reservoir, 700);
+
+    ASSERT_EQ(700, reservoir.size());
+    ASSERT_EQ(700, reservoir.seen());
+    std::vector<uint64_t> sample = Sample(reservoir);
+    for (uint64_t i = 0; i < sample.size(); i++) {
+        ASSERT_EQ(i, sample[i]);
+    }
+}
+
+TEST(FaissTrainingSampleTest, SamplesUniformlyOverTheStream) {
+    const uint64_t capacity = 2000;
+    const uint64_t numVectors = 200000;
+    knn_jni::faiss_wrapper::VectorReservoir reservoir(sizeof(uint64_t), capacity, 1234);
+    AddPositions(reservoir, numVectors);
+
+    ASSERT_EQ(capacity, reservoir.size());
+    ASSERT_EQ(numVectors, reservoir.seen());
+
+    // Every vector is sampled at most once, and each tenth of the stream gets about a tenth of the sample
+    std::vector<uint64_t> sample = Sample(reservoir);
+    ASSERT_EQ(capacity, std::set<uint64_t>(sample.begin(), sample.end()).size());
+    std::vector<int> perTenth(10);
+    for (uint64_t position : sample) {
+        ASSERT_LT(position, numVectors);
+        perTenth[position * 10 / numVectors]++;
+    }
+    for (int count : perTenth) {
+        ASSERT_GT(count, 140);
+        ASSERT_LT(count, 260);
+    }
+}
+
+TEST(FaissTrainingSampleTest, SameSeedGivesSameSample) {
+    knn_jni::faiss_wrapper::VectorReservoir first(sizeof(uint64_t), 100, 42);
+    knn_jni::faiss_wrapper::VectorReservoir second(sizeof(uint64_t), 100, 42);
+    AddPositions(first, 10000);
+    AddPositions(second, 10000);
+    ASSERT_EQ(Sample(first), Sample(second));
+}
+
+TEST(FaissTrainingSampleTest, SampleSizeFollowsTheIndex) {
+    const int dim = 16;
+    std::unique_ptr<faiss::Index> ivfFlat(faiss::index_factory(dim, "IVF64,Flat"));
+    ASSERT_EQ(64 * 256, knn_jni::faiss_wrapper::trainingSampleSize(ivfFlat.get()));
+
+    // The product quantizer needs more vectors than the coarse quantizer here
+    std::unique_ptr<faiss::Index> ivfPq(faiss::index_factory(dim, "IVF16,PQ4x8"));
+    ASSERT_EQ(256 * 256, knn_jni::faiss_wrapper::trainingSampleSize(ivfPq.get()));
+
+    std::unique_ptr<faiss::Index> hnswPq(faiss::index_factory(dim, "HNSW16,PQ4x4"));
+    ASSERT_EQ(16 * 256, knn_jni::faiss_wrapper::trainingSampleSize(hnswPq.get()));
+
+    // Nothing to train
+    std::unique_ptr<faiss::Index> hnswFlat(faiss::index_factory(dim, "HNSW16,Flat"));
+    ASSERT_EQ(0, knn_jni::faiss_wrapper::trainingSampleSize(hnswFlat.get()));
+
+    std::unique_ptr<faiss::IndexBinary> binaryIvf(faiss::index_binary_factory(dim, "BIVF8"));
+    ASSERT_EQ(8 * 256, knn_jni::faiss_wrapper::trainingSampleSize(binaryIvf.get()));
+}
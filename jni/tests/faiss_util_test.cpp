@@ -9,6 +9,7 @@
 
 #include "faiss_util.h"
 
+#include <set>
 #include <vector>
 
 #include "gtest/gtest.h"
@@ -26,3 +27,193 @@ TEST(IDGrouperBitMapTest, BasicAssertions) {
         ASSERT_EQ(ids[groupIndex], idGrouperBitmap->get_group(i));
     }
 }
+
+TEST(IDGrouperBitMapTest, ReusedBitmap) {
+    std::vector<uint64_t> bitmap;
+    int firstIds[] = {5, 70, 200};
+    faiss_util::buildIDGrouperBitmap(firstIds, 3, &bitmap);
+
+    // Groups of the previous build must not leak into a grouper built over the same buffer
+    int ids[] = {10, 300};
+    std::unique_ptr<faiss::IDGrouperBitmap> idGrouperBitmap = faiss_util::buildIDGrouperBitmap(ids, 2, &bitmap);
+    ASSERT_EQ(10, idGrouperBitmap->get_group(0));
+    ASSERT_EQ(300, idGrouperBitmap->get_group(11));
+    ASSERT_EQ(300, idGrouperBitmap->get_group(70));
+    ASSERT_EQ(300, idGrouperBitmap->get_group(200));
+}
+
+TEST(IDSelectorSortedArrayTest, BasicAssertions) {
+    // Uneven gaps so the interpolated guess misses and the lookup has to gallop both ways
+    std::vector<int64_t> ids = {3, 4, 5, 90, 91, 1000, 1001, 5000, 70000};
+    std::set<int64_t> idSet(ids.begin(), ids.end());
+    faiss_util::IDSelectorSortedArray selector(ids.size(), ids.data());
+    for (int64_t id = -1; id <= 70001; id++) {
+        ASSERT_EQ(idSet.count(id) == 1, selector.is_member(id));
+    }
+
+    faiss_util::IDSelectorSortedArray emptySelector(0, nullptr);
+    ASSERT_FALSE(emptySelector.is_member(0));
+}
+
+TEST(IDSelectorRangesTest, BasicAssertions) {
+    std::vector<int64_t> ranges = {0, 10, 20, 21, 100, 200};
+    faiss_util::IDSelectorRanges selector(ranges.size() / 2, ranges.data());
+    for (int64_t id = -1; id <= 201; id++) {
+        bool expected = (id >= 0 && id < 10) || id == 20 || (id >= 100 && id < 200);
+        ASSERT_EQ(expected, selector.is_member(id));
+    }
+}
+
+TEST(IDSelectorRoaringTest, BasicAssertions) {
+    std::vector<int64_t> ids;
+    // Sparse chunk, kept as an array
+    for (int64_t id = 0; id < 65536; id += 97) {
+        ids.push_back(id);
+    }
+    // Dense chunk, kept as a bitmap
+    for (int64_t id = 65536; id < 2 * 65536; id += 3) {
+        ids.push_back(id);
+    }
+    // Chunk after an empty one, made of runs
+    for (int64_t id = 3 * 65536; id < 3 * 65536 + 20000; id++) {
+        if (id % 5000 < 4000) {
+            ids.push_back(id);
+        }
+    }
+    // Duplicates are ignored
+    ids.push_back(ids.back());
+    std::set<int64_t> idSet(ids.begin(), ids.end());
+
+    faiss_util::IDSelectorRoaring selector(ids.size(), ids.data());
+    for (int64_t id = -1; id <= 4 * 65536; id++) {
+        ASSERT_EQ(idSet.count(id) == 1, selector.is_member(id));
+    }
+}
+
+TEST(ChooseIdsSelectorTest, BasicAssertions) {
+    std::vector<int64_t> ids;
+    for (size_t i = 0; i < faiss_util::SORTED_ARRAY_SELECTOR_MAX_IDS; i++) {
+        ids.push_back(2 * i);
+    }
+    ASSERT_EQ(faiss_util::IdsSelectorKind::SORTED_ARRAY, faiss_util::chooseIdsSelector(ids.data(), ids.size()));
+
+    ids.push_back(ids.back() + 1);
+    ASSERT_EQ(faiss_util::IdsSelectorKind::ROARING, faiss_util::chooseIdsSelector(ids.data(), ids.size()));
+
+    std::swap(ids[0], ids[1]);
+    ASSERT_EQ(faiss_util::IdsSelectorKind::UNSORTED, faiss_util::chooseIdsSelector(ids.data(), ids.size()));
+}
+
+TEST(IsExactSearchPreferredTest, BasicAssertions) {
+    // Filters no larger than k are always brute forced
+    ASSERT_TRUE(faiss_util::isExactSearchPreferred(10, 1000000, 10, 100));
+    // 10000^2 <= 100 * 1000000
+    ASSERT_TRUE(faiss_util::isExactSearchPreferred(10000, 1000000, 10, 100));
+    ASSERT_FALSE(faiss_util::isExactSearchPreferred(10001, 1000000, 10, 100));
+    // A k larger than ef_search widens the HNSW search as well
+    ASSERT_TRUE(faiss_util::isExactSearchPreferred(20000, 1000000, 400, 100));
+}
+
+TEST(ChooseQueryParallelismTest, BoundsByWork) {
+    // Not asked for, or nothing to split
+    ASSERT_EQ(1, faiss_util::chooseQueryParallelism(0, 1000000, 1));
+    ASSERT_EQ(1, faiss_util::chooseQueryParallelism(1, 1000000, 1));
+    ASSERT_EQ(1, faiss_util::chooseQueryParallelism(8, 0, 1));
+    // One part per probed list at most
+    ASSERT_EQ(8, faiss_util::chooseQueryParallelism(8, 64, 1));
+    ASSERT_EQ(3, faiss_util::chooseQueryParallelism(8, 3, 1));
+    // Small scans stay on the calling thread
+    ASSERT_EQ(1, faiss_util::chooseQueryParallelism(8, 20000, faiss_util::MIN_VECTORS_PER_SCAN_TASK));
+    ASSERT_EQ(4, faiss_util::chooseQueryParallelism(4, 5000000, faiss_util::MIN_VECTORS_PER_SCAN_TASK));
+}
+
+TEST(BoundedRangeResultHandlerTest, KeepsClosestHits) {
+    faiss_util::BoundedRangeResultHandler handler(50.0f, 3, faiss_util::RangeResultMode::BEST);
+    for (int64_t id = 0; id < 100; id++) {
+        handler.add_result(static_cast<float>((id * 37) % 100), id);
+    }
+    // Once full the threshold is the worst kept hit
+    ASSERT_FLOAT_EQ(2.0f, handler.threshold);
+
+    std::vector<float> distances;
+    std::vector<int64_t> ids;
+    ASSERT_EQ(3, handler.finish(&distances, &ids));
+    for (int i = 0; i < 3; i++) {
+        ASSERT_FLOAT_EQ(static_cast<float>(i), distances[i]);
+        ASSERT_EQ(i, (ids[i] * 37) % 100);
+    }
+}
+
+TEST(BoundedRangeResultHandlerTest, RejectsHitsOutsideRadius) {
+    faiss_util::BoundedRangeResultHandler handler(5.0f, 10, faiss_util::RangeResultMode::BEST);
+    for (int64_t id = 0; id < 100; id++) {
+        handler.add_result(static_cast<float>(id), id);
+    }
+    ASSERT_EQ(5, handler.count());
+
+    std::vector<float> distances;
+    std::vector<int64_t> ids;
+    ASSERT_EQ(5, handler.finish(&distances, &ids));
+    ASSERT_EQ(4, ids.back());
+}
+
+TEST(BoundedRangeResultHandlerTest, CountsHits) {
+    faiss_util::BoundedRangeResultHandler handler(50.0f, 0, faiss_util::RangeResultMode::COUNT);
+    for (int64_t id = 0; id < 100; id++) {
+        ASSERT_FALSE(handler.add_result(static_cast<float>(id), id));
+    }
+    ASSERT_EQ(50, handler.count());
+
+    std::vector<float> distances;
+    std::vector<int64_t> ids;
+    ASSERT_EQ(0, handler.finish(&distances, &ids));
+}
+
+namespace {
+    // Groups ids by tens
+    struct TensGrouper : faiss::IDGrouper {
+        faiss::idx_t get_group(faiss::idx_t id) const override {
+            return id / 10;
+        }
+    };
+}
+
+TEST(BoundedRangeResultHandlerTest, KeepsClosestHitOfEveryGroup) {
+    TensGrouper grouper;
+    faiss_util::BoundedRangeResultHandler handler(1000.0f, 3, faiss_util::RangeResultMode::BEST, &grouper);
+    // Every group gets its closest hit last, after enough other groups to prune the kept ones
+    for (int64_t id = 0; id < 100; id++) {
+        handler.add_result(static_cast<float>(100 - id % 10 * 10 + id / 10), id);
+    }
+
+    std::vector<float> distances;
+    std::vector<int64_t> ids;
+    ASSERT_EQ(3, handler.finish(&distances, &ids));
+    std::vector<int64_t> expectedIds = {9, 19, 29};
+    ASSERT_EQ(expectedIds, ids);
+}
+
+TEST(BoundedRangeResultHandlerTest, CountsGroups) {
+    TensGrouper grouper;
+    faiss_util::BoundedRangeResultHandler handler(50.0f, 0, faiss_util::RangeResultMode::COUNT, &grouper);
+    for (int64_t id = 0; id < 100; id++) {
+        handler.add_result(static_cast<float>(id), id);
+    }
+    ASSERT_EQ(5, handler.count());
+}
+
+TEST(FingerprintTest, ChunkedMatchesWholeBuffer) {
+    std::vector<uint8_t> bytes(1000);
+    for (size_t i = 0; i < bytes.size(); i++) {
+        bytes[i] = static_cast<uint8_t>(i * 31 + 7);
+    }
+
+    faiss_util::Fingerprinter fingerprinter(bytes.size());
+    fingerprinter.update(bytes.data(), 256);
+    fingerprinter.update(bytes.data() + 256, 512);
+    fingerprinter.update(bytes.data() + 768, bytes.size() - 768);
+    ASSERT_EQ(faiss_util::fingerprint(bytes.data(), bytes.size()), fingerprinter.finish());
+
+    bytes[500]++;
+    ASSERT_NE(faiss_util::fingerprint(bytes.data(), bytes.size()), fingerprinter.finish());
+}
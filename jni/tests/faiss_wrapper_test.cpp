@@ -10,7 +10,9 @@
  */
 
 #include "faiss_wrapper.h"
+#include "commons.h"
 
+#include <algorithm>
 #include <vector>
 
 #include "gmock/gmock.h"
@@ -18,8 +20,11 @@
 #include "jni_util.h"
 #include "test_util.h"
 #include "faiss/IndexHNSW.h"
+#include "faiss/IndexBinaryFlat.h"
 #include "faiss/IndexBinaryHNSW.h"
+#include "faiss/IndexFlatCodes.h"
 #include "faiss/IndexIVFPQ.h"
+#include "faiss/utils/distances.h"
 #include "mocks/faiss_index_service_mock.h"
 #include "native_stream_support_util.h"
 
@@ -161,6 +166,76 @@ TEST(FaissCreateIndexTest, BasicAssertions) {
                            insertions);
 }
 
+TEST(FaissSubmitInsertToIndexTest, AddsBatchesFromAlternatingBuffers) {
+    faiss::idx_t numIds = 200;
+    int dim = 8;
+    int insertions = 10;
+    std::vector<float> vectors = test_util::RandomVectors(dim, numIds, randomDataMin, randomDataMax);
+
+    std::string spaceType = knn_jni::L2;
+    std::string indexDescription = "HNSW32,Flat";
+    std::unordered_map<std::string, jobject> parametersMap;
+    parametersMap[knn_jni::SPACE_TYPE] = (jobject)&spaceType;
+    parametersMap[knn_jni::INDEX_DESCRIPTION] = (jobject)&indexDescription;
+    std::unordered_map<std::string, jobject> subParametersMap;
+    parametersMap[knn_jni::PARAMETERS] = (jobject)&subParametersMap;
+
+    NiceMock<JNIEnv> jniEnv;
+    NiceMock<test_util::MockJNIUtil> mockJNIUtil;
+    IndexService indexService(std::unique_ptr<FaissMethods>(new FaissMethods()));
+    jlong indexPointer = knn_jni::faiss_wrapper::InitIndex(&mockJNIUtil, &jniEnv, numIds, dim, (jobject)&parametersMap,
+                                                           &indexService);
+    std::unique_ptr<faiss::IndexIDMap> index(reinterpret_cast<faiss::IndexIDMap *>(indexPointer));
+
+    // One worker serves every batch. Each batch is filled into the buffer the batch before the last one used, once
+    // that batch has been added
+    jlong insertWorker = knn_jni::faiss_wrapper::StartInsertWorker(
+            indexPointer, dim, 0, std::unique_ptr<IndexService>(new IndexService(std::unique_ptr<FaissMethods>(new FaissMethods()))));
+    std::vector<faiss::idx_t> batchIds[2];
+    std::vector<float> batchVectors[2];
+    jlong pendingInsert = 0;
+    int docsPerInsertion = numIds / insertions;
+    for (int i = 0; i < insertions; i++) {
+        std::vector<faiss::idx_t> &insertIds = batchIds[i % 2];
+        std::vector<float> &insertVecs = batchVectors[i % 2];
+        if (pendingInsert != 0) {
+            knn_jni::faiss_wrapper::WaitForInsertToIndex(insertWorker, pendingInsert - 1);
+        }
+        insertIds.clear();
+        insertVecs.clear();
+        for (int j = i * docsPerInsertion; j < (i + 1) * docsPerInsertion; j++) {
+            insertIds.push_back(j);
+            insertVecs.insert(insertVecs.end(), vectors.begin() + j * dim, vectors.begin() + (j + 1) * dim);
+        }
+        jlong submitted = knn_jni::faiss_wrapper::SubmitInsertToIndex(
+                &mockJNIUtil, &jniEnv, insertWorker, reinterpret_cast<jintArray>(&insertIds), (jlong)&insertVecs);
+        // Batches are numbered in the order they are submitted
+        ASSERT_EQ(i + 1, submitted);
+        pendingInsert = submitted;
+    }
+    knn_jni::faiss_wrapper::WaitForInsertToIndex(insertWorker, pendingInsert);
+
+    ASSERT_EQ(numIds, index->ntotal);
+    for (faiss::idx_t i = 0; i < numIds; i++) {
+        ASSERT_EQ(i, index->id_map[i]);
+    }
+
+    // A failed insert is rethrown when it is waited for, and the batches after it are skipped
+    std::vector<faiss::idx_t> mismatchedIds = {0, 1, 2};
+    std::vector<float> mismatchedVectors(dim, 0);
+    jlong failedInsert = knn_jni::faiss_wrapper::SubmitInsertToIndex(
+            &mockJNIUtil, &jniEnv, insertWorker, reinterpret_cast<jintArray>(&mismatchedIds), (jlong)&mismatchedVectors);
+    std::vector<faiss::idx_t> skippedIds = {numIds};
+    std::vector<float> skippedVectors(dim, 0);
+    jlong skippedInsert = knn_jni::faiss_wrapper::SubmitInsertToIndex(
+            &mockJNIUtil, &jniEnv, insertWorker, reinterpret_cast<jintArray>(&skippedIds), (jlong)&skippedVectors);
+    ASSERT_THROW(knn_jni::faiss_wrapper::WaitForInsertToIndex(insertWorker, failedInsert), std::runtime_error);
+    ASSERT_THROW(knn_jni::faiss_wrapper::WaitForInsertToIndex(insertWorker, skippedInsert), std::runtime_error);
+    ASSERT_EQ(numIds, index->ntotal);
+
+    knn_jni::faiss_wrapper::StopInsertWorker(insertWorker);
+}
+
 TEST(FaissCreateBinaryIndexTest, BasicAssertions) {
     // Define the data
     faiss::idx_t numIds = 200;
@@ -269,6 +344,82 @@ TEST(FaissCreateIndexFromTemplateTest, BasicAssertions) {
     }  // End for
 }
 
+TEST(FaissCreateIndexFromTemplateTest, CachesTemplateByModelId) {
+    int dim = 8;
+    faiss::idx_t numIds = 200;
+    std::vector<float> trainingVectors = test_util::RandomVectors(dim, numIds, -500.0, 500.0);
+
+    auto serializeTemplate = [&](int nlist) {
+        std::unique_ptr<faiss::Index> templateIndex(
+            test_util::FaissCreateIndex(dim, "IVF" + std::to_string(nlist) + ",Flat", faiss::METRIC_L2));
+        templateIndex->train(numIds, trainingVectors.data());
+        return test_util::FaissGetSerializedIndex(templateIndex.get());
+    };
+    auto templateV1 = serializeTemplate(4);
+    auto templateV2 = serializeTemplate(8);
+
+    NiceMock<JNIEnv> jniEnv;
+    NiceMock<test_util::MockJNIUtil> mockJNIUtil;
+    std::string spaceType = knn_jni::L2;
+    std::string modelId = test_util::RandomString(10, "model-", "");
+    std::unordered_map<std::string, jobject> parametersMap;
+    parametersMap[knn_jni::SPACE_TYPE] = (jobject) &spaceType;
+    parametersMap[knn_jni::MODEL_ID] = (jobject) &modelId;
+
+    // Builds a segment from the template and returns how many times the template bytes were read
+    int templateReads = 0;
+    ON_CALL(mockJNIUtil, GetByteArrayRegion)
+        .WillByDefault([&](JNIEnv *env, jbyteArray array, jsize start, jsize len, jbyte *buf) {
+            templateReads++;
+            auto byteBuffer = reinterpret_cast<std::vector<uint8_t> *>(array);
+            std::copy(byteBuffer->begin() + start, byteBuffer->begin() + start + len, buf);
+        });
+    auto buildSegment = [&](std::vector<uint8_t> &templateBytes, int expectedNlist) {
+        std::vector<faiss::idx_t> ids;
+        auto *vectors = new std::vector<float>(test_util::RandomVectors(dim, numIds, -500.0, 500.0));
+        for (int64_t i = 0; i < numIds; ++i) {
+            ids.push_back(i);
+        }
+        std::string indexPath = test_util::RandomString(10, "tmp/", ".faiss");
+        JavaFileIndexOutputMock javaFileIndexOutputMock {indexPath};
+        setUpJavaFileOutputMocking(javaFileIndexOutputMock, mockJNIUtil, false);
+        // The output mocking answers for every array, the template array is answered on its own
+        auto templateArray = reinterpret_cast<jbyteArray>(&templateBytes);
+        EXPECT_CALL(mockJNIUtil, GetJavaBytesArrayLength(::testing::_, templateArray))
+            .WillRepeatedly(::testing::Return(templateBytes.size()));
+        // The template is never pinned, it is fingerprinted in chunks
+        EXPECT_CALL(mockJNIUtil, GetPrimitiveArrayCritical(::testing::_, templateArray, ::testing::_)).Times(0);
+
+        templateReads = 0;
+        knn_jni::faiss_wrapper::CreateIndexFromTemplate(
+            &mockJNIUtil, &jniEnv, reinterpret_cast<jintArray>(&ids),
+            (jlong) vectors, dim, (jobject) (&javaFileIndexOutputMock),
+            reinterpret_cast<jbyteArray>(&templateBytes), (jobject) &parametersMap);
+        javaFileIndexOutputMock.file_writer.close();
+
+        std::unique_ptr<faiss::Index> index(test_util::FaissLoadIndex(indexPath));
+        auto *idMap = dynamic_cast<faiss::IndexIDMap *>(index.get());
+        EXPECT_EQ(numIds, idMap->ntotal);
+        EXPECT_EQ(expectedNlist, dynamic_cast<faiss::IndexIVF *>(idMap->index)->nlist);
+        std::remove(indexPath.c_str());
+        return templateReads;
+    };
+
+    // The first build parses the template, later ones clone the cached one and only read the template once, in a
+    // single chunk, to fingerprint it
+    ASSERT_GT(buildSegment(templateV1.data, 4), 1);
+    ASSERT_EQ(1, buildSegment(templateV1.data, 4));
+    ASSERT_EQ(1, buildSegment(templateV1.data, 4));
+
+    // A different template under the same model id replaces the cached one
+    ASSERT_GT(buildSegment(templateV2.data, 8), 1);
+    ASSERT_EQ(1, buildSegment(templateV2.data, 8));
+
+    knn_jni::faiss_wrapper::EvictTemplateIndex(modelId);
+    ASSERT_GT(buildSegment(templateV2.data, 8), 1);
+    knn_jni::faiss_wrapper::EvictTemplateIndex(modelId);
+}
+
 TEST(FaissCreateByteIndexFromTemplateTest, BasicAssertions) {
     for (auto throwIOException : std::array<bool, 2> {false, true}) {
         // Define the data
@@ -424,6 +575,97 @@ TEST(FaissLoadBinaryIndexTest, BasicAssertions) {
     std::remove(indexPath.c_str());
 }
 
+TEST(FaissLoadIndexTest, MmapReadsCodesAndGraphFromFile) {
+    faiss::idx_t numIds = 300;
+    int dim = 16;
+    std::vector<faiss::idx_t> ids = test_util::Range(numIds);
+    std::vector<float> vectors = test_util::RandomVectors(dim, numIds, randomDataMin, randomDataMax);
+
+    // Setup jni
+    NiceMock<JNIEnv> jniEnv;
+    NiceMock<test_util::MockJNIUtil> mockJNIUtil;
+
+    for (std::string method : {"HNSW32,Flat", "HNSW32,SQfp16"}) {
+        std::string indexPath = test_util::RandomString(10, "tmp/", ".faiss");
+        std::unique_ptr<faiss::Index> createdIndex(test_util::FaissCreateIndex(dim, method, faiss::METRIC_L2));
+        test_util::FaissTrainIndex(createdIndex.get(), numIds, vectors.data());
+        auto createdIndexWithData = test_util::FaissAddData(createdIndex.get(), ids, vectors);
+        test_util::FaissWriteIndex(&createdIndexWithData, indexPath);
+
+        std::unique_ptr<faiss::Index> loadedIndexPointer(
+                reinterpret_cast<faiss::Index *>(knn_jni::faiss_wrapper::LoadIndexWithMmap(
+                        &mockJNIUtil, &jniEnv, (jstring)&indexPath)));
+
+        // The codes and the neighbors point into the mapped file instead of being copied
+        auto idMapIndex = dynamic_cast<faiss::IndexIDMap *>(loadedIndexPointer.get());
+        ASSERT_NE(idMapIndex, nullptr);
+        auto hnswIndex = dynamic_cast<faiss::IndexHNSW *>(idMapIndex->index);
+        ASSERT_NE(hnswIndex, nullptr);
+        auto storage = dynamic_cast<faiss::IndexFlatCodes *>(hnswIndex->storage);
+        ASSERT_NE(storage, nullptr);
+        ASSERT_FALSE(storage->codes.is_owned);
+        ASSERT_FALSE(hnswIndex->hnsw.neighbors.is_owned);
+
+        // The mapped index is the same as the one written
+        auto createIndexSerialization = test_util::FaissGetSerializedIndex(&createdIndexWithData);
+        auto loadedIndexSerialization = test_util::FaissGetSerializedIndex(loadedIndexPointer.get());
+        ASSERT_EQ(createIndexSerialization.data, loadedIndexSerialization.data);
+
+        float distance;
+        faiss::idx_t label;
+        loadedIndexPointer->search(1, vectors.data() + 42 * dim, 1, &distance, &label);
+        ASSERT_EQ(42, label);
+
+        // Clean up
+        loadedIndexPointer.reset();
+        std::remove(indexPath.c_str());
+    }
+
+    // A missing file is reported as an error
+    std::string missingPath = test_util::RandomString(10, "tmp/", ".faiss");
+    ASSERT_ANY_THROW(knn_jni::faiss_wrapper::LoadIndexWithMmap(&mockJNIUtil, &jniEnv, (jstring)&missingPath));
+}
+
+TEST(FaissLoadBinaryIndexTest, MmapReadsCodesAndGraphFromFile) {
+    faiss::idx_t numIds = 200;
+    int dim = 128;
+    std::vector<faiss::idx_t> ids = test_util::Range(numIds);
+    std::vector<uint8_t> vectors(numIds * dim / 8);
+    for (auto &vector : vectors) {
+        vector = test_util::RandomInt(0, 255);
+    }
+
+    std::string indexPath = test_util::RandomString(10, "tmp/", ".faiss");
+    std::unique_ptr<faiss::IndexBinary> createdIndex(test_util::FaissCreateBinaryIndex(dim, "BHNSW32"));
+    auto createdIndexWithData = test_util::FaissAddBinaryData(createdIndex.get(), ids, vectors);
+    test_util::FaissWriteBinaryIndex(&createdIndexWithData, indexPath);
+
+    // Setup jni
+    NiceMock<JNIEnv> jniEnv;
+    NiceMock<test_util::MockJNIUtil> mockJNIUtil;
+
+    std::unique_ptr<faiss::IndexBinary> loadedIndexPointer(
+            reinterpret_cast<faiss::IndexBinary *>(knn_jni::faiss_wrapper::LoadBinaryIndexWithMmap(
+                    &mockJNIUtil, &jniEnv, (jstring)&indexPath)));
+
+    auto idMapIndex = dynamic_cast<faiss::IndexBinaryIDMap *>(loadedIndexPointer.get());
+    ASSERT_NE(idMapIndex, nullptr);
+    auto hnswIndex = dynamic_cast<faiss::IndexBinaryHNSW *>(idMapIndex->index);
+    ASSERT_NE(hnswIndex, nullptr);
+    auto storage = dynamic_cast<faiss::IndexBinaryFlat *>(hnswIndex->storage);
+    ASSERT_NE(storage, nullptr);
+    ASSERT_FALSE(storage->xb.is_owned);
+    ASSERT_FALSE(hnswIndex->hnsw.neighbors.is_owned);
+
+    auto createIndexSerialization = test_util::FaissGetSerializedBinaryIndex(&createdIndexWithData);
+    auto loadedIndexSerialization = test_util::FaissGetSerializedBinaryIndex(loadedIndexPointer.get());
+    ASSERT_EQ(createIndexSerialization.data, loadedIndexSerialization.data);
+
+    // Clean up
+    loadedIndexPointer.reset();
+    std::remove(indexPath.c_str());
+}
+
 TEST(FaissLoadIndexTest, HNSWPQDisableSdcTable) {
     // Check that when we load an HNSWPQ index, the sdc table is not present.
     faiss::idx_t numIds = 256;
@@ -545,6 +787,218 @@ TEST(FaissQueryIndexTest, BasicAssertions) {
     }
 }
 
+TEST(FaissQueryIndexBatchTest, BasicAssertions) {
+    // Define the index data
+    faiss::idx_t numIds = 100;
+    int dim = 16;
+    std::vector<faiss::idx_t> ids = test_util::Range(numIds);
+    std::vector<float> vectors = test_util::RandomVectors(dim, numIds, randomDataMin, randomDataMax);
+
+    faiss::MetricType metricType = faiss::METRIC_L2;
+    std::string method = "HNSW32,Flat";
+
+    // Define query data, all queries packed in a single buffer
+    int k = 10;
+    int efSearch = 20;
+    std::unordered_map<std::string, jobject> methodParams;
+    methodParams[knn_jni::EF_SEARCH] = reinterpret_cast<jobject>(&efSearch);
+
+    int numQueries = 32;
+    std::vector<float> queries = test_util::RandomVectors(dim, numQueries, -500.0, 500.0);
+
+    // Create the index
+    std::unique_ptr<faiss::Index> createdIndex(
+            test_util::FaissCreateIndex(dim, method, metricType));
+    auto createdIndexWithData =
+            test_util::FaissAddData(createdIndex.get(), ids, vectors);
+
+    // Setup jni
+    NiceMock<JNIEnv> jniEnv;
+    NiceMock<test_util::MockJNIUtil> mockJNIUtil;
+    auto methodParamsJ = reinterpret_cast<jobject>(&methodParams);
+
+    std::vector<int> resultIds(numQueries * k);
+    std::vector<float> resultDistances(numQueries * k);
+    EXPECT_CALL(mockJNIUtil,
+                GetJavaIntArrayLength(
+                        &jniEnv, reinterpret_cast<jintArray>(&resultIds)))
+            .WillRepeatedly(Return(resultIds.size()));
+
+    knn_jni::faiss_wrapper::QueryIndexBatch(
+            &mockJNIUtil, &jniEnv,
+            reinterpret_cast<jlong>(&createdIndexWithData),
+            reinterpret_cast<jfloatArray>(&queries), k, methodParamsJ, nullptr, 0, nullptr,
+            reinterpret_cast<jintArray>(&resultIds), reinterpret_cast<jfloatArray>(&resultDistances));
+
+    // Every query of the batch must match the single query search
+    for (int i = 0; i < numQueries; i++) {
+        std::vector<float> query(queries.begin() + i * dim, queries.begin() + (i + 1) * dim);
+        std::unique_ptr<std::vector<std::pair<int, float> *>> results(
+                reinterpret_cast<std::vector<std::pair<int, float> *> *>(
+                        knn_jni::faiss_wrapper::QueryIndex(
+                                &mockJNIUtil, &jniEnv,
+                                reinterpret_cast<jlong>(&createdIndexWithData),
+                                reinterpret_cast<jfloatArray>(&query), k, methodParamsJ, nullptr)));
+
+        ASSERT_EQ(k, results->size());
+        for (int j = 0; j < k; j++) {
+            ASSERT_EQ(results->at(j)->first, resultIds[i * k + j]);
+            ASSERT_FLOAT_EQ(results->at(j)->second, resultDistances[i * k + j]);
+        }
+
+        // Need to free up each result
+        for (auto it : *results.get()) {
+            delete it;
+        }
+    }
+}
+
+TEST(FaissQueryIndexBatchTest, InvalidQueryVectorsLength) {
+    int dim = 16;
+    std::unique_ptr<faiss::Index> createdIndex(
+            test_util::FaissCreateIndex(dim, "HNSW32,Flat", faiss::METRIC_L2));
+    auto createdIndexWithData =
+            test_util::FaissAddData(createdIndex.get(), test_util::Range(10),
+                                    test_util::RandomVectors(dim, 10, randomDataMin, randomDataMax));
+
+    NiceMock<JNIEnv> jniEnv;
+    NiceMock<test_util::MockJNIUtil> mockJNIUtil;
+
+    std::vector<float> queries(dim + 1);
+    std::vector<int> resultIds(10);
+    std::vector<float> resultDistances(10);
+    ASSERT_THROW(knn_jni::faiss_wrapper::QueryIndexBatch(
+            &mockJNIUtil, &jniEnv,
+            reinterpret_cast<jlong>(&createdIndexWithData),
+            reinterpret_cast<jfloatArray>(&queries), 5, nullptr, nullptr, 0, nullptr,
+            reinterpret_cast<jintArray>(&resultIds), reinterpret_cast<jfloatArray>(&resultDistances)),
+            std::runtime_error);
+}
+
+TEST(FaissQueryIndexIntoArraysTest, BasicAssertions) {
+    // Define the index data
+    faiss::idx_t numIds = 100;
+    int dim = 16;
+    std::vector<faiss::idx_t> ids = test_util::Range(numIds);
+    std::vector<float> vectors = test_util::RandomVectors(dim, numIds, randomDataMin, randomDataMax);
+
+    faiss::MetricType metricType = faiss::METRIC_L2;
+    std::string method = "HNSW32,Flat";
+
+    // Define query data
+    int k = 10;
+    int efSearch = 20;
+    std::unordered_map<std::string, jobject> methodParams;
+    methodParams[knn_jni::EF_SEARCH] = reinterpret_cast<jobject>(&efSearch);
+    std::vector<float> query = test_util::RandomVectors(dim, 1, -500.0, 500.0);
+
+    // Create the index
+    std::unique_ptr<faiss::Index> createdIndex(
+            test_util::FaissCreateIndex(dim, method, metricType));
+    auto createdIndexWithData =
+            test_util::FaissAddData(createdIndex.get(), ids, vectors);
+
+    // Setup jni
+    NiceMock<JNIEnv> jniEnv;
+    NiceMock<test_util::MockJNIUtil> mockJNIUtil;
+    auto methodParamsJ = reinterpret_cast<jobject>(&methodParams);
+
+    // Output arrays only hold half of the k results
+    std::vector<int> resultIds(k / 2);
+    std::vector<float> resultDistances(k / 2);
+    EXPECT_CALL(mockJNIUtil,
+                GetJavaIntArrayLength(
+                        &jniEnv, reinterpret_cast<jintArray>(&resultIds)))
+            .WillRepeatedly(Return(resultIds.size()));
+
+    jint count = knn_jni::faiss_wrapper::QueryIndex_WithFilterIntoArrays(
+            &mockJNIUtil, &jniEnv,
+            reinterpret_cast<jlong>(&createdIndexWithData),
+            reinterpret_cast<jfloatArray>(&query), k, methodParamsJ, nullptr, 0, nullptr,
+            reinterpret_cast<jintArray>(&resultIds), reinterpret_cast<jfloatArray>(&resultDistances));
+    // The full count is returned so the caller can see the arrays were too short
+    ASSERT_EQ(k, count);
+
+    std::unique_ptr<std::vector<std::pair<int, float> *>> results(
+            reinterpret_cast<std::vector<std::pair<int, float> *> *>(
+                    knn_jni::faiss_wrapper::QueryIndex(
+                            &mockJNIUtil, &jniEnv,
+                            reinterpret_cast<jlong>(&createdIndexWithData),
+                            reinterpret_cast<jfloatArray>(&query), k, methodParamsJ, nullptr)));
+
+    ASSERT_EQ(k, results->size());
+    ASSERT_EQ(k / 2, resultIds.size());
+    for (int j = 0; j < resultIds.size(); j++) {
+        ASSERT_EQ(results->at(j)->first, resultIds[j]);
+        ASSERT_FLOAT_EQ(results->at(j)->second, resultDistances[j]);
+    }
+
+    // Need to free up each result
+    for (auto it : *results.get()) {
+        delete it;
+    }
+}
+
+TEST(FaissQueryIndexWithSearchParamsTest, BasicAssertions) {
+    // Define the index data
+    faiss::idx_t numIds = 100;
+    int dim = 16;
+    std::vector<faiss::idx_t> ids = test_util::Range(numIds);
+    std::vector<float> vectors = test_util::RandomVectors(dim, numIds, randomDataMin, randomDataMax);
+
+    // Define query data
+    int k = 10;
+    int efSearch = 20;
+    std::unordered_map<std::string, jobject> methodParams;
+    methodParams[knn_jni::EF_SEARCH] = reinterpret_cast<jobject>(&efSearch);
+    std::vector<float> query = test_util::RandomVectors(dim, 1, -500.0, 500.0);
+
+    // Create the index
+    std::unique_ptr<faiss::Index> createdIndex(
+            test_util::FaissCreateIndex(dim, "HNSW32,Flat", faiss::METRIC_L2));
+    auto createdIndexWithData =
+            test_util::FaissAddData(createdIndex.get(), ids, vectors);
+
+    // Setup jni
+    NiceMock<JNIEnv> jniEnv;
+    NiceMock<test_util::MockJNIUtil> mockJNIUtil;
+    auto methodParamsJ = reinterpret_cast<jobject>(&methodParams);
+    jlong searchParamsPointer = knn_jni::commons::compileSearchParams(&mockJNIUtil, &jniEnv, methodParamsJ);
+
+    // The map must not be walked again once the parameters are compiled
+    EXPECT_CALL(mockJNIUtil, ConvertJavaMapToCppMap(testing::_, testing::_)).Times(0);
+
+    std::unique_ptr<std::vector<std::pair<int, float> *>> results(
+            reinterpret_cast<std::vector<std::pair<int, float> *> *>(
+                    knn_jni::faiss_wrapper::QueryIndex_WithSearchParams(
+                            &mockJNIUtil, &jniEnv,
+                            reinterpret_cast<jlong>(&createdIndexWithData),
+                            reinterpret_cast<jfloatArray>(&query), k, searchParamsPointer, nullptr, 0, nullptr)));
+    testing::Mock::VerifyAndClearExpectations(&mockJNIUtil);
+
+    std::unique_ptr<std::vector<std::pair<int, float> *>> expectedResults(
+            reinterpret_cast<std::vector<std::pair<int, float> *> *>(
+                    knn_jni::faiss_wrapper::QueryIndex(
+                            &mockJNIUtil, &jniEnv,
+                            reinterpret_cast<jlong>(&createdIndexWithData),
+                            reinterpret_cast<jfloatArray>(&query), k, methodParamsJ, nullptr)));
+
+    ASSERT_EQ(expectedResults->size(), results->size());
+    for (size_t i = 0; i < results->size(); i++) {
+        ASSERT_EQ(expectedResults->at(i)->first, results->at(i)->first);
+        ASSERT_FLOAT_EQ(expectedResults->at(i)->second, results->at(i)->second);
+    }
+
+    // Need to free up each result
+    for (auto it : *results.get()) {
+        delete it;
+    }
+    for (auto it : *expectedResults.get()) {
+        delete it;
+    }
+    knn_jni::commons::freeSearchParams(searchParamsPointer);
+}
+
 TEST(FaissQueryBinaryIndexTest, BasicAssertions) {
     // Define the data
     faiss::idx_t numIds = 200;
@@ -672,6 +1126,607 @@ TEST(FaissQueryIndexWithFilterTest1435, BasicAssertions) {
     }
 }
 
+TEST(FaissQueryIndexWithFilterTest, PinsQueryAndFilter) {
+    // Define the index data
+    faiss::idx_t numIds = 100;
+    std::vector<faiss::idx_t> ids;
+    std::vector<float> vectors;
+    int dim = 16;
+    for (int64_t i = 0; i < numIds; i++) {
+        ids.push_back(i);
+        for (int j = 0; j < dim; j++) {
+            vectors.push_back(test_util::RandomFloat(-500.0, 500.0));
+        }
+    }
+
+    std::vector<jlong> bitmap(test_util::bits2words(numIds), 0);
+    for (int64_t i = 0; i < numIds; i += 2) {
+        test_util::setBitSet(i, bitmap.data(), bitmap.size());
+    }
+
+    std::vector<float> query(vectors.begin(), vectors.begin() + dim);
+
+    // Create the index
+    std::unique_ptr<faiss::Index> createdIndex(
+            test_util::FaissCreateIndex(dim, "HNSW32,Flat", faiss::METRIC_L2));
+    auto createdIndexWithData =
+            test_util::FaissAddData(createdIndex.get(), ids, vectors);
+
+    // Setup jni
+    NiceMock<JNIEnv> jniEnv;
+    NiceMock<test_util::MockJNIUtil> mockJNIUtil;
+    EXPECT_CALL(mockJNIUtil,
+                GetJavaLongArrayLength(
+                        &jniEnv, reinterpret_cast<jlongArray>(&bitmap)))
+            .WillRepeatedly(Return(bitmap.size()));
+    EXPECT_CALL(mockJNIUtil, GetFloatArrayElements(_, _, _)).Times(0);
+    EXPECT_CALL(mockJNIUtil, GetLongArrayElements(_, _, _)).Times(0);
+    EXPECT_CALL(mockJNIUtil, GetPrimitiveArrayCritical(_, _, _)).Times(2);
+    EXPECT_CALL(mockJNIUtil, ReleasePrimitiveArrayCritical(_, _, _, JNI_ABORT)).Times(2);
+
+    int k = 10;
+    std::unique_ptr<std::vector<std::pair<int, float> *>> results(
+            reinterpret_cast<std::vector<std::pair<int, float> *> *>(
+                    knn_jni::faiss_wrapper::QueryIndex_WithFilter(
+                            &mockJNIUtil, &jniEnv,
+                            reinterpret_cast<jlong>(&createdIndexWithData),
+                            reinterpret_cast<jfloatArray>(&query), k, nullptr,
+                            reinterpret_cast<jlongArray>(&bitmap), 0, nullptr)));
+
+    ASSERT_EQ(k, results->size());
+    ASSERT_EQ(0, results->at(0)->first);
+    for (const auto& pairPtr : *results) {
+        ASSERT_EQ(0, pairPtr->first % 2);
+    }
+
+    // Need to free up each result
+    for (auto it : *results.get()) {
+        delete it;
+    }
+}
+
+TEST(FaissQueryIndexWithFilterTest, PinsLargeFilter) {
+    faiss::idx_t numIds = 100;
+    int dim = 16;
+    std::vector<faiss::idx_t> ids = test_util::Range(numIds);
+    std::vector<float> vectors = test_util::RandomVectors(dim, numIds, -500.0, 500.0);
+
+    // Only the first words have bits set, the rest makes the bitmap as large as the one of a big segment
+    std::vector<jlong> bitmap(160000, 0);
+    for (int64_t i = 0; i < numIds; i += 2) {
+        test_util::setBitSet(i, bitmap.data(), bitmap.size());
+    }
+
+    std::vector<float> query(vectors.begin(), vectors.begin() + dim);
+
+    std::unique_ptr<faiss::Index> createdIndex(
+            test_util::FaissCreateIndex(dim, "HNSW32,Flat", faiss::METRIC_L2));
+    auto createdIndexWithData =
+            test_util::FaissAddData(createdIndex.get(), ids, vectors);
+
+    // The filter is pinned like the query vector, whatever its size
+    NiceMock<JNIEnv> jniEnv;
+    NiceMock<test_util::MockJNIUtil> mockJNIUtil;
+    EXPECT_CALL(mockJNIUtil, GetLongArrayRegion(_, _, _, _, _)).Times(0);
+    EXPECT_CALL(mockJNIUtil, GetPrimitiveArrayCritical(_, reinterpret_cast<jarray>(&bitmap), _)).Times(1);
+    EXPECT_CALL(mockJNIUtil, GetPrimitiveArrayCritical(_, reinterpret_cast<jarray>(&query), _)).Times(1);
+    EXPECT_CALL(mockJNIUtil, ReleasePrimitiveArrayCritical(_, _, _, JNI_ABORT)).Times(2);
+
+    int k = 10;
+    std::unique_ptr<std::vector<std::pair<int, float> *>> results(
+            reinterpret_cast<std::vector<std::pair<int, float> *> *>(
+                    knn_jni::faiss_wrapper::QueryIndex_WithFilter(
+                            &mockJNIUtil, &jniEnv,
+                            reinterpret_cast<jlong>(&createdIndexWithData),
+                            reinterpret_cast<jfloatArray>(&query), k, nullptr,
+                            reinterpret_cast<jlongArray>(&bitmap), 0, nullptr)));
+
+    ASSERT_EQ(k, results->size());
+    ASSERT_EQ(0, results->at(0)->first);
+    for (const auto& pairPtr : *results) {
+        ASSERT_EQ(0, pairPtr->first % 2);
+    }
+
+    // Need to free up each result
+    for (auto it : *results.get()) {
+        delete it;
+    }
+}
+
+TEST(FaissQueryIndexWithFilterTest, ExactSearchForSelectiveFilter) {
+    // Define the index data
+    faiss::idx_t numIds = 1000;
+    std::vector<faiss::idx_t> ids;
+    std::vector<float> vectors;
+    int dim = 16;
+    for (int64_t i = 0; i < numIds; i++) {
+        ids.push_back(i);
+        for (int j = 0; j < dim; j++) {
+            vectors.push_back(test_util::RandomFloat(-500.0, 500.0));
+        }
+    }
+    std::vector<float> query;
+    for (int j = 0; j < dim; j++) {
+        query.push_back(test_util::RandomFloat(-500.0, 500.0));
+    }
+
+    // 30 docs out of 1000 are selected, well below sqrt(ef_search * numIds)
+    std::vector<jlong> filterIds;
+    for (int64_t i = 5; i < numIds; i += 33) {
+        filterIds.push_back(i);
+    }
+    int k = 10;
+
+    for (auto metricType : {faiss::METRIC_L2, faiss::METRIC_INNER_PRODUCT}) {
+        std::unique_ptr<faiss::Index> createdIndex(
+                test_util::FaissCreateIndex(dim, "HNSW32,Flat", metricType));
+        auto createdIndexWithData =
+                test_util::FaissAddData(createdIndex.get(), ids, vectors);
+
+        // Expected top k by brute force, best first
+        std::vector<std::pair<float, int64_t>> expected;
+        for (auto id : filterIds) {
+            float distance = 0;
+            for (int j = 0; j < dim; j++) {
+                float value = vectors[id * dim + j];
+                distance += metricType == faiss::METRIC_L2
+                        ? (value - query[j]) * (value - query[j]) : -value * query[j];
+            }
+            expected.emplace_back(distance, id);
+        }
+        std::sort(expected.begin(), expected.end());
+
+        NiceMock<JNIEnv> jniEnv;
+        NiceMock<test_util::MockJNIUtil> mockJNIUtil;
+        std::unique_ptr<std::vector<std::pair<int, float> *>> results(
+                reinterpret_cast<std::vector<std::pair<int, float> *> *>(
+                        knn_jni::faiss_wrapper::QueryIndex_WithFilter(
+                                &mockJNIUtil, &jniEnv,
+                                reinterpret_cast<jlong>(&createdIndexWithData),
+                                reinterpret_cast<jfloatArray>(&query), k, nullptr,
+                                reinterpret_cast<jlongArray>(&filterIds), 1, nullptr)));
+
+        ASSERT_EQ(k, results->size());
+        for (int i = 0; i < k; i++) {
+            ASSERT_EQ(expected[i].second, results->at(i)->first);
+        }
+
+        // Need to free up each result
+        for (auto it : *results.get()) {
+            delete it;
+        }
+    }
+}
+
+TEST(FaissQueryIndexWithParallelismTest, MatchesSingleThreadedSearch) {
+    int dim = 16;
+    int k = 10;
+    std::vector<float> query = test_util::RandomVectors(dim, 1, -500.0, 500.0);
+
+    // IVF queries are split by probed lists, flat ones by ranges of vectors once there are enough of them
+    std::vector<std::pair<std::string, faiss::idx_t>> indexes = {{"IVF8,Flat", 512}, {"Flat", 40000}};
+    for (const auto &[indexDescription, numIds] : indexes) {
+        std::vector<faiss::idx_t> ids = test_util::Range(numIds);
+        std::vector<float> vectors = test_util::RandomVectors(dim, numIds, randomDataMin, randomDataMax);
+        std::vector<jlong> filterIds;
+        for (int64_t i = 3; i < numIds; i += 7) {
+            filterIds.push_back(i);
+        }
+
+        std::unique_ptr<faiss::Index> createdIndex(
+                test_util::FaissCreateIndex(dim, indexDescription, faiss::METRIC_L2));
+        test_util::FaissTrainIndex(createdIndex.get(), numIds, vectors.data());
+        auto createdIndexWithData =
+                test_util::FaissAddData(createdIndex.get(), ids, vectors);
+
+        int nprobes = 8;
+        int parallelism = 4;
+        std::unordered_map<std::string, jobject> sequentialParams;
+        sequentialParams[knn_jni::NPROBES] = reinterpret_cast<jobject>(&nprobes);
+        std::unordered_map<std::string, jobject> parallelParams = sequentialParams;
+        parallelParams[knn_jni::PARALLELISM] = reinterpret_cast<jobject>(&parallelism);
+
+        NiceMock<JNIEnv> jniEnv;
+        NiceMock<test_util::MockJNIUtil> mockJNIUtil;
+        for (jlongArray filterIdsJ : {static_cast<jlongArray>(nullptr), reinterpret_cast<jlongArray>(&filterIds)}) {
+            std::unique_ptr<std::vector<std::pair<int, float> *>> expectedResults(
+                    reinterpret_cast<std::vector<std::pair<int, float> *> *>(
+                            knn_jni::faiss_wrapper::QueryIndex_WithFilter(
+                                    &mockJNIUtil, &jniEnv,
+                                    reinterpret_cast<jlong>(&createdIndexWithData),
+                                    reinterpret_cast<jfloatArray>(&query), k,
+                                    reinterpret_cast<jobject>(&sequentialParams), filterIdsJ, 1, nullptr)));
+            std::unique_ptr<std::vector<std::pair<int, float> *>> results(
+                    reinterpret_cast<std::vector<std::pair<int, float> *> *>(
+                            knn_jni::faiss_wrapper::QueryIndex_WithFilter(
+                                    &mockJNIUtil, &jniEnv,
+                                    reinterpret_cast<jlong>(&createdIndexWithData),
+                                    reinterpret_cast<jfloatArray>(&query), k,
+                                    reinterpret_cast<jobject>(&parallelParams), filterIdsJ, 1, nullptr)));
+
+            ASSERT_EQ(k, results->size());
+            ASSERT_EQ(expectedResults->size(), results->size());
+            for (size_t i = 0; i < results->size(); i++) {
+                ASSERT_EQ(expectedResults->at(i)->first, results->at(i)->first);
+                ASSERT_FLOAT_EQ(expectedResults->at(i)->second, results->at(i)->second);
+            }
+
+            // Need to free up each result
+            for (auto it : *results.get()) {
+                delete it;
+            }
+            for (auto it : *expectedResults.get()) {
+                delete it;
+            }
+        }
+    }
+}
+
+TEST(FaissQueryIndexesTest, MatchesExactSearchOverAllSegments) {
+    int dim = 16;
+    int k = 10;
+    faiss::idx_t numIds = 300;
+    std::vector<float> query = test_util::RandomVectors(dim, 1, -500.0, 500.0);
+    // Search parameters large enough for every segment to be searched exhaustively
+    int efSearch = 400;
+    int nprobes = 8;
+    std::unordered_map<std::string, jobject> methodParams;
+    methodParams[knn_jni::EF_SEARCH] = reinterpret_cast<jobject>(&efSearch);
+    methodParams[knn_jni::NPROBES] = reinterpret_cast<jobject>(&nprobes);
+
+    for (faiss::MetricType metric : {faiss::METRIC_L2, faiss::METRIC_INNER_PRODUCT}) {
+        std::vector<std::string> indexDescriptions = {"HNSW32,Flat", "IVF8,Flat", "Flat"};
+        std::vector<std::unique_ptr<faiss::Index>> createdIndexes;
+        std::vector<faiss::IndexIDMap> segments;
+        segments.reserve(indexDescriptions.size());
+        std::vector<std::vector<float>> segmentVectors;
+        std::vector<int64_t> docBases;
+        std::vector<std::vector<jlong>> filterIds;
+        std::vector<int64_t> filterIdsTypes;
+        for (size_t i = 0; i < indexDescriptions.size(); i++) {
+            std::vector<faiss::idx_t> ids = test_util::Range(numIds);
+            segmentVectors.push_back(test_util::RandomVectors(dim, numIds, randomDataMin, randomDataMax));
+            createdIndexes.emplace_back(test_util::FaissCreateIndex(dim, indexDescriptions[i], metric));
+            test_util::FaissTrainIndex(createdIndexes.back().get(), numIds, segmentVectors.back().data());
+            segments.push_back(test_util::FaissAddData(createdIndexes.back().get(), ids, segmentVectors.back()));
+            docBases.push_back(i * numIds);
+            filterIds.emplace_back();
+            for (int64_t id = i; id < numIds; id += 2) {
+                filterIds.back().push_back(id);
+            }
+            filterIdsTypes.push_back(1);
+        }
+        std::vector<jlong> indexPointers;
+        for (auto &segment : segments) {
+            indexPointers.push_back(reinterpret_cast<jlong>(&segment));
+        }
+
+        NiceMock<JNIEnv> jniEnv;
+        NiceMock<test_util::MockJNIUtil> mockJNIUtil;
+        EXPECT_CALL(mockJNIUtil, GetJavaObjectArrayLength(_, _))
+                .WillRepeatedly(Return(static_cast<int>(filterIds.size())));
+        for (bool filtered : {false, true}) {
+            // Brute force the k best hits over every segment
+            std::vector<std::pair<float, int>> expected;
+            for (size_t i = 0; i < segments.size(); i++) {
+                for (faiss::idx_t id = 0; id < numIds; id++) {
+                    if (filtered && std::find(filterIds[i].begin(), filterIds[i].end(), id) == filterIds[i].end()) {
+                        continue;
+                    }
+                    const float *vector = segmentVectors[i].data() + id * dim;
+                    float distance = metric == faiss::METRIC_L2 ? faiss::fvec_L2sqr(query.data(), vector, dim)
+                                                                : -faiss::fvec_inner_product(query.data(), vector, dim);
+                    expected.emplace_back(distance, docBases[i] + id);
+                }
+            }
+            std::sort(expected.begin(), expected.end());
+
+            std::unique_ptr<std::vector<std::pair<int, float> *>> results(
+                    reinterpret_cast<std::vector<std::pair<int, float> *> *>(
+                            knn_jni::faiss_wrapper::QueryIndexes(
+                                    &mockJNIUtil, &jniEnv, reinterpret_cast<jlongArray>(&indexPointers),
+                                    reinterpret_cast<jintArray>(&docBases), reinterpret_cast<jfloatArray>(&query), k,
+                                    reinterpret_cast<jobject>(&methodParams),
+                                    filtered ? reinterpret_cast<jobjectArray>(&filterIds) : nullptr,
+                                    filtered ? reinterpret_cast<jintArray>(&filterIdsTypes) : nullptr)));
+
+            ASSERT_EQ(k, results->size());
+            for (int i = 0; i < k; i++) {
+                ASSERT_EQ(expected[i].second, results->at(i)->first);
+                ASSERT_NEAR(metric == faiss::METRIC_L2 ? expected[i].first : -expected[i].first,
+                            results->at(i)->second, 1e-2);
+            }
+
+            // Need to free up each result
+            for (auto it : *results.get()) {
+                delete it;
+            }
+        }
+
+        // Segments must share their dimension and every segment needs a doc base
+        std::vector<int64_t> missingDocBases(docBases.begin(), docBases.end() - 1);
+        ASSERT_THROW(knn_jni::faiss_wrapper::QueryIndexes(
+                &mockJNIUtil, &jniEnv, reinterpret_cast<jlongArray>(&indexPointers),
+                reinterpret_cast<jintArray>(&missingDocBases), reinterpret_cast<jfloatArray>(&query), k, nullptr,
+                nullptr, nullptr), std::runtime_error);
+        std::vector<float> shortQuery(dim - 1, 0);
+        ASSERT_THROW(knn_jni::faiss_wrapper::QueryIndexes(
+                &mockJNIUtil, &jniEnv, reinterpret_cast<jlongArray>(&indexPointers),
+                reinterpret_cast<jintArray>(&docBases), reinterpret_cast<jfloatArray>(&shortQuery), k, nullptr,
+                nullptr, nullptr), std::runtime_error);
+    }
+}
+
+TEST(FaissQueryIndexesTest, KLargerThanEfSearchMatchesQueryIndex) {
+    int dim = 16;
+    int k = 50;
+    faiss::idx_t numIds = 300;
+    std::vector<float> query = test_util::RandomVectors(dim, 1, randomDataMin, randomDataMax);
+    std::vector<float> vectors = test_util::RandomVectors(dim, numIds, randomDataMin, randomDataMax);
+    std::vector<faiss::idx_t> ids = test_util::Range(numIds);
+    int efSearch = 5;
+    std::unordered_map<std::string, jobject> methodParams;
+    methodParams[knn_jni::EF_SEARCH] = reinterpret_cast<jobject>(&efSearch);
+
+    NiceMock<JNIEnv> jniEnv;
+    NiceMock<test_util::MockJNIUtil> mockJNIUtil;
+    for (faiss::MetricType metric : {faiss::METRIC_L2, faiss::METRIC_INNER_PRODUCT}) {
+        std::unique_ptr<faiss::Index> createdIndex(test_util::FaissCreateIndex(dim, "HNSW16,Flat", metric));
+        auto createdIndexWithData = test_util::FaissAddData(createdIndex.get(), ids, vectors);
+        std::vector<jlong> indexPointers = {reinterpret_cast<jlong>(&createdIndexWithData)};
+        std::vector<int64_t> docBases = {0};
+
+        std::unique_ptr<std::vector<std::pair<int, float> *>> expected(
+                reinterpret_cast<std::vector<std::pair<int, float> *> *>(
+                        knn_jni::faiss_wrapper::QueryIndex(
+                                &mockJNIUtil, &jniEnv, reinterpret_cast<jlong>(&createdIndexWithData),
+                                reinterpret_cast<jfloatArray>(&query), k, reinterpret_cast<jobject>(&methodParams),
+                                nullptr)));
+        std::unique_ptr<std::vector<std::pair<int, float> *>> results(
+                reinterpret_cast<std::vector<std::pair<int, float> *> *>(
+                        knn_jni::faiss_wrapper::QueryIndexes(
+                                &mockJNIUtil, &jniEnv, reinterpret_cast<jlongArray>(&indexPointers),
+                                reinterpret_cast<jintArray>(&docBases), reinterpret_cast<jfloatArray>(&query), k,
+                                reinterpret_cast<jobject>(&methodParams), nullptr, nullptr)));
+
+        // Both searches visit max(ef_search, k) candidates, so they return k hits and the same ones
+        ASSERT_EQ(k, expected->size());
+        ASSERT_EQ(expected->size(), results->size());
+        for (int i = 0; i < k; i++) {
+            ASSERT_EQ(expected->at(i)->first, results->at(i)->first);
+            ASSERT_NEAR(expected->at(i)->second, results->at(i)->second, 1e-2);
+        }
+
+        // Need to free up each result
+        for (auto it : *expected.get()) {
+            delete it;
+        }
+        for (auto it : *results.get()) {
+            delete it;
+        }
+    }
+}
+
+TEST(FaissSubmitQueryIndexTest, MatchesSynchronousSearch) {
+    faiss::idx_t numIds = 200;
+    int dim = 16;
+    std::vector<faiss::idx_t> ids = test_util::Range(numIds);
+    std::vector<float> vectors = test_util::RandomVectors(dim, numIds, randomDataMin, randomDataMax);
+    std::vector<jlong> filterIds;
+    for (int64_t i = 0; i < numIds; i += 3) {
+        filterIds.push_back(i);
+    }
+
+    std::unique_ptr<faiss::Index> createdIndex(
+            test_util::FaissCreateIndex(dim, "HNSW32,Flat", faiss::METRIC_L2));
+    auto createdIndexWithData =
+            test_util::FaissAddData(createdIndex.get(), ids, vectors);
+
+    NiceMock<JNIEnv> jniEnv;
+    NiceMock<test_util::MockJNIUtil> mockJNIUtil;
+    int k = 10;
+
+    // Every query is in flight before the first results are collected
+    std::vector<std::vector<float>> queries;
+    std::vector<jlong> tasks;
+    for (int i = 0; i < 8; i++) {
+        queries.push_back(test_util::RandomVectors(dim, 1, -500.0, 500.0));
+    }
+    for (auto &query : queries) {
+        tasks.push_back(knn_jni::faiss_wrapper::SubmitQueryIndex(
+                &mockJNIUtil, &jniEnv, reinterpret_cast<jlong>(&createdIndexWithData),
+                reinterpret_cast<jfloatArray>(&query), k, nullptr, reinterpret_cast<jlongArray>(&filterIds), 1,
+                nullptr));
+    }
+
+    for (size_t i = 0; i < queries.size(); i++) {
+        std::unique_ptr<std::vector<std::pair<int, float> *>> expectedResults(
+                reinterpret_cast<std::vector<std::pair<int, float> *> *>(
+                        knn_jni::faiss_wrapper::QueryIndex_WithFilter(
+                                &mockJNIUtil, &jniEnv,
+                                reinterpret_cast<jlong>(&createdIndexWithData),
+                                reinterpret_cast<jfloatArray>(&queries[i]), k, nullptr,
+                                reinterpret_cast<jlongArray>(&filterIds), 1, nullptr)));
+        std::unique_ptr<std::vector<std::pair<int, float> *>> results(
+                reinterpret_cast<std::vector<std::pair<int, float> *> *>(
+                        knn_jni::faiss_wrapper::GetSearchTaskResults(&mockJNIUtil, &jniEnv, tasks[i])));
+
+        ASSERT_EQ(expectedResults->size(), results->size());
+        for (size_t j = 0; j < results->size(); j++) {
+            ASSERT_EQ(expectedResults->at(j)->first, results->at(j)->first);
+            ASSERT_FLOAT_EQ(expectedResults->at(j)->second, results->at(j)->second);
+        }
+
+        // Need to free up each result
+        for (auto it : *results.get()) {
+            delete it;
+        }
+        for (auto it : *expectedResults.get()) {
+            delete it;
+        }
+    }
+
+    // A task dropped without reading its results is waited for and freed
+    jlong task = knn_jni::faiss_wrapper::SubmitQueryIndex(
+            &mockJNIUtil, &jniEnv, reinterpret_cast<jlong>(&createdIndexWithData),
+            reinterpret_cast<jfloatArray>(&queries[0]), k, nullptr, nullptr, 0, nullptr);
+    knn_jni::faiss_wrapper::FreeSearchTask(task);
+
+    // A query of the wrong dimension is rejected up front
+    std::vector<float> shortQuery(dim - 1, 0);
+    ASSERT_THROW(knn_jni::faiss_wrapper::SubmitQueryIndex(
+            &mockJNIUtil, &jniEnv, reinterpret_cast<jlong>(&createdIndexWithData),
+            reinterpret_cast<jfloatArray>(&shortQuery), k, nullptr, nullptr, 0, nullptr), std::runtime_error);
+}
+
+TEST(FaissExactSearchTest, BasicAssertions) {
+    // Define the index data
+    faiss::idx_t numIds = 200;
+    std::vector<faiss::idx_t> ids;
+    std::vector<float> vectors;
+    int dim = 16;
+    for (int64_t i = 0; i < numIds; i++) {
+        ids.push_back(i);
+        for (int j = 0; j < dim; j++) {
+            vectors.push_back(test_util::RandomFloat(-500.0, 500.0));
+        }
+    }
+    std::vector<float> query = test_util::RandomVectors(dim, 1, -500.0, 500.0);
+    int k = 10;
+
+    std::unique_ptr<faiss::Index> createdIndex(
+            test_util::FaissCreateIndex(dim, "HNSW32,Flat", faiss::METRIC_L2));
+    auto createdIndexWithData =
+            test_util::FaissAddData(createdIndex.get(), ids, vectors);
+
+    // Expected top k by brute force over every doc, best first
+    std::vector<std::pair<float, int64_t>> expected;
+    for (int64_t id = 0; id < numIds; id++) {
+        float distance = 0;
+        for (int j = 0; j < dim; j++) {
+            float diff = vectors[id * dim + j] - query[j];
+            distance += diff * diff;
+        }
+        expected.emplace_back(distance, id);
+    }
+    std::sort(expected.begin(), expected.end());
+
+    NiceMock<JNIEnv> jniEnv;
+    NiceMock<test_util::MockJNIUtil> mockJNIUtil;
+    std::unique_ptr<std::vector<std::pair<int, float> *>> results(
+            reinterpret_cast<std::vector<std::pair<int, float> *> *>(
+                    knn_jni::faiss_wrapper::ExactSearch(
+                            &mockJNIUtil, &jniEnv,
+                            reinterpret_cast<jlong>(&createdIndexWithData),
+                            reinterpret_cast<jfloatArray>(&query), k, nullptr, 0)));
+
+    ASSERT_EQ(k, results->size());
+    for (int i = 0; i < k; i++) {
+        ASSERT_EQ(expected[i].second, results->at(i)->first);
+    }
+
+    // Need to free up each result
+    for (auto it : *results.get()) {
+        delete it;
+    }
+}
+
+TEST(FaissExactSearchTest, InvalidQueryDimension) {
+    faiss::idx_t numIds = 10;
+    std::vector<faiss::idx_t> ids;
+    int dim = 16;
+    for (int64_t i = 0; i < numIds; i++) {
+        ids.push_back(i);
+    }
+    std::vector<float> vectors = test_util::RandomVectors(dim, numIds, -500.0, 500.0);
+    std::vector<float> query = test_util::RandomVectors(dim + 1, 1, -500.0, 500.0);
+
+    std::unique_ptr<faiss::Index> createdIndex(
+            test_util::FaissCreateIndex(dim, "HNSW32,Flat", faiss::METRIC_L2));
+    auto createdIndexWithData =
+            test_util::FaissAddData(createdIndex.get(), ids, vectors);
+
+    NiceMock<JNIEnv> jniEnv;
+    NiceMock<test_util::MockJNIUtil> mockJNIUtil;
+    ASSERT_THROW(knn_jni::faiss_wrapper::ExactSearch(
+                         &mockJNIUtil, &jniEnv,
+                         reinterpret_cast<jlong>(&createdIndexWithData),
+                         reinterpret_cast<jfloatArray>(&query), 10, nullptr, 0),
+                 std::runtime_error);
+}
+
+TEST(FaissQueryIndexWithParentFilterTest, GrouperIsCachedPerIndex) {
+    // Define the index data, every 7th doc is a parent
+    faiss::idx_t numIds = 98;
+    std::vector<faiss::idx_t> ids;
+    std::vector<float> vectors;
+    std::vector<int> parentIds;
+    int dim = 16;
+    for (int64_t i = 1; i < numIds + 1; i++) {
+        if (i % 7 == 0) {
+            parentIds.push_back(i);
+            continue;
+        }
+        ids.push_back(i);
+        for (int j = 0; j < dim; j++) {
+            vectors.push_back(test_util::RandomFloat(-500.0, 500.0));
+        }
+    }
+
+    int k = 10;
+    std::vector<float> query = test_util::RandomVectors(dim, 1, -500.0, 500.0);
+    int efSearch = 100;
+    std::unordered_map<std::string, jobject> methodParams;
+    methodParams[knn_jni::EF_SEARCH] = reinterpret_cast<jobject>(&efSearch);
+
+    // The cache is keyed by index pointer, so both id maps live on the heap and are freed through the wrapper, which
+    // evicts their groupers. Both wrap the same graph, so they return the same hits for the same parents.
+    std::unique_ptr<faiss::Index> createdIndex(
+            test_util::FaissCreateIndex(dim, "HNSW32,Flat", faiss::METRIC_L2));
+    auto *cachedIndex = new faiss::IndexIDMap(test_util::FaissAddData(createdIndex.get(), ids, vectors));
+    auto *freshIndex = new faiss::IndexIDMap(*cachedIndex);
+
+    // Setup jni
+    NiceMock<JNIEnv> jniEnv;
+    NiceMock<test_util::MockJNIUtil> mockJNIUtil;
+    auto parentIdsJ = reinterpret_cast<jintArray>(&parentIds);
+    ON_CALL(mockJNIUtil, GetJavaIntArrayLength(&jniEnv, parentIdsJ))
+            .WillByDefault([&parentIds](JNIEnv *env, jintArray array) { return static_cast<int>(parentIds.size()); });
+
+    auto runQuery = [&](faiss::IndexIDMap *index) {
+        std::unique_ptr<std::vector<std::pair<int, float> *>> results(
+                reinterpret_cast<std::vector<std::pair<int, float> *> *>(
+                        knn_jni::faiss_wrapper::QueryIndex(
+                                &mockJNIUtil, &jniEnv, reinterpret_cast<jlong>(index),
+                                reinterpret_cast<jfloatArray>(&query), k, reinterpret_cast<jobject>(&methodParams),
+                                parentIdsJ)));
+        std::vector<std::pair<int, float>> hits;
+        for (auto it : *results.get()) {
+            hits.push_back(*it);
+            delete it;
+        }
+        return hits;
+    };
+
+    // Every query reads the parent ids in full to check them against the cached grouper
+    EXPECT_CALL(mockJNIUtil, GetIntArrayRegion(&jniEnv, parentIdsJ, 0, parentIds.size(), _)).Times(3);
+    std::vector<std::pair<int, float>> hits = runQuery(cachedIndex);
+    ASSERT_EQ(hits, runQuery(cachedIndex));
+    ASSERT_EQ(hits, runQuery(freshIndex));
+    testing::Mock::VerifyAndClearExpectations(&mockJNIUtil);
+
+    // Moving parents around while keeping their count and the first and last of them has to rebuild the grouper
+    for (size_t i = 1; i + 1 < parentIds.size(); i++) {
+        parentIds[i] -= 3;
+    }
+    knn_jni::faiss_wrapper::Free(reinterpret_cast<jlong>(freshIndex), JNI_FALSE);
+    freshIndex = new faiss::IndexIDMap(*cachedIndex);
+    ASSERT_EQ(runQuery(freshIndex), runQuery(cachedIndex));
+
+    knn_jni::faiss_wrapper::Free(reinterpret_cast<jlong>(cachedIndex), JNI_FALSE);
+    knn_jni::faiss_wrapper::Free(reinterpret_cast<jlong>(freshIndex), JNI_FALSE);
+}
+
 TEST(FaissQueryIndexWithParentFilterTest, BasicAssertions) {
     // Define the index data
     faiss::idx_t numIds = 100;
@@ -894,12 +1949,14 @@ TEST(FaissQueryIndexHNSWCagraBinaryWithParentFilterTest, BasicAssertions) {
     // Setup jni
     NiceMock<JNIEnv> jniEnv;
     NiceMock<test_util::MockJNIUtil> mockJNIUtil;
-    EXPECT_CALL(mockJNIUtil,
-                    GetIntArrayElements(&jniEnv, reinterpret_cast<jintArray>(parentIds.data()), nullptr))
-                .WillRepeatedly(Return(reinterpret_cast<jint*>(parentIds.data())));
     EXPECT_CALL(mockJNIUtil,
                     GetJavaIntArrayLength(&jniEnv, reinterpret_cast<jintArray>(parentIds.data())))
                 .WillRepeatedly(Return(parentIds.size()));
+    EXPECT_CALL(mockJNIUtil,
+                    GetIntArrayRegion(&jniEnv, reinterpret_cast<jintArray>(parentIds.data()), testing::_, testing::_, testing::_))
+                .WillRepeatedly([&parentIds](JNIEnv *env, jintArray array, jsize start, jsize len, jint *buf) {
+                    std::copy(parentIds.begin() + start, parentIds.begin() + start + len, buf);
+                });
 
     // Execute searching for all query
     for (auto query : queries) {
@@ -961,7 +2018,7 @@ TEST(FaissBinaryFreeTest, BasicAssertions) {
 }
 
 TEST(FaissInitLibraryTest, BasicAssertions) {
-    knn_jni::faiss_wrapper::InitLibrary();
+    knn_jni::faiss_wrapper::InitLibrary(0, false);
 }
 
 TEST(FaissTrainIndexTest, BasicAssertions) {
@@ -1028,6 +2085,123 @@ TEST(FaissTrainByteIndexTest, BasicAssertions) {
     ASSERT_TRUE(trainedIndex->is_trained);
 }
 
+TEST(FaissTrainIndexWithStreamTest, BasicAssertions) {
+    // Define the index configuration
+    int dim = 2;
+    std::string spaceType = knn_jni::L2;
+    std::string index_description = "IVF4,Flat";
+
+    std::unordered_map<std::string, jobject> parametersMap;
+    parametersMap[knn_jni::SPACE_TYPE] = (jobject) &spaceType;
+    parametersMap[knn_jni::INDEX_DESCRIPTION] = (jobject) &index_description;
+
+    // Define training data
+    int numTrainingVectors = 256;
+    std::vector<float> trainingVectors = test_util::RandomVectors(dim, numTrainingVectors, randomDataMin, randomDataMax);
+
+    // Setup jni
+    NiceMock<JNIEnv> jniEnv;
+    NiceMock<test_util::MockJNIUtil> mockJNIUtil;
+    std::string indexPath = test_util::RandomString(10, "tmp/", ".faiss");
+    JavaFileIndexOutputMock javaFileIndexOutputMock {indexPath};
+    setUpJavaFileOutputMocking(javaFileIndexOutputMock, mockJNIUtil, false);
+
+    // The trained index is written to the output, never to a Java byte array
+    EXPECT_CALL(mockJNIUtil, NewByteArray(_, _)).Times(0);
+
+    // Perform training
+    knn_jni::faiss_wrapper::TrainIndexWithStream(&mockJNIUtil, &jniEnv, (jobject) &parametersMap, dim,
+                                                 reinterpret_cast<jlong>(&trainingVectors),
+                                                 (jobject) &javaFileIndexOutputMock);
+    javaFileIndexOutputMock.file_writer.close();
+
+    // Confirm that training succeeded
+    std::unique_ptr<faiss::Index> trainedIndex(test_util::FaissLoadIndex(indexPath));
+    ASSERT_TRUE(trainedIndex->is_trained);
+    ASSERT_EQ(0, trainedIndex->ntotal);
+    ASSERT_EQ(4, dynamic_cast<faiss::IndexIVF *>(trainedIndex.get())->nlist);
+    std::remove(indexPath.c_str());
+
+    // Training into a missing output fails before any work is done
+    EXPECT_THROW(knn_jni::faiss_wrapper::TrainIndexWithStream(&mockJNIUtil, &jniEnv, (jobject) &parametersMap, dim,
+                                                              reinterpret_cast<jlong>(&trainingVectors), nullptr),
+                 std::runtime_error);
+}
+
+TEST(FaissTrainingSessionTest, TrainsOnBatches) {
+    // Define the index configuration
+    int dim = 4;
+    std::string spaceType = knn_jni::L2;
+    std::string index_description = "IVF4,Flat";
+
+    std::unordered_map<std::string, jobject> parametersMap;
+    parametersMap[knn_jni::SPACE_TYPE] = (jobject) &spaceType;
+    parametersMap[knn_jni::INDEX_DESCRIPTION] = (jobject) &index_description;
+
+    // Setup jni
+    NiceMock<JNIEnv> jniEnv;
+    NiceMock<test_util::MockJNIUtil> mockJNIUtil;
+
+    jlong sessionPointer = knn_jni::faiss_wrapper::InitTrainingSession(
+            &mockJNIUtil, &jniEnv, (jobject) &parametersMap, dim, knn_jni::faiss_wrapper::TrainingVectorType::FLOAT);
+
+    // Nothing to train on yet
+    EXPECT_THROW(knn_jni::faiss_wrapper::TrainFromSession(&mockJNIUtil, &jniEnv, sessionPointer), std::runtime_error);
+
+    // Feed more vectors than the 4 * 256 the sample keeps, one batch at a time
+    for (int batch = 0; batch < 5; batch++) {
+        std::vector<float> vectors = test_util::RandomVectors(dim, 500, randomDataMin, randomDataMax);
+        knn_jni::faiss_wrapper::AddTrainingVectors(sessionPointer, reinterpret_cast<jlong>(&vectors));
+    }
+
+    std::unique_ptr<std::vector<uint8_t>> trainedIndexSerialization(
+            reinterpret_cast<std::vector<uint8_t> *>(
+                    knn_jni::faiss_wrapper::TrainFromSession(&mockJNIUtil, &jniEnv, sessionPointer)));
+    knn_jni::faiss_wrapper::FreeTrainingSession(sessionPointer);
+
+    std::unique_ptr<faiss::Index> trainedIndex(
+            test_util::FaissLoadFromSerializedIndex(trainedIndexSerialization.get()));
+
+    // Confirm that training succeeded
+    ASSERT_TRUE(trainedIndex->is_trained);
+    ASSERT_EQ(4, dynamic_cast<faiss::IndexIVF *>(trainedIndex.get())->nlist);
+}
+
+TEST(FaissTrainingSessionTest, TrainsByteIndexOnBatches) {
+    // Define the index configuration
+    int dim = 4;
+    std::string spaceType = knn_jni::L2;
+    std::string index_description = "IVF4,SQ8_direct_signed";
+
+    std::unordered_map<std::string, jobject> parametersMap;
+    parametersMap[knn_jni::SPACE_TYPE] = (jobject) &spaceType;
+    parametersMap[knn_jni::INDEX_DESCRIPTION] = (jobject) &index_description;
+
+    // Setup jni
+    NiceMock<JNIEnv> jniEnv;
+    NiceMock<test_util::MockJNIUtil> mockJNIUtil;
+
+    jlong sessionPointer = knn_jni::faiss_wrapper::InitTrainingSession(
+            &mockJNIUtil, &jniEnv, (jobject) &parametersMap, dim, knn_jni::faiss_wrapper::TrainingVectorType::BYTE);
+    for (int batch = 0; batch < 3; batch++) {
+        std::vector<int8_t> vectors = test_util::RandomByteVectors(dim, 200, -128, 127);
+        knn_jni::faiss_wrapper::AddTrainingVectors(sessionPointer, reinterpret_cast<jlong>(&vectors));
+    }
+
+    std::string indexPath = test_util::RandomString(10, "tmp/", ".faiss");
+    JavaFileIndexOutputMock javaFileIndexOutputMock {indexPath};
+    setUpJavaFileOutputMocking(javaFileIndexOutputMock, mockJNIUtil, false);
+    knn_jni::faiss_wrapper::TrainFromSessionWithStream(&mockJNIUtil, &jniEnv, sessionPointer,
+                                                       (jobject) &javaFileIndexOutputMock);
+    knn_jni::faiss_wrapper::FreeTrainingSession(sessionPointer);
+    javaFileIndexOutputMock.file_writer.close();
+
+    // Confirm that training succeeded
+    std::unique_ptr<faiss::Index> trainedIndex(test_util::FaissLoadIndex(indexPath));
+    ASSERT_TRUE(trainedIndex->is_trained);
+    std::remove(indexPath.c_str());
+}
+
 TEST(FaissCreateHnswSQfp16IndexTest, BasicAssertions) {
     // Define the data
     faiss::idx_t numIds = 200;
@@ -1298,6 +2472,303 @@ TEST(FaissRangeSearchQueryIndexTest_WhenHitMaxWindowResult, BasicAssertions){
     }
 }
 
+TEST(FaissRangeSearchQueryIndexTest_KeepsClosestHits, BasicAssertions) {
+    // Define the index data
+    faiss::idx_t numIds = 200;
+    int dim = 2;
+    std::vector<faiss::idx_t> ids = test_util::Range(numIds);
+    std::vector<float> vectors = test_util::RandomVectors(dim, numIds, rangeSearchRandomDataMin, rangeSearchRandomDataMax);
+    std::vector<float> query = test_util::RandomVectors(dim, 1, rangeSearchRandomDataMin, rangeSearchRandomDataMax);
+    int maxResultWindow = 10;
+
+    for (auto metricType : {faiss::METRIC_L2, faiss::METRIC_INNER_PRODUCT}) {
+        // Flat indexes are scanned exactly, so the hits can be checked against brute force
+        std::unique_ptr<faiss::Index> createdIndex(
+                test_util::FaissCreateIndex(dim, "Flat", metricType));
+        auto createdIndexWithData =
+                test_util::FaissAddData(createdIndex.get(), ids, vectors);
+
+        const bool isSimilarity = metricType == faiss::METRIC_INNER_PRODUCT;
+        const float radius = isSimilarity ? 0.0f : 2000.0f;
+        std::vector<std::pair<float, int64_t>> expected;
+        for (int64_t id = 0; id < numIds; id++) {
+            float distance = 0;
+            for (int j = 0; j < dim; j++) {
+                float value = vectors[id * dim + j];
+                distance += isSimilarity ? value * query[j] : (value - query[j]) * (value - query[j]);
+            }
+            if (isSimilarity ? distance > radius : distance < radius) {
+                expected.emplace_back(isSimilarity ? -distance : distance, id);
+            }
+        }
+        std::sort(expected.begin(), expected.end());
+        ASSERT_LT(maxResultWindow, expected.size());
+
+        NiceMock<JNIEnv> jniEnv;
+        NiceMock<test_util::MockJNIUtil> mockJNIUtil;
+        std::unique_ptr<std::vector<std::pair<int, float> *>> results(
+                reinterpret_cast<std::vector<std::pair<int, float> *> *>(
+                        knn_jni::faiss_wrapper::RangeSearch(
+                                &mockJNIUtil, &jniEnv,
+                                reinterpret_cast<jlong>(&createdIndexWithData),
+                                reinterpret_cast<jfloatArray>(&query), radius, nullptr, maxResultWindow, nullptr)));
+
+        ASSERT_EQ(maxResultWindow, results->size());
+        for (int i = 0; i < maxResultWindow; i++) {
+            ASSERT_EQ(expected[i].second, results->at(i)->first);
+        }
+
+        ASSERT_EQ(expected.size(), knn_jni::faiss_wrapper::RangeSearchCount(
+                &mockJNIUtil, &jniEnv, reinterpret_cast<jlong>(&createdIndexWithData),
+                reinterpret_cast<jfloatArray>(&query), radius, nullptr, nullptr, 0));
+
+        // Need to free up each result
+        for (auto it : *results) {
+            delete it;
+        }
+    }
+}
+
+TEST(FaissRangeSearchQueryIndexTest_IVFKeepsClosestHits, BasicAssertions) {
+    // Define the index data, with labels that differ from the internal ids
+    faiss::idx_t numIds = 200;
+    int dim = 2;
+    std::vector<faiss::idx_t> ids;
+    for (int64_t i = 0; i < numIds; i++) {
+        ids.push_back(i * 3 + 1);
+    }
+    std::vector<float> vectors = test_util::RandomVectors(dim, numIds, rangeSearchRandomDataMin, rangeSearchRandomDataMax);
+    std::vector<float> query = test_util::RandomVectors(dim, 1, rangeSearchRandomDataMin, rangeSearchRandomDataMax);
+    int maxResultWindow = 10;
+
+    for (auto metricType : {faiss::METRIC_L2, faiss::METRIC_INNER_PRODUCT}) {
+        // Every list is probed and the codes are flat, so the hits can be checked against brute force
+        std::unique_ptr<faiss::Index> createdIndex(
+                test_util::FaissCreateIndex(dim, "IVF4,Flat", metricType));
+        test_util::FaissTrainIndex(createdIndex.get(), numIds, vectors.data());
+        dynamic_cast<faiss::IndexIVF *>(createdIndex.get())->nprobe = 4;
+        auto createdIndexWithData =
+                test_util::FaissAddData(createdIndex.get(), ids, vectors);
+
+        const bool isSimilarity = metricType == faiss::METRIC_INNER_PRODUCT;
+        const float radius = isSimilarity ? 0.0f : 2000.0f;
+        std::vector<std::pair<float, int64_t>> expected;
+        for (int64_t i = 0; i < numIds; i++) {
+            float distance = 0;
+            for (int j = 0; j < dim; j++) {
+                float value = vectors[i * dim + j];
+                distance += isSimilarity ? value * query[j] : (value - query[j]) * (value - query[j]);
+            }
+            if (isSimilarity ? distance > radius : distance < radius) {
+                expected.emplace_back(isSimilarity ? -distance : distance, ids[i]);
+            }
+        }
+        std::sort(expected.begin(), expected.end());
+        ASSERT_LT(maxResultWindow, expected.size());
+
+        NiceMock<JNIEnv> jniEnv;
+        NiceMock<test_util::MockJNIUtil> mockJNIUtil;
+        std::unique_ptr<std::vector<std::pair<int, float> *>> results(
+                reinterpret_cast<std::vector<std::pair<int, float> *> *>(
+                        knn_jni::faiss_wrapper::RangeSearch(
+                                &mockJNIUtil, &jniEnv,
+                                reinterpret_cast<jlong>(&createdIndexWithData),
+                                reinterpret_cast<jfloatArray>(&query), radius, nullptr, maxResultWindow, nullptr)));
+
+        ASSERT_EQ(maxResultWindow, results->size());
+        for (int i = 0; i < maxResultWindow; i++) {
+            ASSERT_EQ(expected[i].second, results->at(i)->first);
+        }
+
+        ASSERT_EQ(expected.size(), knn_jni::faiss_wrapper::RangeSearchCount(
+                &mockJNIUtil, &jniEnv, reinterpret_cast<jlong>(&createdIndexWithData),
+                reinterpret_cast<jfloatArray>(&query), radius, nullptr, nullptr, 0));
+
+        // Need to free up each result
+        for (auto it : *results) {
+            delete it;
+        }
+    }
+}
+
+TEST(FaissRangeSearchBinaryIndexTest, BasicAssertions) {
+    // Define the data
+    faiss::idx_t numIds = 200;
+    int dim = 128;
+    std::vector<faiss::idx_t> ids = test_util::Range(numIds);
+    std::vector<uint8_t> vectors;
+    for (int64_t i = 0; i < numIds * dim / 8; ++i) {
+        vectors.push_back(test_util::RandomInt(0, 255));
+    }
+    std::vector<uint8_t> query;
+    for (int j = 0; j < dim / 8; ++j) {
+        query.push_back(test_util::RandomInt(0, 255));
+    }
+    float radius = 64;
+    int maxResultWindow = 10;
+
+    // Hits by brute force, closest first
+    std::vector<std::pair<float, int64_t>> expected;
+    for (int64_t id = 0; id < numIds; id++) {
+        int distance = 0;
+        for (int j = 0; j < dim / 8; j++) {
+            distance += __builtin_popcount(vectors[id * dim / 8 + j] ^ query[j]);
+        }
+        if (distance < radius) {
+            expected.emplace_back(distance, id);
+        }
+    }
+    std::sort(expected.begin(), expected.end());
+    ASSERT_LT(maxResultWindow, expected.size());
+
+    int efSearch = 400;
+    std::unordered_map<std::string, jobject> methodParams;
+    methodParams[knn_jni::EF_SEARCH] = reinterpret_cast<jobject>(&efSearch);
+
+    NiceMock<JNIEnv> jniEnv;
+    NiceMock<test_util::MockJNIUtil> mockJNIUtil;
+
+    // A flat index is searched exactly, HNSW hits have to be real hits
+    for (std::string method : {"BFlat", "BHNSW32"}) {
+        std::unique_ptr<faiss::IndexBinary> createdIndex(
+                test_util::FaissCreateBinaryIndex(dim, method));
+        auto createdIndexWithData =
+                test_util::FaissAddBinaryData(createdIndex.get(), ids, vectors);
+
+        std::unique_ptr<std::vector<std::pair<int, float> *>> results(
+                reinterpret_cast<std::vector<std::pair<int, float> *> *>(
+                        knn_jni::faiss_wrapper::RangeSearchBinary(
+                                &mockJNIUtil, &jniEnv,
+                                reinterpret_cast<jlong>(&createdIndexWithData),
+                                reinterpret_cast<jbyteArray>(&query), radius,
+                                reinterpret_cast<jobject>(&methodParams), maxResultWindow, nullptr)));
+
+        ASSERT_EQ(maxResultWindow, results->size());
+        for (int i = 0; i < maxResultWindow; i++) {
+            ASSERT_LT(results->at(i)->second, radius);
+            if (i > 0) {
+                ASSERT_LE(results->at(i - 1)->second, results->at(i)->second);
+            }
+            if (method == "BFlat") {
+                ASSERT_EQ(expected[i].second, results->at(i)->first);
+            }
+        }
+
+        // Need to free up each result
+        for (auto it : *results) {
+            delete it;
+        }
+    }
+}
+
+TEST(FaissRangeSearchBinaryIndexTest, IntoArrays) {
+    faiss::idx_t numIds = 200;
+    int dim = 128;
+    std::vector<faiss::idx_t> ids = test_util::Range(numIds);
+    std::vector<uint8_t> vectors;
+    for (int64_t i = 0; i < numIds * dim / 8; ++i) {
+        vectors.push_back(test_util::RandomInt(0, 255));
+    }
+    std::vector<uint8_t> query;
+    for (int j = 0; j < dim / 8; ++j) {
+        query.push_back(test_util::RandomInt(0, 255));
+    }
+    float radius = 64;
+    int maxResultWindow = 10;
+
+    std::vector<std::pair<float, int64_t>> expected;
+    for (int64_t id = 0; id < numIds; id++) {
+        int distance = 0;
+        for (int j = 0; j < dim / 8; j++) {
+            distance += __builtin_popcount(vectors[id * dim / 8 + j] ^ query[j]);
+        }
+        if (distance < radius) {
+            expected.emplace_back(distance, id);
+        }
+    }
+    std::sort(expected.begin(), expected.end());
+    ASSERT_LT(maxResultWindow, expected.size());
+
+    NiceMock<JNIEnv> jniEnv;
+    NiceMock<test_util::MockJNIUtil> mockJNIUtil;
+
+    std::unique_ptr<faiss::IndexBinary> createdIndex(
+            test_util::FaissCreateBinaryIndex(dim, "BFlat"));
+    auto createdIndexWithData =
+            test_util::FaissAddBinaryData(createdIndex.get(), ids, vectors);
+
+    // Output arrays only hold half of the results
+    std::vector<int> resultIds(maxResultWindow / 2);
+    std::vector<float> resultDistances(maxResultWindow / 2);
+    EXPECT_CALL(mockJNIUtil,
+                GetJavaIntArrayLength(
+                        &jniEnv, reinterpret_cast<jintArray>(&resultIds)))
+            .WillRepeatedly(Return(resultIds.size()));
+
+    jint count = knn_jni::faiss_wrapper::RangeSearchBinaryWithFilterIntoArrays(
+            &mockJNIUtil, &jniEnv,
+            reinterpret_cast<jlong>(&createdIndexWithData),
+            reinterpret_cast<jbyteArray>(&query), radius, nullptr, maxResultWindow, nullptr, 0, nullptr,
+            reinterpret_cast<jintArray>(&resultIds), reinterpret_cast<jfloatArray>(&resultDistances));
+
+    // The full count is returned and the closest hits fill the arrays
+    ASSERT_EQ(maxResultWindow, count);
+    ASSERT_EQ(maxResultWindow / 2, resultIds.size());
+    for (int i = 0; i < resultIds.size(); i++) {
+        ASSERT_EQ(expected[i].second, resultIds[i]);
+        ASSERT_FLOAT_EQ(expected[i].first, resultDistances[i]);
+    }
+}
+
+TEST(FaissRangeSearchBinaryIndexTest, WithFilter) {
+    faiss::idx_t numIds = 200;
+    int dim = 128;
+    std::vector<faiss::idx_t> ids = test_util::Range(numIds);
+    std::vector<uint8_t> vectors;
+    for (int64_t i = 0; i < numIds * dim / 8; ++i) {
+        vectors.push_back(test_util::RandomInt(0, 255));
+    }
+    std::vector<uint8_t> query;
+    for (int j = 0; j < dim / 8; ++j) {
+        query.push_back(test_util::RandomInt(0, 255));
+    }
+
+    std::vector<int64_t> filterIds;
+    for (int64_t i = 0; i < numIds; i += 3) {
+        filterIds.push_back(i);
+    }
+    std::unordered_set<int> filterIdSet(filterIds.begin(), filterIds.end());
+
+    NiceMock<JNIEnv> jniEnv;
+    NiceMock<test_util::MockJNIUtil> mockJNIUtil;
+
+    for (std::string method : {"BFlat", "BHNSW32"}) {
+        std::unique_ptr<faiss::IndexBinary> createdIndex(
+                test_util::FaissCreateBinaryIndex(dim, method));
+        auto createdIndexWithData =
+                test_util::FaissAddBinaryData(createdIndex.get(), ids, vectors);
+
+        std::unique_ptr<std::vector<std::pair<int, float> *>> results(
+                reinterpret_cast<std::vector<std::pair<int, float> *> *>(
+                        knn_jni::faiss_wrapper::RangeSearchBinaryWithFilter(
+                                &mockJNIUtil, &jniEnv,
+                                reinterpret_cast<jlong>(&createdIndexWithData),
+                                reinterpret_cast<jbyteArray>(&query), 70, nullptr, 20000,
+                                reinterpret_cast<jlongArray>(&filterIds), 1, nullptr)));
+
+        ASSERT_NE(0, results->size());
+        for (const auto &result : *results) {
+            ASSERT_NE(filterIdSet.end(), filterIdSet.find(result->first));
+            ASSERT_LT(result->second, 70);
+        }
+
+        // Need to free up each result
+        for (auto it : *results) {
+            delete it;
+        }
+    }
+}
+
 TEST(FaissRangeSearchQueryIndexTestWithFilterTest, BasicAssertions) {
     // Define the index data
     faiss::idx_t numIds = 200;
@@ -1368,6 +2839,53 @@ TEST(FaissRangeSearchQueryIndexTestWithFilterTest, BasicAssertions) {
     }
 }
 
+TEST(FaissRangeSearchQueryIndexTestWithFilterTest, PinsQueryAndFilter) {
+    faiss::idx_t numIds = 200;
+    int dim = 2;
+    std::vector<faiss::idx_t> ids = test_util::Range(numIds);
+    std::vector<float> vectors = test_util::RandomVectors(dim, numIds, rangeSearchRandomDataMin, rangeSearchRandomDataMax);
+    std::vector<float> query(vectors.begin(), vectors.begin() + dim);
+
+    std::vector<jlong> bitmap(test_util::bits2words(numIds), 0);
+    for (int64_t i = 0; i < numIds; i += 2) {
+        test_util::setBitSet(i, bitmap.data(), bitmap.size());
+    }
+
+    std::unique_ptr<faiss::Index> createdIndex(
+            test_util::FaissCreateIndex(dim, "HNSW32,Flat", faiss::METRIC_L2));
+    auto createdIndexWithData =
+            test_util::FaissAddData(createdIndex.get(), ids, vectors);
+
+    // A range search is capped by its result window, so it reads the query and the filter in place
+    NiceMock<JNIEnv> jniEnv;
+    NiceMock<test_util::MockJNIUtil> mockJNIUtil;
+    EXPECT_CALL(mockJNIUtil, GetFloatArrayRegion(_, _, _, _, _)).Times(0);
+    EXPECT_CALL(mockJNIUtil, GetLongArrayRegion(_, _, _, _, _)).Times(0);
+    EXPECT_CALL(mockJNIUtil, GetPrimitiveArrayCritical(_, reinterpret_cast<jarray>(&bitmap), _)).Times(1);
+    EXPECT_CALL(mockJNIUtil, GetPrimitiveArrayCritical(_, reinterpret_cast<jarray>(&query), _)).Times(1);
+    EXPECT_CALL(mockJNIUtil, ReleasePrimitiveArrayCritical(_, _, _, JNI_ABORT)).Times(2);
+
+    std::unique_ptr<std::vector<std::pair<int, float> *>> results(
+            reinterpret_cast<std::vector<std::pair<int, float> *> *>(
+                    knn_jni::faiss_wrapper::RangeSearchWithFilter(
+                            &mockJNIUtil, &jniEnv,
+                            reinterpret_cast<jlong>(&createdIndexWithData),
+                            reinterpret_cast<jfloatArray>(&query), rangeSearchRadius, nullptr, 20000,
+                            reinterpret_cast<jlongArray>(&bitmap), 0, nullptr)));
+
+    // The query is the vector of doc 0, which passes the filter
+    ASSERT_NE(0, results->size());
+    ASSERT_EQ(0, results->at(0)->first);
+    for (const auto& pairPtr : *results) {
+        ASSERT_EQ(0, pairPtr->first % 2);
+    }
+
+    // Need to free up each result
+    for (auto it : *results) {
+        delete it;
+    }
+}
+
 TEST(FaissRangeSearchQueryIndexTestWithParentFilterTest, BasicAssertions) {
     // Define the index data
     faiss::idx_t numIds = 100;
@@ -194,12 +194,9 @@ namespace query_index_test {
             methodParams[knn_jni::EF_SEARCH] = reinterpret_cast<jobject>(&efSearch);
         }
 
+        std::vector<int> parentId = {1, 2};
         std::vector<int> *parentIdPtr = nullptr;
         if (input.parentIdsPresent) {
-            std::vector<int> parentId;
-            parentId.reserve(2);
-            parentId.push_back(1);
-            parentId.push_back(2);
             parentIdPtr = &parentId;
 
             EXPECT_CALL(mockJNIUtil,
@@ -207,10 +204,11 @@ namespace query_index_test {
                             jniEnv, reinterpret_cast<jintArray>(parentIdPtr)))
                     .WillOnce(testing::Return(parentId.size()));
 
+            // The parent ids are read in full to match them against the cached grouper
             EXPECT_CALL(mockJNIUtil,
-                        GetIntArrayElements(
-                            jniEnv, reinterpret_cast<jintArray>(parentIdPtr), nullptr))
-                    .WillOnce(testing::Return(new int[2]{1, 2}));
+                        GetIntArrayRegion(
+                            jniEnv, reinterpret_cast<jintArray>(parentIdPtr), 0, parentId.size(), testing::_))
+                    .Times(1);
         }
 
         // When
@@ -254,12 +252,9 @@ namespace query_index_with_filter_test {
         QueryIndexInput const &input = GetParam();
         float query[] = {1.2, 2.3, 3.4};
 
+        std::vector<int> parentId = {1, 2};
         std::vector<int> *parentIdPtr = nullptr;
         if (input.parentIdsPresent) {
-            std::vector<int> parentId;
-            parentId.reserve(2);
-            parentId.push_back(1);
-            parentId.push_back(2);
             parentIdPtr = &parentId;
 
             EXPECT_CALL(mockJNIUtil,
@@ -267,18 +262,20 @@ namespace query_index_with_filter_test {
                             jniEnv, reinterpret_cast<jintArray>(parentIdPtr)))
                     .WillOnce(testing::Return(parentId.size()));
 
+            // The parent ids are read in full to match them against the cached grouper
             EXPECT_CALL(mockJNIUtil,
-                        GetIntArrayElements(
-                            jniEnv, reinterpret_cast<jintArray>(parentIdPtr), nullptr))
-                    .WillOnce(testing::Return(new int[2]{1, 2}));
+                        GetIntArrayRegion(
+                            jniEnv, reinterpret_cast<jintArray>(parentIdPtr), 0, parentId.size(), testing::_))
+                    .Times(1);
         }
 
+        // The filter selects more docs than k, so it is not brute forced
+        std::vector<long> filter;
         std::vector<long> *filterptr = nullptr;
         if (input.filterIdsPresent) {
-            std::vector<long> filter;
-            filter.reserve(2);
-            filter.push_back(1);
-            filter.push_back(2);
+            for (long id = 1; id <= 2 * input.k; id++) {
+                filter.push_back(id);
+            }
             filterptr = &filter;
         }
 
@@ -354,12 +351,9 @@ namespace range_search_test {
             methodParams[knn_jni::EF_SEARCH] = reinterpret_cast<jobject>(&efSearch);
         }
 
+        std::vector<int> parentId = {1, 2};
         std::vector<int> *parentIdPtr = nullptr;
         if (input.parentIdsPresent) {
-            std::vector<int> parentId;
-            parentId.reserve(2);
-            parentId.push_back(1);
-            parentId.push_back(2);
             parentIdPtr = &parentId;
 
             EXPECT_CALL(mockJNIUtil,
@@ -367,10 +361,11 @@ namespace range_search_test {
                             jniEnv, reinterpret_cast<jintArray>(parentIdPtr)))
                     .WillOnce(testing::Return(parentId.size()));
 
+            // The parent ids are read in full to match them against the cached grouper
             EXPECT_CALL(mockJNIUtil,
-                        GetIntArrayElements(
-                            jniEnv, reinterpret_cast<jintArray>(parentIdPtr), nullptr))
-                    .WillOnce(testing::Return(new int[2]{1, 2}));
+                        GetIntArrayRegion(
+                            jniEnv, reinterpret_cast<jintArray>(parentIdPtr), 0, parentId.size(), testing::_))
+                    .Times(1);
         }
 
         std::vector<long> filter;
@@ -0,0 +1,113 @@
+// SPDX-License-Identifier: Apache-2.0
+//
+// The OpenSearch Contributors require contributions made to
+// this file be licensed under the Apache-2.0 license or a
+// compatible open source license.
+//
+// Modifications Copyright OpenSearch Contributors. See
+// GitHub history for details.
+
+#include "native_thread_pool.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+TEST(NativeThreadPoolTest, RunsEveryTaskOnce) {
+    knn_jni::NativeThreadPool pool(3);
+    std::vector<std::atomic<int>> runs(100);
+    pool.parallelFor(100, 4, [&](int i) { runs[i]++; });
+    for (auto &run : runs) {
+        ASSERT_EQ(1, run.load());
+    }
+}
+
+TEST(NativeThreadPoolTest, BoundsParallelism) {
+    knn_jni::NativeThreadPool pool(4);
+    std::atomic<int> running(0);
+    std::atomic<int> maxRunning(0);
+    pool.parallelFor(32, 2, [&](int) {
+        int current = ++running;
+        int observed = maxRunning.load();
+        while (current > observed && !maxRunning.compare_exchange_weak(observed, current)) {}
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        running--;
+    });
+    ASSERT_LE(maxRunning.load(), 2);
+}
+
+TEST(NativeThreadPoolTest, RunsOnCallerWithoutThreads) {
+    knn_jni::NativeThreadPool pool(0);
+    const auto caller = std::this_thread::get_id();
+    std::set<std::thread::id> threads;
+    pool.parallelFor(8, 4, [&](int) { threads.insert(std::this_thread::get_id()); });
+    ASSERT_EQ(1, threads.size());
+    ASSERT_EQ(caller, *threads.begin());
+}
+
+TEST(NativeThreadPoolTest, RethrowsTaskException) {
+    knn_jni::NativeThreadPool pool(2);
+    std::atomic<int> runs(0);
+    ASSERT_THROW(pool.parallelFor(16, 3, [&](int i) {
+        runs++;
+        if (i == 5) {
+            throw std::runtime_error("task failed");
+        }
+    }), std::runtime_error);
+    ASSERT_EQ(16, runs.load());
+
+    // The pool keeps serving after a failed call
+    std::atomic<int> laterRuns(0);
+    pool.parallelFor(4, 3, [&](int) { laterRuns++; });
+    ASSERT_EQ(4, laterRuns.load());
+}
+
+TEST(NativeThreadPoolTest, RunsSubmittedJobs) {
+    knn_jni::NativeThreadPool pool(3);
+    std::mutex mutex;
+    std::condition_variable allDone;
+    int done = 0;
+    for (int i = 0; i < 50; i++) {
+        pool.submit([&]() {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (++done == 50) {
+                allDone.notify_all();
+            }
+        });
+    }
+    std::unique_lock<std::mutex> lock(mutex);
+    ASSERT_TRUE(allDone.wait_for(lock, std::chrono::seconds(10), [&]() { return done == 50; }));
+}
+
+TEST(NativeThreadPoolTest, IdleThreadsStealQueuedJobs) {
+    knn_jni::NativeThreadPool pool(2);
+    // The first job holds its thread until the second one, queued for the same thread, has run elsewhere
+    std::atomic<bool> secondRan(false);
+    std::atomic<bool> firstDone(false);
+    pool.submit([&]() {
+        for (int i = 0; i < 10000 && !secondRan; i++) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        firstDone = true;
+    });
+    pool.submit([]() {});
+    pool.submit([&]() { secondRan = true; });
+    while (!firstDone) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    ASSERT_TRUE(secondRan.load());
+}
+
+TEST(NativeThreadPoolTest, SubmitRunsInlineWithoutThreads) {
+    knn_jni::NativeThreadPool pool(0);
+    bool ran = false;
+    pool.submit([&]() { ran = true; });
+    ASSERT_TRUE(ran);
+}
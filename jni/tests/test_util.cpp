@@ -13,6 +13,7 @@
 
 #include <jni.h>
 
+#include <algorithm>
 #include <random>
 #include <utility>
 
@@ -154,6 +155,15 @@ test_util::MockJNIUtil::MockJNIUtil() {
                         reinterpret_cast<std::vector<float> *>(arrayJ)->data());
             });
 
+    // array is re-interpreted as a std::vector<uint8_t> * and its data is
+    // returned. Only the data pointer is read, so this works for a vector of
+    // any element type
+    ON_CALL(*this, GetPrimitiveArrayCritical)
+            .WillByDefault([this](JNIEnv *env, jarray array, jboolean *isCopy) {
+                return reinterpret_cast<void *>(
+                        reinterpret_cast<std::vector<uint8_t> *>(array)->data());
+            });
+
     // array2dJ is re-interpreted as a std::vector<std::vector<float>> * and then
     // the size of the first element is returned
     ON_CALL(*this, GetInnerDimensionOf2dJavaFloatArray)
@@ -244,6 +254,11 @@ test_util::MockJNIUtil::MockJNIUtil() {
             .WillByDefault(
                     [this](JNIEnv *env, jlongArray array, jlong *elems, int mode) {});
 
+    // This function should not do anything meaningful in the unit tests
+    ON_CALL(*this, ReleasePrimitiveArrayCritical)
+            .WillByDefault(
+                    [this](JNIEnv *env, jarray array, void *carray, jint mode) {});
+
     // array is re-interpreted as a std::vector<uint8_t> * and then the bytes from
     // buf are copied to it
     ON_CALL(*this, SetByteArrayRegion)
@@ -255,6 +270,66 @@ test_util::MockJNIUtil::MockJNIUtil() {
                 }
             });
 
+    // array is re-interpreted as a std::vector<int> * and the values from buf
+    // are copied into [start, start + len)
+    ON_CALL(*this, SetIntArrayRegion)
+            .WillByDefault([this](JNIEnv *env, jintArray array, jsize start,
+                                  jsize len, const jint *buf) {
+                auto intBuffer = reinterpret_cast<std::vector<int> *>(array);
+                if (intBuffer->size() < static_cast<size_t>(start + len)) {
+                    intBuffer->resize(start + len);
+                }
+                std::copy(buf, buf + len, intBuffer->begin() + start);
+            });
+
+    // array is re-interpreted as a std::vector<float> * and the values from
+    // buf are copied into [start, start + len)
+    ON_CALL(*this, SetFloatArrayRegion)
+            .WillByDefault([this](JNIEnv *env, jfloatArray array, jsize start,
+                                  jsize len, const jfloat *buf) {
+                auto floatBuffer = reinterpret_cast<std::vector<float> *>(array);
+                if (floatBuffer->size() < static_cast<size_t>(start + len)) {
+                    floatBuffer->resize(start + len);
+                }
+                std::copy(buf, buf + len, floatBuffer->begin() + start);
+            });
+
+    // array is re-interpreted as a std::vector<int> * and [start, start + len)
+    // is copied into buf
+    ON_CALL(*this, GetIntArrayRegion)
+            .WillByDefault([this](JNIEnv *env, jintArray array, jsize start,
+                                  jsize len, jint *buf) {
+                auto intBuffer = reinterpret_cast<std::vector<int> *>(array);
+                std::copy(intBuffer->begin() + start, intBuffer->begin() + start + len, buf);
+            });
+
+    // array is re-interpreted as a std::vector<uint8_t> * and [start, start + len)
+    // is copied into buf
+    ON_CALL(*this, GetByteArrayRegion)
+            .WillByDefault([this](JNIEnv *env, jbyteArray array, jsize start,
+                                  jsize len, jbyte *buf) {
+                auto byteBuffer = reinterpret_cast<std::vector<uint8_t> *>(array);
+                std::copy(byteBuffer->begin() + start, byteBuffer->begin() + start + len, buf);
+            });
+
+    // array is re-interpreted as a std::vector<float> * and [start, start + len)
+    // is copied into buf
+    ON_CALL(*this, GetFloatArrayRegion)
+            .WillByDefault([this](JNIEnv *env, jfloatArray array, jsize start,
+                                  jsize len, jfloat *buf) {
+                auto floatBuffer = reinterpret_cast<std::vector<float> *>(array);
+                std::copy(floatBuffer->begin() + start, floatBuffer->begin() + start + len, buf);
+            });
+
+    // array is re-interpreted as a std::vector<int64_t> * and [start, start + len)
+    // is copied into buf
+    ON_CALL(*this, GetLongArrayRegion)
+            .WillByDefault([this](JNIEnv *env, jlongArray array, jsize start,
+                                  jsize len, jlong *buf) {
+                auto longBuffer = reinterpret_cast<std::vector<int64_t> *>(array);
+                std::copy(longBuffer->begin() + start, longBuffer->begin() + start + len, buf);
+            });
+
     // array is re-interpreted as a std::vector<std::pair<int, float> *> * and
     // then val is re-interpreted as a std::pair<int, float> * and added to the
     // vector
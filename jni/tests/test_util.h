@@ -103,6 +103,24 @@ namespace test_util {
         MOCK_METHOD(void, SetByteArrayRegion,
                     (JNIEnv * env, jbyteArray array, jsize start, jsize len,
                             const jbyte* buf));
+        MOCK_METHOD(void, SetIntArrayRegion,
+                    (JNIEnv * env, jintArray array, jsize start, jsize len,
+                            const jint* buf));
+        MOCK_METHOD(void, SetFloatArrayRegion,
+                    (JNIEnv * env, jfloatArray array, jsize start, jsize len,
+                            const jfloat* buf));
+        MOCK_METHOD(void, GetIntArrayRegion,
+                    (JNIEnv * env, jintArray array, jsize start, jsize len,
+                            jint* buf));
+        MOCK_METHOD(void, GetByteArrayRegion,
+                    (JNIEnv * env, jbyteArray array, jsize start, jsize len,
+                            jbyte* buf));
+        MOCK_METHOD(void, GetFloatArrayRegion,
+                    (JNIEnv * env, jfloatArray array, jsize start, jsize len,
+                            jfloat* buf));
+        MOCK_METHOD(void, GetLongArrayRegion,
+                    (JNIEnv * env, jlongArray array, jsize start, jsize len,
+                            jlong* buf));
         MOCK_METHOD(void, SetObjectArrayElement,
                     (JNIEnv * env, jobjectArray array, jsize index, jobject val));
         MOCK_METHOD(void, ThrowJavaException,
@@ -88,6 +88,8 @@ public class KNNSettings {
     public static final String KNN_MEMORY_CIRCUIT_BREAKER_CLUSTER_LIMIT = "knn.memory.circuit_breaker.limit";
     public static final String KNN_MEMORY_CIRCUIT_BREAKER_LIMIT_PREFIX = KNN_MEMORY_CIRCUIT_BREAKER_CLUSTER_LIMIT + ".";
     public static final String KNN_VECTOR_STREAMING_MEMORY_LIMIT_IN_MB = "knn.vector_streaming_memory.limit";
+    public static final String KNN_VECTOR_STREAMING_PIPELINED_INGESTION_ENABLED = "knn.vector_streaming.pipelined_ingestion.enabled";
+    public static final String KNN_FAISS_MMAP_LOAD_ENABLED = "knn.faiss.mmap_load.enabled";
     public static final String KNN_CIRCUIT_BREAKER_TRIGGERED = "knn.circuit_breaker.triggered";
     public static final String KNN_CACHE_ITEM_EXPIRY_ENABLED = "knn.cache.item.expiry.enabled";
     public static final String KNN_CACHE_ITEM_EXPIRY_TIME_MINUTES = "knn.cache.item.expiry.minutes";
@@ -102,6 +104,8 @@ public class KNNSettings {
     public static final String QUANTIZATION_STATE_CACHE_EXPIRY_TIME_MINUTES = "knn.quantization.cache.expiry.minutes";
     public static final String KNN_FAISS_AVX512_DISABLED = "knn.faiss.avx512.disabled";
     public static final String KNN_FAISS_AVX512_SPR_DISABLED = "knn.faiss.avx512_spr.disabled";
+    public static final String KNN_NATIVE_SEARCH_THREAD_POOL_SIZE = "knn.native_search.thread_pool.size";
+    public static final String KNN_NATIVE_SEARCH_THREAD_PINNING_ENABLED = "knn.native_search.thread_pool.pinning.enabled";
     public static final String KNN_DISK_VECTOR_SHARD_LEVEL_RESCORING_DISABLED = "index.knn.disk.vector.shard_level_rescoring_disabled";
     public static final String KNN_DERIVED_SOURCE_ENABLED = "index.knn.derived_source.enabled";
     // Remote index build index settings
@@ -128,6 +132,9 @@ public class KNNSettings {
      *
      */
     public static final boolean KNN_DEFAULT_FAISS_AVX2_DISABLED_VALUE = false;
+    // 0 sizes the native search thread pool to one thread less than the number of cores
+    public static final int KNN_DEFAULT_NATIVE_SEARCH_THREAD_POOL_SIZE = 0;
+    public static final boolean KNN_DEFAULT_NATIVE_SEARCH_THREAD_PINNING_ENABLED = false;
     public static final boolean KNN_DEFAULT_FAISS_AVX512_DISABLED_VALUE = false;
     public static final boolean KNN_DEFAULT_FAISS_AVX512_SPR_DISABLED_VALUE = false;
     public static final String INDEX_KNN_DEFAULT_SPACE_TYPE = "l2";
@@ -144,6 +151,8 @@ public class KNNSettings {
     public static final Integer KNN_MAX_MODEL_CACHE_SIZE_LIMIT_PERCENTAGE = 25; // Model cache limit cannot exceed 25% of the JVM heap
     public static final String KNN_DEFAULT_MEMORY_CIRCUIT_BREAKER_LIMIT = "50%";
     public static final String KNN_DEFAULT_VECTOR_STREAMING_MEMORY_LIMIT_PCT = "1%";
+    public static final boolean KNN_DEFAULT_VECTOR_STREAMING_PIPELINED_INGESTION_ENABLED = false;
+    public static final boolean KNN_DEFAULT_FAISS_MMAP_LOAD_ENABLED = false;
 
     public static final Integer ADVANCED_FILTERED_EXACT_SEARCH_THRESHOLD_DEFAULT_VALUE = -1;
     public static final Integer KNN_DEFAULT_QUANTIZATION_STATE_CACHE_SIZE_LIMIT_PERCENTAGE = 5; // By default, set aside 5% of the JVM for
@@ -192,6 +201,29 @@ public class KNNSettings {
         Setting.Property.NodeScope
     );
 
+    /**
+     * When enabled, vectors are streamed to the native index through two buffers, so the next batch is transferred while
+     * the previous one is added. This doubles the off-heap memory used by the transfer.
+     */
+    public static final Setting<Boolean> KNN_VECTOR_STREAMING_PIPELINED_INGESTION_ENABLED_SETTING = Setting.boolSetting(
+        KNN_VECTOR_STREAMING_PIPELINED_INGESTION_ENABLED,
+        KNN_DEFAULT_VECTOR_STREAMING_PIPELINED_INGESTION_ENABLED,
+        Setting.Property.Dynamic,
+        Setting.Property.NodeScope
+    );
+
+    /**
+     * When enabled, faiss indices stored on a local filesystem are loaded by mapping their file, so their vectors and
+     * graph are read from the page cache instead of being copied into native memory. Indices in compound files are
+     * still copied.
+     */
+    public static final Setting<Boolean> KNN_FAISS_MMAP_LOAD_ENABLED_SETTING = Setting.boolSetting(
+        KNN_FAISS_MMAP_LOAD_ENABLED,
+        KNN_DEFAULT_FAISS_MMAP_LOAD_ENABLED,
+        Setting.Property.Dynamic,
+        Setting.Property.NodeScope
+    );
+
     /**
      * build_vector_data_structure_threshold - This parameter determines when to build vector data structure for knn fields during indexing
      * and merging. Setting -1 (min) will skip building graph, whereas on any other values, the graph will be built if
@@ -407,6 +439,22 @@ public class KNNSettings {
         NodeScope
     );
 
+    /*
+     * Native search thread pool settings. The pool is started when the faiss library is loaded, so they are static.
+     */
+    public static final Setting<Integer> KNN_NATIVE_SEARCH_THREAD_POOL_SIZE_SETTING = Setting.intSetting(
+        KNN_NATIVE_SEARCH_THREAD_POOL_SIZE,
+        KNN_DEFAULT_NATIVE_SEARCH_THREAD_POOL_SIZE,
+        0,
+        NodeScope
+    );
+
+    public static final Setting<Boolean> KNN_NATIVE_SEARCH_THREAD_PINNING_ENABLED_SETTING = Setting.boolSetting(
+        KNN_NATIVE_SEARCH_THREAD_PINNING_ENABLED,
+        KNN_DEFAULT_NATIVE_SEARCH_THREAD_PINNING_ENABLED,
+        NodeScope
+    );
+
     /**
      * Cluster level setting to control whether remote index build is enabled or not.
      */
@@ -655,10 +703,26 @@ public class KNNSettings {
             return KNN_FAISS_AVX512_SPR_DISABLED_SETTING;
         }
 
+        if (KNN_NATIVE_SEARCH_THREAD_POOL_SIZE.equals(key)) {
+            return KNN_NATIVE_SEARCH_THREAD_POOL_SIZE_SETTING;
+        }
+
+        if (KNN_NATIVE_SEARCH_THREAD_PINNING_ENABLED.equals(key)) {
+            return KNN_NATIVE_SEARCH_THREAD_PINNING_ENABLED_SETTING;
+        }
+
         if (KNN_VECTOR_STREAMING_MEMORY_LIMIT_IN_MB.equals(key)) {
             return KNN_VECTOR_STREAMING_MEMORY_LIMIT_PCT_SETTING;
         }
 
+        if (KNN_VECTOR_STREAMING_PIPELINED_INGESTION_ENABLED.equals(key)) {
+            return KNN_VECTOR_STREAMING_PIPELINED_INGESTION_ENABLED_SETTING;
+        }
+
+        if (KNN_FAISS_MMAP_LOAD_ENABLED.equals(key)) {
+            return KNN_FAISS_MMAP_LOAD_ENABLED_SETTING;
+        }
+
         if (QUANTIZATION_STATE_CACHE_SIZE_LIMIT.equals(key)) {
             return QUANTIZATION_STATE_CACHE_SIZE_LIMIT_SETTING;
         }
@@ -731,8 +795,12 @@ public class KNNSettings {
             ADVANCED_FILTERED_EXACT_SEARCH_THRESHOLD_SETTING,
             KNN_FAISS_AVX2_DISABLED_SETTING,
             KNN_VECTOR_STREAMING_MEMORY_LIMIT_PCT_SETTING,
+            KNN_VECTOR_STREAMING_PIPELINED_INGESTION_ENABLED_SETTING,
+            KNN_FAISS_MMAP_LOAD_ENABLED_SETTING,
             KNN_FAISS_AVX512_DISABLED_SETTING,
             KNN_FAISS_AVX512_SPR_DISABLED_SETTING,
+            KNN_NATIVE_SEARCH_THREAD_POOL_SIZE_SETTING,
+            KNN_NATIVE_SEARCH_THREAD_PINNING_ENABLED_SETTING,
             QUANTIZATION_STATE_CACHE_SIZE_LIMIT_SETTING,
             QUANTIZATION_STATE_CACHE_EXPIRY_TIME_MINUTES_SETTING,
             KNN_DISK_VECTOR_SHARD_LEVEL_RESCORING_DISABLED_SETTING,
@@ -910,6 +978,35 @@ public class KNNSettings {
         }
     }
 
+    public static int getNativeSearchThreadPoolSize() {
+        try {
+            return KNNSettings.state().getSettingValue(KNNSettings.KNN_NATIVE_SEARCH_THREAD_POOL_SIZE);
+        } catch (Exception e) {
+            // The faiss library may be loaded before the settings are, like in UTs. Fall back to the default then.
+            log.warn(
+                "Unable to get setting value {} from cluster settings. Using default value as {}",
+                KNN_NATIVE_SEARCH_THREAD_POOL_SIZE,
+                KNN_DEFAULT_NATIVE_SEARCH_THREAD_POOL_SIZE,
+                e
+            );
+            return KNN_DEFAULT_NATIVE_SEARCH_THREAD_POOL_SIZE;
+        }
+    }
+
+    public static boolean isNativeSearchThreadPinningEnabled() {
+        try {
+            return KNNSettings.state().getSettingValue(KNNSettings.KNN_NATIVE_SEARCH_THREAD_PINNING_ENABLED);
+        } catch (Exception e) {
+            log.warn(
+                "Unable to get setting value {} from cluster settings. Using default value as {}",
+                KNN_NATIVE_SEARCH_THREAD_PINNING_ENABLED,
+                KNN_DEFAULT_NATIVE_SEARCH_THREAD_PINNING_ENABLED,
+                e
+            );
+            return KNN_DEFAULT_NATIVE_SEARCH_THREAD_PINNING_ENABLED;
+        }
+    }
+
     /**
      * check this index enabled/disabled derived source
      * @param settings Settings
@@ -1015,6 +1112,34 @@ public class KNNSettings {
         return KNNSettings.state().getSettingValue(KNN_VECTOR_STREAMING_MEMORY_LIMIT_IN_MB);
     }
 
+    public static boolean isPipelinedIngestionEnabled() {
+        try {
+            return KNNSettings.state().getSettingValue(KNN_VECTOR_STREAMING_PIPELINED_INGESTION_ENABLED);
+        } catch (Exception e) {
+            log.warn(
+                "Unable to get setting value {} from cluster settings. Using default value as {}",
+                KNN_VECTOR_STREAMING_PIPELINED_INGESTION_ENABLED,
+                KNN_DEFAULT_VECTOR_STREAMING_PIPELINED_INGESTION_ENABLED,
+                e
+            );
+            return KNN_DEFAULT_VECTOR_STREAMING_PIPELINED_INGESTION_ENABLED;
+        }
+    }
+
+    public static boolean isFaissMmapLoadEnabled() {
+        try {
+            return KNNSettings.state().getSettingValue(KNN_FAISS_MMAP_LOAD_ENABLED);
+        } catch (Exception e) {
+            log.warn(
+                "Unable to get setting value {} from cluster settings. Using default value as {}",
+                KNN_FAISS_MMAP_LOAD_ENABLED,
+                KNN_DEFAULT_FAISS_MMAP_LOAD_ENABLED,
+                e
+            );
+            return KNN_DEFAULT_FAISS_MMAP_LOAD_ENABLED;
+        }
+    }
+
     /**
      *
      * @param index Name of the index
@@ -164,6 +164,14 @@ public enum SpaceType {
             return 1 / (1 + rawScore);
         }
 
+        @Override
+        public float scoreToDistanceTranslation(float score) {
+            if (score == 0) {
+                throw new IllegalArgumentException(String.format(Locale.ROOT, "score cannot be 0 when space type is [%s]", getValue()));
+            }
+            return 1 / score - 1;
+        }
+
         @Override
         public void validateVectorDataType(VectorDataType vectorDataType) {
             if (VectorDataType.BINARY != vectorDataType) {
@@ -13,19 +13,26 @@ package org.opensearch.knn.index.codec.KNN990Codec;
 
 import lombok.extern.log4j.Log4j2;
 import org.apache.lucene.codecs.KnnFieldVectorsWriter;
+import org.apache.lucene.codecs.KnnVectorsReader;
 import org.apache.lucene.codecs.KnnVectorsWriter;
 import org.apache.lucene.codecs.hnsw.FlatVectorsWriter;
+import org.apache.lucene.codecs.perfield.PerFieldKnnVectorsFormat;
 import org.apache.lucene.index.FieldInfo;
 import org.apache.lucene.index.MergeState;
+import org.apache.lucene.index.SegmentReadState;
 import org.apache.lucene.index.SegmentWriteState;
 import org.apache.lucene.index.Sorter;
 import org.apache.lucene.search.DocIdSetIterator;
+import org.apache.lucene.util.FixedBitSet;
 import org.apache.lucene.util.IOUtils;
 import org.apache.lucene.util.RamUsageEstimator;
 import org.opensearch.common.StopWatch;
 import org.opensearch.knn.index.VectorDataType;
 import org.opensearch.knn.index.codec.nativeindex.NativeIndexBuildStrategyFactory;
 import org.opensearch.knn.index.codec.nativeindex.NativeIndexWriter;
+import org.opensearch.knn.index.codec.nativeindex.model.MergeGraphSource;
+import org.opensearch.knn.index.codec.util.KNNCodecUtil;
+import org.opensearch.knn.index.engine.KNNEngine;
 import org.opensearch.knn.index.quantizationservice.QuantizationService;
 import org.opensearch.knn.index.vectorvalues.KNNVectorValues;
 import org.opensearch.knn.plugin.stats.KNNGraphValue;
@@ -35,9 +42,13 @@ import org.opensearch.knn.quantization.models.quantizationState.QuantizationStat
 import java.io.IOException;
 import java.util.ArrayList;
 import java.util.List;
+import java.util.Objects;
 import java.util.function.Supplier;
 
+import static org.opensearch.knn.common.FieldInfoExtractor.extractKNNEngine;
 import static org.opensearch.knn.common.FieldInfoExtractor.extractVectorDataType;
+import static org.opensearch.knn.common.KNNConstants.MODEL_ID;
+import static org.opensearch.knn.common.KNNConstants.PARAMETERS;
 import static org.opensearch.knn.index.vectorvalues.KNNVectorValuesFactory.getKNNVectorValuesSupplierForMerge;
 import static org.opensearch.knn.index.vectorvalues.KNNVectorValuesFactory.getVectorValuesSupplier;
 
@@ -169,7 +180,7 @@ public class NativeEngines990KnnVectorsWriter extends KnnVectorsWriter {
 
         StopWatch stopWatch = new StopWatch().start();
 
-        writer.mergeIndex(knnVectorValuesSupplier, totalLiveDocs);
+        writer.mergeIndex(knnVectorValuesSupplier, totalLiveDocs, findMergeGraphSource(fieldInfo, mergeState, quantizationState));
 
         long time_in_millis = stopWatch.stop().totalTime().millis();
         KNNGraphValue.MERGE_TOTAL_TIME_IN_MILLIS.incrementBy(time_in_millis);
@@ -265,6 +276,70 @@ public class NativeEngines990KnnVectorsWriter extends KnnVectorsWriter {
         }
     }
 
+    /**
+     * Finds the merged segment with the most docs whose faiss index for the field can be carried over to the merged
+     * segment, so that only the vectors of the other segments have to be added to it.
+     *
+     * @return the index to start from, or null when the merged index has to be built from scratch
+     */
+    private static MergeGraphSource findMergeGraphSource(
+        final FieldInfo fieldInfo,
+        final MergeState mergeState,
+        final QuantizationState quantizationState
+    ) {
+        if (quantizationState != null
+            || fieldInfo.attributes().containsKey(MODEL_ID)
+            || extractKNNEngine(fieldInfo) != KNNEngine.FAISS
+            || mergeState.knnVectorsReaders == null) {
+            return null;
+        }
+
+        int source = -1;
+        SegmentReadState sourceState = null;
+        String sourceFileName = null;
+        for (int i = 0; i < mergeState.knnVectorsReaders.length; i++) {
+            KnnVectorsReader reader = mergeState.knnVectorsReaders[i];
+            if (reader instanceof PerFieldKnnVectorsFormat.FieldsReader fieldsReader) {
+                reader = fieldsReader.getFieldReader(fieldInfo.name);
+            }
+            if (reader instanceof NativeEngines990KnnVectorsReader == false) {
+                continue;
+            }
+            final SegmentReadState readState = ((NativeEngines990KnnVectorsReader) reader).getSegmentReadState();
+            final FieldInfo sourceFieldInfo = readState.fieldInfos.fieldInfo(fieldInfo.name);
+            // The source index has to be built the same way as the merged one
+            if (sourceFieldInfo == null
+                || extractKNNEngine(sourceFieldInfo) != KNNEngine.FAISS
+                || Objects.equals(sourceFieldInfo.getAttribute(PARAMETERS), fieldInfo.getAttribute(PARAMETERS)) == false) {
+                continue;
+            }
+            final String fileName = KNNCodecUtil.getNativeEngineFileFromFieldInfo(sourceFieldInfo, readState.segmentInfo);
+            if (fileName != null && (source == -1 || mergeState.maxDocs[i] > mergeState.maxDocs[source])) {
+                source = i;
+                sourceState = readState;
+                sourceFileName = fileName;
+            }
+        }
+        if (source == -1) {
+            return null;
+        }
+
+        final int[] docMap = new int[mergeState.maxDocs[source]];
+        final FixedBitSet carriedOverDocs = new FixedBitSet(mergeState.segmentInfo.maxDoc());
+        for (int docId = 0; docId < docMap.length; docId++) {
+            docMap[docId] = mergeState.docMaps[source].get(docId);
+            if (docMap[docId] >= 0) {
+                carriedOverDocs.set(docMap[docId]);
+            }
+        }
+        return MergeGraphSource.builder()
+            .directory(sourceState.directory)
+            .fileName(sourceFileName)
+            .docMap(docMap)
+            .carriedOverDocs(carriedOverDocs)
+            .build();
+    }
+
     private boolean shouldSkipBuildingVectorDataStructure(final long docCount) {
         if (approximateThreshold < 0) {
             return true;
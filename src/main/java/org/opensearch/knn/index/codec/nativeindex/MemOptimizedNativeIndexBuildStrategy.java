@@ -7,9 +7,16 @@ package org.opensearch.knn.index.codec.nativeindex;
 
 import lombok.AccessLevel;
 import lombok.NoArgsConstructor;
+import org.apache.lucene.store.IOContext;
+import org.apache.lucene.store.IndexInput;
+import org.apache.lucene.util.FixedBitSet;
+import org.opensearch.common.Nullable;
+import org.opensearch.knn.index.KNNSettings;
 import org.opensearch.knn.index.codec.nativeindex.model.BuildIndexParams;
+import org.opensearch.knn.index.codec.nativeindex.model.MergeGraphSource;
 import org.opensearch.knn.index.codec.transfer.OffHeapVectorTransfer;
 import org.opensearch.knn.index.engine.KNNEngine;
+import org.opensearch.knn.index.store.IndexInputWithBuffer;
 import org.opensearch.knn.index.vectorvalues.KNNVectorValues;
 import org.opensearch.knn.jni.JNIService;
 
@@ -58,15 +65,24 @@ final class MemOptimizedNativeIndexBuildStrategy implements NativeIndexBuildStra
         Map<String, Object> indexParameters = indexInfo.getParameters();
         IndexBuildSetup indexBuildSetup = QuantizationIndexUtils.prepareIndexBuild(knnVectorValues, indexInfo);
 
-        // Initialize the index
-        long indexMemoryAddress = AccessController.doPrivileged(
-            (PrivilegedAction<Long>) () -> JNIService.initIndex(
-                indexInfo.getTotalLiveDocs(),
-                indexBuildSetup.getDimensions(),
-                indexParameters,
-                engine
-            )
-        );
+        // Start from the index of one of the merged segments when it can be carried over, otherwise initialize the index
+        final long loadedIndexAddress = loadIndexForMerge(indexInfo);
+        final FixedBitSet carriedOverDocs = loadedIndexAddress == 0 ? null : indexInfo.getMergeGraphSource().getCarriedOverDocs();
+        final long indexMemoryAddress = loadedIndexAddress != 0
+            ? loadedIndexAddress
+            : AccessController.doPrivileged(
+                (PrivilegedAction<Long>) () -> JNIService.initIndex(
+                    indexInfo.getTotalLiveDocs(),
+                    indexBuildSetup.getDimensions(),
+                    indexParameters,
+                    engine
+                )
+            );
+
+        if (engine == KNNEngine.FAISS && KNNSettings.isPipelinedIngestionEnabled()) {
+            buildAndWritePipelined(indexInfo, knnVectorValues, indexBuildSetup, indexMemoryAddress, carriedOverDocs);
+            return;
+        }
 
         try (
             final OffHeapVectorTransfer vectorTransfer = getVectorTransfer(
@@ -79,6 +95,11 @@ final class MemOptimizedNativeIndexBuildStrategy implements NativeIndexBuildStra
             final List<Integer> transferredDocIds = new ArrayList<>(vectorTransfer.getTransferLimit());
 
             while (knnVectorValues.docId() != NO_MORE_DOCS) {
+                if (carriedOverDocs != null && carriedOverDocs.get(knnVectorValues.docId())) {
+                    // Already in the loaded index
+                    knnVectorValues.nextDoc();
+                    continue;
+                }
                 Object vector = QuantizationIndexUtils.processAndReturnVector(knnVectorValues, indexBuildSetup);
                 // append is false to be able to reuse the memory location
                 boolean transferred = vectorTransfer.transfer(vector, false);
@@ -133,4 +154,144 @@ final class MemOptimizedNativeIndexBuildStrategy implements NativeIndexBuildStra
             );
         }
     }
+
+    /**
+     * Streams the vectors through two off-heap buffers. A full buffer is handed to a native insert worker to be added to
+     * the index, while the next batch is read and transferred into the other one. The worker lives for the whole build so
+     * its thread is reused by every batch. A buffer is only written again once the batch it held has been added, and
+     * batches are added one at a time and in order. Docs in carriedOverDocs are skipped since they are already in the
+     * index.
+     */
+    private void buildAndWritePipelined(
+        final BuildIndexParams indexInfo,
+        final KNNVectorValues<?> knnVectorValues,
+        final IndexBuildSetup indexBuildSetup,
+        final long indexMemoryAddress,
+        @Nullable final FixedBitSet carriedOverDocs
+    ) throws IOException {
+        KNNEngine engine = indexInfo.getKnnEngine();
+        Map<String, Object> indexParameters = indexInfo.getParameters();
+        try (
+            final OffHeapVectorTransfer firstTransfer = getVectorTransfer(
+                indexInfo.getVectorDataType(),
+                indexBuildSetup.getBytesPerVector(),
+                indexInfo.getTotalLiveDocs()
+            );
+            final OffHeapVectorTransfer secondTransfer = getVectorTransfer(
+                indexInfo.getVectorDataType(),
+                indexBuildSetup.getBytesPerVector(),
+                indexInfo.getTotalLiveDocs()
+            )
+        ) {
+            final OffHeapVectorTransfer[] vectorTransfers = { firstTransfer, secondTransfer };
+            int current = 0;
+            final List<Integer> transferredDocIds = new ArrayList<>(firstTransfer.getTransferLimit());
+
+            final long insertWorker = AccessController.doPrivileged(
+                (PrivilegedAction<Long>) () -> JNIService.startInsertWorker(
+                    indexBuildSetup.getDimensions(),
+                    indexParameters,
+                    indexMemoryAddress,
+                    engine
+                )
+            );
+            try {
+                long pendingInsert = 0;
+                while (knnVectorValues.docId() != NO_MORE_DOCS) {
+                    if (carriedOverDocs != null && carriedOverDocs.get(knnVectorValues.docId())) {
+                        // Already in the loaded index
+                        knnVectorValues.nextDoc();
+                        continue;
+                    }
+                    Object vector = QuantizationIndexUtils.processAndReturnVector(knnVectorValues, indexBuildSetup);
+                    // append is false to be able to reuse the memory location
+                    boolean transferred = vectorTransfers[current].transfer(vector, false);
+                    transferredDocIds.add(knnVectorValues.docId());
+                    if (transferred) {
+                        // The other buffer is only free once its batch has been added
+                        waitForInsert(insertWorker, pendingInsert, engine);
+                        pendingInsert = submitInsert(insertWorker, transferredDocIds, vectorTransfers[current].getVectorAddress(), engine);
+                        transferredDocIds.clear();
+                        current = 1 - current;
+                    }
+                    knnVectorValues.nextDoc();
+                }
+
+                boolean flush = vectorTransfers[current].flush(false);
+                waitForInsert(insertWorker, pendingInsert, engine);
+                // Need to make sure that the flushed vectors are indexed
+                if (flush) {
+                    pendingInsert = submitInsert(insertWorker, transferredDocIds, vectorTransfers[current].getVectorAddress(), engine);
+                    transferredDocIds.clear();
+                    waitForInsert(insertWorker, pendingInsert, engine);
+                }
+            } finally {
+                // The buffers are freed on close, so the worker must be done with them first. Stopping it waits for the
+                // batch it is adding and drops the rest
+                AccessController.doPrivileged((PrivilegedAction<Void>) () -> {
+                    JNIService.stopInsertWorker(insertWorker, engine);
+                    return null;
+                });
+            }
+
+            // Write vector
+            AccessController.doPrivileged((PrivilegedAction<Void>) () -> {
+                JNIService.writeIndex(indexInfo.getIndexOutputWithBuffer(), indexMemoryAddress, engine, indexParameters);
+                return null;
+            });
+
+        } catch (Exception exception) {
+            throw new RuntimeException(
+                "Failed to build index, field name [" + indexInfo.getFieldName() + "], parameters " + indexInfo,
+                exception
+            );
+        }
+    }
+
+    /**
+     * Loads the native index of the merged segment the index is started from, with its docs moved to their merged doc ids
+     * and room reserved for the rest of the vectors.
+     *
+     * @return address of the loaded index, or 0 when there is no such segment or its index cannot be carried over
+     */
+    private static long loadIndexForMerge(final BuildIndexParams indexInfo) throws IOException {
+        final MergeGraphSource mergeGraphSource = indexInfo.getMergeGraphSource();
+        if (mergeGraphSource == null) {
+            return 0;
+        }
+        try (IndexInput input = mergeGraphSource.getDirectory().openInput(mergeGraphSource.getFileName(), IOContext.READONCE)) {
+            final IndexInputWithBuffer readStream = new IndexInputWithBuffer(input);
+            return AccessController.doPrivileged(
+                (PrivilegedAction<Long>) () -> JNIService.loadIndexForMerge(
+                    readStream,
+                    mergeGraphSource.getDocMap(),
+                    indexInfo.getTotalLiveDocs(),
+                    indexInfo.getParameters(),
+                    indexInfo.getKnnEngine()
+                )
+            );
+        }
+    }
+
+    private static long submitInsert(
+        final long insertWorker,
+        final List<Integer> docIds,
+        final long vectorAddress,
+        final KNNEngine engine
+    ) {
+        final int[] docs = intListToArray(docIds);
+        return AccessController.doPrivileged(
+            (PrivilegedAction<Long>) () -> JNIService.submitInsertToIndex(insertWorker, docs, vectorAddress, engine)
+        );
+    }
+
+    private static void waitForInsert(final long insertWorker, final long insertBatch, final KNNEngine engine) {
+        if (insertBatch == 0) {
+            return;
+        }
+        AccessController.doPrivileged((PrivilegedAction<Void>) () -> {
+            JNIService.waitForInsertToIndex(insertWorker, insertBatch, engine);
+            return null;
+        });
+    }
 }
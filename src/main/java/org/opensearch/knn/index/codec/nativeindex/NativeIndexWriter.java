@@ -23,6 +23,7 @@ import org.opensearch.knn.index.KNNSettings;
 import org.opensearch.knn.index.SpaceType;
 import org.opensearch.knn.index.VectorDataType;
 import org.opensearch.knn.index.codec.nativeindex.model.BuildIndexParams;
+import org.opensearch.knn.index.codec.nativeindex.model.MergeGraphSource;
 import org.opensearch.knn.index.engine.KNNEngine;
 import org.opensearch.knn.index.engine.qframe.QuantizationConfig;
 import org.opensearch.knn.index.quantizationservice.QuantizationService;
@@ -102,7 +103,7 @@ public class NativeIndexWriter {
      * @throws IOException
      */
     public void flushIndex(final Supplier<KNNVectorValues<?>> knnVectorValuesSupplier, int totalLiveDocs) throws IOException {
-        buildAndWriteIndex(knnVectorValuesSupplier, totalLiveDocs, true);
+        buildAndWriteIndex(knnVectorValuesSupplier, totalLiveDocs, true, null);
         recordRefreshStats();
     }
 
@@ -112,6 +113,21 @@ public class NativeIndexWriter {
      * @throws IOException
      */
     public void mergeIndex(final Supplier<KNNVectorValues<?>> knnVectorValuesSupplier, int totalLiveDocs) throws IOException {
+        mergeIndex(knnVectorValuesSupplier, totalLiveDocs, null);
+    }
+
+    /**
+     * Merges kNN index, starting from the native index of one of the merged segments when one is given
+     * @param knnVectorValuesSupplier
+     * @param totalLiveDocs
+     * @param mergeGraphSource native index to start from, or null to build the index from scratch
+     * @throws IOException
+     */
+    public void mergeIndex(
+        final Supplier<KNNVectorValues<?>> knnVectorValuesSupplier,
+        int totalLiveDocs,
+        @Nullable final MergeGraphSource mergeGraphSource
+    ) throws IOException {
         KNNVectorValues<?> knnVectorValues = knnVectorValuesSupplier.get();
         initializeVectorValues(knnVectorValues);
         if (knnVectorValues.docId() == NO_MORE_DOCS) {
@@ -122,12 +138,16 @@ public class NativeIndexWriter {
 
         long bytesPerVector = knnVectorValues.bytesPerVector();
         startMergeStats(totalLiveDocs, bytesPerVector);
-        buildAndWriteIndex(knnVectorValuesSupplier, totalLiveDocs, false);
+        buildAndWriteIndex(knnVectorValuesSupplier, totalLiveDocs, false, mergeGraphSource);
         endMergeStats(totalLiveDocs, bytesPerVector);
     }
 
-    private void buildAndWriteIndex(final Supplier<KNNVectorValues<?>> knnVectorValuesSupplier, int totalLiveDocs, boolean isFlush)
-        throws IOException {
+    private void buildAndWriteIndex(
+        final Supplier<KNNVectorValues<?>> knnVectorValuesSupplier,
+        int totalLiveDocs,
+        boolean isFlush,
+        @Nullable final MergeGraphSource mergeGraphSource
+    ) throws IOException {
         if (totalLiveDocs == 0) {
             log.debug("No live docs for field {}", fieldInfo.name);
             return;
@@ -148,7 +168,8 @@ public class NativeIndexWriter {
                 knnEngine,
                 knnVectorValuesSupplier,
                 totalLiveDocs,
-                isFlush
+                isFlush,
+                mergeGraphSource
             );
             NativeIndexBuildStrategy indexBuilder = indexBuilderFactory.getBuildStrategy(
                 fieldInfo,
@@ -157,6 +178,7 @@ public class NativeIndexWriter {
                 nativeIndexParams
             );
             indexBuilder.buildAndWriteIndex(nativeIndexParams);
+            indexOutputWithBuffer.verifyNativeChecksum();
             CodecUtil.writeFooter(output);
         }
     }
@@ -170,7 +192,8 @@ public class NativeIndexWriter {
         KNNEngine knnEngine,
         Supplier<KNNVectorValues<?>> knnVectorValuesSupplier,
         int totalLiveDocs,
-        boolean isFlush
+        boolean isFlush,
+        MergeGraphSource mergeGraphSource
     ) throws IOException {
         final Map<String, Object> parameters;
         VectorDataType vectorDataType;
@@ -197,6 +220,7 @@ public class NativeIndexWriter {
             .totalLiveDocs(totalLiveDocs)
             .segmentWriteState(state)
             .isFlush(isFlush)
+            .mergeGraphSource(mergeGraphSource)
             .build();
     }
 
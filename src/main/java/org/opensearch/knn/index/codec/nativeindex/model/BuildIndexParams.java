@@ -37,4 +37,9 @@ public class BuildIndexParams {
     int totalLiveDocs;
     SegmentWriteState segmentWriteState;
     boolean isFlush;
+    /**
+     * An optional native index of a merged segment to start the merged index from
+     */
+    @Nullable
+    MergeGraphSource mergeGraphSource;
 }
@@ -0,0 +1,29 @@
+/*
+ * Copyright OpenSearch Contributors
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+package org.opensearch.knn.index.codec.nativeindex.model;
+
+import lombok.Builder;
+import lombok.Value;
+import org.apache.lucene.store.Directory;
+import org.apache.lucene.util.FixedBitSet;
+
+/**
+ * Native index of a segment being merged, which the merged index is started from instead of being built from scratch.
+ */
+@Value
+@Builder
+public class MergeGraphSource {
+    Directory directory;
+    String fileName;
+    /**
+     * Doc id in the merged segment of every doc of the source segment, or -1 for a deleted doc
+     */
+    int[] docMap;
+    /**
+     * Docs of the merged segment whose vectors are already in the source index
+     */
+    FixedBitSet carriedOverDocs;
+}
@@ -13,7 +13,10 @@ package org.opensearch.knn.index.memory;
 
 import lombok.extern.log4j.Log4j2;
 import org.apache.lucene.store.Directory;
+import org.apache.lucene.store.FSDirectory;
+import org.apache.lucene.store.FilterDirectory;
 import org.opensearch.core.action.ActionListener;
+import org.opensearch.knn.index.KNNSettings;
 import org.opensearch.knn.index.codec.util.NativeMemoryCacheKeyHelper;
 import org.opensearch.knn.index.engine.qframe.QuantizationConfig;
 import org.opensearch.knn.index.util.IndexUtil;
@@ -24,6 +27,8 @@ import org.opensearch.knn.training.VectorReader;
 
 import java.io.Closeable;
 import java.io.IOException;
+import java.nio.file.Path;
+import java.util.Map;
 import java.util.concurrent.ExecutorService;
 import java.util.concurrent.Executors;
 
@@ -90,15 +95,42 @@ public interface NativeMemoryLoadStrategy<T extends NativeMemoryAllocation, U ex
                 throw new IllegalStateException("Index [" + indexEntryContext.getOpenSearchIndexName() + "] is not preloaded");
             }
             try (indexEntryContext) {
-                final long indexAddress = JNIService.loadIndex(
-                    indexEntryContext.indexInputWithBuffer,
-                    indexEntryContext.getParameters(),
-                    knnEngine
-                );
+                final Map<String, Object> parameters = indexEntryContext.getParameters();
+                final Path mappableIndexPath = getMappableIndexPath(directory, vectorFileName, knnEngine, parameters);
+                final long indexAddress;
+                if (mappableIndexPath != null) {
+                    indexAddress = JNIService.loadIndexWithMmap(mappableIndexPath.toString(), parameters, knnEngine);
+                } else {
+                    indexAddress = JNIService.loadIndex(indexEntryContext.indexInputWithBuffer, parameters, knnEngine);
+                }
                 return createIndexAllocation(indexEntryContext, knnEngine, indexAddress, indexSizeKb, vectorFileName);
             }
         }
 
+        /**
+         * Path of the index file when it can be loaded by mapping it: mmap loading is enabled, the index is a faiss one
+         * without ADC, and the file is stored on its own in a local directory rather than in a compound file.
+         *
+         * @return path of the index file, or null when it has to be loaded from the stream
+         */
+        private static Path getMappableIndexPath(
+            final Directory directory,
+            final String vectorFileName,
+            final KNNEngine knnEngine,
+            final Map<String, Object> parameters
+        ) {
+            if (KNNEngine.FAISS != knnEngine
+                || IndexUtil.isADCEnabled(knnEngine, parameters)
+                || KNNSettings.isFaissMmapLoadEnabled() == false) {
+                return null;
+            }
+            final Directory unwrapped = FilterDirectory.unwrap(directory);
+            if (unwrapped instanceof FSDirectory fsDirectory) {
+                return fsDirectory.getDirectory().resolve(vectorFileName);
+            }
+            return null;
+        }
+
         private NativeMemoryAllocation.IndexAllocation createIndexAllocation(
             final NativeMemoryEntryContext.IndexEntryContext indexEntryContext,
             final KNNEngine knnEngine,
@@ -142,6 +142,18 @@ public class DefaultKNNWeight extends KNNWeight {
                         parentIds
                     );
                 }
+            } else if (knnQuery.getVectorDataType() == VectorDataType.BINARY) {
+                results = JNIService.radiusQueryBinaryIndex(
+                    indexAllocation.getMemoryAddress(),
+                    knnQuery.getByteQueryVector(),
+                    knnQuery.getRadius(),
+                    knnQuery.getMethodParameters(),
+                    knnEngine,
+                    knnQuery.getContext().getMaxResultWindow(),
+                    filterIds,
+                    filterType.getValue(),
+                    parentIds
+                );
             } else {
                 results = JNIService.radiusQueryIndex(
                     indexAllocation.getMemoryAddress(),
@@ -19,6 +19,7 @@ import org.apache.lucene.util.BitSetIterator;
 import org.apache.lucene.util.FixedBitSet;
 
 import java.io.IOException;
+import java.util.Arrays;
 
 /**
  * Util Class for filter ids selector
@@ -28,14 +29,16 @@ import java.io.IOException;
 public class FilterIdsSelector {
 
     /**
-     * When do ann query with filters, there are two types:
-     * BitMap using FixedBitSet, BATCH using a long array stands for filter result docids.
+     * When do ann query with filters, there are three types:
+     * BitMap using FixedBitSet, BATCH using a long array stands for filter result docids, RANGES using a long array of
+     * begin and exclusive end docids of every run of consecutive filter result docids.
      */
     @AllArgsConstructor
     @Getter
     public enum FilterIdsSelectorType {
         BITMAP(0),
-        BATCH(1);
+        BATCH(1),
+        RANGES(2);
 
         private final int value;
     }
@@ -68,9 +71,14 @@ public class FilterIdsSelector {
      *
      * Array Memory: Cardinality * Long.BYTES
      * BitSet Memory: MaxId / Byte.SIZE
-     * When Array Memory less than or equal to BitSet Memory return FilterIdsSelectorType.BATCH
+     * Ranges Memory: Runs * 2 * Long.BYTES
+     * When Ranges Memory is at most half of both Array Memory and BitSet Memory return FilterIdsSelectorType.RANGES
+     * Else when Array Memory less than or equal to BitSet Memory return FilterIdsSelectorType.BATCH
      * Else return FilterIdsSelectorType.BITMAP;
      *
+     * A FixedBitSet is always passed as a BITMAP, since it needs no conversion at all. For BATCH, the native side picks
+     * a sorted array or roaring containers from the cardinality, instead of hashing every id.
+     *
      * @param filterIdsBitSet Filter query result docs
      * @param cardinality The number of bits that are set
      * @return {@link FilterIdsSelector}
@@ -87,6 +95,11 @@ public class FilterIdsSelector {
              */
             filterIds = ((FixedBitSet) filterIdsBitSet).getBits();
             filterType = FilterIdsSelector.FilterIdsSelectorType.BITMAP;
+        } else if ((filterIds = getRanges(filterIdsBitSet, cardinality)) != null) {
+            /**
+             * When filterIds are mostly runs of consecutive docids, using ranges
+             */
+            filterType = FilterIdsSelectorType.RANGES;
         } else if ((cardinality * Long.BYTES * Byte.SIZE) <= filterIdsBitSet.length()) {
             /**
              * When filterIds is sparse bitset, using ram usage to decide FilterIdsSelectorType
@@ -107,4 +120,38 @@ public class FilterIdsSelector {
         }
         return new FilterIdsSelector(filterIds, filterType);
     }
+
+    /**
+     * Collects the runs of consecutive docids of the bitset as begin and exclusive end pairs. Gives up as soon as the
+     * ranges would take more than half the memory of both an id array and a bitmap, so scattered filters only pay for
+     * a short prefix of the iteration.
+     *
+     * @param filterIdsBitSet Filter query result docs
+     * @param cardinality The number of bits that are set
+     * @return ranges of the filter result docs, or null when ranges are not worth it
+     */
+    private static long[] getRanges(final BitSet filterIdsBitSet, final int cardinality) throws IOException {
+        final long arrayBytes = (long) cardinality * Long.BYTES;
+        final long bitSetBytes = filterIdsBitSet.length() / Byte.SIZE;
+        final int maxRuns = (int) (Math.min(arrayBytes, bitSetBytes) / (2 * 2 * Long.BYTES));
+        if (maxRuns == 0) {
+            return null;
+        }
+        long[] ranges = new long[2 * maxRuns];
+        int numRuns = 0;
+        BitSetIterator bitSetIterator = new BitSetIterator(filterIdsBitSet, cardinality);
+        for (int docId = bitSetIterator.nextDoc(); docId != DocIdSetIterator.NO_MORE_DOCS; docId = bitSetIterator.nextDoc()) {
+            if (numRuns > 0 && ranges[2 * numRuns - 1] == docId) {
+                ranges[2 * numRuns - 1] = docId + 1;
+                continue;
+            }
+            if (numRuns == maxRuns) {
+                return null;
+            }
+            ranges[2 * numRuns] = docId;
+            ranges[2 * numRuns + 1] = docId + 1;
+            numRuns++;
+        }
+        return numRuns == maxRuns ? ranges : Arrays.copyOf(ranges, 2 * numRuns);
+    }
 }
@@ -479,7 +479,8 @@ public class KNNQueryBuilder extends AbstractQueryBuilder<KNNQueryBuilder> imple
                     String.format(Locale.ROOT, "Engine [%s] does not support radial search", knnEngine)
                 );
             }
-            if (vectorDataType == VectorDataType.BINARY) {
+            // Faiss range searches binary indices by hamming distance, which other engines and memory optimized search do not
+            if (vectorDataType == VectorDataType.BINARY && (KNNEngine.FAISS != knnEngine || memoryOptimizedSearchEnabled)) {
                 throw new UnsupportedOperationException(String.format(Locale.ROOT, "Binary data type does not support radial search"));
             }
 
@@ -587,7 +588,7 @@ public class KNNQueryBuilder extends AbstractQueryBuilder<KNNQueryBuilder> imple
                 .indexName(indexName)
                 .fieldName(this.fieldName)
                 .vector(VectorDataType.FLOAT == vectorDataType ? this.vector : null)
-                .byteVector(VectorDataType.BYTE == vectorDataType ? byteVector : null)
+                .byteVector(VectorDataType.FLOAT == vectorDataType ? null : byteVector)
                 .vectorDataType(vectorDataType)
                 .radius(radius)
                 .methodParameters(this.methodParameters)
@@ -5,6 +5,7 @@
 
 package org.opensearch.knn.index.store;
 
+import org.apache.lucene.index.CorruptIndexException;
 import org.apache.lucene.store.IndexOutput;
 import org.opensearch.knn.common.exception.TerminalIOException;
 
@@ -24,6 +25,9 @@ public class IndexOutputWithBuffer {
     // 64KB to accumulate bytes as possible to reduce the times of calling `writeBytes`.
     private static final int CHUNK_SIZE = 64 * 1024;
     private final byte[] buffer;
+    // CRC32 of the bytes native engines wrote through `buffer`, computed natively as they were copied, and the number of those bytes.
+    private long nativeChecksum;
+    private long nativeBytesWritten;
 
     public IndexOutputWithBuffer(IndexOutput indexOutput) {
         this.indexOutput = indexOutput;
@@ -31,16 +35,46 @@ public class IndexOutputWithBuffer {
     }
 
     // This method will be called in JNI layer which precisely knows
-    // the amount of bytes need to be written.
-    public void writeBytes(int length) {
+    // the amount of bytes need to be written, along with the checksum of every byte it wrote so far.
+    public void writeBytes(int length, long checksum) {
         try {
             // Delegate Lucene `indexOuptut` to write bytes.
             indexOutput.writeBytes(buffer, 0, length);
+            nativeChecksum = checksum;
+            nativeBytesWritten += length;
         } catch (IOException e) {
             throw new RuntimeException(e);
         }
     }
 
+    // This method will be called in JNI layer, to resume the checksum when an index is written in several native calls.
+    private long nativeChecksum() {
+        return nativeChecksum;
+    }
+
+    /**
+     * Checks the checksum native engines computed over the bytes they wrote against the checksum of {@link IndexOutput}, so what reached
+     * the file is verified without reading it back. Nothing is checked unless every byte written so far came from a native engine.
+     *
+     * @throws CorruptIndexException if the checksums differ
+     * @throws IOException if the checksum of {@link IndexOutput} cannot be computed
+     */
+    public void verifyNativeChecksum() throws IOException {
+        if (nativeBytesWritten == 0 || nativeBytesWritten != indexOutput.getFilePointer()) {
+            return;
+        }
+        final long checksum = indexOutput.getChecksum();
+        if (checksum != nativeChecksum) {
+            throw new CorruptIndexException(
+                "checksum failed (hardware problem?) : expected="
+                    + Long.toHexString(nativeChecksum)
+                    + " actual="
+                    + Long.toHexString(checksum),
+                indexOutput.toString()
+            );
+        }
+    }
+
     /**
      * Writes to the {@link IndexOutput} by buffering bytes into a new buffer of custom size.
      *
@@ -18,6 +18,7 @@ import com.google.common.cache.RemovalNotification;
 import org.apache.logging.log4j.LogManager;
 import org.apache.logging.log4j.Logger;
 import org.opensearch.cluster.service.ClusterService;
+import org.opensearch.knn.jni.JNIService;
 
 import java.time.Instant;
 import java.util.concurrent.ExecutionException;
@@ -96,6 +97,12 @@ public final class ModelCache {
             updateEvictedDueToSizeAt();
         }
 
+        // The native library keeps the deserialized template of the model for index builds, it goes along with the model
+        Model model = removalNotification.getValue();
+        if (model != null && model.getModelMetadata() != null) {
+            JNIService.evictTemplateIndex(removalNotification.getKey(), model.getModelMetadata().getKnnEngine());
+        }
+
         logger.info("[KNN] Model Cache evicted. Key {}, Reason: {}", removalNotification.getKey(), removalNotification.getCause());
     }
 
@@ -24,6 +24,8 @@ import java.util.Map;
 import static org.opensearch.knn.index.KNNSettings.isFaissAVX2Disabled;
 import static org.opensearch.knn.index.KNNSettings.isFaissAVX512Disabled;
 import static org.opensearch.knn.index.KNNSettings.isFaissAVX512SPRDisabled;
+import static org.opensearch.knn.index.KNNSettings.getNativeSearchThreadPoolSize;
+import static org.opensearch.knn.index.KNNSettings.isNativeSearchThreadPinningEnabled;
 import static org.opensearch.knn.jni.PlatformUtils.isAVX2SupportedBySystem;
 import static org.opensearch.knn.jni.PlatformUtils.isAVX512SupportedBySystem;
 import static org.opensearch.knn.jni.PlatformUtils.isAVX512SPRSupportedBySystem;
@@ -54,7 +56,7 @@ class FaissService {
                 System.loadLibrary(KNNConstants.FAISS_JNI_LIBRARY_NAME);
             }
 
-            initLibrary();
+            initLibrary(getNativeSearchThreadPoolSize(), isNativeSearchThreadPinningEnabled());
             KNNEngine.FAISS.setInitialized(true);
             return null;
         });
@@ -90,6 +92,39 @@ class FaissService {
      */
     public static native long initByteIndex(long numDocs, int dim, Map<String, Object> parameters);
 
+    /**
+     * Estimate the native memory of the index initIndex creates for the same parameters, once numDocs vectors are
+     * inserted into it.
+     *
+     * @param numDocs number of documents to be added
+     * @param dim dimension of the vector to be indexed
+     * @param parameters parameters to build index
+     * @return estimated size of the index in bytes
+     */
+    public static native long estimateIndexMemory(long numDocs, int dim, Map<String, Object> parameters);
+
+    /**
+     * Estimate the native memory of the index initBinaryIndex creates for the same parameters, once numDocs vectors are
+     * inserted into it.
+     *
+     * @param numDocs number of documents to be added
+     * @param dim dimension of the vector to be indexed
+     * @param parameters parameters to build index
+     * @return estimated size of the index in bytes
+     */
+    public static native long estimateBinaryIndexMemory(long numDocs, int dim, Map<String, Object> parameters);
+
+    /**
+     * Estimate the native memory of the index initByteIndex creates for the same parameters, once numDocs vectors are
+     * inserted into it.
+     *
+     * @param numDocs number of documents to be added
+     * @param dim dimension of the vector to be indexed
+     * @param parameters parameters to build index
+     * @return estimated size of the index in bytes
+     */
+    public static native long estimateByteIndexMemory(long numDocs, int dim, Map<String, Object> parameters);
+
     /**
      * Inserts to a faiss index. The memory occupied by the vectorsAddress will be freed up during the
      * function call. So Java layer doesn't need to free up the memory. This is not an ideal behavior because Java layer
@@ -129,6 +164,68 @@ class FaissService {
      */
     public static native void insertToByteIndex(int[] ids, long vectorsAddress, int dim, long indexAddress, int threadCount);
 
+    /**
+     * Starts the native background thread that adds the batches of one build to a faiss index. The same thread
+     * serves every batch of the build, and must be stopped with stopInsertWorker once the build is done.
+     *
+     * @param indexAddress address of native memory where index is stored
+     * @param dim dimension of the vector to be indexed
+     * @param threadCount number of threads to use for insertion
+     * @return handle to the insert worker
+     */
+    public static native long startInsertWorker(long indexAddress, int dim, int threadCount);
+
+    /**
+     * Starts the native background thread that adds the batches of one build to a binary faiss index. The same thread
+     * serves every batch of the build, and must be stopped with stopInsertWorker once the build is done.
+     *
+     * @param indexAddress address of native memory where index is stored
+     * @param dim dimension of the vector to be indexed
+     * @param threadCount number of threads to use for insertion
+     * @return handle to the insert worker
+     */
+    public static native long startBinaryInsertWorker(long indexAddress, int dim, int threadCount);
+
+    /**
+     * Starts the native background thread that adds the batches of one build to a byte faiss index. The same thread
+     * serves every batch of the build, and must be stopped with stopInsertWorker once the build is done.
+     *
+     * @param indexAddress address of native memory where index is stored
+     * @param dim dimension of the vector to be indexed
+     * @param threadCount number of threads to use for insertion
+     * @return handle to the insert worker
+     */
+    public static native long startByteInsertWorker(long indexAddress, int dim, int threadCount);
+
+    /**
+     * Queues a batch to be added to the index by an insert worker and returns without waiting for it, so the next batch
+     * can be filled while this one is added. Batches are added in the order they are submitted. The vectors must be left
+     * untouched, and no other insert may be made into the index, until waitForInsertToIndex returns for the batch.
+     *
+     * @param insertWorker handle returned by one of the start insert worker methods
+     * @param ids ids of documents
+     * @param vectorsAddress address of native memory where vectors are stored
+     * @return number of the batch, to be passed to waitForInsertToIndex
+     */
+    public static native long submitInsertToIndex(long insertWorker, int[] ids, long vectorsAddress);
+
+    /**
+     * Wait for an insert worker to be done with a batch and the ones submitted before it. Throws if an insert failed,
+     * in which case the later batches are skipped.
+     *
+     * @param insertWorker handle returned by one of the start insert worker methods
+     * @param insertBatch number returned by submitInsertToIndex
+     */
+    public static native void waitForInsertToIndex(long insertWorker, long insertBatch);
+
+    /**
+     * Stop an insert worker and free it. The batch being added is finished first, the queued ones are dropped. The
+     * handle must not be used afterwards.
+     *
+     * @param insertWorker handle returned by one of the start insert worker methods
+     */
+    public static native void stopInsertWorker(long insertWorker);
+
     /**
      * Writes a faiss index.
      *
@@ -216,6 +313,14 @@ class FaissService {
         Map<String, Object> parameters
     );
 
+    /**
+     * Drop the deserialized template index kept for the model. Builds from templates keep the deserialized template
+     * of every model id they see, so a model is only parsed once.
+     *
+     * @param modelId id of the model
+     */
+    public static native void evictTemplateIndex(String modelId);
+
     /**
      * Load an index into memory
      *
@@ -224,6 +329,15 @@ class FaissService {
      */
     public static native long loadIndex(String indexPath);
 
+    /**
+     * Load an index by mapping its file into memory. The vectors and the graph are read in place from the mapping
+     * instead of being copied, so the file has to be on a local filesystem.
+     *
+     * @param indexPath path to index file
+     * @return pointer to location in memory the index resides in
+     */
+    public static native long loadIndexWithMmap(String indexPath);
+
     /**
      * Load an index into memory via a wrapping having Lucene's IndexInput.
      * Instead of directly accessing an index path, this will make Faiss delegate IndexInput to load bytes.
@@ -254,6 +368,14 @@ class FaissService {
      */
     public static native long loadBinaryIndex(String indexPath);
 
+    /**
+     * Same as {@link #loadIndexWithMmap}, for a binary index.
+     *
+     * @param indexPath path to index file
+     * @return pointer to location in memory the index resides in
+     */
+    public static native long loadBinaryIndexWithMmap(String indexPath);
+
     /**
      * Load a binary index into memory with a wrapping having Lucene's IndexInput.
      * Instead of directly accessing an index path, this will make Faiss delegate IndexInput to load bytes.
@@ -263,6 +385,39 @@ class FaissService {
      */
     public static native long loadBinaryIndexWithStream(IndexInputWithBuffer readStream);
 
+    /**
+     * Load the HNSW index of a segment being merged and carry its graph over to the merged segment. The labels are
+     * remapped with docMap, and the vectors of deleted docs, mapped to -1, are dropped from the graph.
+     *
+     * @param readStream IndexInput wrapper having a Lucene's IndexInput reference.
+     * @param docMap     doc id in the merged segment of every doc of the segment, or -1 for a deleted doc
+     * @param numDocs    number of docs with vectors in the merged segment
+     * @param parameters parameters of the merged index, like the number of threads
+     * @return pointer to location in memory the index resides in, or 0 when the index has to be built from scratch
+     */
+    public static native long loadIndexForMerge(
+        IndexInputWithBuffer readStream,
+        int[] docMap,
+        long numDocs,
+        Map<String, Object> parameters
+    );
+
+    /**
+     * Same as {@link #loadIndexForMerge}, for a binary index.
+     *
+     * @param readStream IndexInput wrapper having a Lucene's IndexInput reference.
+     * @param docMap     doc id in the merged segment of every doc of the segment, or -1 for a deleted doc
+     * @param numDocs    number of docs with vectors in the merged segment
+     * @param parameters parameters of the merged index, like the number of threads
+     * @return pointer to location in memory the index resides in, or 0 when the index has to be built from scratch
+     */
+    public static native long loadBinaryIndexForMerge(
+        IndexInputWithBuffer readStream,
+        int[] docMap,
+        long numDocs,
+        Map<String, Object> parameters
+    );
+
     /**
      * Determine if index contains shared state.
      *
@@ -332,6 +487,111 @@ class FaissService {
         int[] parentIds
     );
 
+    /**
+     * Query an index with query time parameters compiled by {@link JNICommons#compileSearchParams(Map)}
+     *
+     * @param indexPointer pointer to index in memory
+     * @param queryVector vector to be used for query
+     * @param k neighbors to be returned
+     * @param searchParamsPointer handle to the compiled search parameters, 0 to use the index defaults
+     * @param filterIds list of doc ids to include in the query result, null to search without filter
+     * @param filterIdsType how to filter ids: Batch, BitMap or Ranges
+     * @param parentIds list of parent doc ids when the knn field is a nested field
+     * @return KNNQueryResult array of k neighbors
+     */
+    public static native KNNQueryResult[] queryIndexWithSearchParams(
+        long indexPointer,
+        float[] queryVector,
+        int k,
+        long searchParamsPointer,
+        long[] filterIds,
+        int filterIdsType,
+        int[] parentIds
+    );
+
+    /**
+     * Query an index with query time parameters compiled by {@link JNICommons#compileSearchParams(Map)} and write the
+     * results into caller provided arrays
+     *
+     * @param indexPointer pointer to index in memory
+     * @param queryVector vector to be used for query
+     * @param k neighbors to be returned
+     * @param searchParamsPointer handle to the compiled search parameters, 0 to use the index defaults
+     * @param filterIds list of doc ids to include in the query result, null to search without filter
+     * @param filterIdsType how to filter ids: Batch, BitMap or Ranges
+     * @param parentIds list of parent doc ids when the knn field is a nested field
+     * @param resultIds output array for the doc ids of the neighbors
+     * @param resultDistances output array for the distances of the neighbors
+     * @return number of results found, at most k. When it is larger than resultIds.length, only the first
+     *         resultIds.length results are written
+     */
+    public static native int queryIndexWithSearchParamsIntoArrays(
+        long indexPointer,
+        float[] queryVector,
+        int k,
+        long searchParamsPointer,
+        long[] filterIds,
+        int filterIdsType,
+        int[] parentIds,
+        int[] resultIds,
+        float[] resultDistances
+    );
+
+    /**
+     * Query an index and write the results into caller provided arrays, so that no KNNQueryResult object is allocated
+     * per hit.
+     *
+     * @param indexPointer pointer to index in memory
+     * @param queryVector vector to be used for query
+     * @param k neighbors to be returned
+     * @param methodParameters method parameter
+     * @param filterIds list of doc ids to include in the query result, null to search without filter
+     * @param filterIdsType how to filter ids: Batch, BitMap or Ranges
+     * @param parentIds list of parent doc ids when the knn field is a nested field
+     * @param resultIds output array for the doc ids of the neighbors
+     * @param resultDistances output array for the distances of the neighbors
+     * @return number of results found, at most k. When it is larger than resultIds.length, only the first
+     *         resultIds.length results are written
+     */
+    public static native int queryIndexIntoArrays(
+        long indexPointer,
+        float[] queryVector,
+        int k,
+        Map<String, ?> methodParameters,
+        long[] filterIds,
+        int filterIdsType,
+        int[] parentIds,
+        int[] resultIds,
+        float[] resultDistances
+    );
+
+    /**
+     * Query an index with a batch of query vectors. The filter and parent ids are shared by all the queries, and the
+     * whole batch is searched in a single native call.
+     *
+     * @param indexPointer pointer to index in memory
+     * @param queryVectors query vectors packed back to back, the number of queries is queryVectors.length / dimension
+     * @param k neighbors to be returned per query
+     * @param methodParameters method parameter
+     * @param filterIds list of doc ids to include in the query results, null to search without filter
+     * @param filterIdsType how to filter ids: Batch, BitMap or Ranges
+     * @param parentIds list of parent doc ids when the knn field is a nested field
+     * @param resultIds output array of at least numQueries * k ids. Results of query i are at [i * k, (i + 1) * k) and
+     *                  slots without a result are set to -1
+     * @param resultDistances output array of at least numQueries * k distances, laid out like resultIds
+     */
+    public static native void queryIndexBatch(
+        long indexPointer,
+        float[] queryVectors,
+        int k,
+        Map<String, ?> methodParameters,
+        long[] filterIds,
+        int filterIdsType,
+        int[] parentIds,
+        int[] resultIds,
+        float[] resultDistances
+    );
+
     /**
      * Query a binary index with filter
      *
@@ -372,6 +632,158 @@ class FaissService {
         int[] parentIds
     );
 
+    /**
+     * Query a binary index with query time parameters compiled by {@link JNICommons#compileSearchParams(Map)}
+     *
+     * @param indexPointer pointer to index in memory
+     * @param queryVector vector to be used for query
+     * @param k neighbors to be returned
+     * @param searchParamsPointer handle to the compiled search parameters, 0 to use the index defaults
+     * @param filterIds list of doc ids to include in the query result, null to search without filter
+     * @param filterIdsType how to filter ids: Batch, BitMap or Ranges
+     * @param parentIds list of parent doc ids when the knn field is a nested field
+     * @return KNNQueryResult array of k neighbors
+     */
+    public static native KNNQueryResult[] queryBinaryIndexWithSearchParams(
+        long indexPointer,
+        byte[] queryVector,
+        int k,
+        long searchParamsPointer,
+        long[] filterIds,
+        int filterIdsType,
+        int[] parentIds
+    );
+
+    /**
+     * Brute force a query against the vectors stored in a float or byte index. Distances are computed natively with
+     * the faiss kernels of the index storage, so the index must be HNSW or flat.
+     *
+     * @param indexPointer pointer to index in memory
+     * @param queryVector vector to be used for query
+     * @param k neighbors to be returned
+     * @param filterIds list of doc ids to score, null to score every doc of the index
+     * @param filterIdsType how to filter ids: Batch, BitMap or Ranges
+     * @return KNNQueryResult array of k neighbors
+     */
+    public static native KNNQueryResult[] exactSearch(long indexPointer, float[] queryVector, int k, long[] filterIds, int filterIdsType);
+
+    /**
+     * Brute force a query against the vectors stored in a binary HNSW index
+     *
+     * @param indexPointer pointer to index in memory
+     * @param queryVector vector to be used for query
+     * @param k neighbors to be returned
+     * @param filterIds list of doc ids to score, null to score every doc of the index
+     * @param filterIdsType how to filter ids: Batch, BitMap or Ranges
+     * @return KNNQueryResult array of k neighbors
+     */
+    public static native KNNQueryResult[] exactSearchBinary(
+        long indexPointer,
+        byte[] queryVector,
+        int k,
+        long[] filterIds,
+        int filterIdsType
+    );
+
+    /**
+     * Queue a query on the native search thread pool and return without waiting for it. The query and filter are
+     * copied, so the arrays may be reused once this returns. The index must stay loaded until the task is released
+     * with getSearchTaskResults or freeSearchTask.
+     *
+     * @param indexPointer pointer to index in memory
+     * @param queryVector vector to be used for query
+     * @param k neighbors to be returned
+     * @param methodParameters method parameter
+     * @param filterIds list of doc ids to include in the results, null for no filter
+     * @param filterIdsType how to filter ids: Batch, BitMap or Ranges
+     * @param parentIds list of parent doc ids when the knn field is a nested field
+     * @return handle to the search task
+     */
+    public static native long submitQueryIndex(
+        long indexPointer,
+        float[] queryVector,
+        int k,
+        Map<String, ?> methodParameters,
+        long[] filterIds,
+        int filterIdsType,
+        int[] parentIds
+    );
+
+    /**
+     * Query several indexes, one per segment, in a single call and return the k nearest neighbors over all of them.
+     * The k-th best distance found so far bounds the search of the segments that follow, so segments likely to hold
+     * the best hits, such as the largest ones, should come first.
+     *
+     * @param indexPointers pointers to the indexes in memory, one per segment
+     * @param docBases doc id offset of each segment, added to the ids of its results
+     * @param queryVector vector to be used for query
+     * @param k neighbors to be returned
+     * @param methodParameters method parameter
+     * @param filterIds doc ids to include in the results of each segment, null or a null element for no filter
+     * @param filterIdsTypes how to filter the ids of each segment: Batch, BitMap or Ranges
+     * @return KNNQueryResult array of k neighbors, with doc base offset ids
+     */
+    public static native KNNQueryResult[] queryIndexes(
+        long[] indexPointers,
+        int[] docBases,
+        float[] queryVector,
+        int k,
+        Map<String, ?> methodParameters,
+        long[][] filterIds,
+        int[] filterIdsTypes
+    );
+
+    /**
+     * Check whether a search task has finished, without waiting for it
+     *
+     * @param searchTaskPointer handle returned by submitQueryIndex
+     * @return true once the results can be read without blocking
+     */
+    public static native boolean isSearchTaskDone(long searchTaskPointer);
+
+    /**
+     * Wait for a search task to finish, release it and return its results. The handle must not be used afterwards.
+     *
+     * @param searchTaskPointer handle returned by submitQueryIndex
+     * @return KNNQueryResult array of k neighbors
+     */
+    public static native KNNQueryResult[] getSearchTaskResults(long searchTaskPointer);
+
+    /**
+     * Wait for a search task to finish and release it without reading its results
+     *
+     * @param searchTaskPointer handle returned by submitQueryIndex
+     */
+    public static native void freeSearchTask(long searchTaskPointer);
+
+    /**
+     * Query a binary index and write the results into caller provided arrays, so that no KNNQueryResult object is
+     * allocated per hit.
+     *
+     * @param indexPointer pointer to index in memory
+     * @param queryVector vector to be used for query
+     * @param k neighbors to be returned
+     * @param methodParameters method parameter
+     * @param filterIds list of doc ids to include in the query result, null to search without filter
+     * @param filterIdsType how to filter ids: Batch, BitMap or Ranges
+     * @param parentIds list of parent doc ids when the knn field is a nested field
+     * @param resultIds output array for the doc ids of the neighbors
+     * @param resultDistances output array for the distances of the neighbors
+     * @return number of results found, at most k. When it is larger than resultIds.length, only the first
+     *         resultIds.length results are written
+     */
+    public static native int queryBinaryIndexIntoArrays(
+        long indexPointer,
+        byte[] queryVector,
+        int k,
+        Map<String, ?> methodParameters,
+        long[] filterIds,
+        int filterIdsType,
+        int[] parentIds,
+        int[] resultIds,
+        float[] resultDistances
+    );
+
     /**
      * Free native memory pointer
      */
@@ -387,8 +799,11 @@ class FaissService {
     /**
      * Initialize library
      *
+     * @param searchThreadPoolSize number of threads of the native search thread pool, 0 for one less than the number
+     *                             of cores
+     * @param pinSearchThreads whether to pin the native search threads to cores
      */
-    public static native void initLibrary();
+    public static native void initLibrary(int searchThreadPoolSize, boolean pinSearchThreads);
 
     /**
      * Train an empty index
@@ -420,6 +835,111 @@ class FaissService {
      */
     public static native byte[] trainByteIndex(Map<String, Object> indexParameters, int dimension, long trainVectorsPointer);
 
+    /**
+     * Train an empty index and write it to the given output instead of returning its bytes
+     *
+     * @param indexParameters parameters used to build index
+     * @param dimension dimension for the index
+     * @param trainVectorsPointer pointer to where training vectors are stored in native memory
+     * @param output Index output wrapper the trained template index is written to
+     */
+    public static native void trainIndexWithStream(
+        Map<String, Object> indexParameters,
+        int dimension,
+        long trainVectorsPointer,
+        IndexOutputWithBuffer output
+    );
+
+    /**
+     * Train an empty binary index and write it to the given output instead of returning its bytes
+     *
+     * @param indexParameters parameters used to build index
+     * @param dimension dimension for the index
+     * @param trainVectorsPointer pointer to where training vectors are stored in native memory
+     * @param output Index output wrapper the trained template index is written to
+     */
+    public static native void trainBinaryIndexWithStream(
+        Map<String, Object> indexParameters,
+        int dimension,
+        long trainVectorsPointer,
+        IndexOutputWithBuffer output
+    );
+
+    /**
+     * Train an empty byte index and write it to the given output instead of returning its bytes
+     *
+     * @param indexParameters parameters used to build index
+     * @param dimension dimension for the index
+     * @param trainVectorsPointer pointer to where training vectors are stored in native memory
+     * @param output Index output wrapper the trained template index is written to
+     */
+    public static native void trainByteIndexWithStream(
+        Map<String, Object> indexParameters,
+        int dimension,
+        long trainVectorsPointer,
+        IndexOutputWithBuffer output
+    );
+
+    /**
+     * Start a training session for an index on float vectors. The session keeps a bounded, uniform sample of the
+     * vectors it is fed, sized to what training the index makes use of.
+     *
+     * @param indexParameters parameters used to build index
+     * @param dimension dimension for the index
+     * @return address of the training session
+     */
+    public static native long initTrainingSession(Map<String, Object> indexParameters, int dimension);
+
+    /**
+     * Start a training session for a binary index
+     *
+     * @param indexParameters parameters used to build index
+     * @param dimension dimension for the index
+     * @return address of the training session
+     */
+    public static native long initBinaryTrainingSession(Map<String, Object> indexParameters, int dimension);
+
+    /**
+     * Start a training session for a byte index
+     *
+     * @param indexParameters parameters used to build index
+     * @param dimension dimension for the index
+     * @return address of the training session
+     */
+    public static native long initByteTrainingSession(Map<String, Object> indexParameters, int dimension);
+
+    /**
+     * Sample a batch of training vectors into a training session. The vectors are copied, so the caller still owns
+     * the batch and may free it once this returns.
+     *
+     * @param sessionPointer address of the training session
+     * @param trainVectorsPointer pointer to where the batch of training vectors is stored in native memory
+     */
+    public static native void addTrainingVectors(long sessionPointer, long trainVectorsPointer);
+
+    /**
+     * Train the index of a training session on its sample
+     *
+     * @param sessionPointer address of the training session
+     * @return bytes array of trained template index
+     */
+    public static native byte[] trainFromSession(long sessionPointer);
+
+    /**
+     * Train the index of a training session on its sample and write it to the given output
+     *
+     * @param sessionPointer address of the training session
+     * @param output Index output wrapper the trained template index is written to
+     */
+    public static native void trainFromSessionWithStream(long sessionPointer, IndexOutputWithBuffer output);
+
+    /**
+     * Free a training session and its sample
+     *
+     * @param sessionPointer address of the training session
+     */
+    public static native void freeTrainingSession(long sessionPointer);
+
     /**
      * Range search index with filter
      *
@@ -463,4 +983,128 @@ class FaissService {
         int indexMaxResultWindow,
         int[] parentIds
     );
+
+    /**
+     * Range search index and write the results into caller provided arrays, so that no KNNQueryResult object is
+     * allocated per hit.
+     *
+     * @param indexPointer pointer to index in memory
+     * @param queryVector vector to be used for query
+     * @param radius search within radius threshold
+     * @param methodParameters parameters to be used for the query
+     * @param indexMaxResultWindow maximum number of results to return
+     * @param filteredIds list of doc ids to include in the query result, null to search without filter
+     * @param filterIdsType type of filter ids
+     * @param parentIds list of parent doc ids when the knn field is a nested field
+     * @param resultIds output array for the doc ids of the neighbors
+     * @param resultDistances output array for the distances of the neighbors
+     * @return number of results found, at most indexMaxResultWindow. When it is larger than resultIds.length, only the
+     *         first resultIds.length results are written
+     */
+    public static native int rangeSearchIndexIntoArrays(
+        long indexPointer,
+        float[] queryVector,
+        float radius,
+        Map<String, ?> methodParameters,
+        int indexMaxResultWindow,
+        long[] filteredIds,
+        int filterIdsType,
+        int[] parentIds,
+        int[] resultIds,
+        float[] resultDistances
+    );
+
+    /**
+     * Count the docs within radius of the query vector without collecting them
+     *
+     * @param indexPointer pointer to index in memory
+     * @param queryVector vector to be used for query
+     * @param radius search within radius threshold
+     * @param methodParameters parameters to be used for the query
+     * @param filteredIds list of doc ids to count, null to count without filter
+     * @param filterIdsType type of filter ids
+     * @return number of docs within radius
+     */
+    public static native int rangeSearchIndexCount(
+        long indexPointer,
+        float[] queryVector,
+        float radius,
+        Map<String, ?> methodParameters,
+        long[] filteredIds,
+        int filterIdsType
+    );
+
+    /**
+     * Range search binary index with filter
+     *
+     * @param indexPointer pointer to index in memory
+     * @param queryVector binary code to be used for query
+     * @param radius search within hamming radius threshold
+     * @param methodParameters parameters to be used for the query
+     * @param indexMaxResultWindow maximum number of results to return
+     * @param filteredIds list of doc ids to include in the query result
+     * @param filterIdsType type of filter ids
+     * @param parentIds list of parent doc ids when the knn field is a nested field
+     * @return KNNQueryResult array of neighbors within radius
+     */
+    public static native KNNQueryResult[] rangeSearchBinaryIndexWithFilter(
+        long indexPointer,
+        byte[] queryVector,
+        float radius,
+        Map<String, ?> methodParameters,
+        int indexMaxResultWindow,
+        long[] filteredIds,
+        int filterIdsType,
+        int[] parentIds
+    );
+
+    /**
+     * Range search binary index with filter and write the results into caller provided arrays, so that no
+     * KNNQueryResult object is allocated per hit.
+     *
+     * @param indexPointer pointer to index in memory
+     * @param queryVector binary code to be used for query
+     * @param radius search within hamming radius threshold
+     * @param methodParameters parameters to be used for the query
+     * @param indexMaxResultWindow maximum number of results to return
+     * @param filteredIds list of doc ids to include in the query result, null to search without filter
+     * @param filterIdsType type of filter ids
+     * @param parentIds list of parent doc ids when the knn field is a nested field
+     * @param resultIds output array for the doc ids of the neighbors
+     * @param resultDistances output array for the distances of the neighbors
+     * @return number of results found, at most indexMaxResultWindow. When it is larger than resultIds.length, only the
+     *         first resultIds.length results are written
+     */
+    public static native int rangeSearchBinaryIndexIntoArrays(
+        long indexPointer,
+        byte[] queryVector,
+        float radius,
+        Map<String, ?> methodParameters,
+        int indexMaxResultWindow,
+        long[] filteredIds,
+        int filterIdsType,
+        int[] parentIds,
+        int[] resultIds,
+        float[] resultDistances
+    );
+
+    /**
+     * Range search binary index
+     *
+     * @param indexPointer pointer to index in memory
+     * @param queryVector binary code to be used for query
+     * @param radius search within hamming radius threshold
+     * @param methodParameters parameters to be used for the query
+     * @param indexMaxResultWindow maximum number of results to return
+     * @param parentIds list of parent doc ids when the knn field is a nested field
+     * @return KNNQueryResult array of neighbors within radius
+     */
+    public static native KNNQueryResult[] rangeSearchBinaryIndex(
+        long indexPointer,
+        byte[] queryVector,
+        float radius,
+        Map<String, ?> methodParameters,
+        int indexMaxResultWindow,
+        int[] parentIds
+    );
 }
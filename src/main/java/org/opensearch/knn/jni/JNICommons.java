@@ -15,6 +15,7 @@ import org.opensearch.knn.common.KNNConstants;
 
 import java.security.AccessController;
 import java.security.PrivilegedAction;
+import java.util.Map;
 
 /**
  * Common class for providing the JNI related functionality to various JNIServices.
@@ -189,4 +190,26 @@ public class JNICommons {
      * @param memoryAddress address to be freed.
      */
     public static native void freeByteVectorData(long memoryAddress);
+
+    /**
+     * Resolves the query time method parameters (ef_search, nprobes) once into native memory. The returned handle can
+     * be passed to the WithSearchParams query variants in place of the parameters map, so the map is not walked
+     * through JNI on every query.
+     *
+     * <p>
+     * The handle is read only once created, so it can be shared by concurrent queries. It must be released with
+     * {@link JNICommons#freeSearchParams(long)}.
+     * </p>
+     *
+     * @param methodParameters query time method parameters, may be null
+     * @return handle to the compiled search parameters
+     */
+    public static native long compileSearchParams(Map<String, ?> methodParameters);
+
+    /**
+     * Free up the memory allocated by {@link JNICommons#compileSearchParams(Map)}
+     *
+     * @param searchParamsPointer handle to be freed.
+     */
+    public static native void freeSearchParams(long searchParamsPointer);
 }
@@ -55,6 +55,33 @@ public class JNIService {
         );
     }
 
+    /**
+     * Estimate the native memory of the index initIndex creates for the same parameters, once numDocs vectors are
+     * inserted into it. Lets the memory be accounted for before the build starts.
+     *
+     * @param numDocs    number of documents to be added
+     * @param dim        dimension of the vector to be indexed
+     * @param parameters parameters to build index
+     * @param knnEngine  knn engine
+     * @return estimated size of the index in bytes
+     */
+    public static long estimateIndexMemory(long numDocs, int dim, Map<String, Object> parameters, KNNEngine knnEngine) {
+        if (KNNEngine.FAISS == knnEngine) {
+            if (IndexUtil.isBinaryIndex(knnEngine, parameters)) {
+                return FaissService.estimateBinaryIndexMemory(numDocs, dim, parameters);
+            }
+            if (IndexUtil.isByteIndex(parameters)) {
+                return FaissService.estimateByteIndexMemory(numDocs, dim, parameters);
+            }
+
+            return FaissService.estimateIndexMemory(numDocs, dim, parameters);
+        }
+
+        throw new IllegalArgumentException(
+            String.format(Locale.ROOT, "estimateIndexMemory not supported for provided engine : %s", knnEngine.getName())
+        );
+    }
+
     /**
      * Inserts to a faiss index.
      *
@@ -90,6 +117,90 @@ public class JNIService {
         );
     }
 
+    /**
+     * Starts the native background thread that adds the batches of one build to a faiss index, so the caller can fill
+     * its next batch into another buffer while one is added. The same thread serves every batch of the build, and must
+     * be stopped with {@link #stopInsertWorker} once the build is done.
+     *
+     * @param dimension      dimension of the vector to be indexed
+     * @param parameters     parameters to build index
+     * @param indexAddress   address of native memory where index is stored
+     * @param knnEngine      knn engine
+     * @return handle to the insert worker, to be passed to {@link #submitInsertToIndex}
+     */
+    public static long startInsertWorker(int dimension, Map<String, Object> parameters, long indexAddress, KNNEngine knnEngine) {
+        int threadCount = (int) parameters.getOrDefault(KNNConstants.INDEX_THREAD_QTY, 0);
+        if (KNNEngine.FAISS == knnEngine) {
+            if (IndexUtil.isBinaryIndex(knnEngine, parameters)) {
+                return FaissService.startBinaryInsertWorker(indexAddress, dimension, threadCount);
+            } else if (IndexUtil.isByteIndex(parameters)) {
+                return FaissService.startByteInsertWorker(indexAddress, dimension, threadCount);
+            }
+            return FaissService.startInsertWorker(indexAddress, dimension, threadCount);
+        }
+
+        throw new IllegalArgumentException(
+            String.format(Locale.ROOT, "startInsertWorker not supported for provided engine : %s", knnEngine.getName())
+        );
+    }
+
+    /**
+     * Queues a batch to be added by an insert worker and returns without waiting for it. Batches are added in the
+     * order they are submitted.
+     *
+     * @param insertWorker   handle returned by {@link #startInsertWorker}
+     * @param docs           ids of documents
+     * @param vectorsAddress address of native memory where vectors are stored, left untouched until the batch is waited for
+     * @param knnEngine      knn engine
+     * @return number of the batch, to be passed to {@link #waitForInsertToIndex}
+     */
+    public static long submitInsertToIndex(long insertWorker, int[] docs, long vectorsAddress, KNNEngine knnEngine) {
+        if (KNNEngine.FAISS == knnEngine) {
+            return FaissService.submitInsertToIndex(insertWorker, docs, vectorsAddress);
+        }
+
+        throw new IllegalArgumentException(
+            String.format(Locale.ROOT, "submitInsertToIndex not supported for provided engine : %s", knnEngine.getName())
+        );
+    }
+
+    /**
+     * Waits for an insert worker to be done with a batch returned by {@link #submitInsertToIndex} and the ones submitted
+     * before it. Throws if an insert failed.
+     *
+     * @param insertWorker handle returned by {@link #startInsertWorker}
+     * @param insertBatch  number of the batch
+     * @param knnEngine    knn engine
+     */
+    public static void waitForInsertToIndex(long insertWorker, long insertBatch, KNNEngine knnEngine) {
+        if (KNNEngine.FAISS == knnEngine) {
+            FaissService.waitForInsertToIndex(insertWorker, insertBatch);
+            return;
+        }
+
+        throw new IllegalArgumentException(
+            String.format(Locale.ROOT, "waitForInsertToIndex not supported for provided engine : %s", knnEngine.getName())
+        );
+    }
+
+    /**
+     * Stops an insert worker returned by {@link #startInsertWorker} and releases it, once the batch it is adding is done.
+     * Batches still queued are dropped.
+     *
+     * @param insertWorker handle of the insert worker, must not be used afterwards
+     * @param knnEngine    knn engine
+     */
+    public static void stopInsertWorker(long insertWorker, KNNEngine knnEngine) {
+        if (KNNEngine.FAISS == knnEngine) {
+            FaissService.stopInsertWorker(insertWorker);
+            return;
+        }
+
+        throw new IllegalArgumentException(
+            String.format(Locale.ROOT, "stopInsertWorker not supported for provided engine : %s", knnEngine.getName())
+        );
+    }
+
     /**
      * Writes a faiss index to disk.
      *
@@ -185,6 +296,18 @@ public class JNIService {
         );
     }
 
+    /**
+     * Drop the template index the native library keeps for a model
+     *
+     * @param modelId   id of the model
+     * @param knnEngine engine of the model
+     */
+    public static void evictTemplateIndex(String modelId, KNNEngine knnEngine) {
+        if (KNNEngine.FAISS == knnEngine) {
+            FaissService.evictTemplateIndex(modelId);
+        }
+    }
+
     /**
      * Load an index via Lucene's IndexInput.
      *
@@ -213,6 +336,58 @@ public class JNIService {
         );
     }
 
+    /**
+     * Load an index by mapping its file into memory instead of copying it. Only faiss indices without ADC can be
+     * mapped, the others are loaded with {@link #loadIndex}.
+     *
+     * @param indexPath  Path of the index file, on a local filesystem
+     * @param parameters Parameters to be used when loading index
+     * @param knnEngine  Engine to load index
+     * @return Pointer to location in memory the index resides in
+     */
+    public static long loadIndexWithMmap(String indexPath, Map<String, Object> parameters, KNNEngine knnEngine) {
+        if (KNNEngine.FAISS == knnEngine && IndexUtil.isADCEnabled(knnEngine, parameters) == false) {
+            if (IndexUtil.isBinaryIndex(knnEngine, parameters)) {
+                return FaissService.loadBinaryIndexWithMmap(indexPath);
+            }
+            return FaissService.loadIndexWithMmap(indexPath);
+        }
+
+        throw new IllegalArgumentException(
+            String.format(Locale.ROOT, "LoadIndexWithMmap not supported for provided engine : %s", knnEngine.getName())
+        );
+    }
+
+    /**
+     * Load the index of the largest segment of a merge to add the vectors of the other segments to, instead of
+     * building the merged index from scratch. Only faiss HNSW indices over flat codes can be carried over.
+     *
+     * @param readStream A wrapper having Lucene's IndexInput to load bytes from a file.
+     * @param docMap     doc id in the merged segment of every doc of the segment, or -1 for a deleted doc
+     * @param numDocs    number of docs with vectors in the merged segment
+     * @param parameters Parameters of the merged index
+     * @param knnEngine  Engine to load index
+     * @return Pointer to location in memory the index resides in, or 0 when the index has to be built from scratch
+     */
+    public static long loadIndexForMerge(
+        IndexInputWithBuffer readStream,
+        int[] docMap,
+        long numDocs,
+        Map<String, Object> parameters,
+        KNNEngine knnEngine
+    ) {
+        if (KNNEngine.FAISS == knnEngine) {
+            if (IndexUtil.isBinaryIndex(knnEngine, parameters)) {
+                return FaissService.loadBinaryIndexForMerge(readStream, docMap, numDocs, parameters);
+            }
+            return FaissService.loadIndexForMerge(readStream, docMap, numDocs, parameters);
+        }
+
+        throw new IllegalArgumentException(
+            String.format(Locale.ROOT, "LoadIndexForMerge not supported for provided engine : %s", knnEngine.getName())
+        );
+    }
+
     /**
      * Determine if index contains shared state. Currently, we cannot do this in the plugin because we do not store the
      * model definition anywhere. Only faiss supports indices that have shared state. So for all other engines it will
@@ -273,7 +448,7 @@ public class JNIService {
      * @param methodParameters method parameter
      * @param knnEngine        engine to query index
      * @param filteredIds      array of ints on which should be used for search.
-     * @param filterIdsType    how to filter ids: Batch or BitMap
+     * @param filterIdsType    how to filter ids: Batch, BitMap or Ranges
      * @return KNNQueryResult array of k neighbors
      */
     public static KNNQueryResult[] queryIndex(
@@ -314,115 +489,713 @@ public class JNIService {
     }
 
     /**
-     * Query a binary index
+     * Compile query time method parameters into a native handle that can be reused across queries instead of passing
+     * the parameters map on every query. The handle is engine independent and must be released with
+     * {@link JNIService#freeSearchParams(long)}.
      *
-     * @param indexPointer     pointer to index in memory
-     * @param queryVector      vector to be used for query
-     * @param k                neighbors to be returned
      * @param methodParameters method parameter
-     * @param knnEngine        engine to query index
-     * @param filteredIds      array of ints on which should be used for search.
-     * @param filterIdsType    how to filter ids: Batch or BitMap
+     * @return handle to the compiled search parameters
+     */
+    public static long compileSearchParams(@Nullable Map<String, ?> methodParameters) {
+        return JNICommons.compileSearchParams(methodParameters);
+    }
+
+    /**
+     * Free a handle returned by {@link JNIService#compileSearchParams(Map)}
+     *
+     * @param searchParamsPointer handle to be freed
+     */
+    public static void freeSearchParams(long searchParamsPointer) {
+        JNICommons.freeSearchParams(searchParamsPointer);
+    }
+
+    /**
+     * Query an index with query time parameters compiled by {@link JNIService#compileSearchParams(Map)}
+     *
+     * @param indexPointer        pointer to index in memory
+     * @param queryVector         vector to be used for query
+     * @param k                   neighbors to be returned
+     * @param searchParamsPointer handle to the compiled search parameters, 0 to use the index defaults
+     * @param knnEngine           engine to query index
+     * @param filteredIds         array of ints on which should be used for search.
+     * @param filterIdsType       how to filter ids: Batch, BitMap or Ranges
+     * @param parentIds           list of parent doc ids when the knn field is a nested field
      * @return KNNQueryResult array of k neighbors
      */
-    public static KNNQueryResult[] queryBinaryIndex(
+    public static KNNQueryResult[] queryIndexWithSearchParams(
         long indexPointer,
-        byte[] queryVector,
+        float[] queryVector,
         int k,
-        @Nullable Map<String, ?> methodParameters,
+        long searchParamsPointer,
         KNNEngine knnEngine,
         long[] filteredIds,
         int filterIdsType,
         int[] parentIds
     ) {
+        if (KNNEngine.NMSLIB == knnEngine) {
+            return NmslibService.queryIndexWithSearchParams(indexPointer, queryVector, k, searchParamsPointer);
+        }
+
         if (KNNEngine.FAISS == knnEngine) {
-            return FaissService.queryBinaryIndexWithFilter(
+            return FaissService.queryIndexWithSearchParams(
                 indexPointer,
                 queryVector,
                 k,
-                methodParameters,
-                ArrayUtils.isEmpty(filteredIds) ? null : filteredIds,
+                searchParamsPointer,
+                ArrayUtils.isNotEmpty(filteredIds) ? filteredIds : null,
                 filterIdsType,
                 parentIds
             );
         }
         throw new IllegalArgumentException(
-            String.format(Locale.ROOT, "QueryBinaryIndex not supported for provided engine : %s", knnEngine.getName())
+            String.format(Locale.ROOT, "QueryIndexWithSearchParams not supported for provided engine : %s", knnEngine.getName())
         );
     }
 
     /**
-     * Free native memory pointer
+     * Query an index with query time parameters compiled by {@link JNIService#compileSearchParams(Map)} and write the
+     * results into caller provided arrays
      *
-     * @param indexPointer location to be freed
-     * @param knnEngine    engine to perform free
+     * @param indexPointer        pointer to index in memory
+     * @param queryVector         vector to be used for query
+     * @param k                   neighbors to be returned
+     * @param searchParamsPointer handle to the compiled search parameters, 0 to use the index defaults
+     * @param knnEngine           engine to query index
+     * @param filteredIds         array of ints on which should be used for search.
+     * @param filterIdsType       how to filter ids: Batch, BitMap or Ranges
+     * @param parentIds           list of parent doc ids when the knn field is a nested field
+     * @param resultIds           output array for the doc ids, results are written from index 0
+     * @param resultDistances     output array for the distances, results are written from index 0
+     * @return number of results found. When it is larger than resultIds.length, only the first resultIds.length
+     *         results are written
      */
-    public static void free(final long indexPointer, final KNNEngine knnEngine) {
-        free(indexPointer, knnEngine, false);
+    public static int queryIndexWithSearchParamsIntoArrays(
+        long indexPointer,
+        float[] queryVector,
+        int k,
+        long searchParamsPointer,
+        KNNEngine knnEngine,
+        long[] filteredIds,
+        int filterIdsType,
+        int[] parentIds,
+        int[] resultIds,
+        float[] resultDistances
+    ) {
+        if (KNNEngine.FAISS == knnEngine) {
+            return FaissService.queryIndexWithSearchParamsIntoArrays(
+                indexPointer,
+                queryVector,
+                k,
+                searchParamsPointer,
+                ArrayUtils.isNotEmpty(filteredIds) ? filteredIds : null,
+                filterIdsType,
+                parentIds,
+                resultIds,
+                resultDistances
+            );
+        }
+        throw new IllegalArgumentException(
+            String.format(Locale.ROOT, "QueryIndexWithSearchParamsIntoArrays not supported for provided engine : %s", knnEngine.getName())
+        );
     }
 
     /**
-     * Free native memory pointer
+     * Query an index and write the results into caller provided arrays instead of allocating a KNNQueryResult per hit
      *
-     * @param indexPointer  location to be freed
-     * @param knnEngine     engine to perform free
-     * @param isBinaryIndex indicate if it is binary index or not
+     * @param indexPointer     pointer to index in memory
+     * @param queryVector      vector to be used for query
+     * @param k                neighbors to be returned
+     * @param methodParameters method parameter
+     * @param knnEngine        engine to query index
+     * @param filteredIds      array of ints on which should be used for search.
+     * @param filterIdsType    how to filter ids: Batch, BitMap or Ranges
+     * @param parentIds        list of parent doc ids when the knn field is a nested field
+     * @param resultIds        output array for the doc ids, results are written from index 0
+     * @param resultDistances  output array for the distances, results are written from index 0
+     * @return number of results found. When it is larger than resultIds.length, only the first resultIds.length
+     *         results are written
      */
-    public static void free(final long indexPointer, final KNNEngine knnEngine, final boolean isBinaryIndex) {
+    public static int queryIndexIntoArrays(
+        long indexPointer,
+        float[] queryVector,
+        int k,
+        @Nullable Map<String, ?> methodParameters,
+        KNNEngine knnEngine,
+        long[] filteredIds,
+        int filterIdsType,
+        int[] parentIds,
+        int[] resultIds,
+        float[] resultDistances
+    ) {
         if (KNNEngine.NMSLIB == knnEngine) {
-            NmslibService.free(indexPointer);
-            return;
+            return NmslibService.queryIndexIntoArrays(indexPointer, queryVector, k, methodParameters, resultIds, resultDistances);
         }
 
         if (KNNEngine.FAISS == knnEngine) {
-            FaissService.free(indexPointer, isBinaryIndex);
-            return;
+            return FaissService.queryIndexIntoArrays(
+                indexPointer,
+                queryVector,
+                k,
+                methodParameters,
+                ArrayUtils.isNotEmpty(filteredIds) ? filteredIds : null,
+                filterIdsType,
+                parentIds,
+                resultIds,
+                resultDistances
+            );
         }
-
-        throw new IllegalArgumentException(String.format(Locale.ROOT, "Free not supported for provided engine : %s", knnEngine.getName()));
+        throw new IllegalArgumentException(
+            String.format(Locale.ROOT, "QueryIndexIntoArrays not supported for provided engine : %s", knnEngine.getName())
+        );
     }
 
     /**
-     * Deallocate memory of the shared index state
+     * Query an index with a batch of query vectors sharing the same filter and parent ids
      *
-     * @param shareIndexStateAddr address of shared state
-     * @param knnEngine           engine
+     * @param indexPointer     pointer to index in memory
+     * @param queryVectors     query vectors packed back to back, the number of queries is queryVectors.length / dimension
+     * @param k                neighbors to be returned per query
+     * @param methodParameters method parameter
+     * @param knnEngine        engine to query index
+     * @param filteredIds      array of ints on which should be used for search.
+     * @param filterIdsType    how to filter ids: Batch, BitMap or Ranges
+     * @param parentIds        list of parent doc ids when the knn field is a nested field
+     * @param resultIds        output array of at least numQueries * k ids, -1 where a query has less than k results
+     * @param resultDistances  output array of at least numQueries * k distances
      */
-    public static void freeSharedIndexState(long shareIndexStateAddr, KNNEngine knnEngine) {
+    public static void queryIndexBatch(
+        long indexPointer,
+        float[] queryVectors,
+        int k,
+        @Nullable Map<String, ?> methodParameters,
+        KNNEngine knnEngine,
+        long[] filteredIds,
+        int filterIdsType,
+        int[] parentIds,
+        int[] resultIds,
+        float[] resultDistances
+    ) {
         if (KNNEngine.FAISS == knnEngine) {
-            FaissService.freeSharedIndexState(shareIndexStateAddr);
+            FaissService.queryIndexBatch(
+                indexPointer,
+                queryVectors,
+                k,
+                methodParameters,
+                ArrayUtils.isNotEmpty(filteredIds) ? filteredIds : null,
+                filterIdsType,
+                parentIds,
+                resultIds,
+                resultDistances
+            );
             return;
         }
         throw new IllegalArgumentException(
-            String.format(Locale.ROOT, "FreeSharedIndexState not supported for provided engine : %s", knnEngine.getName())
+            String.format(Locale.ROOT, "QueryIndexBatch not supported for provided engine : %s", knnEngine.getName())
         );
     }
 
     /**
-     * Train an empty index
+     * Query a binary index
      *
-     * @param indexParameters     parameters used to build index
-     * @param dimension           dimension for the index
-     * @param trainVectorsPointer pointer to where training vectors are stored in native memory
-     * @param knnEngine           engine to perform the training
-     * @return bytes array of trained template index
+     * @param indexPointer     pointer to index in memory
+     * @param queryVector      vector to be used for query
+     * @param k                neighbors to be returned
+     * @param methodParameters method parameter
+     * @param knnEngine        engine to query index
+     * @param filteredIds      array of ints on which should be used for search.
+     * @param filterIdsType    how to filter ids: Batch, BitMap or Ranges
+     * @return KNNQueryResult array of k neighbors
      */
-    public static byte[] trainIndex(Map<String, Object> indexParameters, int dimension, long trainVectorsPointer, KNNEngine knnEngine) {
+    public static KNNQueryResult[] queryBinaryIndex(
+        long indexPointer,
+        byte[] queryVector,
+        int k,
+        @Nullable Map<String, ?> methodParameters,
+        KNNEngine knnEngine,
+        long[] filteredIds,
+        int filterIdsType,
+        int[] parentIds
+    ) {
         if (KNNEngine.FAISS == knnEngine) {
-            if (IndexUtil.isBinaryIndex(knnEngine, indexParameters)) {
-                return FaissService.trainBinaryIndex(indexParameters, dimension, trainVectorsPointer);
-            }
-            if (IndexUtil.isByteIndex(indexParameters)) {
-                return FaissService.trainByteIndex(indexParameters, dimension, trainVectorsPointer);
-            }
-            return FaissService.trainIndex(indexParameters, dimension, trainVectorsPointer);
+            return FaissService.queryBinaryIndexWithFilter(
+                indexPointer,
+                queryVector,
+                k,
+                methodParameters,
+                ArrayUtils.isEmpty(filteredIds) ? null : filteredIds,
+                filterIdsType,
+                parentIds
+            );
         }
-
+        throw new IllegalArgumentException(
+            String.format(Locale.ROOT, "QueryBinaryIndex not supported for provided engine : %s", knnEngine.getName())
+        );
+    }
+
+    /**
+     * Query a binary index with query time parameters compiled by {@link JNIService#compileSearchParams(Map)}
+     *
+     * @param indexPointer        pointer to index in memory
+     * @param queryVector         vector to be used for query
+     * @param k                   neighbors to be returned
+     * @param searchParamsPointer handle to the compiled search parameters, 0 to use the index defaults
+     * @param knnEngine           engine to query index
+     * @param filteredIds         array of ints on which should be used for search.
+     * @param filterIdsType       how to filter ids: Batch, BitMap or Ranges
+     * @param parentIds           list of parent doc ids when the knn field is a nested field
+     * @return KNNQueryResult array of k neighbors
+     */
+    public static KNNQueryResult[] queryBinaryIndexWithSearchParams(
+        long indexPointer,
+        byte[] queryVector,
+        int k,
+        long searchParamsPointer,
+        KNNEngine knnEngine,
+        long[] filteredIds,
+        int filterIdsType,
+        int[] parentIds
+    ) {
+        if (KNNEngine.FAISS == knnEngine) {
+            return FaissService.queryBinaryIndexWithSearchParams(
+                indexPointer,
+                queryVector,
+                k,
+                searchParamsPointer,
+                ArrayUtils.isEmpty(filteredIds) ? null : filteredIds,
+                filterIdsType,
+                parentIds
+            );
+        }
+        throw new IllegalArgumentException(
+            String.format(Locale.ROOT, "QueryBinaryIndexWithSearchParams not supported for provided engine : %s", knnEngine.getName())
+        );
+    }
+
+    /**
+     * Brute force a query against the vectors stored in a float or byte index, using the native distance kernels
+     * of the index storage instead of reading the vectors back through Lucene
+     *
+     * @param indexPointer  pointer to index in memory
+     * @param queryVector   vector to be used for query
+     * @param k             neighbors to be returned
+     * @param knnEngine     engine to query index
+     * @param filteredIds   doc ids to score, null to score every doc of the index. An empty array matches no doc.
+     * @param filterIdsType how to filter ids: Batch, BitMap or Ranges
+     * @return KNNQueryResult array of k neighbors
+     */
+    public static KNNQueryResult[] exactSearch(
+        long indexPointer,
+        float[] queryVector,
+        int k,
+        KNNEngine knnEngine,
+        long[] filteredIds,
+        int filterIdsType
+    ) {
+        if (KNNEngine.FAISS == knnEngine) {
+            return FaissService.exactSearch(indexPointer, queryVector, k, filteredIds, filterIdsType);
+        }
+        throw new IllegalArgumentException(
+            String.format(Locale.ROOT, "ExactSearch not supported for provided engine : %s", knnEngine.getName())
+        );
+    }
+
+    /**
+     * Queue a query on the native search thread pool and return without waiting for it, so a query hitting many
+     * segments can have all of them searched at once. Filters and parent ids follow queryIndex. The index must stay
+     * loaded until the task is released with getSearchTaskResults or freeSearchTask.
+     *
+     * @param indexPointer     pointer to index in memory
+     * @param queryVector      vector to be used for query
+     * @param k                neighbors to be returned
+     * @param methodParameters method parameter
+     * @param knnEngine        engine to query index
+     * @param filteredIds      array of ints on which should be used for search.
+     * @param filterIdsType    how to filter ids: Batch, BitMap or Ranges
+     * @param parentIds        parent ids of the vectors
+     * @return handle to the search task
+     */
+    public static long submitQueryIndex(
+        long indexPointer,
+        float[] queryVector,
+        int k,
+        @Nullable Map<String, ?> methodParameters,
+        KNNEngine knnEngine,
+        long[] filteredIds,
+        int filterIdsType,
+        int[] parentIds
+    ) {
+        if (KNNEngine.FAISS == knnEngine) {
+            return FaissService.submitQueryIndex(
+                indexPointer,
+                queryVector,
+                k,
+                methodParameters,
+                ArrayUtils.isEmpty(filteredIds) ? null : filteredIds,
+                filterIdsType,
+                parentIds
+            );
+        }
+        throw new IllegalArgumentException(
+            String.format(Locale.ROOT, "SubmitQueryIndex not supported for provided engine : %s", knnEngine.getName())
+        );
+    }
+
+    /**
+     * Query the indexes of several segments in one call and return the k nearest neighbors over all of them. The k-th
+     * best distance found so far bounds the search of every later segment, so passing the largest segments first
+     * prunes the most. Nested fields are not supported.
+     *
+     * @param indexPointers    pointers to the indexes in memory, one per segment
+     * @param docBases         doc id offset of each segment, added to the ids of its results
+     * @param queryVector      vector to be used for query
+     * @param k                neighbors to be returned
+     * @param methodParameters method parameter
+     * @param knnEngine        engine to query the indexes
+     * @param filteredIds      doc ids to search in each segment, null or a null element for no filter
+     * @param filterIdsTypes   how to filter the ids of each segment: Batch, BitMap or Ranges
+     * @return KNNQueryResult array of k neighbors, with doc base offset ids
+     */
+    public static KNNQueryResult[] queryIndexes(
+        long[] indexPointers,
+        int[] docBases,
+        float[] queryVector,
+        int k,
+        @Nullable Map<String, ?> methodParameters,
+        KNNEngine knnEngine,
+        long[][] filteredIds,
+        int[] filterIdsTypes
+    ) {
+        if (KNNEngine.FAISS == knnEngine) {
+            return FaissService.queryIndexes(indexPointers, docBases, queryVector, k, methodParameters, filteredIds, filterIdsTypes);
+        }
+        throw new IllegalArgumentException(
+            String.format(Locale.ROOT, "QueryIndexes not supported for provided engine : %s", knnEngine.getName())
+        );
+    }
+
+    /**
+     * Check whether a search task returned by submitQueryIndex has finished, without waiting for it
+     *
+     * @param searchTaskPointer handle of the search task
+     * @param knnEngine         engine the task was submitted to
+     * @return true once the results can be read without blocking
+     */
+    public static boolean isSearchTaskDone(long searchTaskPointer, KNNEngine knnEngine) {
+        if (KNNEngine.FAISS == knnEngine) {
+            return FaissService.isSearchTaskDone(searchTaskPointer);
+        }
+        throw new IllegalArgumentException(
+            String.format(Locale.ROOT, "IsSearchTaskDone not supported for provided engine : %s", knnEngine.getName())
+        );
+    }
+
+    /**
+     * Wait for a search task returned by submitQueryIndex, release it and return its results
+     *
+     * @param searchTaskPointer handle of the search task, must not be used afterwards
+     * @param knnEngine         engine the task was submitted to
+     * @return KNNQueryResult array of k neighbors
+     */
+    public static KNNQueryResult[] getSearchTaskResults(long searchTaskPointer, KNNEngine knnEngine) {
+        if (KNNEngine.FAISS == knnEngine) {
+            return FaissService.getSearchTaskResults(searchTaskPointer);
+        }
+        throw new IllegalArgumentException(
+            String.format(Locale.ROOT, "GetSearchTaskResults not supported for provided engine : %s", knnEngine.getName())
+        );
+    }
+
+    /**
+     * Wait for a search task returned by submitQueryIndex and release it without reading its results
+     *
+     * @param searchTaskPointer handle of the search task, must not be used afterwards
+     * @param knnEngine         engine the task was submitted to
+     */
+    public static void freeSearchTask(long searchTaskPointer, KNNEngine knnEngine) {
+        if (KNNEngine.FAISS == knnEngine) {
+            FaissService.freeSearchTask(searchTaskPointer);
+            return;
+        }
+        throw new IllegalArgumentException(
+            String.format(Locale.ROOT, "FreeSearchTask not supported for provided engine : %s", knnEngine.getName())
+        );
+    }
+
+    /**
+     * Brute force a query against the vectors stored in a binary index
+     *
+     * @param indexPointer  pointer to index in memory
+     * @param queryVector   vector to be used for query
+     * @param k             neighbors to be returned
+     * @param knnEngine     engine to query index
+     * @param filteredIds   doc ids to score, null to score every doc of the index. An empty array matches no doc.
+     * @param filterIdsType how to filter ids: Batch, BitMap or Ranges
+     * @return KNNQueryResult array of k neighbors
+     */
+    public static KNNQueryResult[] exactSearchBinary(
+        long indexPointer,
+        byte[] queryVector,
+        int k,
+        KNNEngine knnEngine,
+        long[] filteredIds,
+        int filterIdsType
+    ) {
+        if (KNNEngine.FAISS == knnEngine) {
+            return FaissService.exactSearchBinary(indexPointer, queryVector, k, filteredIds, filterIdsType);
+        }
+        throw new IllegalArgumentException(
+            String.format(Locale.ROOT, "ExactSearchBinary not supported for provided engine : %s", knnEngine.getName())
+        );
+    }
+
+    /**
+     * Query a binary index and write the results into caller provided arrays instead of allocating a KNNQueryResult
+     * per hit
+     *
+     * @param indexPointer     pointer to index in memory
+     * @param queryVector      vector to be used for query
+     * @param k                neighbors to be returned
+     * @param methodParameters method parameter
+     * @param knnEngine        engine to query index
+     * @param filteredIds      array of ints on which should be used for search.
+     * @param filterIdsType    how to filter ids: Batch, BitMap or Ranges
+     * @param parentIds        list of parent doc ids when the knn field is a nested field
+     * @param resultIds        output array for the doc ids, results are written from index 0
+     * @param resultDistances  output array for the distances, results are written from index 0
+     * @return number of results found. When it is larger than resultIds.length, only the first resultIds.length
+     *         results are written
+     */
+    public static int queryBinaryIndexIntoArrays(
+        long indexPointer,
+        byte[] queryVector,
+        int k,
+        @Nullable Map<String, ?> methodParameters,
+        KNNEngine knnEngine,
+        long[] filteredIds,
+        int filterIdsType,
+        int[] parentIds,
+        int[] resultIds,
+        float[] resultDistances
+    ) {
+        if (KNNEngine.FAISS == knnEngine) {
+            return FaissService.queryBinaryIndexIntoArrays(
+                indexPointer,
+                queryVector,
+                k,
+                methodParameters,
+                ArrayUtils.isEmpty(filteredIds) ? null : filteredIds,
+                filterIdsType,
+                parentIds,
+                resultIds,
+                resultDistances
+            );
+        }
+        throw new IllegalArgumentException(
+            String.format(Locale.ROOT, "QueryBinaryIndexIntoArrays not supported for provided engine : %s", knnEngine.getName())
+        );
+    }
+
+    /**
+     * Free native memory pointer
+     *
+     * @param indexPointer location to be freed
+     * @param knnEngine    engine to perform free
+     */
+    public static void free(final long indexPointer, final KNNEngine knnEngine) {
+        free(indexPointer, knnEngine, false);
+    }
+
+    /**
+     * Free native memory pointer
+     *
+     * @param indexPointer  location to be freed
+     * @param knnEngine     engine to perform free
+     * @param isBinaryIndex indicate if it is binary index or not
+     */
+    public static void free(final long indexPointer, final KNNEngine knnEngine, final boolean isBinaryIndex) {
+        if (KNNEngine.NMSLIB == knnEngine) {
+            NmslibService.free(indexPointer);
+            return;
+        }
+
+        if (KNNEngine.FAISS == knnEngine) {
+            FaissService.free(indexPointer, isBinaryIndex);
+            return;
+        }
+
+        throw new IllegalArgumentException(String.format(Locale.ROOT, "Free not supported for provided engine : %s", knnEngine.getName()));
+    }
+
+    /**
+     * Deallocate memory of the shared index state
+     *
+     * @param shareIndexStateAddr address of shared state
+     * @param knnEngine           engine
+     */
+    public static void freeSharedIndexState(long shareIndexStateAddr, KNNEngine knnEngine) {
+        if (KNNEngine.FAISS == knnEngine) {
+            FaissService.freeSharedIndexState(shareIndexStateAddr);
+            return;
+        }
+        throw new IllegalArgumentException(
+            String.format(Locale.ROOT, "FreeSharedIndexState not supported for provided engine : %s", knnEngine.getName())
+        );
+    }
+
+    /**
+     * Train an empty index
+     *
+     * @param indexParameters     parameters used to build index
+     * @param dimension           dimension for the index
+     * @param trainVectorsPointer pointer to where training vectors are stored in native memory
+     * @param knnEngine           engine to perform the training
+     * @return bytes array of trained template index
+     */
+    public static byte[] trainIndex(Map<String, Object> indexParameters, int dimension, long trainVectorsPointer, KNNEngine knnEngine) {
+        if (KNNEngine.FAISS == knnEngine) {
+            if (IndexUtil.isBinaryIndex(knnEngine, indexParameters)) {
+                return FaissService.trainBinaryIndex(indexParameters, dimension, trainVectorsPointer);
+            }
+            if (IndexUtil.isByteIndex(indexParameters)) {
+                return FaissService.trainByteIndex(indexParameters, dimension, trainVectorsPointer);
+            }
+            return FaissService.trainIndex(indexParameters, dimension, trainVectorsPointer);
+        }
+
         throw new IllegalArgumentException(
             String.format(Locale.ROOT, "TrainIndex not supported for provided engine : %s", knnEngine.getName())
         );
     }
 
+    /**
+     * Train an empty index and write the trained template index to the given output. Unlike
+     * {@link #trainIndex(Map, int, long, KNNEngine)}, the serialized model is never materialized on the Java heap.
+     *
+     * @param indexParameters     parameters used to build index
+     * @param dimension           dimension for the index
+     * @param trainVectorsPointer pointer to where training vectors are stored in native memory
+     * @param output              Index output wrapper having Lucene's IndexOutput to be used to flush bytes in native engines.
+     * @param knnEngine           engine to perform the training
+     */
+    public static void trainIndex(
+        Map<String, Object> indexParameters,
+        int dimension,
+        long trainVectorsPointer,
+        IndexOutputWithBuffer output,
+        KNNEngine knnEngine
+    ) {
+        if (KNNEngine.FAISS == knnEngine) {
+            if (IndexUtil.isBinaryIndex(knnEngine, indexParameters)) {
+                FaissService.trainBinaryIndexWithStream(indexParameters, dimension, trainVectorsPointer, output);
+            } else if (IndexUtil.isByteIndex(indexParameters)) {
+                FaissService.trainByteIndexWithStream(indexParameters, dimension, trainVectorsPointer, output);
+            } else {
+                FaissService.trainIndexWithStream(indexParameters, dimension, trainVectorsPointer, output);
+            }
+            return;
+        }
+
+        throw new IllegalArgumentException(
+            String.format(Locale.ROOT, "TrainIndex not supported for provided engine : %s", knnEngine.getName())
+        );
+    }
+
+    /**
+     * Start a training session. Batches of training vectors are then fed with
+     * {@link #addTrainingVectors(long, long, KNNEngine)}, and only a bounded sample of them, sized to what training the
+     * index makes use of, is kept in native memory.
+     *
+     * @param indexParameters parameters used to build index
+     * @param dimension       dimension for the index
+     * @param knnEngine       engine to perform the training
+     * @return address of the training session
+     */
+    public static long initTrainingSession(Map<String, Object> indexParameters, int dimension, KNNEngine knnEngine) {
+        if (KNNEngine.FAISS == knnEngine) {
+            if (IndexUtil.isBinaryIndex(knnEngine, indexParameters)) {
+                return FaissService.initBinaryTrainingSession(indexParameters, dimension);
+            }
+            if (IndexUtil.isByteIndex(indexParameters)) {
+                return FaissService.initByteTrainingSession(indexParameters, dimension);
+            }
+            return FaissService.initTrainingSession(indexParameters, dimension);
+        }
+
+        throw new IllegalArgumentException(
+            String.format(Locale.ROOT, "InitTrainingSession not supported for provided engine : %s", knnEngine.getName())
+        );
+    }
+
+    /**
+     * Sample a batch of training vectors into a training session. The caller still owns the batch afterwards.
+     *
+     * @param sessionPointer      address of the training session
+     * @param trainVectorsPointer pointer to where the batch of training vectors is stored in native memory
+     * @param knnEngine           engine to perform the training
+     */
+    public static void addTrainingVectors(long sessionPointer, long trainVectorsPointer, KNNEngine knnEngine) {
+        if (KNNEngine.FAISS == knnEngine) {
+            FaissService.addTrainingVectors(sessionPointer, trainVectorsPointer);
+            return;
+        }
+
+        throw new IllegalArgumentException(
+            String.format(Locale.ROOT, "AddTrainingVectors not supported for provided engine : %s", knnEngine.getName())
+        );
+    }
+
+    /**
+     * Train the index of a training session on its sample
+     *
+     * @param sessionPointer address of the training session
+     * @param knnEngine      engine to perform the training
+     * @return bytes array of trained template index
+     */
+    public static byte[] trainFromSession(long sessionPointer, KNNEngine knnEngine) {
+        if (KNNEngine.FAISS == knnEngine) {
+            return FaissService.trainFromSession(sessionPointer);
+        }
+
+        throw new IllegalArgumentException(
+            String.format(Locale.ROOT, "TrainFromSession not supported for provided engine : %s", knnEngine.getName())
+        );
+    }
+
+    /**
+     * Train the index of a training session on its sample and write it to the given output
+     *
+     * @param sessionPointer address of the training session
+     * @param output         Index output wrapper having Lucene's IndexOutput to be used to flush bytes in native engines.
+     * @param knnEngine      engine to perform the training
+     */
+    public static void trainFromSession(long sessionPointer, IndexOutputWithBuffer output, KNNEngine knnEngine) {
+        if (KNNEngine.FAISS == knnEngine) {
+            FaissService.trainFromSessionWithStream(sessionPointer, output);
+            return;
+        }
+
+        throw new IllegalArgumentException(
+            String.format(Locale.ROOT, "TrainFromSession not supported for provided engine : %s", knnEngine.getName())
+        );
+    }
+
+    /**
+     * Free a training session and its sample
+     *
+     * @param sessionPointer address of the training session
+     * @param knnEngine      engine the session was started with
+     */
+    public static void freeTrainingSession(long sessionPointer, KNNEngine knnEngine) {
+        if (KNNEngine.FAISS == knnEngine) {
+            FaissService.freeTrainingSession(sessionPointer);
+            return;
+        }
+
+        throw new IllegalArgumentException(
+            String.format(Locale.ROOT, "FreeTrainingSession not supported for provided engine : %s", knnEngine.getName())
+        );
+    }
+
     /**
      * Range search index for a given query vector
      *
@@ -433,7 +1206,7 @@ public class JNIService {
      * @param knnEngine            engine to query index
      * @param indexMaxResultWindow maximum number of results to return
      * @param filteredIds          list of doc ids to include in the query result
-     * @param filterIdsType        how to filter ids: Batch or BitMap
+     * @param filterIdsType        how to filter ids: Batch, BitMap or Ranges
      * @param parentIds            parent ids of the vectors
      * @return KNNQueryResult array of neighbors within radius
      */
@@ -465,4 +1238,186 @@ public class JNIService {
         }
         throw new IllegalArgumentException(String.format(Locale.ROOT, "RadiusQueryIndex not supported for provided engine"));
     }
+
+    /**
+     * Range search binary index for a given query code. Hits are the docs within radius hamming distance.
+     *
+     * @param indexPointer         pointer to index in memory
+     * @param queryVector          binary code to be used for query
+     * @param radius               search within hamming radius threshold
+     * @param methodParameters     parameters to be used when loading index
+     * @param knnEngine            engine to query index
+     * @param indexMaxResultWindow maximum number of results to return
+     * @param filteredIds          list of doc ids to include in the query result
+     * @param filterIdsType        how to filter ids: Batch, BitMap or Ranges
+     * @param parentIds            parent ids of the vectors
+     * @return KNNQueryResult array of neighbors within radius
+     */
+    public static KNNQueryResult[] radiusQueryBinaryIndex(
+        long indexPointer,
+        byte[] queryVector,
+        float radius,
+        @Nullable Map<String, ?> methodParameters,
+        KNNEngine knnEngine,
+        int indexMaxResultWindow,
+        long[] filteredIds,
+        int filterIdsType,
+        int[] parentIds
+    ) {
+        if (KNNEngine.FAISS == knnEngine) {
+            if (ArrayUtils.isNotEmpty(filteredIds)) {
+                return FaissService.rangeSearchBinaryIndexWithFilter(
+                    indexPointer,
+                    queryVector,
+                    radius,
+                    methodParameters,
+                    indexMaxResultWindow,
+                    filteredIds,
+                    filterIdsType,
+                    parentIds
+                );
+            }
+            return FaissService.rangeSearchBinaryIndex(
+                indexPointer,
+                queryVector,
+                radius,
+                methodParameters,
+                indexMaxResultWindow,
+                parentIds
+            );
+        }
+        throw new IllegalArgumentException(String.format(Locale.ROOT, "RadiusQueryBinaryIndex not supported for provided engine"));
+    }
+
+    /**
+     * Range search index for a given query vector and write the results into caller provided arrays instead of
+     * allocating a KNNQueryResult per hit
+     *
+     * @param indexPointer         pointer to index in memory
+     * @param queryVector          vector to be used for query
+     * @param radius               search within radius threshold
+     * @param methodParameters     parameters to be used when loading index
+     * @param knnEngine            engine to query index
+     * @param indexMaxResultWindow maximum number of results to return
+     * @param filteredIds          list of doc ids to include in the query result
+     * @param filterIdsType        how to filter ids: Batch, BitMap or Ranges
+     * @param parentIds            parent ids of the vectors
+     * @param resultIds            output array for the doc ids, results are written from index 0
+     * @param resultDistances      output array for the distances, results are written from index 0
+     * @return number of results found. When it is larger than resultIds.length, only the first resultIds.length
+     *         results are written
+     */
+    public static int radiusQueryIndexIntoArrays(
+        long indexPointer,
+        float[] queryVector,
+        float radius,
+        @Nullable Map<String, ?> methodParameters,
+        KNNEngine knnEngine,
+        int indexMaxResultWindow,
+        long[] filteredIds,
+        int filterIdsType,
+        int[] parentIds,
+        int[] resultIds,
+        float[] resultDistances
+    ) {
+        if (KNNEngine.FAISS == knnEngine) {
+            return FaissService.rangeSearchIndexIntoArrays(
+                indexPointer,
+                queryVector,
+                radius,
+                methodParameters,
+                indexMaxResultWindow,
+                ArrayUtils.isNotEmpty(filteredIds) ? filteredIds : null,
+                filterIdsType,
+                parentIds,
+                resultIds,
+                resultDistances
+            );
+        }
+        throw new IllegalArgumentException(String.format(Locale.ROOT, "RadiusQueryIndexIntoArrays not supported for provided engine"));
+    }
+
+    /**
+     * Range search binary index for a given query code and write the results into caller provided arrays instead of
+     * allocating a KNNQueryResult per hit
+     *
+     * @param indexPointer         pointer to index in memory
+     * @param queryVector          binary code to be used for query
+     * @param radius               search within hamming radius threshold
+     * @param methodParameters     parameters to be used when loading index
+     * @param knnEngine            engine to query index
+     * @param indexMaxResultWindow maximum number of results to return
+     * @param filteredIds          list of doc ids to include in the query result
+     * @param filterIdsType        how to filter ids: Batch, BitMap or Ranges
+     * @param parentIds            parent ids of the vectors
+     * @param resultIds            output array for the doc ids, results are written from index 0
+     * @param resultDistances      output array for the distances, results are written from index 0
+     * @return number of results found. When it is larger than resultIds.length, only the first resultIds.length
+     *         results are written
+     */
+    public static int radiusQueryBinaryIndexIntoArrays(
+        long indexPointer,
+        byte[] queryVector,
+        float radius,
+        @Nullable Map<String, ?> methodParameters,
+        KNNEngine knnEngine,
+        int indexMaxResultWindow,
+        long[] filteredIds,
+        int filterIdsType,
+        int[] parentIds,
+        int[] resultIds,
+        float[] resultDistances
+    ) {
+        if (KNNEngine.FAISS == knnEngine) {
+            return FaissService.rangeSearchBinaryIndexIntoArrays(
+                indexPointer,
+                queryVector,
+                radius,
+                methodParameters,
+                indexMaxResultWindow,
+                ArrayUtils.isNotEmpty(filteredIds) ? filteredIds : null,
+                filterIdsType,
+                parentIds,
+                resultIds,
+                resultDistances
+            );
+        }
+        throw new IllegalArgumentException(
+            String.format(Locale.ROOT, "RadiusQueryBinaryIndexIntoArrays not supported for provided engine")
+        );
+    }
+
+    /**
+     * Count the docs within radius of a given query vector without collecting them
+     *
+     * @param indexPointer         pointer to index in memory
+     * @param queryVector          vector to be used for query
+     * @param radius               search within radius threshold
+     * @param methodParameters     parameters to be used when loading index
+     * @param knnEngine            engine to query index
+     * @param filteredIds          list of doc ids to count
+     * @param filterIdsType        how to filter ids: Batch, BitMap or Ranges
+     * @return number of docs within radius
+     */
+    public static int radiusQueryIndexCount(
+        long indexPointer,
+        float[] queryVector,
+        float radius,
+        @Nullable Map<String, ?> methodParameters,
+        KNNEngine knnEngine,
+        long[] filteredIds,
+        int filterIdsType
+    ) {
+        if (KNNEngine.FAISS == knnEngine) {
+            return FaissService.rangeSearchIndexCount(
+                indexPointer,
+                queryVector,
+                radius,
+                methodParameters,
+                ArrayUtils.isNotEmpty(filteredIds) ? filteredIds : null,
+                filterIdsType
+            );
+        }
+        throw new IllegalArgumentException(String.format(Locale.ROOT, "RadiusQueryIndexCount not supported for provided engine"));
+    }
 }
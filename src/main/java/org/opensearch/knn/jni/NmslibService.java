@@ -83,6 +83,42 @@ class NmslibService {
      */
     public static native KNNQueryResult[] queryIndex(long indexPointer, float[] queryVector, int k, Map<String, ?> methodParameters);
 
+    /**
+     * Query an index with query time parameters compiled by {@link JNICommons#compileSearchParams(Map)}
+     *
+     * @param indexPointer pointer to index in memory
+     * @param queryVector vector to be used for query
+     * @param k neighbors to be returned
+     * @param searchParamsPointer handle to the compiled search parameters, 0 to use the index defaults
+     * @return KNNQueryResult array of k neighbors
+     */
+    public static native KNNQueryResult[] queryIndexWithSearchParams(
+        long indexPointer,
+        float[] queryVector,
+        int k,
+        long searchParamsPointer
+    );
+
+    /**
+     * Query an index and write the results into caller provided arrays
+     *
+     * @param indexPointer pointer to index in memory
+     * @param queryVector vector to be used for query
+     * @param k neighbors to be returned
+     * @param resultIds output array for the doc ids of the neighbors
+     * @param resultDistances output array for the distances of the neighbors
+     * @return number of results found, at most k. When it is larger than resultIds.length, only the first
+     *         resultIds.length results are written
+     */
+    public static native int queryIndexIntoArrays(
+        long indexPointer,
+        float[] queryVector,
+        int k,
+        Map<String, ?> methodParameters,
+        int[] resultIds,
+        float[] resultDistances
+    );
+
     /**
      * Free native memory pointer
      */
@@ -8,9 +8,15 @@ package org.opensearch.knn.index.codec.nativeindex;
 import lombok.SneakyThrows;
 import org.mockito.ArgumentCaptor;
 import org.mockito.MockedStatic;
+import org.apache.lucene.store.Directory;
+import org.apache.lucene.store.IOContext;
+import org.apache.lucene.store.IndexInput;
+import org.apache.lucene.util.FixedBitSet;
 import org.mockito.Mockito;
+import org.opensearch.knn.index.KNNSettings;
 import org.opensearch.knn.index.VectorDataType;
 import org.opensearch.knn.index.codec.nativeindex.model.BuildIndexParams;
+import org.opensearch.knn.index.codec.nativeindex.model.MergeGraphSource;
 import org.opensearch.knn.index.codec.transfer.OffHeapVectorTransfer;
 import org.opensearch.knn.index.codec.transfer.OffHeapVectorTransferFactory;
 import org.opensearch.knn.index.engine.KNNEngine;
@@ -27,6 +33,9 @@ import org.opensearch.test.OpenSearchTestCase;
 import java.util.List;
 import java.util.Map;
 
+import static org.mockito.ArgumentMatchers.any;
+import static org.mockito.ArgumentMatchers.anyInt;
+import static org.mockito.ArgumentMatchers.anyLong;
 import static org.mockito.ArgumentMatchers.eq;
 import static org.mockito.Mockito.mock;
 import static org.mockito.Mockito.times;
@@ -246,4 +255,157 @@ public class MemOptimizedNativeIndexBuildStrategyTests extends OpenSearchTestCas
             }
         }
     }
+
+    @SneakyThrows
+    public void testBuildAndWrite_withPipelinedIngestion() {
+        // Given
+        List<float[]> vectorValues = List.of(new float[] { 1, 2 }, new float[] { 2, 3 }, new float[] { 3, 4 });
+        final TestVectorValues.PreDefinedFloatVectorValues randomVectorValues = new TestVectorValues.PreDefinedFloatVectorValues(
+            vectorValues
+        );
+        final KNNVectorValues<byte[]> knnVectorValues = KNNVectorValuesFactory.getVectorValues(VectorDataType.FLOAT, randomVectorValues);
+
+        try (
+            MockedStatic<JNIService> mockedJNIService = Mockito.mockStatic(JNIService.class);
+            MockedStatic<OffHeapVectorTransferFactory> mockedOffHeapVectorTransferFactory = Mockito.mockStatic(
+                OffHeapVectorTransferFactory.class
+            );
+            MockedStatic<KNNSettings> mockedKNNSettings = Mockito.mockStatic(KNNSettings.class)
+        ) {
+            mockedKNNSettings.when(KNNSettings::isPipelinedIngestionEnabled).thenReturn(true);
+            mockedJNIService.when(() -> JNIService.initIndex(3, 2, Map.of("index", "param"), KNNEngine.FAISS)).thenReturn(100L);
+
+            // Limits transfer to 1 vector, so every vector fills a buffer and the two buffers take turns
+            OffHeapVectorTransfer firstTransfer = mock(OffHeapVectorTransfer.class);
+            OffHeapVectorTransfer secondTransfer = mock(OffHeapVectorTransfer.class);
+            mockedOffHeapVectorTransferFactory.when(() -> OffHeapVectorTransferFactory.getVectorTransfer(VectorDataType.FLOAT, 8, 3))
+                .thenReturn(firstTransfer)
+                .thenReturn(secondTransfer);
+            when(firstTransfer.getTransferLimit()).thenReturn(1);
+            when(firstTransfer.transfer(any(), eq(false))).thenReturn(true);
+            when(firstTransfer.getVectorAddress()).thenReturn(200L);
+            when(secondTransfer.getTransferLimit()).thenReturn(1);
+            when(secondTransfer.transfer(any(), eq(false))).thenReturn(true);
+            when(secondTransfer.getVectorAddress()).thenReturn(300L);
+            mockedJNIService.when(() -> JNIService.startInsertWorker(2, Map.of("index", "param"), 100L, KNNEngine.FAISS))
+                .thenReturn(400L);
+            mockedJNIService.when(() -> JNIService.submitInsertToIndex(eq(400L), any(), anyLong(), any()))
+                .thenReturn(1L)
+                .thenReturn(2L)
+                .thenReturn(3L);
+
+            IndexOutputWithBuffer indexOutputWithBuffer = Mockito.mock(IndexOutputWithBuffer.class);
+            BuildIndexParams buildIndexParams = BuildIndexParams.builder()
+                .indexOutputWithBuffer(indexOutputWithBuffer)
+                .knnEngine(KNNEngine.FAISS)
+                .vectorDataType(VectorDataType.FLOAT)
+                .parameters(Map.of("index", "param"))
+                .knnVectorValuesSupplier(() -> knnVectorValues)
+                .totalLiveDocs((int) knnVectorValues.totalLiveDocs())
+                .build();
+
+            // When
+            MemOptimizedNativeIndexBuildStrategy.getInstance().buildAndWriteIndex(buildIndexParams);
+
+            // Then
+            long[] expectedAddresses = { 200L, 300L, 200L };
+            for (int i = 0; i < expectedAddresses.length; i++) {
+                final int docId = i;
+                mockedJNIService.verify(
+                    () -> JNIService.submitInsertToIndex(
+                        eq(400L),
+                        eq(new int[] { docId }),
+                        eq(expectedAddresses[docId]),
+                        eq(KNNEngine.FAISS)
+                    )
+                );
+                mockedJNIService.verify(() -> JNIService.waitForInsertToIndex(eq(400L), eq(docId + 1L), eq(KNNEngine.FAISS)));
+            }
+            // A single worker serves every batch of the build and is stopped before the index is written
+            mockedJNIService.verify(() -> JNIService.startInsertWorker(anyInt(), any(), anyLong(), any()), times(1));
+            mockedJNIService.verify(() -> JNIService.stopInsertWorker(eq(400L), eq(KNNEngine.FAISS)));
+            mockedJNIService.verify(() -> JNIService.insertToIndex(any(), anyLong(), anyInt(), any(), anyLong(), any()), times(0));
+            mockedJNIService.verify(
+                () -> JNIService.writeIndex(eq(indexOutputWithBuffer), eq(100L), eq(KNNEngine.FAISS), eq(Map.of("index", "param")))
+            );
+            verify(firstTransfer).close();
+            verify(secondTransfer).close();
+        }
+    }
+
+    @SneakyThrows
+    public void testBuildAndWrite_withMergeGraphSource() {
+        // Given
+        List<float[]> vectorValues = List.of(new float[] { 1, 2 }, new float[] { 2, 3 }, new float[] { 3, 4 });
+        final TestVectorValues.PreDefinedFloatVectorValues randomVectorValues = new TestVectorValues.PreDefinedFloatVectorValues(
+            vectorValues
+        );
+        final KNNVectorValues<byte[]> knnVectorValues = KNNVectorValuesFactory.getVectorValues(VectorDataType.FLOAT, randomVectorValues);
+
+        try (
+            MockedStatic<JNIService> mockedJNIService = Mockito.mockStatic(JNIService.class);
+            MockedStatic<OffHeapVectorTransferFactory> mockedOffHeapVectorTransferFactory = Mockito.mockStatic(
+                OffHeapVectorTransferFactory.class
+            )
+        ) {
+            // Docs 0 and 2 of the merged segment come from the source segment, whose doc 1 was deleted
+            final int[] docMap = { 0, -1, 2 };
+            final FixedBitSet carriedOverDocs = new FixedBitSet(3);
+            carriedOverDocs.set(0);
+            carriedOverDocs.set(2);
+            Directory directory = mock(Directory.class);
+            IndexInput indexInput = mock(IndexInput.class);
+            when(directory.openInput("_0_165_target_field.faissc", IOContext.READONCE)).thenReturn(indexInput);
+            mockedJNIService.when(
+                () -> JNIService.loadIndexForMerge(any(), eq(docMap), eq(3L), eq(Map.of("index", "param")), eq(KNNEngine.FAISS))
+            ).thenReturn(100L);
+
+            OffHeapVectorTransfer offHeapVectorTransfer = mock(OffHeapVectorTransfer.class);
+            mockedOffHeapVectorTransferFactory.when(() -> OffHeapVectorTransferFactory.getVectorTransfer(VectorDataType.FLOAT, 8, 3))
+                .thenReturn(offHeapVectorTransfer);
+            when(offHeapVectorTransfer.getTransferLimit()).thenReturn(2);
+            when(offHeapVectorTransfer.transfer(any(), eq(false))).thenReturn(false);
+            when(offHeapVectorTransfer.flush(false)).thenReturn(true);
+            when(offHeapVectorTransfer.getVectorAddress()).thenReturn(200L);
+
+            IndexOutputWithBuffer indexOutputWithBuffer = Mockito.mock(IndexOutputWithBuffer.class);
+            BuildIndexParams buildIndexParams = BuildIndexParams.builder()
+                .indexOutputWithBuffer(indexOutputWithBuffer)
+                .knnEngine(KNNEngine.FAISS)
+                .vectorDataType(VectorDataType.FLOAT)
+                .parameters(Map.of("index", "param"))
+                .knnVectorValuesSupplier(() -> knnVectorValues)
+                .totalLiveDocs((int) knnVectorValues.totalLiveDocs())
+                .mergeGraphSource(
+                    MergeGraphSource.builder()
+                        .directory(directory)
+                        .fileName("_0_165_target_field.faissc")
+                        .docMap(docMap)
+                        .carriedOverDocs(carriedOverDocs)
+                        .build()
+                )
+                .build();
+
+            // When
+            MemOptimizedNativeIndexBuildStrategy.getInstance().buildAndWriteIndex(buildIndexParams);
+
+            // Then
+            mockedJNIService.verify(() -> JNIService.initIndex(anyLong(), anyInt(), any(), any()), times(0));
+            verify(offHeapVectorTransfer, times(1)).transfer(any(), eq(false));
+            mockedJNIService.verify(
+                () -> JNIService.insertToIndex(
+                    eq(new int[] { 1 }),
+                    eq(200L),
+                    eq(knnVectorValues.dimension()),
+                    eq(Map.of("index", "param")),
+                    eq(100L),
+                    eq(KNNEngine.FAISS)
+                )
+            );
+            mockedJNIService.verify(
+                () -> JNIService.writeIndex(eq(indexOutputWithBuffer), eq(100L), eq(KNNEngine.FAISS), eq(Map.of("index", "param")))
+            );
+            verify(indexInput).close();
+        }
+    }
 }
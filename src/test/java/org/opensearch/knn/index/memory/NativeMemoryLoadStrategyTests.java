@@ -17,7 +17,10 @@ import org.opensearch.core.action.ActionListener;
 import org.opensearch.action.search.SearchResponse;
 import org.opensearch.knn.KNNTestCase;
 import org.opensearch.knn.TestUtils;
+import org.mockito.MockedStatic;
+import org.mockito.Mockito;
 import org.opensearch.knn.common.KNNConstants;
+import org.opensearch.knn.index.KNNSettings;
 import org.opensearch.knn.index.VectorDataType;
 import org.opensearch.knn.index.engine.qframe.QuantizationConfig;
 import org.opensearch.knn.jni.JNICommons;
@@ -38,6 +41,7 @@ import static org.mockito.ArgumentMatchers.any;
 import static org.mockito.ArgumentMatchers.eq;
 import static org.mockito.Mockito.doAnswer;
 import static org.mockito.Mockito.mock;
+import static org.mockito.Mockito.mockStatic;
 
 public class NativeMemoryLoadStrategyTests extends KNNTestCase {
 
@@ -139,6 +143,58 @@ public class NativeMemoryLoadStrategyTests extends KNNTestCase {
         }
     }
 
+    public void testLoad_whenFaissMmapLoadEnabled_thenIndexFileIsMapped() throws IOException {
+        Path tempDirPath = createTempDir();
+        try (Directory luceneDirectory = newFSDirectory(tempDirPath)) {
+            KNNEngine knnEngine = KNNEngine.FAISS;
+            String indexFileName = "test1" + knnEngine.getExtension();
+            int numVectors = 10;
+            int dimension = 10;
+            int[] ids = new int[numVectors];
+            float[][] vectors = new float[numVectors][dimension];
+            for (int i = 0; i < numVectors; i++) {
+                ids[i] = i;
+                Arrays.fill(vectors[i], i);
+            }
+            Map<String, Object> parameters = ImmutableMap.of(
+                KNNConstants.SPACE_TYPE,
+                SpaceType.L2.getValue(),
+                KNNConstants.INDEX_DESCRIPTION_PARAMETER,
+                "HNSW32,Flat"
+            );
+            long memoryAddress = JNICommons.storeVectorData(0, vectors, numVectors * dimension);
+            TestUtils.createIndex(ids, memoryAddress, dimension, luceneDirectory, indexFileName, parameters, knnEngine);
+
+            NativeMemoryEntryContext.IndexEntryContext indexEntryContext = new NativeMemoryEntryContext.IndexEntryContext(
+                luceneDirectory,
+                TestUtils.createFakeNativeMamoryCacheKey(indexFileName),
+                NativeMemoryLoadStrategy.IndexLoadStrategy.getInstance(),
+                parameters,
+                "test"
+            );
+            indexEntryContext.open();
+
+            NativeMemoryAllocation.IndexAllocation indexAllocation;
+            try (
+                MockedStatic<KNNSettings> mockedKNNSettings = mockStatic(KNNSettings.class);
+                MockedStatic<JNIService> mockedJNIService = mockStatic(JNIService.class, Mockito.CALLS_REAL_METHODS)
+            ) {
+                mockedKNNSettings.when(KNNSettings::isFaissMmapLoadEnabled).thenReturn(true);
+                indexAllocation = indexEntryContext.load();
+                String indexPath = tempDirPath.toRealPath().resolve(indexFileName).toString();
+                mockedJNIService.verify(() -> JNIService.loadIndexWithMmap(indexPath, parameters, knnEngine));
+                mockedJNIService.verify(() -> JNIService.loadIndex(any(), any(), any()), Mockito.never());
+            }
+
+            // The vectors and the graph are read from the mapping
+            float[] query = new float[dimension];
+            Arrays.fill(query, 3);
+            KNNQueryResult[] results = JNIService.queryIndex(indexAllocation.getMemoryAddress(), query, 1, null, knnEngine, null, 0, null);
+            assertEquals(1, results.length);
+            assertEquals(3, results[0].getId());
+        }
+    }
+
     @SuppressWarnings("unchecked")
     public void testTrainingLoadStrategy_load() {
         // Mock the vector reader so that on read, it waits 2 seconds, transfers vectors to the consumer, and then calls
@@ -33,7 +33,7 @@ public class FilterIdsSelectorTests extends KNNTestCase {
     @SneakyThrows
     public void testGetIdSelectorTypeWithSparseBitSetHigh() {
         SparseFixedBitSet bits = new SparseFixedBitSet(101);
-        for (int i = 1; i <= 100; i++) {
+        for (int i = 1; i <= 100; i += 2) {
             bits.set(i);
         }
         FilterIdsSelector idsSelector = FilterIdsSelector.getFilterIdSelector(bits, bits.cardinality());
@@ -49,7 +49,7 @@ public class FilterIdsSelectorTests extends KNNTestCase {
         int maxDoc = (Integer.MAX_VALUE) / 2;
         SparseFixedBitSet bits = new SparseFixedBitSet(maxDoc);
         long array[] = new long[100];
-        for (int i = maxDoc - 100, idx = 0; i < maxDoc; i++) {
+        for (int i = maxDoc - 200, idx = 0; i < maxDoc; i += 2) {
             bits.set(i);
             array[idx++] = i;
         }
@@ -57,4 +57,32 @@ public class FilterIdsSelectorTests extends KNNTestCase {
         assertEquals(idsSelector.getFilterType(), FilterIdsSelector.FilterIdsSelectorType.BATCH);
         assertArrayEquals(array, idsSelector.filterIds);
     }
+
+    @SneakyThrows
+    public void testGetIdSelectorTypeWithSparseBitSetRanges() {
+        int maxDoc = 100000;
+        SparseFixedBitSet bits = new SparseFixedBitSet(maxDoc);
+        for (int i = 1000; i < 3000; i++) {
+            bits.set(i);
+        }
+        for (int i = 50000; i < 60000; i++) {
+            bits.set(i);
+        }
+        bits.set(maxDoc - 1);
+        FilterIdsSelector idsSelector = FilterIdsSelector.getFilterIdSelector(bits, bits.cardinality());
+        assertEquals(idsSelector.getFilterType(), FilterIdsSelector.FilterIdsSelectorType.RANGES);
+        assertArrayEquals(new long[] { 1000, 3000, 50000, 60000, maxDoc - 1, maxDoc }, idsSelector.filterIds);
+    }
+
+    @SneakyThrows
+    public void testGetIdSelectorTypeWithScatteredSparseBitSet() {
+        int maxDoc = 100000;
+        SparseFixedBitSet bits = new SparseFixedBitSet(maxDoc);
+        for (int i = 0; i < maxDoc; i += 10) {
+            bits.set(i);
+        }
+        // Every doc is its own run, so ranges would be twice the size of the ids
+        FilterIdsSelector idsSelector = FilterIdsSelector.getFilterIdSelector(bits, bits.cardinality());
+        assertEquals(idsSelector.getFilterType(), FilterIdsSelector.FilterIdsSelectorType.BITMAP);
+    }
 }
@@ -426,7 +426,39 @@ public class KNNQueryBuilderTests extends KNNTestCase {
         expectThrows(IllegalArgumentException.class, () -> knnQueryBuilder.doToQuery(mockQueryShardContext));
     }
 
-    public void testDoToQuery_whenRadialSearchOnBinaryIndex_thenException() {
+    public void testDoToQuery_whenRadialSearchOnBinaryIndex_whenFaissEngine_thenRadiusIsHammingDistance() {
+        float[] queryVector = { 1.0f };
+        byte[] expectedQueryVector = { 1 };
+        // A min score of 0.25 is a hamming distance of 3
+        List<KNNQueryBuilder> knnQueryBuilders = List.of(
+            KNNQueryBuilder.builder().fieldName(FIELD_NAME).vector(queryVector).maxDistance(3.0f).build(),
+            KNNQueryBuilder.builder().fieldName(FIELD_NAME).vector(queryVector).minScore(0.25f).build()
+        );
+        for (KNNQueryBuilder knnQueryBuilder : knnQueryBuilders) {
+            Index dummyIndex = new Index("dummy", "dummy");
+            QueryShardContext mockQueryShardContext = mock(QueryShardContext.class);
+            KNNVectorFieldType mockKNNVectorField = mock(KNNVectorFieldType.class);
+            when(mockQueryShardContext.index()).thenReturn(dummyIndex);
+            when(mockKNNVectorField.getVectorDataType()).thenReturn(VectorDataType.BINARY);
+            when(mockQueryShardContext.fieldMapper(anyString())).thenReturn(mockKNNVectorField);
+            IndexSettings indexSettings = mock(IndexSettings.class);
+            when(mockQueryShardContext.getIndexSettings()).thenReturn(indexSettings);
+            when(indexSettings.getMaxResultWindow()).thenReturn(1000);
+            MethodComponentContext methodComponentContext = new MethodComponentContext(
+                org.opensearch.knn.common.KNNConstants.METHOD_HNSW,
+                ImmutableMap.of()
+            );
+            KNNMethodContext knnMethodContext = new KNNMethodContext(KNNEngine.FAISS, SpaceType.HAMMING, methodComponentContext);
+            when(mockKNNVectorField.getKnnMappingConfig()).thenReturn(getMappingConfigForMethodMapping(knnMethodContext, 8));
+
+            KNNQuery query = (KNNQuery) knnQueryBuilder.doToQuery(mockQueryShardContext);
+            assertEquals(3.0f, query.getRadius(), 0);
+            assertArrayEquals(expectedQueryVector, query.getByteQueryVector());
+            assertEquals(VectorDataType.BINARY, query.getVectorDataType());
+        }
+    }
+
+    public void testDoToQuery_whenRadialSearchOnBinaryIndex_whenLuceneEngine_thenException() {
         float[] queryVector = { 1.0f };
         KNNQueryBuilder knnQueryBuilder = KNNQueryBuilder.builder()
             .fieldName(FIELD_NAME)
@@ -443,7 +475,7 @@ public class KNNQueryBuilderTests extends KNNTestCase {
             org.opensearch.knn.common.KNNConstants.METHOD_HNSW,
             ImmutableMap.of()
         );
-        KNNMethodContext knnMethodContext = new KNNMethodContext(KNNEngine.FAISS, SpaceType.HAMMING, methodComponentContext);
+        KNNMethodContext knnMethodContext = new KNNMethodContext(KNNEngine.LUCENE, SpaceType.HAMMING, methodComponentContext);
         when(mockKNNVectorField.getKnnMappingConfig()).thenReturn(getMappingConfigForMethodMapping(knnMethodContext, 8));
         Exception e = expectThrows(UnsupportedOperationException.class, () -> knnQueryBuilder.doToQuery(mockQueryShardContext));
         assertTrue(e.getMessage().contains("Binary data type does not support radial search"));
@@ -158,14 +158,39 @@ public class BinaryIndexIT extends KNNRestTestCase {
     }
 
     @SneakyThrows
-    public void testHnswBinary_whenRadialSearch_thenThrowException() {
+    public void testHnswBinary_whenRadialSearch_thenReturnDocsWithinHammingDistance() {
         // Create Index
         createKnnHnswBinaryIndex(engine, INDEX_NAME, FIELD_NAME, 16);
-
-        // Query
         float[] queryVector = { (byte) 0b10001111, (byte) 0b10000000 };
-        Exception e = expectThrows(Exception.class, () -> runRnnQuery(INDEX_NAME, FIELD_NAME, queryVector, 1, 4));
-        assertTrue(e.getMessage(), e.getMessage().contains("Binary data type does not support radial search"));
+        if (engine != KNNEngine.FAISS) {
+            Exception e = expectThrows(Exception.class, () -> runRnnQuery(INDEX_NAME, FIELD_NAME, queryVector, 1, 4));
+            assertTrue(e.getMessage(), e.getMessage().contains("Binary data type does not support radial search"));
+            return;
+        }
+
+        // Ingest, the docs are at hamming distances 6, 5, 4 and 3 of the query
+        Byte[] vector1 = { 0b00000001, 0b00000001 };
+        Byte[] vector2 = { 0b00000011, 0b00000001 };
+        Byte[] vector3 = { 0b00000111, 0b00000001 };
+        Byte[] vector4 = { 0b00001111, 0b00000001 };
+        addKnnDoc(INDEX_NAME, "1", FIELD_NAME, vector1);
+        addKnnDoc(INDEX_NAME, "2", FIELD_NAME, vector2);
+        addKnnDoc(INDEX_NAME, "3", FIELD_NAME, vector3);
+        addKnnDoc(INDEX_NAME, "4", FIELD_NAME, vector4);
+        refreshAllIndices();
+
+        // A min score of 1 / (1 + 4.5) keeps the docs within a hamming distance of 4.5
+        List<KNNResult> results = runRnnQuery(INDEX_NAME, FIELD_NAME, queryVector, 1 / 5.5f, 4);
+        assertEquals(2, results.size());
+        assertEquals("4", results.get(0).getDocId());
+        assertEquals("3", results.get(1).getDocId());
+
+        // Merged into a segment with a graph, the hits are the same
+        forceMergeKnnIndex(INDEX_NAME, 1);
+        results = runRnnQuery(INDEX_NAME, FIELD_NAME, queryVector, 1 / 5.5f, 4);
+        assertEquals(2, results.size());
+        assertEquals("4", results.get(0).getDocId());
+        assertEquals("3", results.get(1).getDocId());
     }
 
     private float getRecall(final Set<String> truth, final Set<String> result) {
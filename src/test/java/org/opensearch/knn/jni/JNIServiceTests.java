@@ -23,6 +23,7 @@ import org.opensearch.Version;
 import org.opensearch.common.xcontent.XContentFactory;
 import org.opensearch.core.xcontent.XContentBuilder;
 import org.opensearch.knn.KNNTestCase;
+import org.opensearch.knn.Pair;
 import org.opensearch.knn.TestUtils;
 import org.opensearch.knn.common.KNNConstants;
 import org.opensearch.knn.common.RaisingIOExceptionIndexInput;
@@ -806,6 +807,37 @@ public class JNIServiceTests extends KNNTestCase {
         }
     }
 
+    public void testWriteIndex_faiss_whenWritten_thenNativeChecksumMatchesIndexOutput() throws IOException {
+        Path tempDirPath = createTempDir();
+        String indexFileName1 = "test1" + UUID.randomUUID() + ".tmp";
+        Map<String, Object> parameters = ImmutableMap.of(
+            INDEX_DESCRIPTION_PARAMETER,
+            faissMethod,
+            KNNConstants.SPACE_TYPE,
+            SpaceType.L2.getValue()
+        );
+        try (Directory directory = newFSDirectory(tempDirPath)) {
+            long indexAddress = JNIService.initIndex(0, testData.indexData.getDimension(), parameters, KNNEngine.FAISS);
+            JNIService.insertToIndex(
+                testData.indexData.docs,
+                testData.loadDataToMemoryAddress(),
+                testData.indexData.getDimension(),
+                parameters,
+                indexAddress,
+                KNNEngine.FAISS
+            );
+            try (IndexOutput indexOutput = directory.createOutput(indexFileName1, IOContext.DEFAULT)) {
+                final IndexOutputWithBuffer indexOutputWithBuffer = new IndexOutputWithBuffer(indexOutput);
+                JNIService.writeIndex(indexOutputWithBuffer, indexAddress, KNNEngine.FAISS, parameters);
+                indexOutputWithBuffer.verifyNativeChecksum();
+
+                // A byte written behind the native engine's back is not verified
+                indexOutput.writeByte((byte) 0);
+                indexOutputWithBuffer.verifyNativeChecksum();
+            }
+        }
+    }
+
     @SneakyThrows
     public void testCreateIndex_binary_faiss_valid() {
         Path tempDirPath = createTempDir();
@@ -832,6 +864,40 @@ public class JNIServiceTests extends KNNTestCase {
         }
     }
 
+    public void testEstimateIndexMemory_faiss_valid() {
+        int dim = testData.indexData.getDimension();
+        for (SpaceType spaceType : ImmutableList.of(SpaceType.L2, SpaceType.INNER_PRODUCT)) {
+            Map<String, Object> parameters = ImmutableMap.of(
+                INDEX_DESCRIPTION_PARAMETER,
+                faissMethod,
+                KNNConstants.SPACE_TYPE,
+                spaceType.getValue()
+            );
+            long small = JNIService.estimateIndexMemory(1000, dim, parameters, KNNEngine.FAISS);
+            long large = JNIService.estimateIndexMemory(2000, dim, parameters, KNNEngine.FAISS);
+            // At least the flat vectors and the labels
+            assertTrue(small >= 1000L * (dim * Float.BYTES + Long.BYTES));
+            assertTrue(large > small);
+        }
+
+        Map<String, Object> binaryParameters = ImmutableMap.of(
+            INDEX_DESCRIPTION_PARAMETER,
+            faissBinaryMethod,
+            KNNConstants.SPACE_TYPE,
+            SpaceType.HAMMING.getValue(),
+            KNNConstants.VECTOR_DATA_TYPE_FIELD,
+            VectorDataType.BINARY.getValue()
+        );
+        long binary = JNIService.estimateIndexMemory(1000, dim, binaryParameters, KNNEngine.FAISS);
+        assertTrue(binary >= 1000L * (dim / Byte.SIZE + Long.BYTES));
+
+        expectThrows(
+            IllegalArgumentException.class,
+            () -> JNIService.estimateIndexMemory(1000, dim, ImmutableMap.of(), KNNEngine.NMSLIB)
+        );
+        expectThrows(Exception.class, () -> JNIService.estimateIndexMemory(1000, dim, ImmutableMap.of(), KNNEngine.FAISS));
+    }
+
     public void testLoadIndex_invalidEngine() {
         expectThrows(IllegalArgumentException.class, () -> JNIService.loadIndex(null, Collections.emptyMap(), KNNEngine.LUCENE));
     }
@@ -996,6 +1062,47 @@ public class JNIServiceTests extends KNNTestCase {
         }
     }
 
+    public void testLoadIndexForMerge_faiss_whenDocsAreDeleted_thenRemapsGraph() throws IOException {
+        Path tempDirPath = createTempDir();
+        String indexFileName1 = "test1" + UUID.randomUUID() + ".tmp";
+        Map<String, Object> parameters = ImmutableMap.of(
+            INDEX_DESCRIPTION_PARAMETER,
+            faissMethod,
+            KNNConstants.SPACE_TYPE,
+            SpaceType.L2.getValue()
+        );
+        try (Directory directory = newFSDirectory(tempDirPath)) {
+            TestUtils.createIndex(
+                testData.indexData.docs,
+                testData.loadDataToMemoryAddress(),
+                testData.indexData.getDimension(),
+                directory,
+                indexFileName1,
+                parameters,
+                KNNEngine.FAISS
+            );
+
+            // Every other doc is deleted and the others are compacted
+            int[] docMap = new int[Arrays.stream(testData.indexData.docs).max().getAsInt() + 1];
+            int numDocs = 0;
+            for (int i = 0; i < docMap.length; i++) {
+                docMap[i] = i % 2 == 0 ? -1 : numDocs++;
+            }
+
+            try (IndexInput indexInput = directory.openInput(indexFileName1, IOContext.DEFAULT)) {
+                final IndexInputWithBuffer indexInputWithBuffer = new IndexInputWithBuffer(indexInput);
+                long pointer = JNIService.loadIndexForMerge(indexInputWithBuffer, docMap, numDocs, parameters, KNNEngine.FAISS);
+                assertNotEquals(0, pointer);
+                JNIService.free(pointer, KNNEngine.FAISS);
+            }
+        }
+
+        expectThrows(
+            IllegalArgumentException.class,
+            () -> JNIService.loadIndexForMerge(null, new int[] {}, 0, Collections.emptyMap(), KNNEngine.NMSLIB)
+        );
+    }
+
     public void testQueryIndex_invalidEngine() {
         expectThrows(
             IllegalArgumentException.class,
@@ -1221,6 +1328,371 @@ public class JNIServiceTests extends KNNTestCase {
         }
     }
 
+    public void testQueryIndexBatch_faiss_valid() throws IOException {
+        int k = 10;
+        int efSearch = 100;
+
+        Path tempDirPath = createTempDir();
+        try (Directory directory = newFSDirectory(tempDirPath)) {
+            String indexFileName1 = createFaissHNSWIndex(directory, SpaceType.L2);
+
+            final long pointer;
+            try (IndexInput indexInput = directory.openInput(indexFileName1, IOContext.DEFAULT)) {
+                final IndexInputWithBuffer indexInputWithBuffer = new IndexInputWithBuffer(indexInput);
+                pointer = JNIService.loadIndex(
+                    indexInputWithBuffer,
+                    ImmutableMap.of(KNNConstants.SPACE_TYPE, SpaceType.L2.getValue()),
+                    KNNEngine.FAISS
+                );
+                assertNotEquals(0, pointer);
+            }
+
+            int numQueries = testData.queries.length;
+            int dimension = testData.queries[0].length;
+            float[] queryVectors = new float[numQueries * dimension];
+            for (int i = 0; i < numQueries; i++) {
+                System.arraycopy(testData.queries[i], 0, queryVectors, i * dimension, dimension);
+            }
+            int[] resultIds = new int[numQueries * k];
+            float[] resultDistances = new float[numQueries * k];
+
+            JNIService.queryIndexBatch(
+                pointer,
+                queryVectors,
+                k,
+                Map.of("ef_search", efSearch),
+                KNNEngine.FAISS,
+                null,
+                0,
+                null,
+                resultIds,
+                resultDistances
+            );
+
+            for (int i = 0; i < numQueries; i++) {
+                KNNQueryResult[] results = JNIService.queryIndex(
+                    pointer,
+                    testData.queries[i],
+                    k,
+                    Map.of("ef_search", efSearch),
+                    KNNEngine.FAISS,
+                    null,
+                    0,
+                    null
+                );
+                assertEquals(k, results.length);
+                for (int j = 0; j < k; j++) {
+                    assertEquals(results[j].getId(), resultIds[i * k + j]);
+                    assertEquals(results[j].getScore(), resultDistances[i * k + j], 0.00001);
+                }
+            }
+
+            // Filter will result in no ids
+            JNIService.queryIndexBatch(
+                pointer,
+                queryVectors,
+                k,
+                Map.of("ef_search", efSearch),
+                KNNEngine.FAISS,
+                new long[] { 0 },
+                0,
+                null,
+                resultIds,
+                resultDistances
+            );
+            for (int resultId : resultIds) {
+                assertEquals(-1, resultId);
+            }
+        }
+    }
+
+    public void testQueryIndexWithSearchParams_faiss_valid() throws IOException {
+        int k = 10;
+        int efSearch = 100;
+
+        Path tempDirPath = createTempDir();
+        try (Directory directory = newFSDirectory(tempDirPath)) {
+            String indexFileName1 = createFaissHNSWIndex(directory, SpaceType.L2);
+
+            final long pointer;
+            try (IndexInput indexInput = directory.openInput(indexFileName1, IOContext.DEFAULT)) {
+                final IndexInputWithBuffer indexInputWithBuffer = new IndexInputWithBuffer(indexInput);
+                pointer = JNIService.loadIndex(
+                    indexInputWithBuffer,
+                    ImmutableMap.of(KNNConstants.SPACE_TYPE, SpaceType.L2.getValue()),
+                    KNNEngine.FAISS
+                );
+                assertNotEquals(0, pointer);
+            }
+
+            long searchParamsPointer = JNIService.compileSearchParams(Map.of("ef_search", efSearch));
+            assertNotEquals(0, searchParamsPointer);
+            try {
+                for (float[] query : testData.queries) {
+                    KNNQueryResult[] expected = JNIService.queryIndex(
+                        pointer,
+                        query,
+                        k,
+                        Map.of("ef_search", efSearch),
+                        KNNEngine.FAISS,
+                        null,
+                        0,
+                        null
+                    );
+                    KNNQueryResult[] results = JNIService.queryIndexWithSearchParams(
+                        pointer,
+                        query,
+                        k,
+                        searchParamsPointer,
+                        KNNEngine.FAISS,
+                        null,
+                        0,
+                        null
+                    );
+                    assertEquals(expected.length, results.length);
+                    for (int j = 0; j < results.length; j++) {
+                        assertEquals(expected[j].getId(), results[j].getId());
+                        assertEquals(expected[j].getScore(), results[j].getScore(), 0.00001);
+                    }
+                }
+            } finally {
+                JNIService.freeSearchParams(searchParamsPointer);
+            }
+        }
+    }
+
+    public void testExactSearch_faiss_valid() throws IOException {
+        int k = 10;
+
+        Path tempDirPath = createTempDir();
+        try (Directory directory = newFSDirectory(tempDirPath)) {
+            String indexFileName1 = createFaissHNSWIndex(directory, SpaceType.L2);
+
+            final long pointer;
+            try (IndexInput indexInput = directory.openInput(indexFileName1, IOContext.DEFAULT)) {
+                final IndexInputWithBuffer indexInputWithBuffer = new IndexInputWithBuffer(indexInput);
+                pointer = JNIService.loadIndex(
+                    indexInputWithBuffer,
+                    ImmutableMap.of(KNNConstants.SPACE_TYPE, SpaceType.L2.getValue()),
+                    KNNEngine.FAISS
+                );
+                assertNotEquals(0, pointer);
+            }
+
+            // Score only every third doc
+            int[] docs = testData.indexData.docs;
+            float[][] vectors = testData.indexData.vectors;
+            long[] filterIds = new long[(docs.length + 2) / 3];
+            for (int i = 0; i < docs.length; i += 3) {
+                filterIds[i / 3] = docs[i];
+            }
+
+            for (float[] query : testData.queries) {
+                List<Pair<Integer, Float>> expected = new ArrayList<>();
+                for (int i = 0; i < docs.length; i += 3) {
+                    float distance = 0;
+                    for (int j = 0; j < query.length; j++) {
+                        distance += (query[j] - vectors[i][j]) * (query[j] - vectors[i][j]);
+                    }
+                    expected.add(new Pair<>(docs[i], distance));
+                }
+                expected.sort((a, b) -> Float.compare(a.getSecond(), b.getSecond()));
+
+                KNNQueryResult[] results = JNIService.exactSearch(pointer, query, k, KNNEngine.FAISS, filterIds, 1);
+                assertEquals(Math.min(k, filterIds.length), results.length);
+                for (int j = 0; j < results.length; j++) {
+                    assertEquals((int) expected.get(j).getFirst(), results[j].getId());
+                    assertEquals(expected.get(j).getSecond(), results[j].getScore(), 0.001f * expected.get(j).getSecond() + 0.001f);
+                }
+            }
+        }
+    }
+
+    public void testSubmitQueryIndex_faiss_valid() throws IOException {
+        int k = 10;
+        int efSearch = 100;
+
+        Path tempDirPath = createTempDir();
+        try (Directory directory = newFSDirectory(tempDirPath)) {
+            String indexFileName1 = createFaissHNSWIndex(directory, SpaceType.L2);
+
+            final long pointer;
+            try (IndexInput indexInput = directory.openInput(indexFileName1, IOContext.DEFAULT)) {
+                final IndexInputWithBuffer indexInputWithBuffer = new IndexInputWithBuffer(indexInput);
+                pointer = JNIService.loadIndex(
+                    indexInputWithBuffer,
+                    ImmutableMap.of(KNNConstants.SPACE_TYPE, SpaceType.L2.getValue()),
+                    KNNEngine.FAISS
+                );
+                assertNotEquals(0, pointer);
+            }
+
+            // Every query is in flight before the first results are collected
+            Map<String, ?> methodParameters = Map.of("ef_search", efSearch);
+            long[] tasks = new long[testData.queries.length];
+            for (int i = 0; i < testData.queries.length; i++) {
+                tasks[i] = JNIService.submitQueryIndex(pointer, testData.queries[i], k, methodParameters, KNNEngine.FAISS, null, 0, null);
+                assertNotEquals(0, tasks[i]);
+            }
+
+            for (int i = 0; i < testData.queries.length; i++) {
+                KNNQueryResult[] expected = JNIService.queryIndex(
+                    pointer,
+                    testData.queries[i],
+                    k,
+                    methodParameters,
+                    KNNEngine.FAISS,
+                    null,
+                    0,
+                    null
+                );
+                KNNQueryResult[] results = JNIService.getSearchTaskResults(tasks[i], KNNEngine.FAISS);
+                assertEquals(expected.length, results.length);
+                for (int j = 0; j < results.length; j++) {
+                    assertEquals(expected[j].getId(), results[j].getId());
+                    assertEquals(expected[j].getScore(), results[j].getScore(), 0.0001f);
+                }
+            }
+
+            // A dropped task is waited for and released
+            long task = JNIService.submitQueryIndex(pointer, testData.queries[0], k, null, KNNEngine.FAISS, null, 0, null);
+            JNIService.freeSearchTask(task, KNNEngine.FAISS);
+
+            expectThrows(
+                IllegalArgumentException.class,
+                () -> JNIService.submitQueryIndex(pointer, testData.queries[0], k, null, KNNEngine.NMSLIB, null, 0, null)
+            );
+            JNIService.free(pointer, KNNEngine.FAISS);
+        }
+    }
+
+    public void testQueryIndexes_faiss_valid() throws IOException {
+        int k = 10;
+        int efSearch = 100;
+        int docBase = 100000;
+
+        Path tempDirPath = createTempDir();
+        try (Directory directory = newFSDirectory(tempDirPath)) {
+            String indexFileName1 = createFaissHNSWIndex(directory, SpaceType.L2);
+
+            // The same index loaded twice stands for two segments holding the same vectors
+            long[] pointers = new long[2];
+            for (int i = 0; i < pointers.length; i++) {
+                try (IndexInput indexInput = directory.openInput(indexFileName1, IOContext.DEFAULT)) {
+                    final IndexInputWithBuffer indexInputWithBuffer = new IndexInputWithBuffer(indexInput);
+                    pointers[i] = JNIService.loadIndex(
+                        indexInputWithBuffer,
+                        ImmutableMap.of(KNNConstants.SPACE_TYPE, SpaceType.L2.getValue()),
+                        KNNEngine.FAISS
+                    );
+                    assertNotEquals(0, pointers[i]);
+                }
+            }
+            int[] docBases = new int[] { 0, docBase };
+
+            Map<String, ?> methodParameters = Map.of("ef_search", efSearch);
+            for (float[] query : testData.queries) {
+                KNNQueryResult[] expected = JNIService.queryIndex(pointers[0], query, k, methodParameters, KNNEngine.FAISS, null, 0, null);
+                KNNQueryResult[] results = JNIService.queryIndexes(
+                    pointers,
+                    docBases,
+                    query,
+                    k,
+                    methodParameters,
+                    KNNEngine.FAISS,
+                    null,
+                    null
+                );
+                // Every hit shows up once per segment
+                assertEquals(k, results.length);
+                for (int j = 0; j < k / 2; j++) {
+                    Set<Integer> ids = Set.of(results[2 * j].getId(), results[2 * j + 1].getId());
+                    assertEquals(Set.of(expected[j].getId(), expected[j].getId() + docBase), ids);
+                    assertEquals(expected[j].getScore(), results[2 * j].getScore(), 0.0001f);
+                    assertEquals(expected[j].getScore(), results[2 * j + 1].getScore(), 0.0001f);
+                }
+            }
+
+            expectThrows(
+                IllegalArgumentException.class,
+                () -> JNIService.queryIndexes(pointers, docBases, testData.queries[0], k, null, KNNEngine.NMSLIB, null, null)
+            );
+            for (long pointer : pointers) {
+                JNIService.free(pointer, KNNEngine.FAISS);
+            }
+        }
+    }
+
+    public void testQueryIndexIntoArrays_faiss_valid() throws IOException {
+        int k = 10;
+        int efSearch = 100;
+
+        Path tempDirPath = createTempDir();
+        try (Directory directory = newFSDirectory(tempDirPath)) {
+            String indexFileName1 = createFaissHNSWIndex(directory, SpaceType.L2);
+
+            final long pointer;
+            try (IndexInput indexInput = directory.openInput(indexFileName1, IOContext.DEFAULT)) {
+                final IndexInputWithBuffer indexInputWithBuffer = new IndexInputWithBuffer(indexInput);
+                pointer = JNIService.loadIndex(
+                    indexInputWithBuffer,
+                    ImmutableMap.of(KNNConstants.SPACE_TYPE, SpaceType.L2.getValue()),
+                    KNNEngine.FAISS
+                );
+                assertNotEquals(0, pointer);
+            }
+
+            int[] resultIds = new int[k];
+            float[] resultDistances = new float[k];
+            for (float[] query : testData.queries) {
+                KNNQueryResult[] results = JNIService.queryIndex(
+                    pointer,
+                    query,
+                    k,
+                    Map.of("ef_search", efSearch),
+                    KNNEngine.FAISS,
+                    null,
+                    0,
+                    null
+                );
+                int count = JNIService.queryIndexIntoArrays(
+                    pointer,
+                    query,
+                    k,
+                    Map.of("ef_search", efSearch),
+                    KNNEngine.FAISS,
+                    null,
+                    0,
+                    null,
+                    resultIds,
+                    resultDistances
+                );
+                assertEquals(results.length, count);
+                for (int j = 0; j < count; j++) {
+                    assertEquals(results[j].getId(), resultIds[j]);
+                    assertEquals(results[j].getScore(), resultDistances[j], 0.00001);
+                }
+            }
+
+            // Output arrays smaller than k are filled up to their capacity, and the full count shows they were too short
+            int[] smallIds = new int[k / 2];
+            float[] smallDistances = new float[k / 2];
+            int count = JNIService.queryIndexIntoArrays(
+                pointer,
+                testData.queries[0],
+                k,
+                Map.of("ef_search", efSearch),
+                KNNEngine.FAISS,
+                null,
+                0,
+                null,
+                smallIds,
+                smallDistances
+            );
+            assertEquals(k, count);
+        }
+    }
+
     public void testQueryIndex_faiss_streaming_valid() throws IOException {
         int k = 10;
         int efSearch = 100;
@@ -1707,6 +2179,56 @@ public class JNIServiceTests extends KNNTestCase {
         JNICommons.freeVectorData(trainPointer);
     }
 
+    public void testTrain_whenOutputIsGiven_thenWritesTrainedIndex() throws IOException {
+        long trainPointer = transferVectors(10);
+        Map<String, Object> parameters = ImmutableMap.of(
+            INDEX_DESCRIPTION_PARAMETER,
+            "IVF16,Flat",
+            KNNConstants.SPACE_TYPE,
+            SpaceType.L2.getValue()
+        );
+
+        byte[] faissIndex = JNIService.trainIndex(parameters, 128, trainPointer, KNNEngine.FAISS);
+
+        Path tempDirPath = createTempDir();
+        String indexFileName = "test" + UUID.randomUUID() + ".tmp";
+        try (Directory directory = newFSDirectory(tempDirPath)) {
+            try (IndexOutput indexOutput = directory.createOutput(indexFileName, IOContext.DEFAULT)) {
+                final IndexOutputWithBuffer indexOutputWithBuffer = new IndexOutputWithBuffer(indexOutput);
+                JNIService.trainIndex(parameters, 128, trainPointer, indexOutputWithBuffer, KNNEngine.FAISS);
+            }
+            // Same index as the one returned in a byte array, only the centroids may differ
+            assertEquals(faissIndex.length, directory.fileLength(indexFileName));
+        } finally {
+            JNICommons.freeVectorData(trainPointer);
+        }
+    }
+
+    public void testTrainingSession_whenFedInBatches_thenSucceed() {
+        Map<String, Object> parameters = ImmutableMap.of(
+            INDEX_DESCRIPTION_PARAMETER,
+            "IVF16,Flat",
+            KNNConstants.SPACE_TYPE,
+            SpaceType.L2.getValue()
+        );
+
+        long sessionPointer = JNIService.initTrainingSession(parameters, 128, KNNEngine.FAISS);
+        try {
+            for (int batch = 0; batch < 5; batch++) {
+                long batchPointer = transferVectors(10);
+                try {
+                    JNIService.addTrainingVectors(sessionPointer, batchPointer, KNNEngine.FAISS);
+                } finally {
+                    JNICommons.freeVectorData(batchPointer);
+                }
+            }
+            byte[] faissIndex = JNIService.trainFromSession(sessionPointer, KNNEngine.FAISS);
+            assertNotEquals(0, faissIndex.length);
+        } finally {
+            JNIService.freeTrainingSession(sessionPointer, KNNEngine.FAISS);
+        }
+    }
+
     public void testTrain_whenConfigurationIsIVFPQ_thenSucceed() throws IOException {
         long trainPointer = transferVectors(10);
         int ivfNlistParam = 16;
@@ -2026,6 +2548,10 @@ public class JNIServiceTests extends KNNTestCase {
         expectThrows(IllegalArgumentException.class, () -> JNIService.initSharedIndexState(dummyAddress, KNNEngine.NMSLIB));
         expectThrows(IllegalArgumentException.class, () -> JNIService.setSharedIndexState(dummyAddress, dummyAddress, KNNEngine.NMSLIB));
         expectThrows(IllegalArgumentException.class, () -> JNIService.freeSharedIndexState(dummyAddress, KNNEngine.NMSLIB));
+        expectThrows(
+            IllegalArgumentException.class,
+            () -> JNIService.queryIndexBatch(dummyAddress, new float[0], 1, null, KNNEngine.NMSLIB, null, 0, null, new int[0], new float[0])
+        );
     }
 
     private void assertQueryResultsMatch(float[][] testQueries, int k, List<Long> indexAddresses) {